@@ -8,7 +8,7 @@ use strict;
 ## EXECUTABLES
 my @masterprog=("fullBuild","ess","muBeam","pipe","photonMod2","t1Real",
 		"sns","reactor","t1MarkII","essBeamline",
-		"filter","singleItem","testMain"); 
+		"filter","singleItem","varBench","testMain"); 
 
 
 
@@ -342,6 +342,21 @@ $gM->addDepUnit("gamma",    ["gammaBuild","t1Build","imat","chip","build",
 			     "support","weights","md5","global","attachComp",
 			     "visit","poly"]);
 
+$gM->addDepUnit("varBench", ["essBuild","beamline","support","input",
+			     "funcBase","log","construct","md5",
+			     "process","world","monte","geometry",
+                             "mersenne","src","xml","poly",
+			     "weights","global","attachComp","visit",
+                             "beer","bifrost","cspec","dream","estia",
+			     "freia","heimdal","loki","magic","miracles",
+			     "nmx","nnbar","odin","testBeam","trex",
+			     "vor","vespa","skadi",
+			     "shortDream","shortNmx","shortOdin","longLoki",
+			     "commonVar","simpleItem","physics","simMC",
+			     "transport","scatMat","endf","crystal",
+			     "tally","source","instrument","work"
+    	 	             ]);
+
 $gM->addDepUnit("testMain", ["test","build","visit","chip","t1Upgrade",
 			     "imat","moderator","build","zoom","construct",
 			     "crystal","transport","scatMat","endf","t1Build",
@@ -12,7 +12,7 @@ sub new
     
     bcomp => "clang",
     ccomp => "clang",
-    cflag => "-fPIC -Wconversion -W -Wall -Wextra -Wno-comment -fexceptions -std=c++11",
+    cflag => "-fPIC -Wconversion -W -Wall -Wextra -Wno-comment -fexceptions -pthread -std=c++11",
     boostLib => "-L/opt/local/lib -lboost_regex ",
     boostReq => "regex system filesystem ",
 
@@ -195,6 +195,9 @@ sub setParameters
 	  $self->{optimise}.=" -O2 " if ($Ostr eq "-O");
 	  push(@{$self->{definitions}},"NO_REGEX") if ($Ostr eq "-NR");
 	  $self->{noregex}=1 if ($Ostr eq "-NR");
+	  ## RegMethod trace : -T2 all / -T1 no hot methods / -T0 none
+	  push(@{$self->{definitions}},"REGTRACE_LEVEL=".$1)
+	    if ($Ostr=~/^-T([012])$/);
 	  $self->{optimise}.=" -pg " if ($Ostr eq "-p"); ## Gprof
 	  $self->{gcov}=1 if ($Ostr eq "-C");
 	  $self->{debug}="" if ($Ostr eq "-g");
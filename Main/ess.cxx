@@ -116,7 +116,11 @@ main(int argc,char* argv[])
       mainSystem::setDefUnits(SimPtr->getDataBase(),IParam);
       const std::set<std::string> beamlines=
         IParam.getComponents<std::string>("beamlines",1);
-      setVariable::EssVariables(SimPtr->getDataBase(),beamlines);
+      if (!mainSystem::readVarSnapshot(SimPtr->getDataBase(),IParam,"ess"))
+        {
+          setVariable::EssVariables(SimPtr->getDataBase(),beamlines);
+          mainSystem::writeVarSnapshot(SimPtr->getDataBase(),IParam,"ess");
+        }
       InputModifications(SimPtr,IParam,Names);
       mainSystem::setMaterialsDataBase(IParam);
 
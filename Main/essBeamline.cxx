@@ -116,7 +116,13 @@ main(int argc,char* argv[])
       mainSystem::setDefUnits(SimPtr->getDataBase(),IParam);
       const std::set<std::string> beamlines=
         IParam.getComponents<std::string>("beamlines",1);            
-      setVariable::EssVariables(SimPtr->getDataBase(),beamlines);
+      if (!mainSystem::readVarSnapshot(SimPtr->getDataBase(),
+                                       IParam,"essBeamline"))
+        {
+          setVariable::EssVariables(SimPtr->getDataBase(),beamlines);
+          mainSystem::writeVarSnapshot(SimPtr->getDataBase(),
+                                       IParam,"essBeamline");
+        }
       InputModifications(SimPtr,IParam,Names);            
       mainSystem::setMaterialsDataBase(IParam);
 
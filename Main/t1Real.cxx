@@ -120,7 +120,11 @@ main(int argc,char* argv[])
       if (!SimPtr) return -1;
       
       // The big variable setting
-      setVariable::TS1real(SimPtr->getDataBase());
+      if (!mainSystem::readVarSnapshot(SimPtr->getDataBase(),IParam,"t1Real"))
+	{
+	  setVariable::TS1real(SimPtr->getDataBase());
+	  mainSystem::writeVarSnapshot(SimPtr->getDataBase(),IParam,"t1Real");
+	}
       InputModifications(SimPtr,IParam,Names);
 
       
@@ -173,6 +173,8 @@
 #include "testSurfEqual.h"
 #include "testSurfExpand.h"
 #include "testSurIntersect.h"
+#include "testSurfPack.h"
+#include "testTrackScratch.h"
 #include "testSurfRegister.h"
 #include "testSVD.h"
 #include "testTally.h"
@@ -180,6 +182,7 @@
 #include "testVec3D.h"
 #include "testVolumes.h"
 #include "testWorkData.h"
+#include "testWWG.h"
 #include "testWrapper.h"
 #include "testXML.h"
 
@@ -600,6 +603,7 @@ geometryTest(const int type,const int extra)
       "testPlane",
       "testRecTriangle",
       "testSurIntersect",
+      "testSurfPack",
       "testSVD",
       "testVec3D"
     };
@@ -698,6 +702,12 @@ geometryTest(const int type,const int extra)
 	  testSurIntersect A;
 	  X=A.applyTest(extra);
 	}
+
+      if(index==testNum++)
+	{
+	  testSurfPack A;
+	  X=A.applyTest(extra);
+	}
       
       if(index==testNum++)
 	{
@@ -818,6 +828,7 @@ montecarloTest(const int type,const int extra)
       std::cout<<"testMaterial         (4)"<<std::endl;
       std::cout<<"testNeutron          (5)"<<std::endl;
       std::cout<<"testObject           (6)"<<std::endl;
+      std::cout<<"testTrackScratch     (7)"<<std::endl;
     }
 
   if(type==1 || type<0)
@@ -862,6 +873,13 @@ montecarloTest(const int type,const int extra)
       if (X) return X;
     }
 
+  if(type==7 || type<0)
+    {
+      testTrackScratch A;
+      const int X=A.applyTest(extra);
+      if (X) return X;
+    }
+
   return 0;
 }
 
@@ -949,7 +967,8 @@ processTest(const int type,const int extra)
       std::cout<<"testSurfExpand      (16)"<<std::endl;
       std::cout<<"testSurfRegister    (17)"<<std::endl;
       std::cout<<"testVolumes         (18)"<<std::endl;
-      std::cout<<"testWrapper         (19)"<<std::endl;
+      std::cout<<"testWWG             (19)"<<std::endl;
+      std::cout<<"testWrapper         (20)"<<std::endl;
     }
   int index(1);
   if(type==index || type<0)
@@ -1097,6 +1116,14 @@ processTest(const int type,const int extra)
     }
   index++;
   
+  if(type==index || type<0)
+    {
+      testWWG A;
+      const int X=A.applyTest(extra);
+      if (X) return X;
+    }
+  index++;
+  
   if(type==index || type<0)
     {
       testWrapper A;
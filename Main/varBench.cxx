@@ -0,0 +1,249 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   Main/varBench.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <list>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "Exception.h"
+#include "MersenneTwister.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "support.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Code.h"
+#include "FItem.h"
+#include "varList.h"
+#include "FuncDataBase.h"
+#include "varScope.h"
+#include "MainProcess.h"
+#include "variableSetup.h"
+
+MTRand RNG(12345UL);
+
+///\cond STATIC
+namespace ELog 
+{
+  ELog::OutputLog<EReport> EM;
+  ELog::OutputLog<FileReport> FM("Spectrum.log");
+  ELog::OutputLog<FileReport> RN("Renumber.txt");   ///< Renumber
+  ELog::OutputLog<StreamReport> CellM;
+}
+///\endcond STATIC
+
+/// Head : tails of the variable names
+typedef std::vector<std::pair<std::string,std::vector<std::string>>> KTYPE;
+
+namespace
+{
+
+KTYPE
+splitKeys(const std::vector<std::string>& Keys)
+  /*!
+    Split the keys into the keyName part [up to the
+    first capital letter] and the tail. The heads and
+    the tails in each head are shuffled, so that the look 
+    ups are not in name order [as in a model build].
+    \param Keys :: Variable names
+    \return head : tails
+  */
+{
+  std::map<std::string,std::vector<std::string>> HMap;
+  for(const std::string& K : Keys)
+    {
+      size_t i;
+      for(i=1;i<K.size() && !std::isupper(K[i]);i++) ;
+      HMap[K.substr(0,i)].push_back(K.substr(i));
+    }
+  
+  std::mt19937 Gen(12345);
+  KTYPE Out(HMap.begin(),HMap.end());
+  std::shuffle(Out.begin(),Out.end(),Gen);
+  for(KTYPE::value_type& KP : Out)
+    std::shuffle(KP.second.begin(),KP.second.end(),Gen);
+  return Out;
+}
+
+double
+rate(const size_t N,const std::chrono::duration<double>& T)
+  /*!
+    Look up rate
+    \param N :: Number of look ups
+    \param T :: Time taken
+    \return million look ups per second
+  */
+{
+  return (T.count()>0.0) ?
+    1e-6*static_cast<double>(N)/T.count() : 0.0;
+}
+
+}
+
+int 
+main(int argc,char* argv[])
+  /*!
+    Time the look up of all the ESS variables by 
+    - the ordered name map [the old varList store]
+    - FuncDataBase::findItem [hashed]
+    - varScope [head re-used, hashed]
+    and the read of a binary variable snapshot. The [uncached]
+    evaluation of function variables is compared to values.
+    Optional argument is the number of passes [default 20]
+  */
+{
+  int exitFlag(0);                // Value on exit
+  ELog::RegMethod RControl("","main");
+  mainSystem::activateLogging(RControl);
+
+  typedef std::chrono::high_resolution_clock CLOCK;
+  try
+    {
+      size_t nLoop(20);
+      if (argc>1 && !StrFunc::convert(argv[1],nLoop))
+	throw ColErr::InvalidLine(argv[1],"varBench nLoop",0);
+      
+      FuncDataBase Control;
+      const std::set<std::string> beamNames;
+
+      CLOCK::time_point TStart=CLOCK::now();
+      setVariable::EssVariables(Control,beamNames);
+      const std::chrono::duration<double> setTime=CLOCK::now()-TStart;
+
+      // Binary snapshot : write + read back
+      const std::string snapName("varBench.snap");
+      Control.writeBinary(snapName,"varBench");
+      FuncDataBase SnapControl;
+      TStart=CLOCK::now();
+      const int snapFlag=SnapControl.readBinary(snapName,"varBench");
+      const std::chrono::duration<double> snapTime=CLOCK::now()-TStart;
+      std::remove(snapName.c_str());
+      if (!snapFlag)
+	throw ColErr::FileError(0,snapName,"varBench snapshot");
+      
+      const std::vector<std::string> Keys=Control.getKeys();
+      const KTYPE KeyParts=splitKeys(Keys);
+      const size_t NLook(nLoop*Keys.size());
+
+      std::map<std::string,const FItem*> OMap;
+      for(const std::string& K : Keys)
+	OMap.emplace(K,Control.findItem(K));
+
+      // Ordered map : full string built each time
+      size_t nFound(0);
+      TStart=CLOCK::now();
+      for(size_t i=0;i<nLoop;i++)
+	for(const KTYPE::value_type& KP : KeyParts)
+	  for(const std::string& T : KP.second)
+	    if (OMap.find(KP.first+T)!=OMap.end()) nFound++;
+      const std::chrono::duration<double> mapTime=CLOCK::now()-TStart;
+
+      // Hash : full string built each time
+      TStart=CLOCK::now();
+      for(size_t i=0;i<nLoop;i++)
+	for(const KTYPE::value_type& KP : KeyParts)
+	  for(const std::string& T : KP.second)
+	    if (Control.findItem(KP.first+T)) nFound++;
+      const std::chrono::duration<double> hashTime=CLOCK::now()-TStart;
+
+      // Scope : head re-used
+      TStart=CLOCK::now();
+      for(size_t i=0;i<nLoop;i++)
+	for(const KTYPE::value_type& KP : KeyParts)
+	  {
+	    varScope SV(Control,KP.first);
+	    for(const std::string& T : KP.second)
+	      nFound+=static_cast<size_t>(SV.hasVariable(T));
+	  }
+      const std::chrono::duration<double> scopeTime=CLOCK::now()-TStart;
+
+      // Function variables [uncached : fresh copy] against values
+      const size_t NFunc(10000);
+      FuncDataBase FControl;
+      FControl.addVariable("benchLength",2.0);
+      FControl.addVariable("benchWidth",3.0);
+      for(size_t i=0;i<NFunc;i++)
+	{
+	  const std::string Index=std::to_string(i);
+	  FControl.addVariable("benchValue"+Index,static_cast<double>(i));
+	  FControl.Parse("benchLength*(2.0+3.0)+benchWidth/2.0+benchValue"+
+			 Index);
+	  FControl.addVariable("benchFunc"+Index);
+	}
+      double sum(0.0);
+      std::chrono::duration<double> funcTime(0.0);
+      for(size_t i=0;i<nLoop;i++)
+	{
+	  const FuncDataBase FCopy(FControl);
+	  TStart=CLOCK::now();
+	  for(size_t j=0;j<NFunc;j++)
+	    sum+=FCopy.EvalVar<double>("benchFunc"+std::to_string(j));
+	  funcTime+=CLOCK::now()-TStart;
+	}
+      TStart=CLOCK::now();
+      for(size_t i=0;i<nLoop;i++)
+	for(size_t j=0;j<NFunc;j++)
+	  sum+=FControl.EvalVar<double>("benchValue"+std::to_string(j));
+      const std::chrono::duration<double> valueTime=CLOCK::now()-TStart;
+      
+      if (nFound!=3*NLook)
+	throw ColErr::MisMatch<size_t>(nFound,3*NLook,"varBench found");
+
+      ELog::EM<<"Variables   : "<<Keys.size()<<" ["
+	      <<KeyParts.size()<<" heads]"<<ELog::endDiag;
+      ELog::EM<<"EssVariables: "<<setTime.count()<<" s"<<ELog::endDiag;
+      ELog::EM<<"Snapshot    : "<<snapTime.count()<<" s"<<ELog::endDiag;
+      ELog::EM<<"Look ups    : "<<NLook<<" per method"<<ELog::endDiag;
+      ELog::EM<<"Ordered map : "<<rate(NLook,mapTime)
+	      <<" M/s"<<ELog::endDiag;
+      ELog::EM<<"Hash        : "<<rate(NLook,hashTime)
+	      <<" M/s"<<ELog::endDiag;
+      ELog::EM<<"varScope    : "<<rate(NLook,scopeTime)
+	      <<" M/s"<<ELog::endDiag;
+      ELog::EM<<"Functions   : "<<rate(nLoop*NFunc,funcTime)
+	      <<" M/s [uncached]"<<ELog::endDiag;
+      ELog::EM<<"Values      : "<<rate(nLoop*NFunc,valueTime)
+	      <<" M/s "<<sum<<ELog::endDiag;
+    }
+  catch (ColErr::ExBase& A)
+    {
+      ELog::EM<<"EXCEPTION FAILURE :: "
+	      <<A.what()<<ELog::endCrit;
+      exitFlag= -1;
+    }
+  return exitFlag;
+}
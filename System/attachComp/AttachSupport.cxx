@@ -33,6 +33,7 @@
 #include <string>
 #include <algorithm>
 #include <memory>
+#include <array>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -67,6 +68,7 @@
 #include "CellMap.h"
 #include "objectRegister.h"
 #include "Qhull.h"
+#include "CellIndex.h"
 #include "Simulation.h"
 #include "SurInter.h"
 #include "Line.h"
@@ -506,6 +508,8 @@ addToInsertSurfCtrl(Simulation& System,
   if (!CRPtr) return;
   
   CRPtr->populate();
+  if (!checkBoxIntersect(CC,*CRPtr)) return;
+
   CRPtr->createSurfaceList();
   const std::vector<const Geometry::Surface*>&
     CellSVec=CRPtr->getSurList();
@@ -534,7 +538,8 @@ addToInsertSurfCtrl(Simulation& System,
 {
   ELog::RegMethod RegA("AttachSupport","addToInsertSurfCtrl(int,int,CC)");
 
-  const std::vector<Geometry::Surface*> SVec=CC.getSurfaces();
+  const ModelSupport::CellIndex::BoxTYPE CCBox=
+    ModelSupport::CellIndex::ruleBox(CC.getOuterSurf().getTopRule());
 
   for(int i=cellA+1;i<=cellB;i++)
     {
@@ -542,6 +547,10 @@ addToInsertSurfCtrl(Simulation& System,
       if (CRPtr)
 	{
 	  CRPtr->populate();
+	  // reject cells that cannot overlap 
+	  if (!ModelSupport::CellIndex::overlapBox
+	      (CCBox,ModelSupport::CellIndex::ruleBox(CRPtr->topRule())))
+	    continue;
 	  CRPtr->createSurfaceList();
 	  const std::vector<const Geometry::Surface*>&
 	    CellSVec=CRPtr->getSurList();
@@ -573,9 +582,6 @@ addToInsertOuterSurfCtrl(Simulation& System,
 {
   ELog::RegMethod RegA("AttachSupport","addToInsertSurfCtrl(int,int,CC)");
 
-  const std::vector<Geometry::Surface*> SVec=CC.getSurfaces();
-
-
   // Populate and createSurface list MUST have been called      
   const std::vector<const Geometry::Surface*>
     CellSVec=BaseCC.getConstSurfaces();
@@ -583,7 +589,8 @@ addToInsertOuterSurfCtrl(Simulation& System,
   for(int i=cellA+1;i<=cellB;i++)
     {
       MonteCarlo::Qhull* CRPtr=System.findQhull(i);
-      if (CRPtr && checkIntersect(CC,*CRPtr,CellSVec))
+      if (CRPtr && checkBoxIntersect(CC,*CRPtr) &&
+	  checkIntersect(CC,*CRPtr,CellSVec))
 	CC.addInsertCell(i);
     }
 
@@ -591,6 +598,67 @@ addToInsertOuterSurfCtrl(Simulation& System,
   return;
 }
 
+void
+addToInsertAutoCtrl(Simulation& System,
+		    const attachSystem::FixedComp& FC,
+		    attachSystem::ContainedComp& CC)
+ /*!
+   Adds this object to all the cells that it intersects.
+   The candidate cells are those whose bounding box overlaps
+   the outer box of CC [from the cell index] rather than a 
+   range of cells. The cells of FC are not tested.
+   \param System :: Simulation to use
+   \param FC :: FixedComp of the inserted object [own cells]
+   \param CC :: ContainedComp object to add to this
+  */
+{
+  ELog::RegMethod RegA("AttachSupport","addToInsertAutoCtrl");
+
+  if (!CC.hasOuterSurf()) return;
+  
+  const ModelSupport::objectRegister& OR=
+    ModelSupport::objectRegister::Instance();
+  const int cellN=OR.getCell(FC.getKeyName());
+  const int cellL=OR.getLast(FC.getKeyName());
+
+  if (!System.getCellIndex() || !System.getCellIndex()->isBuilt())
+    System.buildCellIndex();
+  
+  const ModelSupport::CellIndex::BoxTYPE CCBox=
+    ModelSupport::CellIndex::ruleBox(CC.getOuterSurf().getTopRule());
+  std::vector<MonteCarlo::Object*> candidates;
+  System.getCellIndex()->boxCells(CCBox,candidates);
+
+  for(MonteCarlo::Object* CRPtr : candidates)
+    {
+      const int CN=CRPtr->getName();
+      if (CN>cellN && CN<=cellL) continue;
+
+      CRPtr->populate();
+      CRPtr->createSurfaceList();
+      if (checkIntersect(CC,*CRPtr,CRPtr->getSurList()))
+	CC.addInsertCell(CN);
+    }
+  CC.insertObjects(System);
+  return;
+}
+
+bool
+checkBoxIntersect(const ContainedComp& CC,const MonteCarlo::Object& CellObj)
+  /*!
+    Quick rejection test : can the contained component
+    overlap the cell. Uses the conservative boxes of the 
+    rules [both must be populated].
+    \param CC :: Contained Component
+    \param CellObj :: Cell Object
+    \return false if the object and cell are disjoint
+  */
+{
+  return ModelSupport::CellIndex::overlapBox
+    (ModelSupport::CellIndex::ruleBox(CC.getOuterSurf().getTopRule()),
+     ModelSupport::CellIndex::ruleBox(CellObj.topRule()));
+}
+
 bool
 checkIntersect(const ContainedComp& CC,const MonteCarlo::Object& CellObj,
 	       const std::vector<const Geometry::Surface*>& CellSVec)
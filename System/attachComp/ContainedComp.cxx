@@ -623,11 +623,16 @@ ContainedComp::insertObjects(Simulation& System)
   ELog::RegMethod RegA("ContainedComp","insertObjects");
   if (!hasOuterSurf()) return;
 
+  // process the exclude once: it is spliced into each cell
+  HeadRule ExcludeRule;
+  if (!ExcludeRule.procString(getExclude()))
+    throw ColErr::InvalidLine(getExclude(),"ExcludeRule failed");
+
   for(const int CN : insertCells)
     {
       MonteCarlo::Qhull* outerObj=System.findQhull(CN);
       if (outerObj)
-	outerObj->addSurfString(getExclude());
+	outerObj->addIntersection(ExcludeRule);
       else
 	ELog::EM<<"Failed to find outerObject: "<<CN<<ELog::endErr;
     }
@@ -74,6 +74,8 @@ void addToInsertSurfCtrl(Simulation&,const CellMap&,const std::string&,
 void addToInsertSurfCtrl(Simulation&,const int,const int,
 			ContainedComp&);
 void addToInsertSurfCtrl(Simulation&,const int,ContainedComp&);
+void addToInsertAutoCtrl(Simulation&,const FixedComp&,
+			 ContainedComp&);
 void addToInsertOuterSurfCtrl(Simulation&,const FixedComp&,
 			ContainedComp&);
 void addToInsertOuterSurfCtrl(Simulation&,
@@ -89,6 +91,7 @@ void addToInsertForced(Simulation&,const int,const int,
 // External check system
 bool checkIntersect(const ContainedComp&,const MonteCarlo::Object&,
 		    const std::vector<const Geometry::Surface*>&);
+bool checkBoxIntersect(const ContainedComp&,const MonteCarlo::Object&);
 
 bool checkLineIntersect(const FixedComp&,const MonteCarlo::Object&);
 
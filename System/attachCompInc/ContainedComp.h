@@ -79,6 +79,8 @@ class ContainedComp
 
   /// Test if has outer rule
   bool hasOuterSurf() const { return outerSurf.hasRule(); }
+  /// Access outer rule
+  const HeadRule& getOuterSurf() const { return outerSurf; }
   /// Test if has boundary rule
   bool hasBoundary() const { return boundary.hasRule(); }
   int isBoundaryValid(const Geometry::Vec3D&) const;
@@ -373,7 +373,7 @@ ENDFmaterial::Sab(const size_t atomIndex,const double E,
     \return S(Q,w)
   */
 {
-  ELog::RegMethod RegA("ENDFmaterial","Sab");
+  ELog::HotMethod RegA("ENDFmaterial","Sab");
 
   const double alpha=(Eprime+E-2*mu*sqrt(Eprime*E))/
     (AWR*RefCon::k_bev*tempActual);
@@ -3,7 +3,7 @@
  
  * File:   funcBase/Code.cxx
  *
- * Copyright (c) 2004-2016 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -27,7 +27,9 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include <iterator>
+#include <algorithm>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -36,6 +38,7 @@
 #include "RegMethod.h"
 #include "OutputLog.h"
 #include "support.h"
+#include "fileSupport.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
@@ -45,14 +48,14 @@
 
 
 Code::Code() :
-  valid(0),StackPtr(0),StackSize(1)
+  valid(0),scalarFlag(0),StackPtr(0),StackSize(1)
   /*!
     Standard constructor
   */
 {}
 
 Code::Code(const Code& A) :
-  valid(A.valid),StackPtr(A.StackPtr),
+  valid(A.valid),scalarFlag(A.scalarFlag),StackPtr(A.StackPtr),
   StackSize(A.StackSize),ByteCode(A.ByteCode),
   Labels(A.Labels),Immed(A.Immed),      
   ImmedVec(A.ImmedVec)
@@ -73,6 +76,7 @@ Code::operator=(const Code& A)
   if (&A!=this)
     {
       valid=A.valid;
+      scalarFlag=A.scalarFlag;
       StackPtr=A.StackPtr;
       StackSize=A.StackSize;
       ByteCode=A.ByteCode;
@@ -96,6 +100,7 @@ Code::clear()
   */
 {
   valid=0;
+  scalarFlag=0;
   StackPtr=0;
   StackSize=0;
   ByteCode.clear();
@@ -182,17 +187,306 @@ Code::subStackPtr(const size_t AS)
   return StackPtr;
 }
 
+int
+Code::hasAssign() const
+  /*!
+    Determine if the code assigns a variable during
+    evaluation [and thus has a side effect]
+    \return 1 if an assignment exists
+  */
+{
+  for(const int BC : ByteCode)
+    if (BC==Opcodes::cEqual) return 1;
+  return 0;
+}
+
+
+
+int
+Code::stackArgs(const int Op)
+  /*!
+    Number of stack items an operation uses [one is
+    always put back]
+    \param Op :: Opcode 
+    \return number of arguments / -1 if not an operation
+  */
+{
+  switch(Op)
+    {
+    case Opcodes::cAtan2:
+    case Opcodes::cDot:
+    case Opcodes::cMax:
+    case Opcodes::cMin:
+    case Opcodes::cAdd:
+    case Opcodes::cSub:
+    case Opcodes::cMul:
+    case Opcodes::cDiv:
+    case Opcodes::cMod:
+    case Opcodes::cPow:
+      return 2;
+    case Opcodes::cVec3D:
+      return 3;
+    default:
+      break;
+    }
+  return (Op>=Opcodes::cAbs && Op<=Opcodes::cRad) ? 1 : -1;
+}
+
+int
+Code::scalarOp(const int Op,double* Stack,size_t& SP)
+  /*!
+    Apply a scalar operation to the top of a double stack.
+    Invalid values are not processed so that the general
+    evaluation can report them.
+    \param Op :: Opcode 
+    \param Stack :: Double stack
+    \param SP :: Stack pointer [updated]
+    \return 1 on success / 0 if not a valid scalar operation
+  */
+{
+  double& A=Stack[SP];
+  switch(Op)
+    {
+    case Opcodes::cAbs: A=fabs(A); return 1;
+    case Opcodes::cAcos:
+      if (A< -1.0 || A>1.0) return 0;
+      A=acos(A);
+      return 1;
+    case Opcodes::cAcosh: A=acosh(A); return 1;
+    case Opcodes::cAsin: 
+      if (A< -1.0 || A>1.0) return 0;
+      A=asin(A);
+      return 1;
+    case Opcodes::cAsinh: A=asinh(A); return 1;
+    case Opcodes::cAtan: A=atan(A); return 1;
+    case Opcodes::cAtanh: A=atanh(A); return 1;
+    case Opcodes::cCeil: A=ceil(A); return 1;
+    case Opcodes::cCos: A=cos(A); return 1;
+    case Opcodes::cCosd: A=cos(M_PI*A/180.0); return 1;
+    case Opcodes::cCosh: A=cosh(A); return 1;
+    case Opcodes::cCot: 
+      if (tan(A)==0.0) return 0;
+      A=1.0/tan(A);
+      return 1;
+    case Opcodes::cCotd: 
+      if (tan(M_PI*A/180.0)==0.0) return 0;
+      A=1.0/tan(M_PI*A/180.0);
+      return 1;
+    case Opcodes::cCsc: 
+      if (sin(A)==0.0) return 0;
+      A=1.0/sin(A);
+      return 1;
+    case Opcodes::cCscd: 
+      if (sin(M_PI*A/180.0)==0.0) return 0;
+      A=1.0/sin(M_PI*A/180.0);
+      return 1;
+    case Opcodes::cExp: A=exp(A); return 1;
+    case Opcodes::cFloor: A=floor(A); return 1;
+    case Opcodes::cInt: A=int(A+0.5); return 1;
+    case Opcodes::cInv: 
+      if (A==0.0) return 0;
+      A=1.0/A;
+      return 1;
+    case Opcodes::cLog:
+      if (A<=0.0) return 0;
+      A=log(A);
+      return 1;
+    case Opcodes::cLog10:
+      if (A<=0.0) return 0;
+      A=log10(A);
+      return 1;
+    case Opcodes::cSec: 
+      if (cos(A)==0.0) return 0;
+      A=1.0/cos(A);
+      return 1;
+    case Opcodes::cSecd: 
+      if (cos(M_PI*A/180.0)==0.0) return 0;
+      A=1.0/cos(M_PI*A/180.0);
+      return 1;
+    case Opcodes::cSin: A=sin(A); return 1;
+    case Opcodes::cSind: A=sin(M_PI*A/180.0); return 1;
+    case Opcodes::cSinh: A=sinh(A); return 1;
+    case Opcodes::cSqrt: A=sqrt(A); return 1;
+    case Opcodes::cTan: A=tan(A); return 1;
+    case Opcodes::cTand: A=tan(M_PI*A/180.0); return 1;
+    case Opcodes::cTanh: A=tanh(A); return 1;
+    case Opcodes::cNeg: A= -A; return 1;
+    case Opcodes::cDeg: A=180.0*A/M_PI; return 1;
+    case Opcodes::cRad: A=M_PI*A/180.0; return 1;
+    default:
+      break;
+    }
+
+  // Binary operations
+  if (!SP || stackArgs(Op)!=2) return 0;
+  double& B=Stack[SP-1];
+  switch(Op)
+    {
+    case Opcodes::cAtan2: B=atan2(B,A); break;
+    case Opcodes::cMax: B=(B>A) ? B : A; break;
+    case Opcodes::cMin: B=(B<A) ? B : A; break;
+    case Opcodes::cAdd: B+=A; break;
+    case Opcodes::cSub: B-=A; break;
+    case Opcodes::cMul: B*=A; break;
+    case Opcodes::cDiv:
+      if (A==0.0) return 0;
+      B/=A;
+      break;
+    case Opcodes::cMod:
+      if (A==0.0) return 0;
+      B=fmod(B,A);
+      break;
+    case Opcodes::cPow: B=pow(B,A); break;
+    default:
+      return 0;
+    }
+  SP--;
+  return 1;
+}
+
+void
+Code::setScalarFlag()
+  /*!
+    Set the scalar flag if the code has only
+    scalar operations, immediates and variables.
+  */
+{
+  scalarFlag=0;
+  if (StackSize>maxScalarStack)
+    return;
+  for(const int BC : ByteCode)
+    {
+      if (BC!=Opcodes::cImmed && BC<Opcodes::varBegin)
+	{
+	  if (BC==Opcodes::cDot || BC==Opcodes::cVec3D ||
+	      stackArgs(BC)<0)
+	    return;
+	}
+    }
+  scalarFlag=1;
+  return;
+}
+
+void
+Code::optimise()
+  /*!
+    Fold the constant sub-expressions of the compiled
+    code into single immediate values and then determine
+    if the code can use the scalar evaluation.
+    A constant on the stack is always a single cImmed
+    (the last one in the new byte code).
+  */
+{
+  std::vector<int> BC;
+  std::vector<double> IM;
+  std::vector<int> constFlag;     // stack item is a cImmed
+  size_t DP(0);
+  
+  const size_t ByteCodeSize = ByteCode.size();
+  for(size_t IP=0;IP<ByteCodeSize;IP++)
+    {
+      const int Op=ByteCode[IP];
+      if (Op==Opcodes::cImmed)
+	{
+	  if (DP>=Immed.size()) return;
+	  IM.push_back(Immed[DP++]);
+	  constFlag.push_back(1);
+	}
+      else if (Op==Opcodes::cImmedVec || Op>=Opcodes::varBegin)
+	constFlag.push_back(0);
+      else if (Op==Opcodes::cEqual)
+	{
+	  if (constFlag.empty() || IP+1>=ByteCodeSize) return;
+	  constFlag.back()=0;
+	  BC.push_back(Op);
+	  IP++;
+	  BC.push_back(ByteCode[IP]);
+	  continue;
+	}
+      else
+	{
+	  const int NArg=stackArgs(Op);
+	  const size_t NA=static_cast<size_t>(NArg);
+	  if (NArg<0 || constFlag.size()<NA) return;   // leave unchanged
+	  
+	  double Stack[3];
+	  size_t SP(NA-1);
+	  const int allConst=
+	    std::find(constFlag.end()-NArg,constFlag.end(),0)==constFlag.end();
+	  if (allConst && NArg<3)
+	    {
+	      std::copy(IM.end()-NArg,IM.end(),Stack);
+	      if (scalarOp(Op,Stack,SP))
+		{
+		  // remove the cImmed of the arguments
+		  BC.resize(BC.size()-NA);
+		  IM.resize(IM.size()-NA);
+		  constFlag.resize(constFlag.size()-NA);
+		  IM.push_back(Stack[0]);
+		  BC.push_back(Opcodes::cImmed);
+		  constFlag.push_back(1);
+		  continue;
+		}
+	    }
+	  constFlag.resize(constFlag.size()-NA);
+	  constFlag.push_back(0);
+	}
+      BC.push_back(Op);
+    }
+  ByteCode=BC;
+  Immed=IM;
+  setScalarFlag();
+  return;
+}
 
+int
+Code::evalScalar(varList* Vars,double& Out) const
+  /*!
+    Evaluate code that has only scalar operations on
+    a double only stack. 
+    \param Vars :: Variable list
+    \param Out :: Output value
+    \return 1 on success / 0 if the general evaluation is
+    needed [Vec3D variable / invalid value]
+  */
+{
+  double Stack[maxScalarStack];
+  Geometry::Vec3D VecValue;
+  size_t DP(0);       // Immediated points (data)
+  size_t SP(0);       // Stack pointer  
+  SP--;
+
+  for(const int Op : ByteCode)
+    {
+      if (Op==Opcodes::cImmed || Op>=Opcodes::varBegin)
+	{
+	  if (++SP>=maxScalarStack) return 0;
+	  if (Op==Opcodes::cImmed)
+	    Stack[SP]=Immed[DP++];
+	  else if (Vars->selectValue(Op-Opcodes::varBegin,VecValue,Stack[SP]))
+	    return 0;
+	}
+      else if (SP>=maxScalarStack || !scalarOp(Op,Stack,SP))
+	return 0;
+    }
+  if (SP>=maxScalarStack) return 0;
+  Out=Stack[SP];
+  return 1;
+}
 
 template<typename T>
 T
-Code::Eval(varList* Vars)
+Code::Eval(varList* Vars) const
   /*!
     The function that evaluates everything
     \param Vars :: Vector of variable pointers
     \returns value of Function expression
   */
 {
+  double scalarValue;
+  if (scalarFlag && evalScalar(Vars,scalarValue))
+    return typeConvert<T>(scalarValue);
+  
   const size_t ByteCodeSize = ByteCode.size();
   size_t IP(0);       // Bytecode Pointer
   size_t DP(0);       // Immediated points (data)
@@ -375,14 +669,14 @@ Code::Eval(varList* Vars)
 	  break;
 
 	case Opcodes::cLog: 
-	  if(stackType[SP]==0 && Stack[SP] <= 0.0)
+	  if(stackType[SP]==0 && Stack[SP] > 0.0)
 	    Stack[SP] = log(Stack[SP]); 
 	  else 
 	    return zeroType<T>();
 	  break;
 
 	case Opcodes::cLog10: 
-	  if(stackType[SP]==0 && Stack[SP] <= 0.0)
+	  if(stackType[SP]==0 && Stack[SP] > 0.0)
 	    Stack[SP] = log10(Stack[SP]); 
 	  else 
 	    return zeroType<T>();
@@ -711,6 +1005,80 @@ Code::writeCompact(std::ostream& OX) const
   return;
 }
 
+void
+Code::writeBinary(std::ostream& OX) const
+  /*!
+    Write the compiled code in binary form [snapshot]
+    \param OX :: Output stream [binary]
+  */
+{
+  StrFunc::writeBinary(OX,valid);
+  StrFunc::writeBinary(OX,StackPtr);
+  StrFunc::writeBinary(OX,StackSize);
+  StrFunc::writeBinary(OX,ByteCode);
+  StrFunc::writeBinary(OX,Immed);
+
+  StrFunc::writeBinary(OX,ImmedVec.size());
+  for(const Geometry::Vec3D& V : ImmedVec)
+    {
+      StrFunc::writeBinary(OX,V.X());
+      StrFunc::writeBinary(OX,V.Y());
+      StrFunc::writeBinary(OX,V.Z());
+    }
+  
+  StrFunc::writeBinary(OX,Labels.size());
+  for(const std::map<std::string,int>::value_type& LC : Labels)
+    {
+      StrFunc::writeBinary(OX,LC.first);
+      StrFunc::writeBinary(OX,LC.second);
+    }
+  return;
+}
+
+void
+Code::readBinary(std::istream& IX)
+  /*!
+    Read the compiled code in binary form [snapshot]
+    \param IX :: Input stream [binary]
+  */
+{
+  StrFunc::readBinary(IX,valid);
+  StrFunc::readBinary(IX,StackPtr);
+  StrFunc::readBinary(IX,StackSize);
+  StrFunc::readBinary(IX,ByteCode);
+  StrFunc::readBinary(IX,Immed);
+
+  size_t N;
+  double V[3];
+  StrFunc::readBinary(IX,N);
+  if (N>StrFunc::remainBinary(IX)/(3*sizeof(double)))
+    throw ColErr::FileError(0,"stream","Code : size exceeds stream");
+  ImmedVec.clear();
+  for(size_t i=0;i<N;i++)
+    {
+      StrFunc::readBinary(IX,V[0]);
+      StrFunc::readBinary(IX,V[1]);
+      StrFunc::readBinary(IX,V[2]);
+      ImmedVec.push_back(Geometry::Vec3D(V[0],V[1],V[2]));
+    }
+  
+  std::string Name;
+  int index;
+  StrFunc::readBinary(IX,N);
+  // smallest label : name size + index
+  if (N>StrFunc::remainBinary(IX)/(sizeof(size_t)+sizeof(int)))
+    throw ColErr::FileError(0,"stream","Code : size exceeds stream");
+  Labels.clear();
+  for(size_t i=0;i<N;i++)
+    {
+      StrFunc::readBinary(IX,Name);
+      StrFunc::readBinary(IX,index);
+      Labels.emplace(Name,index);
+    }
+  setScalarFlag();
+  return;
+}
+
 void
 Code::printByteCode(std::ostream& OFS) const
   /*!
@@ -814,8 +1182,8 @@ Code::printByteCode(std::ostream& OFS) const
 
 
 ///\cond TEMPLATE
-template double Code::Eval(varList*);
-template Geometry::Vec3D Code::Eval(varList*);
+template double Code::Eval(varList*) const;
+template Geometry::Vec3D Code::Eval(varList*) const;
 
 template double Code::typeConvert(const Geometry::Vec3D&);
 template Geometry::Vec3D Code::typeConvert(const double&);
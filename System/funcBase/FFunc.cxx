@@ -3,7 +3,7 @@
  
  * File:   funcBase/FFunc.cxx
  *
- * Copyright (c) 2004-2014 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -26,6 +26,7 @@
 #include <cmath>
 #include <vector>
 #include <map>
+#include <set>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -34,6 +35,7 @@
 #include "RegMethod.h"
 #include "OutputLog.h"
 #include "support.h"
+#include "fileSupport.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
@@ -46,7 +48,7 @@
 //-----------------------------------------
 
 FFunc::FFunc(varList* VA,const int I,const Code& CObj) :
-  FItem(VA,I),BaseUnit(CObj)
+  FItem(VA,I),cacheFlag(!CObj.hasAssign()),BaseUnit(CObj)
   /*!
     Standard constructor
     \param VA :: VarList pointer
@@ -56,7 +58,7 @@ FFunc::FFunc(varList* VA,const int I,const Code& CObj) :
 {}
 
 FFunc::FFunc(const FFunc& A) :
-  FItem(A),BaseUnit(A.BaseUnit)
+  FItem(A),cacheFlag(A.cacheFlag),BaseUnit(A.BaseUnit)
   /*!
     Standard copy constructor
     \param A :: FFunc object to copy
@@ -74,6 +76,7 @@ FFunc::operator=(const FFunc& A)
   if (this!=&A)
     {
       FItem::operator=(A);
+      cacheFlag=A.cacheFlag;
       BaseUnit=A.BaseUnit;
     }
   return *this;
@@ -104,22 +107,102 @@ FFunc::setValue(const Code& AC)
   */
 {
   BaseUnit=AC;
+  cacheFlag=!AC.hasAssign();
   return;
 }
 
+double
+FFunc::evalDouble() const
+  /*!
+    Evaluate the code as a double. The cached value
+    is used if the varList holds one.
+    \return value of code
+  */
+{
+  double V;
+  if (cacheFlag && VListPtr->getCache(getIndex(),V))
+    return V;
+
+  VListPtr->pushEval(getIndex());
+  try
+    {
+      V=BaseUnit.Eval<double>(VListPtr);
+    }
+  catch (ColErr::ExBase&)
+    {
+      VListPtr->popEval();
+      throw;
+    }
+  VListPtr->popEval();
+  if (cacheFlag)
+    VListPtr->setCache(getIndex(),V);
+  return V;
+}
+
+Geometry::Vec3D
+FFunc::evalVec() const
+  /*!
+    Evaluate the code as a Vec3D. The cached value
+    is used if the varList holds one.
+    \return value of code
+  */
+{
+  Geometry::Vec3D V;
+  if (cacheFlag && VListPtr->getCache(getIndex(),V))
+    return V;
+
+  VListPtr->pushEval(getIndex());
+  try
+    {
+      V=BaseUnit.Eval<Geometry::Vec3D>(VListPtr);
+    }
+  catch (ColErr::ExBase&)
+    {
+      VListPtr->popEval();
+      throw;
+    }
+  VListPtr->popEval();
+  if (cacheFlag)
+    VListPtr->setCache(getIndex(),V);
+  return V;
+}
+
 int
 FFunc::getValue(Geometry::Vec3D& V) const
   /*!
     Get the values. Note that this
-    uses varlist
+    uses varlist. A scalar expression returns 0 
+    [as FValue<double>] so varList::selectValue 
+    can fall back to the double value.
     \param V :: Outsyste m
     \return 1 if appropiate eval / 0 otherwise
   */
 {
-  ELog::RegMethod RegA("FFunc","getValue(Vec3D)");
+  ELog::HotMethod RegA("FFunc","getValue(Vec3D)");
 
-  Code BC(BaseUnit);
-  V=BC.Eval<Geometry::Vec3D>(FItem::VListPtr);
+  // a cached double means a scalar expression
+  double D;
+  if (cacheFlag && VListPtr->getCache(getIndex(),D))
+    return 0;
+  // scalar code is a double unless a variable is a Vec3D
+  if (BaseUnit.isScalar())
+    {
+      try
+	{
+	  evalDouble();
+	  return 0;
+	}
+      catch (ColErr::TypeConvError<Geometry::Vec3D,double>&)
+	{ }
+    }
+  try
+    {
+      V=evalVec();
+    }
+  catch (ColErr::TypeConvError<double,Geometry::Vec3D>&)
+    {
+      return 0;
+    }
   const_cast<int&>(active)++;
   return 1;
 }
@@ -132,8 +215,7 @@ FFunc::getValue(double& V) const
     \return 1 if appropiate eval / 0 otherwise
   */
 {
-  Code BC(BaseUnit);
-  V=BC.Eval<double>(FItem::VListPtr);
+  V=evalDouble();
   const_cast<int&>(active)++;
   return 1;
 }
@@ -146,8 +228,7 @@ FFunc::getValue(int& V) const
     \return Code expression 
   */
 {
-  Code BC(BaseUnit);
-  V=static_cast<int>(BC.Eval<double>(VListPtr));
+  V=static_cast<int>(evalDouble());
   const_cast<int&>(active)++;
   return 1;
 }
@@ -160,8 +241,7 @@ FFunc::getValue(long int& V) const
     \return Code expression 
   */
 {
-  Code BC(BaseUnit);
-  V=static_cast<long int>(BC.Eval<double>(VListPtr));
+  V=static_cast<long int>(evalDouble());
   const_cast<int&>(active)++;
   return 1;
 }
@@ -175,8 +255,7 @@ FFunc::getValue(size_t& V) const
     \return Code expression 
   */
 {
-  Code BC(BaseUnit);
-  V=static_cast<size_t>(BC.Eval<double>(VListPtr));
+  V=static_cast<size_t>(evalDouble());
   const_cast<int&>(active)++;
   return 1;
 }
@@ -189,8 +268,7 @@ FFunc::getValue(std::string& V) const
     \return Code expression 
   */
 {
-  Code BC(BaseUnit);
-  double Val=BC.Eval<double>(VListPtr);
+  const double Val=evalDouble();
   std::stringstream cx;
   cx<<Val;
   V=cx.str();
@@ -215,3 +293,15 @@ FFunc::write(std::ostream& OX) const
   return;
 }
 
+void
+FFunc::writeBinary(std::ostream& OX) const
+  /*!
+    Write out the type key and compiled code in binary form
+    \param OX :: Output stream [binary]
+   */
+{
+  StrFunc::writeBinary(OX,'C');
+  BaseUnit.writeBinary(OX);
+  return;
+}
+
@@ -26,6 +26,7 @@
 #include <cmath>
 #include <vector>
 #include <map>
+#include <set>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -27,6 +27,7 @@
 #include <climits>
 #include <vector>
 #include <map>
+#include <set>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -35,6 +36,7 @@
 #include "RegMethod.h"
 #include "OutputLog.h"
 #include "support.h"
+#include "fileSupport.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
@@ -606,6 +608,45 @@ FValue<T>::write(std::ostream& OX) const
   return;
 }
 
+/// \cond TEMPLATE
+
+template<> const char FValue<Geometry::Vec3D>::binKey('V');
+template<> const char FValue<double>::binKey('d');
+template<> const char FValue<int>::binKey('i');
+template<> const char FValue<long int>::binKey('l');
+template<> const char FValue<size_t>::binKey('s');
+template<> const char FValue<std::string>::binKey('S');
+
+/// \endcond TEMPLATE
+
+template<typename T>
+void
+FValue<T>::writeBinary(std::ostream& OX) const
+  /*!
+    Write out the variable type key and value in binary form
+    \param OX :: Output stream [binary]
+   */
+{
+  StrFunc::writeBinary(OX,binKey);
+  StrFunc::writeBinary(OX,Value);
+  return;
+}
+
+template<>
+void
+FValue<Geometry::Vec3D>::writeBinary(std::ostream& OX) const
+  /*!
+    Write out the variable type key and value in binary form
+    \param OX :: Output stream [binary]
+   */
+{
+  StrFunc::writeBinary(OX,binKey);
+  StrFunc::writeBinary(OX,Value.X());
+  StrFunc::writeBinary(OX,Value.Y());
+  StrFunc::writeBinary(OX,Value.Z());
+  return;
+}
+
 /// Simple Typename
 template<>
 std::string FValue<Geometry::Vec3D>::typeKey()  const
@@ -28,6 +28,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <set>
 #include <algorithm>
 #include <functional>
 #include <iterator>
@@ -45,6 +46,7 @@
 #include "Matrix.h"
 #include "Vec3D.h"
 #include "support.h"
+#include "fileSupport.h"
 #include "regexSupport.h"
 #include "BaseVisit.h"
 #include "BaseModVisit.h"
@@ -61,6 +63,7 @@
 #include "MD5hash.h"
 #include "FuncDataBase.h"
 
+const char FuncDataBase::snapTag[8]={'C','L','V','A','R','S','1','\0'};
 
 FuncDataBase::FuncDataBase()
   /*!
@@ -516,7 +519,8 @@ FuncDataBase::CheckSyntax(const std::string& FString) const
 long int
 FuncDataBase::Compile(const std::string& FString)
   /*!
-    Compile function string to bytecode.
+    Compile function string to bytecode. The bytecode
+    is then optimised [constant folding]
     \param FString :: previously checked function string
     \returns 1 on success (0 on failure)
   */
@@ -533,7 +537,7 @@ FuncDataBase::Compile(const std::string& FString)
       ELog::EM<<"Compile error:"<<Error.what()<<ELog::endErr;
       return 0;
     }
-
+  Build.optimise();
   return 1;
 }
 
@@ -977,6 +981,86 @@ FuncDataBase::writeAll(const std::string& Fname) const
   return;
 }
 
+void
+FuncDataBase::writeBinary(const std::string& FName,
+			  const std::string& Key) const
+  /*!
+    Write all the variables as a binary snapshot. 
+    The file is the tag, the Key, the hash of the variable
+    block and the variable block.
+    \param FName :: Filename 
+    \param Key :: Key to identify the source of the variables
+  */
+{
+  ELog::RegMethod RegA("FuncDataBase","writeBinary");
+
+  std::ostringstream cx(std::ios::binary);
+  VList.writeBinary(cx);
+  const std::string Block(cx.str());
+  MD5hash sum;
+
+  std::ofstream OX(FName.c_str(),std::ios::binary);
+  if (!OX.good())
+    throw ColErr::FileError(0,FName,"Variable snapshot");
+  OX.write(snapTag,sizeof(snapTag));
+  StrFunc::writeBinary(OX,Key);
+  StrFunc::writeBinary(OX,sum.processMessage(Block));
+  StrFunc::writeBinary(OX,Block);
+  OX.close();
+  return;
+}
+
+int
+FuncDataBase::readBinary(const std::string& FName,
+			 const std::string& Key)
+  /*!
+    Read a binary snapshot of all the variables. The variables
+    are only replaced if the tag/key/hash all match.
+    \param FName :: Filename 
+    \param Key :: Key to identify the source of the variables
+    \return 1 on success / 0 on a missing/stale/corrupt snapshot
+  */
+{
+  ELog::RegMethod RegA("FuncDataBase","readBinary");
+
+  std::ifstream IX(FName.c_str(),std::ios::binary);
+  if (!IX.good())
+    return 0;
+
+  try
+    {
+      char tag[sizeof(snapTag)];
+      std::string fileKey;
+      std::string fileHash;
+      std::string Block;
+      IX.read(tag,sizeof(tag));
+      if (!IX.good() || !std::equal(tag,tag+sizeof(tag),snapTag))
+	return 0;
+      StrFunc::readBinary(IX,fileKey);
+      if (fileKey!=Key)
+	return 0;
+      StrFunc::readBinary(IX,fileHash);
+      StrFunc::readBinary(IX,Block);
+      MD5hash sum;
+      if (sum.processMessage(Block)!=fileHash)
+	return 0;
+
+      std::istringstream cx(Block,std::ios::binary);
+      varList VSnap;
+      VSnap.readBinary(cx);
+      VList.swap(VSnap);
+    }
+  catch (ColErr::ExBase&)
+    {
+      return 0;
+    }
+  catch (std::exception&)
+    {
+      return 0;
+    }
+  return 1;
+}
+
 std::string
 FuncDataBase::variableHash() const
   /*!
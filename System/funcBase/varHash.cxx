@@ -0,0 +1,83 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   funcBase/varHash.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "varHash.h"
+
+void
+varHash::clear()
+  /*!
+    Remove all the names
+  */
+{
+  HMap.clear();
+  return;
+}
+
+void
+varHash::reserve(const size_t N)
+  /*!
+    Reserve space for a number of names
+    \param N :: Number of names expected
+  */
+{
+  HMap.reserve(N);
+  return;
+}
+
+void
+varHash::insert(const std::string& Name,FItem* FPtr)
+  /*!
+    Add/replace a name
+    \param Name :: Variable name
+    \param FPtr :: Item 
+  */
+{
+  HMap[Name]=FPtr;
+  return;
+}
+
+void
+varHash::erase(const std::string& Name)
+  /*!
+    Remove a name 
+    \param Name :: Variable name
+  */
+{
+  HMap.erase(Name);
+  return;
+}
+
+FItem*
+varHash::find(const std::string& Name) const
+  /*!
+    Find the item of a name
+    \param Name :: Variable name
+    \return FItem pointer / 0 if not found
+  */
+{
+  std::unordered_map<std::string,FItem*>::const_iterator mc=
+    HMap.find(Name);
+  return (mc==HMap.end()) ? 0 : mc->second;
+}
@@ -3,7 +3,7 @@
  
  * File:   funcBase/varList.cxx
  *
- * Copyright (c) 2004-2016 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -27,9 +27,11 @@
 #include <cmath>
 #include <vector>
 #include <list>
+#include <set>
 #include <map>
 #include <algorithm>
 #include <functional>
+#include <unordered_map>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -37,34 +39,41 @@
 #include "NameStack.h"
 #include "RegMethod.h"
 #include "OutputLog.h"
+#include "support.h"
+#include "fileSupport.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
 #include "Code.h"
 #include "FItem.h"
+#include "varHash.h"
 #include "varList.h"
 
 varList::varList() :
-  varNum(0)
+  varNum(0),VHPtr(new varHash)
   /*!
     Default constructor
   */
 {}
 
 varList::varList(const varList& A) :
-  varNum(A.varNum)
+  varNum(A.varNum),VHPtr(new varHash)
   /*!
     Standard Copy constructor.
-    Makes a memory copy of the FItem*
+    Makes a memory copy of the FItem*. The function
+    cache is not copied.
     \param A :: varList to copy
   */
 {
+  varItem.resize(A.varItem.size(),0);
   std::map<std::string,FItem*>::const_iterator vc;
   for(vc=A.varName.begin();vc!=A.varName.end();vc++)
     {
       FItem* Ptr=vc->second->clone();
+      Ptr->setVList(this);
       varName.insert(std::pair<std::string,FItem*>(vc->first,Ptr));
-      varItem.insert(std::pair<int,FItem*>(Ptr->getIndex(),Ptr));
+      setSlot(Ptr->getIndex(),Ptr);
+      VHPtr->insert(vc->first,Ptr);
     }
   return;
 }
@@ -82,17 +91,46 @@ varList::operator=(const varList& A)
     {
       varNum=A.varNum;
       deleteMem();
+      varItem.resize(A.varItem.size(),0);
       std::map<std::string,FItem*>::const_iterator vc;
       for(vc=A.varName.begin();vc!=A.varName.end();vc++)
         {
 	  FItem* Ptr=vc->second->clone();
+	  Ptr->setVList(this);
 	  varName.insert(std::pair<std::string,FItem*>(vc->first,Ptr));
-	  varItem.insert(std::pair<int,FItem*>(Ptr->getIndex(),Ptr));
+	  setSlot(Ptr->getIndex(),Ptr);
+	  VHPtr->insert(vc->first,Ptr);
 	}
     }
   return *this;
 }
 
+void
+varList::swap(varList& A)
+  /*!
+    Exchange the variables with another varList
+    without copying the FItems
+    \param A :: varList to swap with
+  */
+{
+  if (this!=&A)
+    {
+      std::swap(varNum,A.varNum);
+      std::swap(VHPtr,A.VHPtr);
+      varName.swap(A.varName);
+      varItem.swap(A.varItem);
+      cacheDbl.swap(A.cacheDbl);
+      cacheVec.swap(A.cacheVec);
+      evalStack.swap(A.evalStack);
+      depMap.swap(A.depMap);
+      for(FItem* Ptr : varItem)
+	if (Ptr) Ptr->setVList(this);
+      for(FItem* Ptr : A.varItem)
+	if (Ptr) Ptr->setVList(&A);
+    }
+  return;
+}
+
 varList::~varList() 
   /*!
     Deletion operator removes
@@ -100,6 +138,7 @@ varList::~varList()
   */
 {
   deleteMem();
+  delete VHPtr;
 }
 
 void
@@ -120,11 +159,116 @@ varList::deleteMem()
     Erase and clear the list of variables
   */
 {
-  std::map<int,FItem*>::iterator vc;
-  for(vc=varItem.begin();vc!=varItem.end();vc++)
-    delete vc->second;
-  varItem.erase(varItem.begin(),varItem.end());
+  for(FItem* Ptr : varItem)
+    delete Ptr;
+  varItem.clear();
   varName.erase(varName.begin(),varName.end());
+  VHPtr->clear();
+  clearCache();
+  return;
+}
+
+void
+varList::setSlot(const int Key,FItem* Ptr)
+  /*!
+    Set the direct slot of a variable number
+    \param Key :: Variable number
+    \param Ptr :: FItem to store [0 to remove]
+  */
+{
+  const size_t index(static_cast<size_t>(Key));
+  if (index>=varItem.size())
+    varItem.resize(index+1,0);
+  varItem[index]=Ptr;
+  return;
+}
+
+void
+varList::clearCache()
+  /*!
+    Remove all cached function values and dependencies
+  */
+{
+  cacheDbl.clear();
+  cacheVec.clear();
+  depMap.clear();
+  return;
+}
+
+void
+varList::invalidate(const int Key)
+  /*!
+    Remove the cached value of a variable and of all
+    the functions that [recursively] depend on it.
+    \param Key :: Index of variable that has changed
+  */
+{
+  cacheDbl.erase(Key);
+  cacheVec.erase(Key);
+
+  std::map<int,std::set<int>>::iterator mc=depMap.find(Key);
+  if (mc!=depMap.end())
+    {
+      // erase before recursion so a cycle terminates
+      const std::set<int> depItems(mc->second);
+      depMap.erase(mc);
+      for(const int D : depItems)
+	invalidate(D);
+    }
+  return;
+}
+
+int
+varList::getCache(const int Key,double& V) const
+  /*!
+    Get a cached function value
+    \param Key :: Index of function variable
+    \param V :: Value [if cached]
+    \return 1 if cached / 0 otherwise
+  */
+{
+  std::map<int,double>::const_iterator mc=cacheDbl.find(Key);
+  if (mc==cacheDbl.end()) return 0;
+  V=mc->second;
+  return 1;
+}
+
+int
+varList::getCache(const int Key,Geometry::Vec3D& V) const
+  /*!
+    Get a cached function value
+    \param Key :: Index of function variable
+    \param V :: Value [if cached]
+    \return 1 if cached / 0 otherwise
+  */
+{
+  std::map<int,Geometry::Vec3D>::const_iterator mc=cacheVec.find(Key);
+  if (mc==cacheVec.end()) return 0;
+  V=mc->second;
+  return 1;
+}
+
+void
+varList::setCache(const int Key,const double& V)
+  /*!
+    Store an evaluated function value
+    \param Key :: Index of function variable
+    \param V :: Value 
+  */
+{
+  cacheDbl[Key]=V;
+  return;
+}
+
+void
+varList::setCache(const int Key,const Geometry::Vec3D& V)
+  /*!
+    Store an evaluated function value
+    \param Key :: Index of function variable
+    \param V :: Value 
+  */
+{
+  cacheVec[Key]=V;
   return;
 }
 
@@ -137,12 +281,7 @@ varList::findVar(const std::string& Key) const
     \retval FItem pointer
   */
 {
-  std::map<std::string,FItem*>::const_iterator vc;
-  vc=varName.find(Key);
-  if (vc!=varName.end())
-    return vc->second;
-
-  return 0;
+  return VHPtr->find(Key);
 }
 
 const FItem*
@@ -155,11 +294,8 @@ varList::findVar(const int Key) const
     \retval FuncDefinition if item exists
   */
 {
-  std::map<int,FItem*>::const_iterator vc;
-  vc=varItem.find(Key);
-  if (vc!=varItem.end())
-    return vc->second;
-  return 0;
+  return (Key>=0 && static_cast<size_t>(Key)<varItem.size()) ?
+    varItem[static_cast<size_t>(Key)] : 0;
 }
 
 FItem*
@@ -172,11 +308,8 @@ varList::findVar(const int Key)
     \retval FuncDefinition if item exists
   */
 {
-  std::map<int,FItem*>::iterator vc;
-  vc=varItem.find(Key);
-  if (vc!=varItem.end())
-    return vc->second;
-  return 0;
+  return (Key>=0 && static_cast<size_t>(Key)<varItem.size()) ?
+    varItem[static_cast<size_t>(Key)] : 0;
 }
 
 FItem* 
@@ -188,12 +321,7 @@ varList::findVar(const std::string& Key)
     \retval FItem pointer
   */
 {
-  std::map<std::string,FItem*>::iterator vc;
-  vc=varName.find(Key);
-  if (vc!=varName.end())
-    return vc->second;
-
-  return 0;
+  return VHPtr->find(Key);
 }
 
 
@@ -221,18 +349,18 @@ varList::copyVar(const std::string& newKey,const std::string& oldKey)
     {
       const int I=ac->second->getIndex();
       delete ac->second;
-
-      std::map<int,FItem*>::iterator ic;
-      ic=varItem.find(I);
+      invalidate(I);
       varName.erase(ac);
-      varItem.erase(ic);
+      setSlot(I,0);
     }
   FItem* Ptr=bc->second->clone();
+  Ptr->setVList(this);
   Ptr->setIndex(varNum);
   varNum++;
     // Now insert into master lists
   varName.insert(std::pair<std::string,FItem*>(newKey,Ptr));
-  varItem.insert(std::pair<int,FItem*>(Ptr->getIndex(),Ptr));
+  setSlot(Ptr->getIndex(),Ptr);
+  VHPtr->insert(newKey,Ptr);
 
   return;
 }
@@ -286,9 +414,10 @@ varList::copyVarSet(const std::string& oldHead,const std::string& newHead)
 
 int 
 varList::selectValue(const int Key,Geometry::Vec3D& oVec,
-		     double& oDbl) const
+		     double& oDbl)
   /*!
-    Simple selector
+    Simple selector. If called within a function evaluation
+    the function is registered as a dependent of Key.
     \param Key :: Variable name
     \param oVec :: output vector
     \param oDbl :: output value [ selected]
@@ -299,6 +428,9 @@ varList::selectValue(const int Key,Geometry::Vec3D& oVec,
 {
   const FItem* FPtr=findVar(Key);
   if (!FPtr) return -1;
+
+  if (!evalStack.empty())
+    depMap[Key].insert(evalStack.back());
   
   if (FPtr->getValue(oVec))
     return 1;
@@ -351,7 +483,10 @@ varList::setValue(const int Key,const T& Value)
 {
   FItem* FPtr=findVar(Key);
   if (FPtr)
-    FPtr->setValue(Value);
+    {
+      FPtr->setValue(Value);
+      invalidate(Key);
+    }
   return;
 }
 
@@ -369,13 +504,14 @@ varList::removeVar(const std::string& Name)
   if (mc==varName.end())
     throw ColErr::InContainerError<std::string>(Name,"Name");
 
-  std::map<int,FItem*>::iterator ic=varItem.find(mc->second->getIndex());
-  if (ic==varItem.end())
-    throw ColErr::InContainerError<int>(mc->second->getIndex(),
-                                        "NAME [INT] "+Name);
+  const int index=mc->second->getIndex();
+  if (!findVar(index))
+    throw ColErr::InContainerError<int>(index,"NAME [INT] "+Name);
 
+  invalidate(index);
   delete mc->second;
-  varItem.erase(ic);
+  setSlot(index,0);
+  VHPtr->erase(Name);
   varName.erase(mc);
   return;
 }
@@ -403,10 +539,8 @@ varList::addVar(const std::string& Name,const T& Value)
       const int I=vc->second->getIndex();
 
       delete vc->second;
-      std::map<int,FItem*>::iterator ac;
-      ac=varItem.find(I);
+      invalidate(I);
       varName.erase(vc);
-      varItem.erase(ac);
       Ptr=createFType<T>(I,Value);
     }
   else
@@ -417,7 +551,8 @@ varList::addVar(const std::string& Name,const T& Value)
     }
   // Now insert into master lists
   varName.insert(std::pair<std::string,FItem*>(Name,Ptr));
-  varItem.insert(std::pair<int,FItem*>(Ptr->getIndex(),Ptr));
+  setSlot(Ptr->getIndex(),Ptr);
+  VHPtr->insert(Name,Ptr);
   return;
 }
 
@@ -438,6 +573,7 @@ varList::setVar(const std::string& Name,const T& Value)
   try
     {
       vc->second->setValue(Value);
+      invalidate(vc->second->getIndex());
     }
   catch (ColErr::ExBase&)
     {
@@ -530,6 +666,122 @@ varList::writeAll(std::ostream& OX) const
   return;
 }
 
+void
+varList::writeBinary(std::ostream& OX) const
+  /*!
+    Write out all the variables in binary form [snapshot].
+    Each item is name, index, type key and value/code.
+    \param OX :: Output stream [binary]
+  */
+{
+  StrFunc::writeBinary(OX,varNum);
+  StrFunc::writeBinary(OX,varName.size());
+  for(const varStore::value_type& mc : varName)
+    {
+      StrFunc::writeBinary(OX,mc.first);
+      StrFunc::writeBinary(OX,mc.second->getIndex());
+      mc.second->writeBinary(OX);
+    }
+  return;
+}
+
+void
+varList::readBinary(std::istream& IX)
+  /*!
+    Read all the variables in binary form [snapshot].
+    Replaces all the current variables.
+    \param IX :: Input stream [binary]
+  */
+{
+  ELog::RegMethod RegA("varList","readBinary");
+
+  deleteMem();
+  size_t N;
+  StrFunc::readBinary(IX,varNum);
+  StrFunc::readBinary(IX,N);
+  // smallest item : name size + index + type key
+  const size_t minItem(sizeof(size_t)+sizeof(int)+sizeof(char));
+  if (varNum<0 || N>StrFunc::remainBinary(IX)/minItem)
+    throw ColErr::FileError(0,"stream","varList : size exceeds stream");
+  VHPtr->reserve(N);
+
+  std::string Name;
+  int index;
+  char typeKey;
+  for(size_t i=0;i<N;i++)
+    {
+      StrFunc::readBinary(IX,Name);
+      StrFunc::readBinary(IX,index);
+      StrFunc::readBinary(IX,typeKey);
+      if (index<0 || index>=varNum)
+	throw ColErr::IndexError<int>(index,varNum,"varList index : "+Name);
+      FItem* Ptr(0);
+      switch (typeKey)
+	{
+	case 'd':
+	  {
+	    double V;
+	    StrFunc::readBinary(IX,V);
+	    Ptr=createFType<double>(index,V);
+	    break;
+	  }
+	case 'i':
+	  {
+	    int V;
+	    StrFunc::readBinary(IX,V);
+	    Ptr=createFType<int>(index,V);
+	    break;
+	  }
+	case 'l':
+	  {
+	    long int V;
+	    StrFunc::readBinary(IX,V);
+	    Ptr=createFType<long int>(index,V);
+	    break;
+	  }
+	case 's':
+	  {
+	    size_t V;
+	    StrFunc::readBinary(IX,V);
+	    Ptr=createFType<size_t>(index,V);
+	    break;
+	  }
+	case 'S':
+	  {
+	    std::string V;
+	    StrFunc::readBinary(IX,V);
+	    Ptr=createFType<std::string>(index,V);
+	    break;
+	  }
+	case 'V':
+	  {
+	    double V[3];
+	    StrFunc::readBinary(IX,V[0]);
+	    StrFunc::readBinary(IX,V[1]);
+	    StrFunc::readBinary(IX,V[2]);
+	    Ptr=createFType<Geometry::Vec3D>
+	      (index,Geometry::Vec3D(V[0],V[1],V[2]));
+	    break;
+	  }
+	case 'C':
+	  {
+	    Code V;
+	    V.readBinary(IX);
+	    Ptr=createFType<Code>(index,V);
+	    break;
+	  }
+	default:
+	  throw ColErr::InContainerError<std::string>
+	    (Name,"Unknown binary type key");
+	}
+      // written in name order : insert at the end
+      varName.emplace_hint(varName.end(),Name,Ptr);
+      setSlot(index,Ptr);
+      VHPtr->insert(Name,Ptr);
+    }
+  return;
+}
+
 
 ///\cond TEMPLATE
 
@@ -0,0 +1,237 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   funcBase/varScope.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Code.h"
+#include "FItem.h"
+#include "varList.h"
+#include "FuncDataBase.h"
+#include "varScope.h"
+
+varScope::varScope(const FuncDataBase& C,const std::string& Head) :
+  Control(C),headLen(Head.size()),Key(Head)
+  /*!
+    Constructor 
+    \param C :: Variable data base
+    \param Head :: Head of keys [keyName]
+  */
+{}
+
+varScope::varScope(const varScope& A) :
+  Control(A.Control),headLen(A.headLen),Key(A.Key)
+  /*!
+    Copy constructor 
+    \param A :: varScope to copy
+  */
+{}
+
+const FItem*
+varScope::findItem(const std::string& Tail)
+  /*!
+    Set the work key to head+Tail and find the item
+    \param Tail :: Tail of key
+    \return FItem / 0 if not found
+  */
+{
+  Key.resize(headLen);
+  Key+=Tail;
+  return Control.findItem(Key);
+}
+
+const FItem*
+varScope::findItem(const size_t Index,const std::string& Tail)
+  /*!
+    Set the work key to head+Index+Tail and find the item
+    \param Index :: Index number after head
+    \param Tail :: Tail of key
+    \return FItem / 0 if not found
+  */
+{
+  Key.resize(headLen);
+  Key+=std::to_string(Index);
+  Key+=Tail;
+  return Control.findItem(Key);
+}
+
+int
+varScope::hasVariable(const std::string& Tail)
+  /*!
+    Determine if head+Tail exists
+    \param Tail :: Tail of key
+    \return 1 if variable exists
+  */
+{
+  return (findItem(Tail)) ? 1 : 0;
+}
+
+int
+varScope::hasVariable(const size_t Index,const std::string& Tail)
+  /*!
+    Determine if head+Index+Tail exists
+    \param Index :: Index number after head
+    \param Tail :: Tail of key
+    \return 1 if variable exists
+  */
+{
+  return (findItem(Index,Tail)) ? 1 : 0;
+}
+
+template<typename T>
+T
+varScope::EvalVar(const std::string& Tail)
+  /*!
+    Finds the value of head+Tail
+    \param Tail :: Tail of key
+    \return Value of variable 
+    \throw InContainerError if no variable exists
+  */
+{
+  const FItem* FI=findItem(Tail);
+  if (!FI)
+    throw ColErr::InContainerError<std::string>
+      (Key,"varScope::EvalVar variable not found");
+
+  T Out;
+  FI->getValue(Out);
+  return Out;
+}
+
+template<typename T>
+T
+varScope::EvalVar(const size_t Index,const std::string& Tail)
+  /*!
+    Finds the value of head+Index+Tail
+    \param Index :: Index number after head
+    \param Tail :: Tail of key
+    \return Value of variable 
+    \throw InContainerError if no variable exists
+  */
+{
+  const FItem* FI=findItem(Index,Tail);
+  if (!FI)
+    throw ColErr::InContainerError<std::string>
+      (Key,"varScope::EvalVar variable not found");
+
+  T Out;
+  FI->getValue(Out);
+  return Out;
+}
+
+template<typename T>
+T
+varScope::EvalDefVar(const std::string& Tail,const T& defVal)
+  /*!
+    Finds the value of head+Tail
+    \param Tail :: Tail of key
+    \param defVal :: default value
+    \return Value of variable / defVal
+  */
+{
+  const FItem* FI=findItem(Tail);
+  if (!FI)
+    return defVal;
+
+  T Out;
+  FI->getValue(Out);
+  return Out;
+}
+
+template<typename T>
+T
+varScope::EvalDefVar(const size_t Index,const std::string& Tail,
+		     const T& defVal)
+  /*!
+    Finds the value of head+Index+Tail
+    \param Index :: Index number after head
+    \param Tail :: Tail of key
+    \param defVal :: default value
+    \return Value of variable / defVal
+  */
+{
+  const FItem* FI=findItem(Index,Tail);
+  if (!FI)
+    return defVal;
+
+  T Out;
+  FI->getValue(Out);
+  return Out;
+}
+
+///\cond TEMPLATE
+
+template double varScope::EvalVar(const std::string&);
+template int varScope::EvalVar(const std::string&);
+template long int varScope::EvalVar(const std::string&);
+template size_t varScope::EvalVar(const std::string&);
+template std::string varScope::EvalVar(const std::string&);
+template Geometry::Vec3D varScope::EvalVar(const std::string&);
+
+template double varScope::EvalVar(const size_t,const std::string&);
+template int varScope::EvalVar(const size_t,const std::string&);
+template long int varScope::EvalVar(const size_t,const std::string&);
+template size_t varScope::EvalVar(const size_t,const std::string&);
+template std::string varScope::EvalVar(const size_t,const std::string&);
+template Geometry::Vec3D varScope::EvalVar(const size_t,const std::string&);
+
+template double
+varScope::EvalDefVar(const std::string&,const double&);
+template int
+varScope::EvalDefVar(const std::string&,const int&);
+template long int
+varScope::EvalDefVar(const std::string&,const long int&);
+template size_t
+varScope::EvalDefVar(const std::string&,const size_t&);
+template std::string
+varScope::EvalDefVar(const std::string&,const std::string&);
+template Geometry::Vec3D
+varScope::EvalDefVar(const std::string&,const Geometry::Vec3D&);
+
+template double
+varScope::EvalDefVar(const size_t,const std::string&,const double&);
+template int
+varScope::EvalDefVar(const size_t,const std::string&,const int&);
+template long int
+varScope::EvalDefVar(const size_t,const std::string&,const long int&);
+template size_t
+varScope::EvalDefVar(const size_t,const std::string&,const size_t&);
+template std::string
+varScope::EvalDefVar(const size_t,const std::string&,const std::string&);
+template Geometry::Vec3D
+varScope::EvalDefVar(const size_t,const std::string&,const Geometry::Vec3D&);
+
+///\endcond TEMPLATE
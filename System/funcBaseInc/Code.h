@@ -60,13 +60,20 @@ class varList;
   \date April 2006
   \version 1.0
 
+  After compilation constant sub-expressions are folded
+  into single immediates. Code that has only scalar
+  operations is evaluated by a double-only stack, falling
+  back to the general evaluation if a variable is a Vec3D.
 */
 
 class Code
 {
  private:
+
+  static const size_t maxScalarStack=32;  ///< Max stack for scalar eval
   
   int valid;                           ///< Good code build
+  int scalarFlag;                      ///< Only scalar operations
   size_t StackPtr;                     ///< Current point in an evaluation
   size_t StackSize;                    ///< Stack size [max]
 
@@ -80,6 +87,11 @@ class Code
   template<typename T>
     static T zeroType();
 
+  static int stackArgs(const int);
+  static int scalarOp(const int,double*,size_t&);
+  void setScalarFlag();
+  int evalScalar(varList*,double&) const;
+
  public:
 
   Code();
@@ -88,7 +100,12 @@ class Code
   ~Code();
 
   template<typename T>
-  T Eval(varList*);
+  T Eval(varList*) const;
+
+  int hasAssign() const;
+  /// Only scalar operations [fast evaluation]
+  int isScalar() const { return scalarFlag; }
+  void optimise();
 
   void clear();
   int popByte();
@@ -116,6 +133,8 @@ class Code
   void minusImmed() { Immed.back()*=-1.0; }
   
   void writeCompact(std::ostream&) const;
+  void writeBinary(std::ostream&) const;
+  void readBinary(std::istream&);
   void printByteCode(std::ostream&) const;
 
 };
@@ -79,6 +79,7 @@ class FItem
   
   virtual std::string typeKey() const =0;
   virtual void write(std::ostream&) const=0;  
+  virtual void writeBinary(std::ostream&) const=0;  
   ///\endcond ABSTRACT
 };
 
@@ -94,6 +95,7 @@ class FValue : public FItem
 {
  private:
 
+  static const char binKey;   ///< Type key in binary snapshot
   T Value;             ///< Value of an item (fixed)
 
  public:
@@ -122,6 +124,7 @@ class FValue : public FItem
 
   virtual std::string typeKey() const;
   void write(std::ostream&) const;  
+  void writeBinary(std::ostream&) const;  
 };
 
 
@@ -132,15 +135,20 @@ class FValue : public FItem
   \date April 2006
   \version 1.0
   Holds just the code item of the parser (the only bit that
-  is really needed)
+  is really needed). The evaluated value is cached 
+  in the varList.
 */
 
 class FFunc : public FItem
 {
  private:
 
+  int cacheFlag;    ///< Value can be cached [no assignment]
   Code BaseUnit;    ///< Code unit of a compile Function
 
+  double evalDouble() const;
+  Geometry::Vec3D evalVec() const;
+
  public:
 
   FFunc(varList*,const int,const Code&);
@@ -160,6 +168,7 @@ class FFunc : public FItem
 
   virtual std::string typeKey() const;
   void write(std::ostream&) const;
+  void writeBinary(std::ostream&) const;
 
 };
 
@@ -41,6 +41,8 @@ class FuncDataBase
 {
  private:
 
+  static const char snapTag[8];  ///< Binary snapshot tag
+  
   varList VList;           ///< Variable list
   Code Build;              ///< Current total-bytecode
 
@@ -74,6 +76,8 @@ class FuncDataBase
   
   /// Access varList
   const varList& getVarList() const { return VList; }
+  /// Access last compiled code
+  const Code& getBuild() const { return Build; }
   
   //  int hasItem(const std::string&) const;
   const FItem* findItem(const std::string&) const;
@@ -126,6 +130,8 @@ class FuncDataBase
   int hasVariable(const std::string&) const;
 
   void writeAll(const std::string&) const; 
+  void writeBinary(const std::string&,const std::string&) const;
+  int readBinary(const std::string&,const std::string&);
   void processXML(const std::string&);
   void writeXML(const std::string&) const;
   /// Debug print function
@@ -0,0 +1,62 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   funcBaseInc/varHash.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef varHash_h
+#define varHash_h
+
+class FItem;
+
+/*!
+  \class varHash
+  \version 1.0
+  \author S. Ansell
+  \date October 2017
+  \brief Hash index of the variable names in a varList
+
+  Gives the FItem of a name without the string 
+  compares of the ordered name map. The item index is the
+  stable integer id of the name. The varList keeps this in step
+  with its ordered map, which is still used for sorted output
+  and for prefix [copyVarSet] searches.
+*/
+
+class varHash
+{
+ private:
+
+  std::unordered_map<std::string,FItem*> HMap;   ///< Name : Item
+
+ public:
+
+  varHash() {}               ///< Constructor
+  ~varHash() {}              ///< Destructor
+
+  void clear();
+  void reserve(const size_t);
+  void insert(const std::string&,FItem*);
+  void erase(const std::string&);
+  FItem* find(const std::string&) const;
+
+  /// Number of names
+  size_t size() const { return HMap.size(); }
+};
+
+#endif
@@ -3,7 +3,7 @@
  
  * File:   funcBaseInc/varList.h
  *
- * Copyright (c) 2004-2016 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -31,9 +31,19 @@
 
   This class holds the variable name + number 
   relative to the actual variable type object. 
+  Name lookups use a hash index [varHash], the
+  ordered map is kept for sorted/prefix access.
+  Variable numbers [as used in the Code bytecode]
+  index a direct slot vector.
+
+  Function (Code) variables have their evaluated value
+  cached. Each variable read during a function evaluation
+  records that function as a dependent, so that changing
+  a variable only invalidates the functions that read it.
 */
 
 class FItem;
+class varHash;
 
 class varList
 {
@@ -46,9 +56,18 @@ class varList
   int varNum;                              ///< Current max var
 
   varStore varName;    ///< Var by name
-  std::map<int,FItem*> varItem;            ///< Var by number
+  varHash* VHPtr;      ///< Hashed var by name
+  std::vector<FItem*> varItem;  ///< Var by number [direct slot]
+
+  std::map<int,double> cacheDbl;            ///< Cached function [double]
+  std::map<int,Geometry::Vec3D> cacheVec;   ///< Cached function [Vec3D]
+  std::vector<int> evalStack;               ///< Functions being evaluated
+  /// Var index : function indexes that read it
+  std::map<int,std::set<int>> depMap;
 
   void deleteMem();
+  void setSlot(const int,FItem*);
+  void clearCache();
 
  public:
 
@@ -57,6 +76,8 @@ class varList
   varList& operator=(const varList&);
   ~varList();
 
+  void swap(varList&);
+
   const FItem* findVar(const std::string&) const;
   const FItem* findVar(const int) const;
   FItem* findVar(const std::string&);
@@ -65,7 +86,17 @@ class varList
   void copyVar(const std::string&,const std::string&);
   void copyVarSet(const std::string&,const std::string&);
   
-  int selectValue(const int,Geometry::Vec3D&,double&) const;
+  int selectValue(const int,Geometry::Vec3D&,double&);
+
+  int getCache(const int,double&) const;
+  int getCache(const int,Geometry::Vec3D&) const;
+  void setCache(const int,const double&);
+  void setCache(const int,const Geometry::Vec3D&);
+  /// Start the evaluation of a function
+  void pushEval(const int I) { evalStack.push_back(I); }
+  /// End the evaluation of a function
+  void popEval() { evalStack.pop_back(); }
+  void invalidate(const int);
 
   template<typename T>
   T getValue(const int) const;
@@ -92,6 +123,8 @@ class varList
   std::vector<std::string> getKeys() const;
   void writeActive(std::ostream&) const;
   void writeAll(std::ostream&) const;
+  void writeBinary(std::ostream&) const;
+  void readBinary(std::istream&);
 
 };
 
@@ -0,0 +1,73 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   funcBaseInc/varScope.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef varScope_h
+#define varScope_h
+
+class FuncDataBase;
+class FItem;
+
+/*!
+  \class varScope
+  \version 1.0
+  \author S. Ansell
+  \date October 2017
+  \brief Access to variables that share a key head
+
+  Holds a work key of the head [normally the keyName] and
+  appends the tail [and an optional index] for each look up. 
+  This avoids building a new string for each variable. 
+*/
+
+class varScope
+{
+ private:
+
+  const FuncDataBase& Control;    ///< Variable data base
+  const size_t headLen;           ///< Length of head
+  std::string Key;                ///< Work key [head+index+tail]
+
+  const FItem* findItem(const std::string&);
+  const FItem* findItem(const size_t,const std::string&);
+
+ public:
+
+  varScope(const FuncDataBase&,const std::string&);
+  varScope(const varScope&);
+  ~varScope() {}             ///< Destructor
+
+  /// Access head
+  std::string getHead() const { return Key.substr(0,headLen); }
+  
+  int hasVariable(const std::string&);
+  int hasVariable(const size_t,const std::string&);
+
+  template<typename T>
+  T EvalVar(const std::string&);
+  template<typename T>
+  T EvalVar(const size_t,const std::string&);
+  template<typename T>
+  T EvalDefVar(const std::string&,const T&);
+  template<typename T>
+  T EvalDefVar(const size_t,const std::string&,const T&);
+};
+
+#endif
@@ -89,6 +89,8 @@ class Cylinder : public Quadratic
   const Geometry::Vec3D& getNormal() const { return Normal; }  
 
   double getRadius() const { return Radius; }  ///< Get Radius      
+  /// Get axis alignment [1-3 : x,y,z / 0 : general]
+  int getNvec() const { return Nvec; }
   void setBaseEqn();
 
   void mirror(const Geometry::Plane&);
@@ -89,12 +89,17 @@ class Mesh3D
 	       const std::vector<double>&,const std::vector<size_t>&,
 	       const std::vector<double>&,const std::vector<size_t>&);
   std::vector<Geometry::Vec3D> midPoints() const;
+  Mesh3D refine(const std::vector<size_t>&,const std::vector<size_t>&,
+		const std::vector<size_t>&) const;
   /// Set reference point 
   void setRefPt(const Geometry::Vec3D&);  
   
   void write(std::ostream&) const;
   void writeWWINP(std::ostream&,const int,const size_t) const;
 
+  void writeBinary(std::ostream&) const;
+  void readBinary(std::istream&);
+
 };
 
 }  
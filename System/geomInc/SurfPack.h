@@ -0,0 +1,117 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   geomInc/SurfPack.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef Geometry_SurfPack_h
+#define Geometry_SurfPack_h
+
+namespace Geometry
+{
+  class Surface;
+
+/*!
+  \class SurfPack
+  \version 1.0
+  \author S. Ansell
+  \date October 2017
+  \brief Packed structure-of-arrays copy of a set of surfaces
+
+  Surfaces are split by form (plane / sphere / axis cylinder /
+  general quadratic) and their coefficients held in contiguous
+  arrays so that side() of one point against many surfaces, or
+  many points against one surface, is a branch-free loop that the
+  compiler can vectorise. Other surfaces use their virtual side().
+  The results are identical to Surface::side. The pack holds copies
+  of the coefficients so update() must be called if surfaces move.
+*/
+
+class SurfPack
+{
+ private:
+
+  /// Form of each surface
+  enum class SForm { plane=0, sphere=1, cylinder=2, quadratic=3, other=4 };
+
+  std::map<const Surface*,size_t> slotMap;   ///< Surface : slot
+  std::vector<const Surface*> SList;         ///< Surface by slot
+  std::vector<SForm> form;                   ///< Form by slot
+  std::vector<size_t> formIndex;             ///< Index in form arrays
+
+  std::vector<size_t> PSlot;           ///< Plane slots
+  std::vector<double> PX;              ///< Plane normal [x]
+  std::vector<double> PY;              ///< Plane normal [y]
+  std::vector<double> PZ;              ///< Plane normal [z]
+  std::vector<double> PD;              ///< Plane distance
+
+  std::vector<size_t> SSlot;           ///< Sphere slots
+  std::vector<double> SX;              ///< Sphere centre [x]
+  std::vector<double> SY;              ///< Sphere centre [y]
+  std::vector<double> SZ;              ///< Sphere centre [z]
+  std::vector<double> SR2;             ///< Sphere radius^2
+
+  std::vector<size_t> CSlot;           ///< Axis cylinder slots
+  std::vector<double> CX;              ///< Cylinder centre [x]
+  std::vector<double> CY;              ///< Cylinder centre [y]
+  std::vector<double> CZ;              ///< Cylinder centre [z]
+  std::vector<double> CWX;             ///< Use x component [0/1]
+  std::vector<double> CWY;             ///< Use y component [0/1]
+  std::vector<double> CWZ;             ///< Use z component [0/1]
+  std::vector<double> CR2;             ///< Cylinder radius^2
+
+  std::vector<size_t> QSlot;           ///< General quadratic slots
+  std::vector<double> QEqn[10];        ///< Quadratic base equations
+
+  std::vector<size_t> OSlot;           ///< Other surface slots
+
+  void setCoefficients(const size_t);
+
+  void slotSide(const size_t,const size_t,const double*,
+		const double*,const double*,int*) const;
+
+ public:
+
+  SurfPack();
+  SurfPack(const SurfPack&);
+  SurfPack& operator=(const SurfPack&);
+  ~SurfPack() {}    ///< Destructor
+
+  void clear();
+  size_t addSurface(const Surface*);
+  void addSurfaces(const std::map<int,Surface*>&);
+  void update();
+
+  /// Number of surfaces
+  size_t size() const { return SList.size(); }
+  /// Surface at slot
+  const Surface* getSurf(const size_t I) const { return SList[I]; }
+  int hasSurface(const Surface*) const;
+  size_t getSlot(const Surface*) const;
+
+  void side(const Geometry::Vec3D&,std::vector<int>&) const;
+  void side(const size_t,const std::vector<Geometry::Vec3D>&,
+	    std::vector<int>&) const;
+  void sideMatrix(const std::vector<Geometry::Vec3D>&,
+		  std::vector<int>&) const;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   geomInc/surfHash.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef ModelSupport_surfHash_h
+#define ModelSupport_surfHash_h
+
+namespace Geometry
+{
+  class Surface;
+}
+
+namespace ModelSupport
+{
+
+/*!
+  \class surfHash
+  \version 1.0
+  \author S. Ansell
+  \date October 2017
+  \brief Hash index of surfaces for equal/opposite surface search
+
+  Planes, spheres, cylinders and cones are put into bins from two
+  quantities that do not change under the surface equality tolerance
+  or on reversing a plane (e.g. |D| and a weighted sum of |normal|
+  for planes). The bins are wider than the tolerances so an equal
+  surface is always in the surface bin or a neighbouring one. 
+  Entries hold the surface number and pointer and are checked 
+  against the surface map when used, so deleted / replaced 
+  surfaces are ignored. New surfaces are held as pending numbers
+  and binned at the next search, since surfaces are often set after
+  being put in the map. Other surface types are not binned.
+*/
+
+class surfHash
+{
+ public:
+
+  typedef std::map<int,Geometry::Surface*> STYPE;   ///< Surface map
+
+ private:
+
+  /// Surface number / pointer pair 
+  typedef std::pair<int,const Geometry::Surface*> ITEM;
+
+  static const double binWidth;          ///< Width of bins 
+  
+  std::unordered_multimap<size_t,ITEM> HMap;  ///< bin : surface 
+  std::vector<int> pending;                   ///< Surfaces to bin
+
+  static int surfKey(const Geometry::Surface*,long int&,long int&);
+  static size_t binKey(const int,const long int,const long int);
+
+  void processPending(const STYPE&);
+  
+ public:
+
+  surfHash();
+  surfHash(const surfHash&);
+  surfHash& operator=(const surfHash&);
+  ~surfHash() {}     ///< Destructor
+
+  void clear();
+  void addPending(const int);
+
+  bool findCandidates(const STYPE&,const Geometry::Surface*,STYPE&);
+
+  /// Number of binned items [including stale]
+  size_t size() const { return HMap.size(); }
+  /// Number of surfaces waiting to be binned
+  size_t nPending() const { return pending.size(); }
+};
+
+}
+
+#endif
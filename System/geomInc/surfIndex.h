@@ -30,6 +30,8 @@ namespace Geometry
 namespace ModelSupport
 {
 
+class surfHash;
+
 /*!
   \class surfIndex 
   \version 1.0
@@ -49,6 +51,7 @@ class surfIndex
   int uniqNum;                      ///< uniq number
   STYPE SMap;                       ///< Index of kept surfaces
   std::map<int,int> holdMap;        ///< Hold/Write map :: surfaceN : write/no-write flag
+  surfHash* SHPtr;                  ///< Hash of surfaces for equal search
   
   surfIndex();
 
@@ -86,6 +89,9 @@ class surfIndex
   void renumber(const int,const int);
 
   Geometry::Surface* getSurf(const int) const; 
+
+  bool findCandidates(const Geometry::Surface*,STYPE&);
+  void rehash();
   
   int calcRenumber(const int,std::vector<std::pair<int,int> >&) const;
   int calcRenumber(const std::vector<int>&,const std::vector<int>&,
@@ -45,6 +45,7 @@
 #include "BaseVisit.h"
 #include "BaseModVisit.h" 
 #include "support.h"
+#include "fileSupport.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
@@ -191,18 +192,16 @@ Mesh3D::getCoordinate(const std::vector<double>& Vec,
     \return positions [Origin non - offset
    */
 {
-  size_t offset(NF[0]);
+  size_t offset(0);
   size_t I(0);
-  while(Index>offset)
+  while(I+1<NF.size() && Index>offset+NF[I])
     {
       offset+=NF[I];
       I++;
     }
-  offset-=NF[I];
-         
   
   return Vec[I]+static_cast<double>(Index-offset)*
-    (Vec[I+1]-Vec[I])/NF[I];
+    (Vec[I+1]-Vec[I])/static_cast<double>(NF[I]);
 }
 
 std::vector<Geometry::Vec3D>
@@ -412,4 +411,112 @@ Mesh3D::write(std::ostream& OX) const
   return;
 }
 
+Mesh3D
+Mesh3D::refine(const std::vector<size_t>& XR,
+	       const std::vector<size_t>& YR,
+	       const std::vector<size_t>& ZR) const
+  /*!
+    Create a mesh with each bin split into a number 
+    of equal bins. The boundaries of the new mesh are the
+    bin boundaries of this mesh.
+    \param XR :: Number of parts for each x bin [NX]
+    \param YR :: Number of parts for each y bin [NY]
+    \param ZR :: Number of parts for each z bin [NZ]
+    \return refined mesh
+  */
+{
+  ELog::RegMethod RegA("Mesh3D","refine");
+
+  if (XR.size()!=NX || YR.size()!=NY || ZR.size()!=NZ)
+    throw ColErr::MisMatch<size_t>(XR.size()*YR.size()*ZR.size(),
+				   NX*NY*NZ,"Refine/Mesh size");
+  
+  Mesh3D Out(*this);
+  const std::vector<size_t>* RPtr[3]={&XR,&YR,&ZR};
+  std::vector<double>* VPtr[3]={&Out.X,&Out.Y,&Out.Z};
+  std::vector<size_t>* FPtr[3]={&Out.XFine,&Out.YFine,&Out.ZFine};
+  size_t* NPtr[3]={&Out.NX,&Out.NY,&Out.NZ};
+  for(size_t index=0;index<3;index++)
+    {
+      const size_t N(*NPtr[index]);
+      std::vector<double> BVec(N+1);
+      for(size_t i=0;i<=N;i++)
+	BVec[i]=(!index) ? getXCoordinate(i) :
+	  ((index==1) ? getYCoordinate(i) : getZCoordinate(i));
+      std::vector<size_t> FVec(*RPtr[index]);
+      for(size_t& F : FVec)
+	if (!F) F=1;
+      
+      *VPtr[index]=BVec;
+      *FPtr[index]=FVec;
+      *NPtr[index]=std::accumulate(FVec.begin(),FVec.end(),0UL);
+    }
+  return Out;
+}
+
+void
+Mesh3D::writeBinary(std::ostream& OX) const
+  /*!
+    Write the mesh in native binary form 
+    \param OX :: output stream [binary]
+  */
+{
+  ELog::RegMethod RegA("Mesh3D","writeBinary");
+
+  StrFunc::writeBinary(OX,static_cast<int>(type));
+  StrFunc::writeBinary(OX,writeFlag);
+  for(const Geometry::Vec3D* VPtr : {&RefPoint,&Origin,&Axis,&Vec})
+    for(size_t i=0;i<3;i++)
+      StrFunc::writeBinary(OX,(*VPtr)[i]);
+  
+  StrFunc::writeBinary(OX,X);
+  StrFunc::writeBinary(OX,Y);
+  StrFunc::writeBinary(OX,Z);
+  StrFunc::writeBinary(OX,XFine);
+  StrFunc::writeBinary(OX,YFine);
+  StrFunc::writeBinary(OX,ZFine);
+  return;
+}
+
+void
+Mesh3D::readBinary(std::istream& IX)
+  /*!
+    Read the mesh written by writeBinary
+    \param IX :: input stream [binary]
+  */
+{
+  ELog::RegMethod RegA("Mesh3D","readBinary");
+
+  int typeN;
+  StrFunc::readBinary(IX,typeN);
+  if (typeN<XYZ || typeN>Sph)
+    throw ColErr::RangeError<int>(typeN,XYZ,Sph,"Mesh type");
+  type=static_cast<GeomENUM>(typeN);
+  
+  StrFunc::readBinary(IX,writeFlag);
+  for(Geometry::Vec3D* VPtr : {&RefPoint,&Origin,&Axis,&Vec})
+    {
+      double V[3];
+      for(size_t i=0;i<3;i++)
+	StrFunc::readBinary(IX,V[i]);
+      *VPtr=Geometry::Vec3D(V[0],V[1],V[2]);
+    }
+
+  StrFunc::readBinary(IX,X);
+  StrFunc::readBinary(IX,Y);
+  StrFunc::readBinary(IX,Z);
+  StrFunc::readBinary(IX,XFine);
+  StrFunc::readBinary(IX,YFine);
+  StrFunc::readBinary(IX,ZFine);
+  if (X.size()!=XFine.size()+1 ||
+      Y.size()!=YFine.size()+1 ||
+      Z.size()!=ZFine.size()+1)
+    throw ColErr::FileError(0,"stream","Mesh3D : bin/boundary mismatch");
+  
+  NX=std::accumulate(XFine.begin(),XFine.end(),0UL);
+  NY=std::accumulate(YFine.begin(),YFine.end(),0UL);
+  NZ=std::accumulate(ZFine.begin(),ZFine.end(),0UL);
+  return;
+}
+
 }   // NAMESPACE Geometry
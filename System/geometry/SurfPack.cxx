@@ -0,0 +1,558 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   geometry/SurfPack.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <map>
+#include <list>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "Surface.h"
+#include "Quadratic.h"
+#include "Cylinder.h"
+#include "Ellipsoid.h"
+#include "EllipticCyl.h"
+#include "General.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include "SurfPack.h"
+
+namespace Geometry
+{
+
+SurfPack::SurfPack()
+  /*!
+    Constructor
+  */
+{}
+
+SurfPack::SurfPack(const SurfPack& A) :
+  slotMap(A.slotMap),SList(A.SList),form(A.form),
+  formIndex(A.formIndex),
+  PSlot(A.PSlot),PX(A.PX),PY(A.PY),PZ(A.PZ),PD(A.PD),
+  SSlot(A.SSlot),SX(A.SX),SY(A.SY),SZ(A.SZ),SR2(A.SR2),
+  CSlot(A.CSlot),CX(A.CX),CY(A.CY),CZ(A.CZ),
+  CWX(A.CWX),CWY(A.CWY),CWZ(A.CWZ),CR2(A.CR2),
+  QSlot(A.QSlot),OSlot(A.OSlot)
+  /*!
+    Copy constructor
+    \param A :: SurfPack to copy
+  */
+{
+  for(size_t i=0;i<10;i++)
+    QEqn[i]=A.QEqn[i];
+}
+
+SurfPack&
+SurfPack::operator=(const SurfPack& A)
+  /*!
+    Assignment operator
+    \param A :: SurfPack to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      slotMap=A.slotMap;
+      SList=A.SList;
+      form=A.form;
+      formIndex=A.formIndex;
+      PSlot=A.PSlot;
+      PX=A.PX;
+      PY=A.PY;
+      PZ=A.PZ;
+      PD=A.PD;
+      SSlot=A.SSlot;
+      SX=A.SX;
+      SY=A.SY;
+      SZ=A.SZ;
+      SR2=A.SR2;
+      CSlot=A.CSlot;
+      CX=A.CX;
+      CY=A.CY;
+      CZ=A.CZ;
+      CWX=A.CWX;
+      CWY=A.CWY;
+      CWZ=A.CWZ;
+      CR2=A.CR2;
+      QSlot=A.QSlot;
+      for(size_t i=0;i<10;i++)
+	QEqn[i]=A.QEqn[i];
+      OSlot=A.OSlot;
+    }
+  return *this;
+}
+
+void
+SurfPack::clear()
+  /*!
+    Remove all the surfaces
+  */
+{
+  slotMap.clear();
+  SList.clear();
+  form.clear();
+  formIndex.clear();
+  PSlot.clear();
+  PX.clear();
+  PY.clear();
+  PZ.clear();
+  PD.clear();
+  SSlot.clear();
+  SX.clear();
+  SY.clear();
+  SZ.clear();
+  SR2.clear();
+  CSlot.clear();
+  CX.clear();
+  CY.clear();
+  CZ.clear();
+  CWX.clear();
+  CWY.clear();
+  CWZ.clear();
+  CR2.clear();
+  QSlot.clear();
+  for(size_t i=0;i<10;i++)
+    QEqn[i].clear();
+  OSlot.clear();
+  return;
+}
+
+void
+SurfPack::setCoefficients(const size_t slot)
+  /*!
+    Copy the coefficients of the surface in slot into
+    the packed arrays
+    \param slot :: Slot index
+  */
+{
+  const size_t index=formIndex[slot];
+  switch (form[slot])
+    {
+    case SForm::plane:
+      {
+	const Plane* PPtr=dynamic_cast<const Plane*>(SList[slot]);
+	const Geometry::Vec3D& N=PPtr->getNormal();
+	PX[index]=N.X();
+	PY[index]=N.Y();
+	PZ[index]=N.Z();
+	PD[index]=PPtr->getDistance();
+	return;
+      }
+    case SForm::sphere:
+      {
+	const Sphere* SPtr=dynamic_cast<const Sphere*>(SList[slot]);
+	const Geometry::Vec3D& C=SPtr->getCentre();
+	SX[index]=C.X();
+	SY[index]=C.Y();
+	SZ[index]=C.Z();
+	SR2[index]=SPtr->getRadius()*SPtr->getRadius();
+	return;
+      }
+    case SForm::cylinder:
+      {
+	const Cylinder* CPtr=dynamic_cast<const Cylinder*>(SList[slot]);
+	const Geometry::Vec3D& C=CPtr->getCentre();
+	const int NV=CPtr->getNvec();
+	CX[index]=C.X();
+	CY[index]=C.Y();
+	CZ[index]=C.Z();
+	CWX[index]=(NV==1) ? 0.0 : 1.0;
+	CWY[index]=(NV==2) ? 0.0 : 1.0;
+	CWZ[index]=(NV==3) ? 0.0 : 1.0;
+	CR2[index]=CPtr->getRadius()*CPtr->getRadius();
+	return;
+      }
+    case SForm::quadratic:
+      {
+	const Quadratic* QPtr=dynamic_cast<const Quadratic*>(SList[slot]);
+	const std::vector<double>& BE=QPtr->copyBaseEqn();
+	for(size_t i=0;i<10;i++)
+	  QEqn[i][index]=BE[i];
+	return;
+      }
+    case SForm::other:
+      return;
+    }
+  return;
+}
+
+size_t
+SurfPack::addSurface(const Surface* SPtr)
+  /*!
+    Add a surface to the pack
+    \param SPtr :: Surface to add
+    \return slot number of the surface
+  */
+{
+  ELog::RegMethod RegA("SurfPack","addSurface");
+
+  if (!SPtr)
+    throw ColErr::EmptyValue<Geometry::Surface*>("SPtr");
+
+  std::map<const Surface*,size_t>::const_iterator mc=slotMap.find(SPtr);
+  if (mc!=slotMap.end())
+    return mc->second;
+
+  const size_t slot(SList.size());
+  slotMap.emplace(SPtr,slot);
+  SList.push_back(SPtr);
+
+  const Cylinder* CPtr=dynamic_cast<const Cylinder*>(SPtr);
+  if (dynamic_cast<const Plane*>(SPtr))
+    {
+      form.push_back(SForm::plane);
+      formIndex.push_back(PSlot.size());
+      PSlot.push_back(slot);
+      PX.push_back(0.0);
+      PY.push_back(0.0);
+      PZ.push_back(0.0);
+      PD.push_back(0.0);
+    }
+  else if (dynamic_cast<const Sphere*>(SPtr))
+    {
+      form.push_back(SForm::sphere);
+      formIndex.push_back(SSlot.size());
+      SSlot.push_back(slot);
+      SX.push_back(0.0);
+      SY.push_back(0.0);
+      SZ.push_back(0.0);
+      SR2.push_back(0.0);
+    }
+  else if (CPtr && CPtr->getNvec())
+    {
+      form.push_back(SForm::cylinder);
+      formIndex.push_back(CSlot.size());
+      CSlot.push_back(slot);
+      CX.push_back(0.0);
+      CY.push_back(0.0);
+      CZ.push_back(0.0);
+      CWX.push_back(0.0);
+      CWY.push_back(0.0);
+      CWZ.push_back(0.0);
+      CR2.push_back(0.0);
+    }
+  // Surfaces which use Quadratic::side
+  else if (CPtr || dynamic_cast<const General*>(SPtr) ||
+	   dynamic_cast<const Ellipsoid*>(SPtr) ||
+	   dynamic_cast<const EllipticCyl*>(SPtr))
+    {
+      form.push_back(SForm::quadratic);
+      formIndex.push_back(QSlot.size());
+      QSlot.push_back(slot);
+      for(size_t i=0;i<10;i++)
+	QEqn[i].push_back(0.0);
+    }
+  else
+    {
+      form.push_back(SForm::other);
+      formIndex.push_back(OSlot.size());
+      OSlot.push_back(slot);
+    }
+  setCoefficients(slot);
+  return slot;
+}
+
+void
+SurfPack::addSurfaces(const std::map<int,Surface*>& SMap)
+  /*!
+    Add all the surfaces in a map [e.g. surfIndex::surMap]
+    \param SMap :: Map of surfaces
+  */
+{
+  for(const std::map<int,Surface*>::value_type& SItem : SMap)
+    if (SItem.second)
+      addSurface(SItem.second);
+  return;
+}
+
+void
+SurfPack::update()
+  /*!
+    Re-read the coefficients of all the surfaces.
+    Required if the surfaces have been moved/rotated.
+  */
+{
+  for(size_t i=0;i<SList.size();i++)
+    setCoefficients(i);
+  return;
+}
+
+int
+SurfPack::hasSurface(const Surface* SPtr) const
+  /*!
+    Determine if the surface is in the pack
+    \param SPtr :: Surface to test
+    \return true if surface exists
+  */
+{
+  return (slotMap.find(SPtr)!=slotMap.end()) ? 1 : 0;
+}
+
+size_t
+SurfPack::getSlot(const Surface* SPtr) const
+  /*!
+    Get the slot of a surface
+    \param SPtr :: Surface to find
+    \return slot number
+  */
+{
+  ELog::RegMethod RegA("SurfPack","getSlot");
+
+  std::map<const Surface*,size_t>::const_iterator mc=slotMap.find(SPtr);
+  if (mc==slotMap.end())
+    throw ColErr::InContainerError<int>
+      ((SPtr) ? SPtr->getName() : 0,"Surface not in pack");
+  return mc->second;
+}
+
+void
+SurfPack::side(const Geometry::Vec3D& Pt,std::vector<int>& Out) const
+  /*!
+    Calculate the side of one point against all surfaces.
+    Each form is a single loop over its packed arrays.
+    \param Pt :: Point to test
+    \param Out :: Side [-1/0/1] for each slot
+  */
+{
+  Out.resize(SList.size());
+  const double x(Pt.X());
+  const double y(Pt.Y());
+  const double z(Pt.Z());
+  const double tol(Geometry::zeroTol);
+  const double cylTol(Geometry::parallelTol);
+
+  int* OPtr=Out.data();
+
+  const size_t NP(PSlot.size());
+  for(size_t i=0;i<NP;i++)
+    {
+      const double Dp=PX[i]*x+PY[i]*y+PZ[i]*z-PD[i];
+      OPtr[PSlot[i]]=(Dp>tol)-(Dp< -tol);
+    }
+
+  const size_t NS(SSlot.size());
+  for(size_t i=0;i<NS;i++)
+    {
+      const double dx=x-SX[i];
+      const double dy=y-SY[i];
+      const double dz=z-SZ[i];
+      OPtr[SSlot[i]]=2*(dx*dx+dy*dy+dz*dz>SR2[i])-1;
+    }
+
+  const size_t NC(CSlot.size());
+  for(size_t i=0;i<NC;i++)
+    {
+      const double dx=x-CX[i];
+      const double dy=y-CY[i];
+      const double dz=z-CZ[i];
+      const double displace=CWX[i]*(dx*dx)+CWY[i]*(dy*dy)+
+	CWZ[i]*(dz*dz)-CR2[i];
+      OPtr[CSlot[i]]=(displace>=cylTol)-(displace<= -cylTol);
+    }
+
+  const size_t NQ(QSlot.size());
+  for(size_t i=0;i<NQ;i++)
+    {
+      double res(0.0);
+      res+=QEqn[0][i]*x*x;
+      res+=QEqn[1][i]*y*y;
+      res+=QEqn[2][i]*z*z;
+      res+=QEqn[3][i]*x*y;
+      res+=QEqn[4][i]*x*z;
+      res+=QEqn[5][i]*y*z;
+      res+=QEqn[6][i]*x;
+      res+=QEqn[7][i]*y;
+      res+=QEqn[8][i]*z;
+      res+=QEqn[9][i];
+      OPtr[QSlot[i]]=(res>=tol)-(res<= -tol);
+    }
+
+  for(const size_t slot : OSlot)
+    OPtr[slot]=SList[slot]->side(Pt);
+
+  return;
+}
+
+void
+SurfPack::slotSide(const size_t slot,const size_t nPts,
+		   const double* X,const double* Y,const double* Z,
+		   int* OPtr) const
+  /*!
+    Calculate the side of many points against one surface.
+    The points are in separate coordinate arrays.
+    \param slot :: Slot of surface
+    \param nPts :: Number of points
+    \param X :: x coordinates
+    \param Y :: y coordinates
+    \param Z :: z coordinates
+    \param OPtr :: Output array [nPts]
+  */
+{
+  const size_t index=formIndex[slot];
+  const double tol(Geometry::zeroTol);
+
+  switch (form[slot])
+    {
+    case SForm::plane:
+      {
+	const double nx(PX[index]),ny(PY[index]),nz(PZ[index]);
+	const double D(PD[index]);
+	for(size_t i=0;i<nPts;i++)
+	  {
+	    const double Dp=nx*X[i]+ny*Y[i]+nz*Z[i]-D;
+	    OPtr[i]=(Dp>tol)-(Dp< -tol);
+	  }
+	return;
+      }
+    case SForm::sphere:
+      {
+	const double cx(SX[index]),cy(SY[index]),cz(SZ[index]);
+	const double R2(SR2[index]);
+	for(size_t i=0;i<nPts;i++)
+	  {
+	    const double dx=X[i]-cx;
+	    const double dy=Y[i]-cy;
+	    const double dz=Z[i]-cz;
+	    OPtr[i]=2*(dx*dx+dy*dy+dz*dz>R2)-1;
+	  }
+	return;
+      }
+    case SForm::cylinder:
+      {
+	const double cylTol(Geometry::parallelTol);
+	const double cx(CX[index]),cy(CY[index]),cz(CZ[index]);
+	const double wx(CWX[index]),wy(CWY[index]),wz(CWZ[index]);
+	const double R2(CR2[index]);
+	for(size_t i=0;i<nPts;i++)
+	  {
+	    const double dx=X[i]-cx;
+	    const double dy=Y[i]-cy;
+	    const double dz=Z[i]-cz;
+	    const double displace=wx*(dx*dx)+wy*(dy*dy)+wz*(dz*dz)-R2;
+	    OPtr[i]=(displace>=cylTol)-(displace<= -cylTol);
+	  }
+	return;
+      }
+    case SForm::quadratic:
+      {
+	double Q[10];
+	for(size_t j=0;j<10;j++)
+	  Q[j]=QEqn[j][index];
+	for(size_t i=0;i<nPts;i++)
+	  {
+	    const double x(X[i]),y(Y[i]),z(Z[i]);
+	    double res(0.0);
+	    res+=Q[0]*x*x;
+	    res+=Q[1]*y*y;
+	    res+=Q[2]*z*z;
+	    res+=Q[3]*x*y;
+	    res+=Q[4]*x*z;
+	    res+=Q[5]*y*z;
+	    res+=Q[6]*x;
+	    res+=Q[7]*y;
+	    res+=Q[8]*z;
+	    res+=Q[9];
+	    OPtr[i]=(res>=tol)-(res<= -tol);
+	  }
+	return;
+      }
+    case SForm::other:
+      {
+	const Surface* SPtr=SList[slot];
+	for(size_t i=0;i<nPts;i++)
+	  OPtr[i]=SPtr->side(Geometry::Vec3D(X[i],Y[i],Z[i]));
+	return;
+      }
+    }
+  return;
+}
+
+void
+SurfPack::side(const size_t slot,
+	       const std::vector<Geometry::Vec3D>& Pts,
+	       std::vector<int>& Out) const
+  /*!
+    Calculate the side of many points against one surface
+    \param slot :: Slot of surface
+    \param Pts :: Points to test
+    \param Out :: Side [-1/0/1] for each point
+  */
+{
+  ELog::RegMethod RegA("SurfPack","side(slot)");
+
+  if (slot>=SList.size())
+    throw ColErr::IndexError<size_t>(slot,SList.size(),"slot");
+
+  const size_t nPts(Pts.size());
+  std::vector<double> X(nPts),Y(nPts),Z(nPts);
+  for(size_t i=0;i<nPts;i++)
+    {
+      X[i]=Pts[i].X();
+      Y[i]=Pts[i].Y();
+      Z[i]=Pts[i].Z();
+    }
+  Out.resize(nPts);
+  slotSide(slot,nPts,X.data(),Y.data(),Z.data(),Out.data());
+  return;
+}
+
+void
+SurfPack::sideMatrix(const std::vector<Geometry::Vec3D>& Pts,
+		     std::vector<int>& Out) const
+  /*!
+    Calculate the side of many points against all surfaces
+    \param Pts :: Points to test
+    \param Out :: Side [-1/0/1] : index slot*Pts.size()+point
+  */
+{
+  const size_t nPts(Pts.size());
+  std::vector<double> X(nPts),Y(nPts),Z(nPts);
+  for(size_t i=0;i<nPts;i++)
+    {
+      X[i]=Pts[i].X();
+      Y[i]=Pts[i].Y();
+      Z[i]=Pts[i].Z();
+    }
+  Out.resize(nPts*SList.size());
+  for(size_t slot=0;slot<SList.size();slot++)
+    slotSide(slot,nPts,X.data(),Y.data(),Z.data(),Out.data()+slot*nPts);
+  return;
+}
+
+}  // NAMESPACE Geometry
@@ -0,0 +1,253 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   geometry/surfHash.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <map>
+#include <list>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "Surface.h"
+#include "Quadratic.h"
+#include "Cone.h"
+#include "Cylinder.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include "surfHash.h"
+
+namespace ModelSupport
+{
+
+const double surfHash::binWidth(1e-4);
+
+surfHash::surfHash()
+  /*!
+    Constructor
+  */
+{}
+
+surfHash::surfHash(const surfHash& A) :
+  HMap(A.HMap),pending(A.pending)
+  /*!
+    Copy constructor
+    \param A :: surfHash to copy
+  */
+{}
+
+surfHash&
+surfHash::operator=(const surfHash& A)
+  /*!
+    Assignment operator
+    \param A :: surfHash to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      HMap=A.HMap;
+      pending=A.pending;
+    }
+  return *this;
+}
+
+void
+surfHash::clear()
+  /*!
+    Remove all the items
+  */
+{
+  HMap.clear();
+  pending.clear();
+  return;
+}
+
+void
+surfHash::addPending(const int SN)
+  /*!
+    Add a surface number to be binned at the next search
+    \param SN :: Surface number
+  */
+{
+  pending.push_back(SN);
+  return;
+}
+
+size_t
+surfHash::binKey(const int family,const long int kA,const long int kB)
+  /*!
+    Combine the bin indexes into a hash key
+    \param family :: Surface family
+    \param kA :: First bin index
+    \param kB :: Second bin index
+    \return hash key
+  */
+{
+  size_t H=static_cast<size_t>(family);
+  H=H*1000003UL ^ static_cast<size_t>(kA);
+  H=H*1000003UL ^ static_cast<size_t>(kB);
+  return H;
+}
+
+int
+surfHash::surfKey(const Geometry::Surface* SPtr,
+		  long int& kA,long int& kB)
+  /*!
+    Calculate the bin indexes of a surface. The two quantities
+    are the same for equal surfaces (within tolerance) and 
+    opposite planes.
+    \param SPtr :: Surface 
+    \param kA :: First bin index
+    \param kB :: Second bin index
+    \return family [0 if not binned]
+  */
+{
+  int family(0);
+  double A(0.0);
+  double B(0.0);
+
+  const Geometry::Plane* PPtr;
+  const Geometry::Sphere* SphPtr;
+  const Geometry::Cylinder* CPtr;
+  const Geometry::Cone* ConePtr;
+  if ( (PPtr=dynamic_cast<const Geometry::Plane*>(SPtr)) )
+    {
+      const Geometry::Vec3D& N=PPtr->getNormal();
+      family=1;
+      A=std::abs(PPtr->getDistance());
+      B=std::abs(N[0])+2.0*std::abs(N[1])+3.0*std::abs(N[2]);
+    }
+  else if ( (SphPtr=dynamic_cast<const Geometry::Sphere*>(SPtr)) )
+    {
+      const Geometry::Vec3D& C=SphPtr->getCentre();
+      family=2;
+      A=SphPtr->getRadius();
+      B=C[0]+2.0*C[1]+3.0*C[2];
+    }
+  else if ( (CPtr=dynamic_cast<const Geometry::Cylinder*>(SPtr)) )
+    {
+      // centre can move along the axis : not used
+      const Geometry::Vec3D& N=CPtr->getNormal();
+      family=3;
+      A=CPtr->getRadius();
+      B=std::abs(N[0])+2.0*std::abs(N[1])+3.0*std::abs(N[2]);
+    }
+  else if ( (ConePtr=dynamic_cast<const Geometry::Cone*>(SPtr)) )
+    {
+      const Geometry::Vec3D C=ConePtr->getCentre();
+      family=4;
+      A=ConePtr->getCosAngle();
+      B=C[0]+2.0*C[1]+3.0*C[2];
+    }
+
+  if (!family || !std::isfinite(A) || !std::isfinite(B) ||
+      std::abs(A)>1e12*binWidth || std::abs(B)>1e12*binWidth)
+    return 0;
+
+  kA=static_cast<long int>(std::floor(A/binWidth));
+  kB=static_cast<long int>(std::floor(B/binWidth));
+  return family;
+}
+
+void
+surfHash::processPending(const STYPE& SMap)
+  /*!
+    Bin the surfaces waiting to be binned
+    \param SMap :: Surface map [to find pointers]
+  */
+{
+  for(const int SN : pending)
+    {
+      STYPE::const_iterator mc=SMap.find(SN);
+      if (mc!=SMap.end())
+	{
+	  long int kA,kB;
+	  const int family=surfKey(mc->second,kA,kB);
+	  if (family)
+	    HMap.insert(std::pair<size_t,ITEM>
+			(binKey(family,kA,kB),ITEM(SN,mc->second)));
+	}
+    }
+  pending.clear();
+  return;
+}
+
+bool
+surfHash::findCandidates(const STYPE& SMap,
+			 const Geometry::Surface* SPtr,
+			 STYPE& Out) 
+  /*!
+    Find the surfaces that may be equal/opposite to SPtr.
+    Items that are no longer in the surface map are removed.
+    \param SMap :: Surface map 
+    \param SPtr :: Surface to find
+    \param Out :: Candidate surfaces [ordered by number]
+    \return false if the surface is not binned [search all]
+  */
+{
+  ELog::RegMethod RegA("surfHash","findCandidates");
+
+  processPending(SMap);
+  
+  long int kA,kB;
+  const int family=surfKey(SPtr,kA,kB);
+  if (!family) return 0;
+
+  for(long int i=-1;i<2;i++)
+    for(long int j=-1;j<2;j++)
+      {
+	typedef std::unordered_multimap<size_t,ITEM>::iterator hIter;
+	std::pair<hIter,hIter> HR=HMap.equal_range(binKey(family,kA+i,kB+j));
+	hIter hc=HR.first;
+	while(hc!=HR.second)
+	  {
+	    const int SN=hc->second.first;
+	    STYPE::const_iterator mc=SMap.find(SN);
+	    if (mc==SMap.end() || mc->second!=hc->second.second)
+	      hc=HMap.erase(hc);   // stale item
+	    else
+	      {
+		Out.insert(STYPE::value_type(SN,mc->second));
+		++hc;
+	      }
+	  }
+      }
+  return 1;
+}
+
+}  // NAMESPACE ModelSupport
@@ -30,6 +30,7 @@
 #include <stack>
 #include <string>
 #include <algorithm>
+#include <unordered_map>
 
 #ifndef NO_REGEX
 #include <boost/regex.hpp>
@@ -65,6 +66,7 @@
 #include "surfEqual.h"
 #include "surfaceFactory.h"
 #include "surfRegister.h"
+#include "surfHash.h"
 #include "surfIndex.h"
 
 #include "Debug.h"
@@ -72,7 +74,7 @@
 namespace ModelSupport
 {
 
-surfIndex::surfIndex() : uniqNum(1)
+surfIndex::surfIndex() : uniqNum(1),SHPtr(new surfHash)
   /*!
     Constructor
   */
@@ -97,6 +99,7 @@ surfIndex::~surfIndex()
   STYPE::iterator mc;
   for(mc=SMap.begin();mc!=SMap.end();mc++)
     delete mc->second;
+  delete SHPtr;
 }
 
 void
@@ -109,6 +112,7 @@ surfIndex::reset()
   for(mc=SMap.begin();mc!=SMap.end();mc++)
     delete mc->second;
   SMap.erase(SMap.begin(),SMap.end());
+  SHPtr->clear();
   return;
 }
 
@@ -147,7 +151,10 @@ surfIndex::addSurface(Geometry::Surface* SPtr)
   Geometry::Surface* NewPtr=ModelSupport::equalSurface(SPtr);
   // Now find if we have copy
   if (NewPtr==SPtr)
-    SMap.insert(STYPE::value_type(SPtr->getName(),SPtr));
+    {
+      SMap.insert(STYPE::value_type(SPtr->getName(),SPtr));
+      SHPtr->addPending(SPtr->getName());
+    }
   else
     delete SPtr;
 
@@ -188,6 +195,7 @@ surfIndex::insertSurface(Geometry::Surface* SPtr)
     }
 
   SMap.insert(STYPE::value_type(SPtr->getName(),SPtr));
+  SHPtr->addPending(SPtr->getName());
 
   return;
 }
@@ -205,8 +213,11 @@ surfIndex::findOpposite(const Geometry::Surface* SPtr)  const
     dynamic_cast<const Geometry::Plane*>(SPtr);
   if (PPtr)
     {
+      STYPE CMap;
+      const STYPE& SearchMap=
+	(SHPtr->findCandidates(SMap,PPtr,CMap)) ? CMap : SMap;
       STYPE::const_iterator mc;
-      for(mc=SMap.begin();mc!=SMap.end();mc++)
+      for(mc=SearchMap.begin();mc!=SearchMap.end();mc++)
 	if (ModelSupport::oppositeSurfaces(PPtr,mc->second)) 
 	  return mc->first;
     }
@@ -294,11 +305,13 @@ surfIndex::createSurf(const int surfN)
       delete mp->second;
       outPtr=new T(surfN,0);
       mp->second=outPtr;
+      SHPtr->addPending(surfN);
       ELog::EM<<"Reasigned exiting surface"<<surfN<<ELog::endWarn;
       return outPtr;
     }
   outPtr=new T(surfN,0);
   SMap.insert(STYPE::value_type(surfN,outPtr));
+  SHPtr->addPending(surfN);
   return outPtr;
 }
 
@@ -381,6 +394,7 @@ surfIndex::createSurface(const int SN,const int TN,const std::string& SLine)
         {
 	  SMap.insert(STYPE::value_type(SN,SPtr));
 	}
+      SHPtr->addPending(SN);
     }
   catch (const ColErr::ExBase& A)
     {
@@ -438,6 +452,32 @@ surfIndex::getSurf(const int Index) const
   return (mc==SMap.end()) ? 0 : mc->second;
 }
 
+bool
+surfIndex::findCandidates(const Geometry::Surface* SPtr,STYPE& Out)
+  /*!
+    Find the surfaces that could be equal or opposite to SPtr
+    from the surface hash.
+    \param SPtr :: Surface to find
+    \param Out :: Candidate surfaces
+    \return false if the whole map must be searched
+   */
+{
+  return SHPtr->findCandidates(SMap,SPtr,Out);
+}
+
+void
+surfIndex::rehash()
+  /*!
+    Rebin all the surfaces : required if the surfaces 
+    have been moved.
+   */
+{
+  SHPtr->clear();
+  for(const STYPE::value_type& SV : SMap)
+    SHPtr->addPending(SV.first);
+  return;
+}
+
 void 
 surfIndex::renumber(const int origNum,const int newNum)
   /*!
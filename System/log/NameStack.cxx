@@ -3,7 +3,7 @@
  
  * File:   log/NameStack.cxx
  *
- * Copyright (c) 2004-2015 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,31 +20,34 @@
  *
  ****************************************************************************/
 #include <iostream>
+#include <sstream>
 #include <string>
-#include <vector>
-#include <map>
 
 #include "NameStack.h"
 
 namespace ELog
 {
 
+const size_t NameStack::ringSize;
+
 NameStack::NameStack() :
-  extraLevel(0),indentLevel(0)
+  depth(0),nLost(0),extraLevel(0),indentLevel(0)
   /*!
     Constructor
   */
 {}
 
 NameStack::NameStack(const NameStack& A) :
-  key(A.key),Class(A.Class),Method(A.Method),
-  Extra(A.Extra),extraLevel(A.extraLevel),
+  depth(A.depth),nLost(A.nLost),Extra(A.Extra),extraLevel(A.extraLevel),
   indentLevel(A.indentLevel)
   /*!
     Copy Constructor
     \param A :: NameStack to copy
   */
-{}
+{
+  for(size_t i=0;i<ringSize;i++)
+    Items[i]=A.Items[i];
+}
 
 NameStack&
 NameStack::operator=(const NameStack& A) 
@@ -56,9 +59,10 @@ NameStack::operator=(const NameStack& A)
 {
   if (this!=&A)
     {
-      key=A.key;
-      Class=A.Class;
-      Method=A.Method;
+      for(size_t i=0;i<ringSize;i++)
+	Items[i]=A.Items[i];
+      depth=A.depth;
+      nLost=A.nLost;
       Extra=A.Extra;
       extraLevel=A.extraLevel;
       indentLevel=A.indentLevel;
@@ -72,9 +76,8 @@ NameStack::clear()
    Clear the stack
  */
 {
-  key.erase(key.begin(),key.end());
-  Class.clear();
-  Method.clear();
+  depth=0;
+  nLost=0;
   Extra.clear();
   extraLevel=0;
   indentLevel=0;
@@ -86,32 +89,52 @@ NameStack::addComp(const std::string& CN,
 		   const std::string& MN)
   /*!
     Adds a component to the class names series
+    from names that are not literals [copied]
     \param CN :: Class name
     \param MN :: Method name
   */
 {
-  Class.push_back(CN);
-  Method.push_back(MN);
+  StackItem& SI(Items[depth % ringSize]);
+  SI.Class=0;
+  SI.Method=0;
+  SI.CStore=CN;
+  SI.MStore=MN;
+  SI.paramFlag=0;
+  if (depth>=ringSize && depth+1-ringSize>nLost)
+    nLost=depth+1-ringSize;
+  depth++;
   return;
 }
+
+size_t
+NameStack::firstItem() const
+  /*!
+    Get the first item still held in the ring
+    \return index of first item
+  */
+{
+  return nLost;
+}
   
-void
-NameStack::popBack() 
+std::string
+NameStack::itemName(const size_t index) const
   /*!
-    Pop back a item
+    Get the name of an item as Class<param>::Method
+    \param index :: Index of item [must be held]
+    \return name
   */
 {
-  if (!Class.empty())
+  const StackItem& SI(Items[index % ringSize]);
+  std::string Out((SI.Class) ? SI.Class : SI.CStore);
+  if (SI.paramFlag)
     {
-      if (extraLevel==Class.size())
-	{
-	  Extra.clear();
-	  extraLevel=0;
-	}
-      Class.pop_back();
-      Method.pop_back();
+      std::ostringstream cx;
+      cx<<"<"<<SI.param<<">";
+      Out+=cx.str();
     }
-  return;
+  Out+="::";
+  Out+=(SI.Method) ? SI.Method : SI.MStore;
+  return Out;
 }
 
 void
@@ -122,7 +145,7 @@ NameStack::setExtra(const std::string& A)
    */
 {
   Extra=A;
-  extraLevel=Class.size();
+  extraLevel=depth;
   return;
 }
 
@@ -143,8 +166,7 @@ NameStack::getBase() const
     \return BaseItem
   */
 {
-  return (Class.empty()) ?  
-    "" : Class.back()+"::"+Method.back();
+  return (depth>nLost) ? itemName(depth-1) : "";
 }
 
 std::string
@@ -156,17 +178,15 @@ NameStack::getItem(const long int Index) const
     \return BaseItem
   */
 {
-  if (Class.empty()) return "";
+  if (depth<=nLost) return "";
   if (!Index) 
-    return Class.back()+"::"+Method.back();
+    return itemName(depth-1);
   
-  const size_t CSize=Class.size();
- 
   const size_t itx( (Index<0) 
-		    ? (CSize-static_cast<size_t>(1-Index)) 
+		    ? (depth-static_cast<size_t>(1-Index)) 
 		    : static_cast<size_t>(Index));
 
-  return (itx<CSize) ? Class[itx]+"::"+Method[itx] : "";
+  return (itx<depth && itx>=firstItem()) ? itemName(itx) : "";
 } 
 
 std::string
@@ -176,13 +196,14 @@ NameStack::getFull() const
     \return BaseItem
   */
 {
-  std::vector<std::string>::const_iterator vc(Class.begin());
-  std::vector<std::string>::const_iterator ac(Method.begin());
-  std::string Out=*vc+"::"+*ac;
-  for(ac++,vc++;vc!=Class.end();vc++,ac++)
+  std::string Out;
+  const size_t first(firstItem());
+  if (first)
+    Out="...#";
+  for(size_t i=first;i<depth;i++)
     {
-      Out+="#";
-      Out+=*vc+"::"+*ac;
+      if (i!=first) Out+="#";
+      Out+=itemName(i);
     }
   if (!Extra.empty())
     {
@@ -199,15 +220,19 @@ NameStack::getFullTree() const
     \return BaseItem
   */
 {
-  std::vector<std::string>::const_iterator vc(Class.begin());
-  std::vector<std::string>::const_iterator ac(Method.begin());
-  size_t indent(2);
-  std::string Out=*vc+"::"+*ac;
-  for(ac++,vc++;vc!=Class.end();vc++,ac++,indent+=2)
+  std::string Out;
+  const size_t first(firstItem());
+  if (first)
+    Out="...\n";
+  size_t indent(0);
+  for(size_t i=first;i<depth;i++,indent+=2)
     {
-      Out+='\n';
-      Out+=std::string(indent,' ');
-      Out+=*vc+"::"+*ac;
+      if (i!=first)
+	{
+	  Out+='\n';
+	  Out+=std::string(indent,' ');
+	}
+      Out+=itemName(i);
     }
   if (!Extra.empty())
     {
@@ -3,7 +3,7 @@
  
  * File:   log/RegMethod.cxx
  *
- * Copyright (c) 2004-2016 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -21,8 +21,6 @@
  ****************************************************************************/
 #include <string>
 #include <sstream>
-#include <map>
-#include <vector>
 
 #include <iostream>
 
@@ -33,7 +31,7 @@
 namespace ELog
 {
 
-NameStack RegMethod::Base;
+thread_local NameStack RegMethod::Base;
 
 RegMethod::RegMethod(const std::string& CN,
 		     const std::string& MN) :
@@ -44,8 +42,12 @@ RegMethod::RegMethod(const std::string& CN,
     \param MN :: Method name
   */
 {
+#if REGTRACE_LEVEL>0
   Base.addComp(CN,MN);
-
+#else
+  (void) CN;
+  (void) MN;
+#endif
 }
 
 RegMethod::RegMethod(const std::string& CN,
@@ -59,19 +61,15 @@ RegMethod::RegMethod(const std::string& CN,
     \param param :: Index for type
   */
 {
+#if REGTRACE_LEVEL>0
   std::ostringstream cx;
   cx<<"<"<<param<<">";
   Base.addComp(CN+cx.str(),MN);
-}
-
-RegMethod::~RegMethod() 
-  /*!
-    Destructor removes one from the stack
-  */
-{
-  Base.popBack();
-  if (indentLevel) 
-    Base.addIndent(-indentLevel);
+#else
+  (void) CN;
+  (void) MN;
+  (void) param;
+#endif
 }
 
 void
@@ -3,7 +3,7 @@
  
  * File:   logInc/NameStack.h
  *
- * Copyright (c) 2004-2015 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -28,20 +28,44 @@ namespace ELog
     \class NameStack 
     \brief Holds a list of items for a calling stack
     \author S. Ansell
-    \version 1.0
-    \date June 2009
+    \version 2.0
+    \date October 2017
+
+    The stack holds pointers to the literal class/method
+    names in a fixed ring so that add/pop do not allocate
+    or copy strings. The text is only built when an 
+    exception/log requires it. If the stack is deeper than 
+    the ring the outer items are overwritten and are shown 
+    as ... [until popped]. Names that are not literals
+    are copied into the item.
   */
 class NameStack
 {
  private:
 
-  std::map<std::string,int> key;        ///< Key names
-  std::vector<std::string> Class;       ///< Class Name
-  std::vector<std::string> Method;      ///< Method Name
+  static const size_t ringSize=256;     ///< Number of items held
+
+  /// Single stack item
+  struct StackItem
+  {
+    const char* Class;      ///< Class name [literal : 0 if owned]
+    const char* Method;     ///< Method name [literal : 0 if owned]
+    int param;              ///< Template index
+    int paramFlag;          ///< Template index set
+    std::string CStore;     ///< Class name [owned]
+    std::string MStore;     ///< Method name [owned]
+  };
+  
+  StackItem Items[ringSize];            ///< Ring of items
+  size_t depth;                         ///< Stack depth
+  size_t nLost;                         ///< Outer items overwritten
   std::string Extra;                    ///< Extra tag if neeed
   size_t extraLevel;                    ///< Extra tag if neeed
   long int indentLevel;                 ///< Indent level
 
+  std::string itemName(const size_t) const;
+  size_t firstItem() const;
+  
  public:
 
   NameStack();
@@ -55,9 +79,10 @@ class NameStack
   void setExtra(const std::string&);
   /// Remove extra output for exception [early]
   void clearExtra() { Extra.clear(); }
+  void addComp(const char*,const char*);
+  void addComp(const char*,const char*,const int);
   void addComp(const std::string&,const std::string&);
   void popBack();
-
   
   std::string getBase() const;
   std::string getItem(const long int) const;
@@ -66,7 +91,7 @@ class NameStack
   const std::string& getExtra() const;
 
   /// Access depth of function:
-  size_t getDepth() const { return Class.size(); }
+  size_t getDepth() const { return depth; }
 
   void addIndent(const long int);
   /// Output of the indent level
@@ -74,7 +99,62 @@ class NameStack
   
 };
 
+inline void
+NameStack::addComp(const char* CN,const char* MN)
+  /*!
+    Adds a component to the class names series
+    \param CN :: Class name [literal]
+    \param MN :: Method name [literal]
+  */
+{
+  StackItem& SI(Items[depth % ringSize]);
+  SI.Class=CN;
+  SI.Method=MN;
+  SI.paramFlag=0;
+  if (depth>=ringSize && depth+1-ringSize>nLost)
+    nLost=depth+1-ringSize;
+  depth++;
+  return;
+}
+
+inline void
+NameStack::addComp(const char* CN,const char* MN,const int P)
+  /*!
+    Adds a component to the class names series
+    \param CN :: Class name [literal]
+    \param MN :: Method name [literal]
+    \param P :: Template index
+  */
+{
+  StackItem& SI(Items[depth % ringSize]);
+  SI.Class=CN;
+  SI.Method=MN;
+  SI.param=P;
+  SI.paramFlag=1;
+  if (depth>=ringSize && depth+1-ringSize>nLost)
+    nLost=depth+1-ringSize;
+  depth++;
+  return;
+}
 
+inline void
+NameStack::popBack() 
+  /*!
+    Pop back a item
+  */
+{
+  if (depth)
+    {
+      if (extraLevel==depth)
+	{
+	  Extra.clear();
+	  extraLevel=0;
+	}
+      depth--;
+      if (nLost>depth) nLost=depth;
+    }
+  return;
+}
 
 }
 
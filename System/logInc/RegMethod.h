@@ -3,7 +3,7 @@
  
  * File:   logInc/RegMethod.h
  *
- * Copyright (c) 2004-2016 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -22,6 +22,16 @@
 #ifndef ELog_RegMethod_h
 #define ELog_RegMethod_h
 
+/*!
+  Trace level for the RegMethod stack 
+  - 2 : all methods are traced
+  - 1 : HotMethod [inner loop] methods are not traced
+  - 0 : no tracing [exceptions have no code location]
+*/
+#ifndef REGTRACE_LEVEL
+#define REGTRACE_LEVEL 2
+#endif
+
 namespace ELog
 {
   /*!
@@ -39,7 +49,7 @@ class RegMethod
 {
  private:
 
-  static NameStack Base;           ///< Singleton of base to register
+  static thread_local NameStack Base;  ///< Stack of base [per thread]
 
   int indentLevel;                 ///< Additional indent
   /// \cond NOWRITTEN
@@ -51,6 +61,8 @@ class RegMethod
 
   /// Access NameStack pointer
   NameStack* getBasePtr() { return &Base; }
+  RegMethod(const char*,const char*);
+  RegMethod(const char*,const char*,const int);
   RegMethod(const std::string&,const std::string&);
   RegMethod(const std::string&,const std::string&,const int);
   ~RegMethod();
@@ -70,6 +82,82 @@ class RegMethod
 
 };
 
+/*!
+  \class NullMethod 
+  \brief Stand in for RegMethod that does nothing
+  \author S. Ansell
+  \date October 2017
+  \version 1.0
+*/
+
+class NullMethod
+{
+ public:
+
+  /// Constructor [no-op]
+  NullMethod(const char*,const char*) {}
+  /// Constructor [no-op]
+  NullMethod(const char*,const char*,const int) {}
+
+};
+
+/// Registration for inner loop methods [compiled out below level 2]
+#if REGTRACE_LEVEL>1
+typedef RegMethod HotMethod;
+#else
+typedef NullMethod HotMethod;
+#endif
+
+inline
+RegMethod::RegMethod(const char* CN,const char* MN) :
+  indentLevel(0)
+  /*!
+    Constructor add name to stack
+    \param CN :: Class name [literal]
+    \param MN :: Method name [literal]
+  */
+{
+#if REGTRACE_LEVEL>0
+  Base.addComp(CN,MN);
+#else
+  (void) CN;
+  (void) MN;
+#endif
+}
+
+inline
+RegMethod::RegMethod(const char* CN,const char* MN,
+		     const int param) :
+  indentLevel(0)
+  /*!
+    Constructor add name to stack
+    \param CN :: Class name [literal]
+    \param MN :: Method name [literal]
+    \param param :: Index for type
+  */
+{
+#if REGTRACE_LEVEL>0
+  Base.addComp(CN,MN,param);
+#else
+  (void) CN;
+  (void) MN;
+  (void) param;
+#endif
+}
+
+inline
+RegMethod::~RegMethod() 
+  /*!
+    Destructor removes one from the stack
+  */
+{
+#if REGTRACE_LEVEL>0
+  Base.popBack();
+#endif
+  if (indentLevel) 
+    Base.addIndent(-indentLevel);
+}
+
 }
 
 #endif
@@ -51,11 +51,15 @@
 #include "Transform.h"
 #include "Track.h"
 #include "Line.h"
-#include "LineIntersectVisit.h"
+#include "TrackScratch.h"
 #include "Surface.h"
 #include "surfIndex.h"
 #include "Rules.h"
 #include "HeadRule.h"
+#include "SurfPack.h"
+#include "RuleProgram.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "Token.h"
 #include "neutron.h"
 #include "RuleCheck.h"
@@ -164,7 +168,7 @@ Object::startLine(const std::string& Line)
 Object::Object() :
   ObjName(0),listNum(-1),Tmp(300),MatN(-1),fill(0),trcl(0),
   universe(0),imp(1),density(0.0),placehold(0),populated(0),
-  objSurfValid(0)
+  HProg(new RuleProgram),objSurfValid(0)
  /*!
    Defaut constuctor, set temperature to 300C and material to vacuum
  */
@@ -174,7 +178,7 @@ Object::Object(const int N,const int M,const double T,
 	       const std::string& Line) :
   ObjName(N),listNum(-1),Tmp(T),MatN(M),fill(0),trcl(0),
   universe(0),imp(1),density(0.0),placehold(0),
-  populated(0),objSurfValid(0)
+  populated(0),HProg(new RuleProgram),objSurfValid(0)
  /*!
    Constuctor, set temperature to 300C 
    \param N :: number
@@ -190,9 +194,11 @@ Object::Object(const Object& A) :
   ObjName(A.ObjName),listNum(A.listNum),Tmp(A.Tmp),MatN(A.MatN),
   fill(A.fill),trcl(A.trcl),universe(A.universe),imp(A.imp),
   density(A.density),placehold(A.placehold),populated(A.populated),
-  HRule(A.HRule),objSurfValid(0),SurList(A.SurList),SurSet(A.SurSet)
+  HRule(A.HRule),HProg(new RuleProgram),objSurfValid(0),
+  SurList(A.SurList),SurKind(A.SurKind),SurSet(A.SurSet)
   /*!
-    Copy constructor
+    Copy constructor : The program is not copied
+    since it points into the rule tree of A.
     \param A :: Object to copy
   */
 {}
@@ -219,8 +225,10 @@ Object::operator=(const Object& A)
       placehold=A.placehold;
       populated=A.populated;
       HRule=A.HRule;
+      HProg->clear();
       objSurfValid=0;
       SurList=A.SurList;
+      SurKind=A.SurKind;
       SurSet=A.SurSet;
     }
   return *this;
@@ -230,7 +238,9 @@ Object::~Object()
   /*!
     Delete operator : removes Object tree
   */
-{}
+{
+  delete HProg;
+}
 
 Object*
 Object::clone() const 
@@ -285,10 +295,12 @@ Object::complementaryObject(const int Cnum,std::string& Ln)
   ObjName=Cnum;
   MatN=0;
   density=0.0;
+  HProg->clear();
   if (!HRule.procString(Part))
     throw ColErr::ExBase(0,RegA.getFull()+"\n"+Part);
 
   SurList.clear();
+  SurKind.clear();
   SurSet.erase(SurSet.begin(),SurSet.end());
   Ln.erase(posA-1,posB+1);  //Delete brackets ( Part ) .
   std::ostringstream CompCell;
@@ -390,9 +402,11 @@ Object::setObject(std::string Ln)
     }
 
   populated=0;
+  HProg->clear();
   if (HRule.procString(Ln))     // this currently does not fail:
     {
       SurList.clear();
+      SurKind.clear();
       SurSet.erase(SurSet.begin(),SurSet.end());
       objSurfValid=0;
       return 1;
@@ -412,6 +426,7 @@ Object::procString(const std::string& cellStr)
    */
 {
   populated=0;
+  HProg->clear();
   return HRule.procString(cellStr);
 }
 
@@ -438,9 +453,11 @@ Object::setObject(const int N,const int matNum,
   for(mc=TVec.begin();mc!=TVec.end();mc++)
     mc->write(cx);
 
+  HProg->clear();
   if (HRule.procString(cx.str()))     // this currently does not fail:
     {
       SurList.clear();
+      SurKind.clear();
       SurSet.erase(SurSet.begin(),SurSet.end());
       objSurfValid=0;
       return 1;
@@ -471,6 +488,19 @@ Object::populate()
   return 0;
 }
 
+void
+Object::updateProgram()
+  /*!
+    Rebuild the compiled rule [if built] after the surfaces
+    have been moved in place. The packed surface coefficients
+    and forms of the program are copies so must be re-read.
+  */
+{
+  if (HProg->isCompiled())
+    HProg->compile(HRule);
+  return;
+}
+
 int
 Object::addSurfString(const std::string& XE)
   /*!
@@ -495,6 +525,39 @@ Object::addSurfString(const std::string& XE)
   return flag;
 }
 
+int
+Object::addIntersection(const HeadRule& XRule)
+  /*!
+    Intersect the cell with a pre-processed rule. The rule
+    is spliced into the existing tree so the surfaces already 
+    populated are kept and only the new rule is populated.
+    The surface list must be rebuilt before tracking.
+    \param XRule :: Rule to intersect with the cell
+    \retval 1 on success
+    \retval 0 on empty rule
+  */
+{
+  ELog::RegMethod RegA("Object","addIntersection");
+
+  if (!XRule.hasRule()) return 0;
+
+  if (populated)
+    {
+      HeadRule PRule(XRule);
+      PRule.populateSurf();
+      HRule.addIntersection(PRule);
+    }
+  else
+    HRule.addIntersection(XRule);
+
+  HProg->clear();
+  SurList.clear();
+  SurKind.clear();
+  SurSet.erase(SurSet.begin(),SurSet.end());
+  objSurfValid=0;
+  return 1;
+}
+
 
 int
 Object::isOnSide(const Geometry::Vec3D& Pt) const
@@ -606,7 +669,8 @@ Object::isValid(const Geometry::Vec3D& Pt) const
   \returns 1 if true and 0 if false
 */
 {
-  return HRule.isValid(Pt);
+  return (HProg->isCompiled()) ?
+    HProg->isValid(Pt) : HRule.isValid(Pt);
 }
 
 int
@@ -620,7 +684,8 @@ Object::isValid(const Geometry::Vec3D& Pt,
   \returns 1 if true and 0 if false
 */
 {
-  return HRule.isValid(Pt,ExSN);
+  return (HProg->isCompiled()) ?
+    HProg->isValid(Pt,ExSN) : HRule.isValid(Pt,ExSN);
 }
 
 int
@@ -634,7 +699,8 @@ Object::isDirectionValid(const Geometry::Vec3D& Pt,
   \returns 1 if true and 0 if false
 */
 {
-  return HRule.isDirectionValid(Pt,ExSN);
+  return (HProg->isCompiled()) ?
+    HProg->isDirectionValid(Pt,ExSN) : HRule.isDirectionValid(Pt,ExSN);
 }
 
 
@@ -649,7 +715,39 @@ Object::isValid(const Geometry::Vec3D& Pt,
   \returns 1 if true and 0 if false
 */
 {
-  return HRule.isValid(Pt,ExSN);
+  return (HProg->isCompiled()) ?
+    HProg->isValid(Pt,ExSN) : HRule.isValid(Pt,ExSN);
+}
+
+int
+Object::isValid(const Geometry::Vec3D& Pt,SurfSideCache& Cache) const
+/*! 
+  Determines is Pt is within the object 
+  or on the surface
+  \param Pt :: Point to be tested
+  \param Cache :: Surface sides at Pt [shared between cells]
+  \returns 1 if true and 0 if false
+*/
+{
+  return (HProg->isCompiled()) ?
+    HProg->isValid(Pt,Cache) : HRule.isValid(Pt);
+}
+
+int
+Object::isDirectionValid(const Geometry::Vec3D& Pt,const int ExSN,
+			 SurfSideCache& Cache) const
+/*! 
+  Determines is Pt is within the object 
+  or on the surface
+  \param Pt :: Point to be tested 
+  \param ExSN :: Excluded surf Number [signed]
+  \param Cache :: Surface sides at Pt [shared between cells]
+  \returns 1 if true and 0 if false
+*/
+{
+  return (HProg->isCompiled()) ?
+    HProg->isDirectionValid(Pt,ExSN,Cache) :
+    HRule.isDirectionValid(Pt,ExSN);
 }
 
 int
@@ -663,6 +761,27 @@ Object::isValid(const std::map<int,int>& SMap) const
   return HRule.isValid(SMap);
 }
 
+void
+Object::isValid(const std::vector<Geometry::Vec3D>& Pts,
+		std::vector<int>& Out) const
+/*! 
+  Determines if each of a set of points is within the object.
+  Uses a single pass over each surface if the rule is compiled.
+  \param Pts :: Points to be tested
+  \param Out :: 1 if valid / 0 if not [for each point]
+*/
+{
+  if (HProg->isCompiled())
+    {
+      HProg->isValid(Pts,Out);
+      return;
+    }
+  Out.resize(Pts.size());
+  for(size_t i=0;i<Pts.size();i++)
+    Out[i]=HRule.isValid(Pts[i]);
+  return;
+}
+
 std::map<int,int>
 Object::mapValid(const Geometry::Vec3D& Pt) const
 /*! 
@@ -698,7 +817,8 @@ Object::pairValid(const int SN,const Geometry::Vec3D& Pt) const
     \retval 3 : valid [SN true/false]
   */
 {
-  return HRule.pairValid(SN,Pt);
+  return (HProg->isCompiled()) ?
+    HProg->pairValid(SN,Pt) : HRule.pairValid(SN,Pt);
 }
 
 int
@@ -716,6 +836,7 @@ Object::createSurfaceList()
   std::ostringstream debugCX;
 
   SurList.clear();
+  SurKind.clear();
   SurSet.erase(SurSet.begin(),SurSet.end());
 
   std::stack<const Rule*> TreeLine;
@@ -766,7 +887,10 @@ Object::createSurfaceList()
       ELog::EM<<"Cell == "<<*this<<ELog::endErr;
       throw ColErr::ExitAbort("Empty surf List");
     }
+  for(const Geometry::Surface* SPtr : SurList)
+    SurKind.push_back(static_cast<int>(TrackScratch::surfKind(SPtr)));
 
+  HProg->compile(HRule);
   createLogicOpp();
   return 1;
 }
@@ -886,10 +1010,9 @@ Object::hasIntercept(const Geometry::Vec3D& IP,
 {
   ELog::RegMethod RegA("Object","hadIntercept");
 
-  MonteCarlo::LineIntersectVisit LI(IP,UV);
-  std::vector<const Geometry::Surface*>::const_iterator vc;
-  for(vc=SurList.begin();vc!=SurList.end();vc++)
-    (*vc)->acceptVisitor(LI);
+  TrackScratch LI;
+  LI.setLine(IP,UV);
+  trackSurfaces(LI);
 
   const std::vector<double>& dPts(LI.getDistance());
   for(size_t i=0;i<dPts.size();i++)
@@ -918,10 +1041,9 @@ Object::forwardIntercept(const Geometry::Vec3D& IP,
   ELog::RegMethod RegA("Object","forwardIntercept");
   
 
-  MonteCarlo::LineIntersectVisit LI(IP,UV);
-  std::vector<const Geometry::Surface*>::const_iterator vc;
-  for(vc=SurList.begin();vc!=SurList.end();vc++)
-    (*vc)->acceptVisitor(LI);
+  TrackScratch LI;
+  LI.setLine(IP,UV);
+  trackSurfaces(LI);
 
   const std::vector<Geometry::Vec3D>& IPts(LI.getPoints());
   const std::vector<double>& dPts(LI.getDistance());
@@ -980,6 +1102,92 @@ Object::trackIntoCell(const MonteCarlo::neutron& N,double& D,
   return trackCell(N,D,1,SPtr,startSurf);
 }
 
+int
+Object::trackOutCell(TrackScratch& LI,const MonteCarlo::neutron& N,
+		     double& D,const Geometry::Surface*& SPtr,
+		     const int startSurf) const
+  /*!
+    Track the distance to exit the cell using a scratch buffer
+    \param LI :: Scratch buffer for intercepts
+    \param N :: Neutron
+    \param D :: Distance to exit
+    \param SPtr :: Surface at exit
+    \param startSurf :: Start surface [not to be used]
+    \return surface number on exit
+  */
+{
+  return trackCell(LI,N,D,-1,SPtr,startSurf);
+}
+
+int
+Object::trackIntoCell(TrackScratch& LI,const MonteCarlo::neutron& N,
+		      double& D,const Geometry::Surface*& SPtr,
+		      const int startSurf) const
+  /*!
+    Track the distance to a cell using a scratch buffer
+    \param LI :: Scratch buffer for intercepts
+    \param N :: Neutron
+    \param D :: Distance to entrance
+    \param SPtr :: Surface at exit
+    \param startSurf :: Start surface 
+    \return surface number on exit
+  */
+{
+  return trackCell(LI,N,D,1,SPtr,startSurf);
+}
+
+int
+Object::trackOutCell(QueryContext& QC,const MonteCarlo::neutron& N,
+		     double& D,const Geometry::Surface*& SPtr,
+		     const int startSurf) const
+  /*!
+    Track the distance to exit the cell within a query context
+    \param QC :: Query context [provides intercept buffer]
+    \param N :: Neutron
+    \param D :: Distance to exit
+    \param SPtr :: Surface at exit
+    \param startSurf :: Start surface [not to be used]
+    \return surface number on exit
+  */
+{
+  QC.addTrack();
+  return trackCell(QC.getTrackBuffer(),N,D,-1,SPtr,startSurf);
+}
+
+int
+Object::trackIntoCell(QueryContext& QC,const MonteCarlo::neutron& N,
+		      double& D,const Geometry::Surface*& SPtr,
+		      const int startSurf) const
+  /*!
+    Track the distance to a cell within a query context
+    \param QC :: Query context [provides intercept buffer]
+    \param N :: Neutron
+    \param D :: Distance to entrance
+    \param SPtr :: Surface at exit
+    \param startSurf :: Start surface 
+    \return surface number on exit
+  */
+{
+  QC.addTrack();
+  return trackCell(QC.getTrackBuffer(),N,D,1,SPtr,startSurf);
+}
+
+void
+Object::trackSurfaces(TrackScratch& LI) const
+  /*!
+    Add the intercepts of all the surfaces of the object
+    to the current track of the scratch buffer
+    \param LI :: Scratch buffer [line already set]
+  */
+{
+  if (SurKind.size()==SurList.size())
+    LI.addSurfaces(SurList,SurKind);
+  else
+    for(const Geometry::Surface* SPtr : SurList)
+      LI.addSurface(SPtr);
+  return;
+}
+
 int
 Object::calcInOut(const int pAB,const int N) const
   /*!
@@ -1016,13 +1224,32 @@ Object::trackCell(const MonteCarlo::neutron& N,double& D,
     \return surface number of intercept
    */
 {
-  ELog::RegMethod RegA("Object","trackCell[D,dir]");
+  TrackScratch LI;
+  return trackCell(LI,N,D,direction,surfPtr,startSurf);
+}
 
-  MonteCarlo::LineIntersectVisit LI(N);
-  for(const Geometry::Surface* isptr : SurList)
-    {
-      isptr->acceptVisitor(LI);
-    }
+int
+Object::trackCell(TrackScratch& LI,const MonteCarlo::neutron& N,
+		  double& D,const int direction,
+		  const Geometry::Surface*& surfPtr,
+		  const int startSurf) const
+  /*!
+    Track to a neutron into/out of a cell. 
+    The scratch buffer is reset and reused so that
+    the caller can keep one over many tracks.
+    \param LI :: Scratch buffer for intercepts
+    \param N :: Neutron 
+    \param D :: Distance traveled to the cell [get added too]
+    \param direction :: direction to track [+1/-1 : in/out ] 
+    \param surfPtr :: Surface at exit
+    \param startSurf :: Start surface [to be ignored]
+    \return surface number of intercept
+   */
+{
+  ELog::HotMethod RegA("Object","trackCell[D,dir]");
+
+  LI.setLine(N);
+  trackSurfaces(LI);
 
   const std::vector<Geometry::Vec3D>& IPts(LI.getPoints());
   const std::vector<double>& dPts(LI.getDistance());
@@ -1033,6 +1260,7 @@ Object::trackCell(const MonteCarlo::neutron& N,double& D,
   // NOTE: we only check for and exiting surface by going
   // along the line.
   int bestPairValid(0);
+  SurfSideCache Cache;
   for(size_t i=0;i<dPts.size();i++)
     {
       // Is point possible closer
@@ -1041,8 +1269,8 @@ Object::trackCell(const MonteCarlo::neutron& N,double& D,
 	   (dPts[i]>0.0 && dPts[i]<D) )
 	{
 	  const int NS=surfIndex[i]->getName();	    // NOT SIGNED
-	  const int pAB=isDirectionValid(IPts[i],NS);
-	  const int mAB=isDirectionValid(IPts[i],-NS);
+	  const int pAB=isDirectionValid(IPts[i],NS,Cache);
+	  const int mAB=isDirectionValid(IPts[i],-NS,Cache);
 	  const int normD=surfIndex[i]->sideDirection(IPts[i],N.uVec);
           
 	  if (direction<0)
@@ -1082,10 +1310,9 @@ Object::forwardInterceptInit(const Geometry::Vec3D& IP,
 {
   ELog::RegMethod RegA("Object","forwardInterceptInit");
   
-  MonteCarlo::LineIntersectVisit LI(IP,UV);
-  std::vector<const Geometry::Surface*>::const_iterator vc;
-  for(vc=SurList.begin();vc!=SurList.end();vc++)
-    (*vc)->acceptVisitor(LI);
+  TrackScratch LI;
+  LI.setLine(IP,UV);
+  trackSurfaces(LI);
 
   const std::vector<Geometry::Vec3D>& IPts(LI.getPoints());
   const std::vector<double>& dPts(LI.getDistance());
@@ -1133,6 +1360,7 @@ Object::makeComplement()
     Takes the complement of a group
    */
 {
+  HProg->clear();
   HRule.makeComplement();
   return;
 }
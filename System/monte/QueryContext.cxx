@@ -0,0 +1,144 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   monte/QueryContext.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <list>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Line.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
+
+namespace MonteCarlo
+{
+
+std::ostream&
+operator<<(std::ostream& OX,const QueryContext& A)
+  /*!
+    Write to a standard stream
+    \param OX :: Output stream
+    \param A :: QueryContext to write
+    \return stream
+  */
+{
+  A.write(OX);
+  return OX;
+}
+
+QueryContext::QueryContext() :
+  lastCell(0),nFind(0),nTestHit(0),nLastHit(0),
+  nIndexHit(0),nSearch(0),nTrack(0),nNext(0),nBundleHit(0)
+  /*!
+    Constructor
+  */
+{}
+
+QueryContext::QueryContext(const QueryContext& A) :
+  lastCell(A.lastCell),TrackBuffer(A.TrackBuffer),
+  SideCache(A.SideCache),nFind(A.nFind),nTestHit(A.nTestHit),
+  nLastHit(A.nLastHit),nIndexHit(A.nIndexHit),nSearch(A.nSearch),
+  nTrack(A.nTrack),nNext(A.nNext),nBundleHit(A.nBundleHit)
+  /*!
+    Copy constructor
+    \param A :: QueryContext to copy
+  */
+{}
+
+QueryContext&
+QueryContext::operator=(const QueryContext& A)
+  /*!
+    Assignment operator
+    \param A :: QueryContext to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      lastCell=A.lastCell;
+      TrackBuffer=A.TrackBuffer;
+      SideCache=A.SideCache;
+      nFind=A.nFind;
+      nTestHit=A.nTestHit;
+      nLastHit=A.nLastHit;
+      nIndexHit=A.nIndexHit;
+      nSearch=A.nSearch;
+      nTrack=A.nTrack;
+      nNext=A.nNext;
+      nBundleHit=A.nBundleHit;
+    }
+  return *this;
+}
+
+void
+QueryContext::clear()
+  /*!
+    Clear the state [e.g. after the geometry has changed]
+    and the counters.
+  */
+{
+  lastCell=0;
+  TrackBuffer.clearTrack();
+  SideCache.clear();
+  nFind=0;
+  nTestHit=0;
+  nLastHit=0;
+  nIndexHit=0;
+  nSearch=0;
+  nTrack=0;
+  nNext=0;
+  nBundleHit=0;
+  return;
+}
+
+void
+QueryContext::write(std::ostream& OX) const
+  /*!
+    Write the query counts
+    \param OX :: Output stream
+  */
+{
+  OX<<"findCell "<<nFind<<" [guess:"<<nTestHit<<" last:"<<nLastHit
+    <<" index:"<<nIndexHit<<" search:"<<nSearch<<"]"
+    <<" track "<<nTrack<<" next "<<nNext<<" bundle "<<nBundleHit;
+  return;
+}
+
+} // NAMESPACE MonteCarlo
@@ -0,0 +1,463 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   monte/RuleProgram.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <list>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <limits>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Surface.h"
+#include "Quadratic.h"
+#include "Plane.h"
+#include "SurfPack.h"
+#include "SurfSideCache.h"
+#include "Rules.h"
+#include "HeadRule.h"
+#include "RuleProgram.h"
+
+const size_t RuleProgram::trueExit(std::numeric_limits<size_t>::max());
+const size_t RuleProgram::falseExit(std::numeric_limits<size_t>::max()-1);
+
+RuleProgram::RuleProgram() :
+  compiled(0),entry(falseExit)
+  /*!
+    Constructor
+  */
+{}
+
+RuleProgram::RuleProgram(const RuleProgram& A) :
+  compiled(A.compiled),entry(A.entry),Prog(A.Prog),
+  slotSurf(A.slotSurf),SPack(A.SPack)
+  /*!
+    Copy constructor
+    \param A :: RuleProgram to copy
+  */
+{}
+
+RuleProgram&
+RuleProgram::operator=(const RuleProgram& A)
+  /*!
+    Assignment operator
+    \param A :: RuleProgram to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      compiled=A.compiled;
+      entry=A.entry;
+      Prog=A.Prog;
+      slotSurf=A.slotSurf;
+      SPack=A.SPack;
+    }
+  return *this;
+}
+
+void
+RuleProgram::clear()
+  /*!
+    Remove the program
+  */
+{
+  compiled=0;
+  entry=falseExit;
+  Prog.clear();
+  slotSurf.clear();
+  SPack.clear();
+  return;
+}
+
+size_t
+RuleProgram::addInst(const RuleInst& RI)
+  /*!
+    Add an instruction
+    \param RI :: Instruction
+    \return index of instruction
+  */
+{
+  Prog.push_back(RI);
+  return Prog.size()-1;
+}
+
+size_t
+RuleProgram::surfSlot(const Geometry::Surface* SPtr)
+  /*!
+    Get the slot of a surface : adds the surface if new
+    \param SPtr :: Surface
+    \return slot index
+  */
+{
+  std::vector<const Geometry::Surface*>::const_iterator vc=
+    std::find(slotSurf.begin(),slotSurf.end(),SPtr);
+  if (vc!=slotSurf.end())
+    return static_cast<size_t>(vc-slotSurf.begin());
+  slotSurf.push_back(SPtr);
+  return slotSurf.size()-1;
+}
+
+size_t
+RuleProgram::compileRule(const Rule* RPtr,const size_t TIndex,
+			 const size_t FIndex)
+  /*!
+    Compile a rule so that it jumps to TIndex if true
+    and FIndex if false. The second leaf is compiled first
+    so that its entry point is known to the first leaf.
+    \param RPtr :: Rule to compile
+    \param TIndex :: Instruction for true
+    \param FIndex :: Instruction for false
+    \return entry point of the rule
+  */
+{
+  if (!RPtr) return FIndex;
+
+  const SurfPoint* SP=dynamic_cast<const SurfPoint*>(RPtr);
+  if (SP)
+    {
+      const Geometry::Surface* SPtr=SP->getKey();
+      if (!SPtr) return FIndex;
+      RuleInst RI;
+      RI.PPtr=dynamic_cast<const Geometry::Plane*>(SPtr);
+      RI.op=(RI.PPtr) ? 0 : 1;
+      RI.keyN=SP->getKeyN();
+      RI.sign=SP->getSign();
+      RI.SPtr=SPtr;
+      RI.RPtr=0;
+      RI.slot=surfSlot(SPtr);
+      RI.onTrue=TIndex;
+      RI.onFalse=FIndex;
+      return addInst(RI);
+    }
+
+  const int RType=RPtr->type();
+  if (RType==1 || RType==-1)
+    {
+      const Rule* APtr=RPtr->leaf(0);
+      const Rule* BPtr=RPtr->leaf(1);
+      if (!APtr || !BPtr) return FIndex;
+      const size_t BIndex=compileRule(BPtr,TIndex,FIndex);
+      return (RType==1) ?
+	compileRule(APtr,BIndex,FIndex) :     // intersection
+	compileRule(APtr,TIndex,BIndex);      // union
+    }
+
+  if (dynamic_cast<const CompGrp*>(RPtr))
+    {
+      const Rule* APtr=RPtr->leaf(0);
+      return (APtr) ? compileRule(APtr,FIndex,TIndex) : TIndex;
+    }
+
+  if (dynamic_cast<const ContGrp*>(RPtr))
+    return compileRule(RPtr->leaf(0),TIndex,FIndex);
+
+  const BoolValue* BV=dynamic_cast<const BoolValue*>(RPtr);
+  if (BV)
+    {
+      // status can be -1 [doesn't matter] : treated as true
+      const Geometry::Vec3D Origin;
+      return (BV->isValid(Origin)) ? TIndex : FIndex;
+    }
+
+  // Complement objects etc : use the rule
+  RuleInst RI;
+  RI.op=2;
+  RI.keyN=0;
+  RI.sign=0;
+  RI.PPtr=0;
+  RI.SPtr=0;
+  RI.RPtr=RPtr;
+  RI.slot=0;
+  RI.onTrue=TIndex;
+  RI.onFalse=FIndex;
+  return addInst(RI);
+}
+
+void
+RuleProgram::compile(const HeadRule& HR)
+  /*!
+    Compile the head rule. The surfaces of the rule
+    must already be populated. The packed copy of the 
+    surfaces is built in slot order.
+    \param HR :: HeadRule to compile
+  */
+{
+  clear();
+  if (HR.hasRule())
+    entry=compileRule(HR.getTopRule(),trueExit,falseExit);
+  for(const Geometry::Surface* SPtr : slotSurf)
+    SPack.addSurface(SPtr);
+  compiled=1;
+  return;
+}
+
+int
+RuleProgram::surfSide(const RuleInst& RI,const Geometry::Vec3D& Pt,
+		      MonteCarlo::SurfSideCache* CPtr) const
+  /*!
+    Calculate the side of the surface. Planes are always
+    evaluated directly as they are cheaper than the cache lookup.
+    \param RI :: Instruction [op 0/1]
+    \param Pt :: Point to test
+    \param CPtr :: Side cache [if not null]
+    \return -1/0/1 as Surface::side
+  */
+{
+  if (RI.op==0)
+    {
+      const Geometry::Vec3D& N=RI.PPtr->getNormal();
+      const double Dp=N.X()*Pt.X()+N.Y()*Pt.Y()+N.Z()*Pt.Z()-
+	RI.PPtr->getDistance();
+      if (Geometry::zeroTol<std::abs(Dp))
+	return (Dp>0.0) ? 1 : -1;
+      return 0;
+    }
+  return (CPtr) ? CPtr->side(Pt,RI.SPtr) : RI.SPtr->side(Pt);
+}
+
+bool
+RuleProgram::eval(const Geometry::Vec3D& Pt,const int SN,
+		  const int mode,MonteCarlo::SurfSideCache* CPtr) const
+  /*!
+    Run the program
+    \param Pt :: Point to test
+    \param SN :: Surface to control
+    \param mode :: 0 : no control / 1 : SN is excluded [true]
+                   2 : SN is true/false based on its sign
+    \param CPtr :: Side cache [if not null]
+    \return true if valid
+  */
+{
+  const size_t NProg(Prog.size());
+  const int absSN(std::abs(SN));
+  size_t pc(entry);
+  while(pc<NProg)
+    {
+      const RuleInst& RI(Prog[pc]);
+      bool flag;
+      if (RI.op==2)
+	{
+	  flag=(mode==0) ? RI.RPtr->isValid(Pt) :
+	    ((mode==1) ? RI.RPtr->isValid(Pt,SN) :
+	     RI.RPtr->isDirectionValid(Pt,SN));
+	}
+      else if (mode && RI.keyN==absSN)
+	flag=(mode==1) ? 1 : (RI.sign*SN>0);
+      else
+	flag=(surfSide(RI,Pt,CPtr)*RI.sign>=0);
+
+      pc=(flag) ? RI.onTrue : RI.onFalse;
+    }
+  return (pc==trueExit);
+}
+
+bool
+RuleProgram::isValid(const Geometry::Vec3D& Pt) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \return true/false
+  */
+{
+  return eval(Pt,0,0,0);
+}
+
+bool
+RuleProgram::isValid(const Geometry::Vec3D& Pt,const int ExSN) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \param ExSN :: Surface to treat as valid
+    \return true/false
+  */
+{
+  return eval(Pt,ExSN,1,0);
+}
+
+bool
+RuleProgram::isDirectionValid(const Geometry::Vec3D& Pt,
+			      const int ExSN) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \param ExSN :: Surface to treat as true/false [based on sign]
+    \return true/false
+  */
+{
+  return eval(Pt,ExSN,2,0);
+}
+
+bool
+RuleProgram::isValid(const Geometry::Vec3D& Pt,
+		     const std::set<int>& ExSN) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \param ExSN :: Surfaces to treat as valid
+    \return true/false
+  */
+{
+  const size_t NProg(Prog.size());
+  size_t pc(entry);
+  while(pc<NProg)
+    {
+      const RuleInst& RI(Prog[pc]);
+      bool flag;
+      if (RI.op==2)
+	flag=RI.RPtr->isValid(Pt,ExSN);
+      else if (ExSN.find(RI.keyN)!=ExSN.end())
+	flag=1;
+      else
+	flag=(surfSide(RI,Pt,0)*RI.sign>=0);
+
+      pc=(flag) ? RI.onTrue : RI.onFalse;
+    }
+  return (pc==trueExit);
+}
+
+int
+RuleProgram::pairValid(const int SN,const Geometry::Vec3D& Pt) const
+  /*!
+    Calculate the validity of the point with the
+    surface SN set false/true
+    \param SN :: Surface number
+    \param Pt :: Point to test
+    \retval 0 : Not valid [SN true/false]
+    \retval 1 : valid [SN false only]
+    \retval 2 : valid [SN true only]
+    \retval 3 : valid [SN true/false]
+  */
+{
+  const int absSN(std::abs(SN));
+  int out=(eval(Pt,-absSN,2,0)) ? 1 : 0;
+  if (eval(Pt,absSN,2,0)) out+=2;
+  return out;
+}
+
+bool
+RuleProgram::isValid(const Geometry::Vec3D& Pt,
+		     MonteCarlo::SurfSideCache& Cache) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \param Cache :: Surface side cache
+    \return true/false
+  */
+{
+  return eval(Pt,0,0,&Cache);
+}
+
+bool
+RuleProgram::isDirectionValid(const Geometry::Vec3D& Pt,const int ExSN,
+			      MonteCarlo::SurfSideCache& Cache) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \param ExSN :: Surface to treat as true/false [based on sign]
+    \param Cache :: Surface side cache
+    \return true/false
+  */
+{
+  return eval(Pt,ExSN,2,&Cache);
+}
+
+int
+RuleProgram::pairValid(const int SN,const Geometry::Vec3D& Pt,
+		       MonteCarlo::SurfSideCache& Cache) const
+  /*!
+    Calculate the validity of the point with the
+    surface SN set false/true
+    \param SN :: Surface number
+    \param Pt :: Point to test
+    \param Cache :: Surface side cache
+    \return 0-3 as pairValid(SN,Pt)
+  */
+{
+  const int absSN(std::abs(SN));
+  int out=(eval(Pt,-absSN,2,&Cache)) ? 1 : 0;
+  if (eval(Pt,absSN,2,&Cache)) out+=2;
+  return out;
+}
+
+bool
+RuleProgram::isValid(const Geometry::Vec3D& Pt,
+		     const std::vector<int>& SideVec,
+		     const size_t stride,const size_t index) const
+  /*!
+    Calculate if a point is valid using precalculated
+    surface sides.
+    \param Pt :: Point [for rule fallback]
+    \param SideVec :: Sides of the surfaces [slot*stride+index]
+    \param stride :: Step between slots
+    \param index :: Offset of the point
+    \return true/false
+  */
+{
+  const size_t NProg(Prog.size());
+  size_t pc(entry);
+  while(pc<NProg)
+    {
+      const RuleInst& RI(Prog[pc]);
+      const bool flag=(RI.op==2) ? RI.RPtr->isValid(Pt) :
+	(SideVec[RI.slot*stride+index]*RI.sign>=0);
+      pc=(flag) ? RI.onTrue : RI.onFalse;
+    }
+  return (pc==trueExit);
+}
+
+void
+RuleProgram::isValid(const std::vector<Geometry::Vec3D>& Pts,
+		     std::vector<int>& Out) const
+  /*!
+    Calculate if a set of points are valid. The surface
+    sides are calculated for all points in a single pass
+    over each surface.
+    \param Pts :: Points to test
+    \param Out :: Validity of each point [1/0]
+  */
+{
+  const size_t nPts(Pts.size());
+  std::vector<int> SideVec;
+  SPack.sideMatrix(Pts,SideVec);
+
+  Out.resize(nPts);
+  for(size_t i=0;i<nPts;i++)
+    Out[i]=(isValid(Pts[i],SideVec,nPts,i)) ? 1 : 0;
+  return;
+}
@@ -0,0 +1,202 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   monte/SurfSideCache.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Surface.h"
+#include "SurfSideCache.h"
+
+namespace MonteCarlo
+{
+
+thread_local size_t SurfSideCache::totalHit(0);
+thread_local size_t SurfSideCache::totalMiss(0);
+
+void
+SurfSideCache::resetTotals()
+  /*!
+    Zero the global counters
+  */
+{
+  totalHit=0;
+  totalMiss=0;
+  return;
+}
+
+void
+SurfSideCache::writeTotals(std::ostream& OX)
+  /*!
+    Write the global counters
+    \param OX :: Output stream
+  */
+{
+  const size_t N(totalHit+totalMiss);
+  OX<<"Surface side cache : hits "<<totalHit<<" / "<<N;
+  if (N)
+    OX<<" ["<<(100.0*static_cast<double>(totalHit))/
+      static_cast<double>(N)<<"%]";
+  return;
+}
+
+SurfSideCache::SurfSideCache() :
+  validPoint(0),genN(1),nSurf(0),SurfList(),SideList(),GenList(),
+  nHit(0),nMiss(0)
+  /*!
+    Constructor [table is zeroed : generation 0 is never current]
+  */
+{}
+
+SurfSideCache::SurfSideCache(const SurfSideCache& A) :
+  validPoint(A.validPoint),Pt(A.Pt),genN(A.genN),nSurf(A.nSurf),
+  nHit(0),nMiss(0)
+  /*!
+    Copy constructor [counters are not copied]
+    \param A :: SurfSideCache to copy
+  */
+{
+  std::copy(A.SurfList,A.SurfList+maxSurf,SurfList);
+  std::copy(A.SideList,A.SideList+maxSurf,SideList);
+  std::copy(A.GenList,A.GenList+maxSurf,GenList);
+}
+
+SurfSideCache&
+SurfSideCache::operator=(const SurfSideCache& A)
+  /*!
+    Assignment operator [counters are not copied]
+    \param A :: SurfSideCache to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      validPoint=A.validPoint;
+      Pt=A.Pt;
+      genN=A.genN;
+      nSurf=A.nSurf;
+      std::copy(A.SurfList,A.SurfList+maxSurf,SurfList);
+      std::copy(A.SideList,A.SideList+maxSurf,SideList);
+      std::copy(A.GenList,A.GenList+maxSurf,GenList);
+    }
+  return *this;
+}
+
+void
+SurfSideCache::clear()
+  /*!
+    Remove the point and the memo
+  */
+{
+  validPoint=0;
+  genN++;
+  nSurf=0;
+  return;
+}
+
+void
+SurfSideCache::setPoint(const Geometry::Vec3D& A)
+  /*!
+    Set the current point : moves to a new generation if the
+    point has changed [exact comparison]
+    \param A :: New point
+  */
+{
+  if (!validPoint || A.X()!=Pt.X() ||
+      A.Y()!=Pt.Y() || A.Z()!=Pt.Z())
+    {
+      genN++;
+      nSurf=0;
+      Pt=A;
+      validPoint=1;
+    }
+  return;
+}
+
+int
+SurfSideCache::side(const Geometry::Vec3D& A,
+		    const Geometry::Surface* SPtr)
+  /*!
+    Get the side of a surface at the point
+    \param A :: Point to test
+    \param SPtr :: Surface
+    \return Surface::side value
+  */
+{
+  setPoint(A);
+
+  const std::uintptr_t key(reinterpret_cast<std::uintptr_t>(SPtr));
+  size_t index((key>>4 ^ key>>10) & (maxSurf-1));
+  while(GenList[index]==genN)
+    {
+      if (SurfList[index]==SPtr)
+	{
+	  nHit++;
+	  totalHit++;
+	  return SideList[index];
+	}
+      index=(index+1) & (maxSurf-1);
+    }
+  nMiss++;
+  totalMiss++;
+  const int S=SPtr->side(A);
+  // keep one entry free so the probe always stops
+  if (nSurf+1<maxSurf)
+    {
+      SurfList[index]=SPtr;
+      SideList[index]=S;
+      GenList[index]=genN;
+      nSurf++;
+    }
+  return S;
+}
+
+double
+SurfSideCache::hitRatio() const
+  /*!
+    Calculate the fraction of side calls that hit
+    \return hit fraction [0 if no calls]
+  */
+{
+  const size_t N(nHit+nMiss);
+  return (N) ? static_cast<double>(nHit)/static_cast<double>(N) : 0.0;
+}
+
+}  // NAMESPACE MonteCarlo
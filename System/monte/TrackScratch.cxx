@@ -0,0 +1,548 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   monte/TrackScratch.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <list>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <complex>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "mathSupport.h"
+#include "polySupport.h"
+#include "Triple.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Quaternion.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "Surface.h"
+#include "Quadratic.h"
+#include "ArbPoly.h"
+#include "Cone.h"
+#include "CylCan.h"
+#include "Cylinder.h"
+#include "EllipticCyl.h"
+#include "General.h"
+#include "MBrect.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include "Torus.h"
+#include "Line.h"
+#include "neutron.h"
+#include "TrackScratch.h"
+
+namespace MonteCarlo
+{
+
+TrackScratch::SKind
+TrackScratch::surfKind(const Geometry::Surface* SPtr)
+  /*!
+    Determine the intersect kernel to use for a surface.
+    EllipticCyl is a quadratic but has its own line intersect
+    so is visited.
+    \param SPtr :: Surface
+    \return kind of surface
+  */
+{
+  if (dynamic_cast<const Geometry::Plane*>(SPtr))
+    return SKind::plane;
+  if (dynamic_cast<const Geometry::Sphere*>(SPtr))
+    return SKind::sphere;
+  if (dynamic_cast<const Geometry::Cylinder*>(SPtr))
+    return SKind::cylinder;
+  if (dynamic_cast<const Geometry::Cone*>(SPtr))
+    return SKind::cone;
+  if (dynamic_cast<const Geometry::EllipticCyl*>(SPtr))
+    return SKind::other;
+  if (dynamic_cast<const Geometry::Quadratic*>(SPtr))
+    return SKind::quadratic;
+  return SKind::other;
+}
+
+TrackScratch::TrackScratch() :
+  Global::BaseVisit()
+  /*!
+    Constructor
+  */
+{}
+
+TrackScratch::TrackScratch(const TrackScratch& A) :
+  Global::BaseVisit(A),ATrack(A.ATrack),
+  PtOut(A.PtOut),DOut(A.DOut),SurfOut(A.SurfOut)
+  /*!
+    Copy constructor
+    \param A :: TrackScratch to copy
+  */
+{}
+
+TrackScratch&
+TrackScratch::operator=(const TrackScratch& A)
+  /*!
+    Assignment operator
+    \param A :: TrackScratch to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      ATrack=A.ATrack;
+      PtOut=A.PtOut;
+      DOut=A.DOut;
+      SurfOut=A.SurfOut;
+    }
+  return *this;
+}
+
+void
+TrackScratch::setLine(const Geometry::Vec3D& Pt,
+		      const Geometry::Vec3D& uVec)
+  /*!
+    Set a new track and clear the intercepts.
+    The buffers keep their capacity.
+    \param Pt :: Origin of track
+    \param uVec :: Track direction
+  */
+{
+  ATrack=Geometry::Line(Pt,uVec);
+  clearTrack();
+  return;
+}
+
+void
+TrackScratch::setLine(const MonteCarlo::neutron& N)
+  /*!
+    Set a new track from a neutron and clear the intercepts
+    \param N :: Neutron to track
+  */
+{
+  setLine(N.Pos,N.uVec);
+  return;
+}
+
+void
+TrackScratch::clearTrack()
+  /*!
+    Remove the intercepts but keep the buffer capacity
+  */
+{
+  PtOut.clear();
+  DOut.clear();
+  SurfOut.clear();
+  return;
+}
+
+void
+TrackScratch::procTrack(const Geometry::Surface* SPtr)
+  /*!
+    Add the distances/surface for the new points
+    \param SPtr :: Surface of the new points
+  */
+{
+  const Geometry::Vec3D& O=ATrack.getOrigin();
+  const Geometry::Vec3D& D=ATrack.getDirect();
+  for(size_t i=DOut.size();i<PtOut.size();i++)
+    {
+      DOut.push_back((PtOut[i]-O).dotProd(D));
+      SurfOut.push_back(SPtr);
+    }
+  return;
+}
+
+void
+TrackScratch::addRoots(const Geometry::Surface* SPtr,const size_t ix,
+		       const std::pair<std::complex<double>,
+		       std::complex<double> >& SQ)
+  /*!
+    Add the real roots of a quadratic in lambda as points
+    [closest first]. Follows Line::lambdaPair.
+    \param SPtr :: Surface
+    \param ix :: Number of solutions
+    \param SQ :: Solutions
+  */
+{
+  if (ix<1) return;
+
+  int nCnt(0);
+  double lambdaA(0.0),lambdaB(0.0);
+  if (std::abs(SQ.first.imag())<1e-38)
+    {
+      lambdaA=SQ.first.real();
+      nCnt=1;
+    }
+  if (ix==2 && std::abs(SQ.second.imag())<1e-38)
+    {
+      lambdaB=SQ.second.real();
+      nCnt+=2;
+    }
+  if (nCnt==1)
+    PtOut.push_back(ATrack.getPoint(lambdaA));
+  else if (nCnt==2)
+    PtOut.push_back(ATrack.getPoint(lambdaB));
+  else if (nCnt==3)
+    {
+      if (lambdaA>lambdaB)
+	std::swap(lambdaA,lambdaB);
+      PtOut.push_back(ATrack.getPoint(lambdaA));
+      PtOut.push_back(ATrack.getPoint(lambdaB));
+    }
+  procTrack(SPtr);
+  return;
+}
+
+void
+TrackScratch::intersectPlane(const Geometry::Plane& Pln)
+  /*!
+    Line-plane intersect
+    \param Pln :: Plane
+  */
+{
+  const Geometry::Vec3D& N=Pln.getNormal();
+  const double DdotN=ATrack.getDirect().dotProd(N);
+  if (std::abs(DdotN)<Geometry::parallelTol)
+    return;
+  const double OdotN=ATrack.getOrigin().dotProd(N);
+  PtOut.push_back(ATrack.getPoint((Pln.getDistance()-OdotN)/DdotN));
+  procTrack(&Pln);
+  return;
+}
+
+void
+TrackScratch::intersectSphere(const Geometry::Sphere& Sph)
+  /*!
+    Line-sphere intersect
+    \param Sph :: Sphere
+  */
+{
+  const Geometry::Vec3D Ax=ATrack.getOrigin()-Sph.getCentre();
+  const double R=Sph.getRadius();
+  double C[3];
+  C[0]=1;
+  C[1]=2.0*Ax.dotProd(ATrack.getDirect());
+  C[2]=Ax.dotProd(Ax)-R*R;
+  std::pair<std::complex<double>,std::complex<double> > SQ;
+  const size_t ix=solveQuadratic(C,SQ);
+  addRoots(&Sph,ix,SQ);
+  return;
+}
+
+void
+TrackScratch::intersectCylinder(const Geometry::Cylinder& Cyl)
+  /*!
+    Line-cylinder intersect
+    \param Cyl :: Cylinder
+  */
+{
+  const Geometry::Vec3D& Dir=ATrack.getDirect();
+  const Geometry::Vec3D Ax=ATrack.getOrigin()-Cyl.getCentre();
+  const Geometry::Vec3D N=Cyl.getNormal();
+  const double R=Cyl.getRadius();
+  const double vDn=N.dotProd(Dir);
+  const double vDA=N.dotProd(Ax);
+
+  double C[3];
+  C[0]=1.0-(vDn*vDn);
+  C[1]=2.0*(Ax.dotProd(Dir)-vDA*vDn);
+  C[2]=Ax.dotProd(Ax)-(R*R+vDA*vDA);
+  std::pair<std::complex<double>,std::complex<double> > SQ;
+  const size_t ix=solveQuadratic(C,SQ);
+  addRoots(&Cyl,ix,SQ);
+  return;
+}
+
+void
+TrackScratch::intersectCone(const Geometry::Cone& CObj)
+  /*!
+    Line-cone intersect : roots are removed if on the cut
+    side of the cone [Line::intersect(Cone)]
+    \param CObj :: Cone
+  */
+{
+  const Geometry::Vec3D& Dir=ATrack.getDirect();
+  const Geometry::Vec3D V=CObj.getCentre();
+  const Geometry::Vec3D A=CObj.getNormal();
+
+  const Geometry::Vec3D b=ATrack.getOrigin()-V;
+  const double AdotN=A.dotProd(Dir);
+  const double AdotB=A.dotProd(b);
+  const double BdotN=b.dotProd(Dir);
+  const double gamma2=CObj.getCosAngle()*CObj.getCosAngle();
+
+  double C[3];
+  C[0]=AdotN*AdotN-gamma2;
+  C[1]=2.0*(AdotB*AdotN-gamma2*BdotN);
+  C[2]=AdotB*AdotB-gamma2*b.dotProd(b);
+  std::pair<std::complex<double>,std::complex<double> > SQ;
+  const size_t ix=solveQuadratic(C,SQ);
+
+  const size_t nStart(PtOut.size());
+  addRoots(&CObj,ix,SQ);
+  const int cF=CObj.getCutFlag();
+  if (!cF) return;
+
+  // remove roots on the wrong nappe [keeping order]
+  size_t nOut(nStart);
+  for(size_t i=nStart;i<PtOut.size();i++)
+    {
+      if (cF*A.dotProd(PtOut[i]-V)>0.0)
+	{
+	  PtOut[nOut]=PtOut[i];
+	  DOut[nOut]=DOut[i];
+	  nOut++;
+	}
+    }
+  PtOut.resize(nOut);
+  DOut.resize(nOut);
+  SurfOut.resize(nOut);
+  return;
+}
+
+void
+TrackScratch::intersectQuadratic(const Geometry::Quadratic& Sur)
+  /*!
+    Line-general quadratic intersect
+    \param Sur :: Quadratic surface
+  */
+{
+  const std::vector<double>& BN=Sur.copyBaseEqn();
+  const Geometry::Vec3D& O=ATrack.getOrigin();
+  const Geometry::Vec3D& Dir=ATrack.getDirect();
+  const double a(O[0]),b(O[1]),c(O[2]);
+  const double d(Dir[0]),e(Dir[1]),f(Dir[2]);
+  double Coef[3];
+  Coef[0] = BN[0]*d*d+BN[1]*e*e+BN[2]*f*f+
+    BN[3]*d*e+BN[4]*d*f+BN[5]*e*f;
+  Coef[1] = 2*BN[0]*a*d+2*BN[1]*b*e+2*BN[2]*c*f+
+    BN[3]*(a*e+b*d)+BN[4]*(a*f+c*d)+BN[5]*(b*f+c*e)+
+    BN[6]*d+BN[7]*e+BN[8]*f;
+  Coef[2] = BN[0]*a*a+BN[1]*b*b+BN[2]*c*c+
+    BN[3]*a*b+BN[4]*a*c+BN[5]*b*c+BN[6]*a+BN[7]*b+
+    BN[8]*c+BN[9];
+
+  std::pair<std::complex<double>,std::complex<double> > SQ;
+  const size_t ix=solveQuadratic(Coef,SQ);
+  addRoots(&Sur,ix,SQ);
+  return;
+}
+
+void
+TrackScratch::addSurface(const Geometry::Surface* SPtr,const SKind SK)
+  /*!
+    Add the intercepts of a surface with a known kind
+    \param SPtr :: Surface
+    \param SK :: Kind of surface [from surfKind]
+  */
+{
+  switch (SK)
+    {
+    case SKind::plane:
+      intersectPlane(*static_cast<const Geometry::Plane*>(SPtr));
+      return;
+    case SKind::sphere:
+      intersectSphere(*static_cast<const Geometry::Sphere*>(SPtr));
+      return;
+    case SKind::cylinder:
+      intersectCylinder(*static_cast<const Geometry::Cylinder*>(SPtr));
+      return;
+    case SKind::cone:
+      intersectCone(*static_cast<const Geometry::Cone*>(SPtr));
+      return;
+    case SKind::quadratic:
+      intersectQuadratic(*static_cast<const Geometry::Quadratic*>(SPtr));
+      return;
+    default:
+      SPtr->acceptVisitor(*this);
+    }
+  return;
+}
+
+void
+TrackScratch::addSurface(const Geometry::Surface* SPtr)
+  /*!
+    Add the intercepts of a surface
+    \param SPtr :: Surface
+  */
+{
+  addSurface(SPtr,surfKind(SPtr));
+  return;
+}
+
+void
+TrackScratch::addSurfaces(const std::vector<const Geometry::Surface*>& SVec,
+			  const std::vector<int>& KVec)
+  /*!
+    Add the intercepts of a set of surfaces
+    \param SVec :: Surfaces
+    \param KVec :: Kinds of the surfaces [as int : same size as SVec]
+  */
+{
+  for(size_t i=0;i<SVec.size();i++)
+    addSurface(SVec[i],static_cast<SKind>(KVec[i]));
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::Surface&)
+  /*!
+    Process an intersect track
+    \throw AbsObjMethod [always]
+  */
+{
+  throw ColErr::AbsObjMethod("TrackScratch::Accept Surface");
+}
+
+void
+TrackScratch::Accept(const Geometry::Quadratic& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  intersectQuadratic(Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::ArbPoly& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  ATrack.intersect(PtOut,Surf);
+  procTrack(&Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::Cone& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  intersectCone(Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::CylCan& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  ATrack.intersect(PtOut,Surf);
+  procTrack(&Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::Cylinder& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  intersectCylinder(Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::EllipticCyl& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  ATrack.intersect(PtOut,Surf);
+  procTrack(&Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::General& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  intersectQuadratic(Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::MBrect& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  ATrack.intersect(PtOut,Surf);
+  procTrack(&Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::Plane& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  intersectPlane(Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::Sphere& Surf)
+  /*!
+    Process an intersect track
+    \param Surf :: Surface to intersect
+  */
+{
+  intersectSphere(Surf);
+  return;
+}
+
+void
+TrackScratch::Accept(const Geometry::Torus&)
+  /*!
+    Process an intersect track
+    \throw AbsObjMethod [always]
+  */
+{
+  throw ColErr::AbsObjMethod("TrackScratch::Accept Torus");
+}
+
+} // NAMESPACE MonteCarlo
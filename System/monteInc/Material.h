@@ -101,6 +101,8 @@ class Material
 		 const std::string&);
   /// Get atomic density
   double getAtomDensity() const { return atomDensity; }
+  /// Get the zaid/fraction list
+  const std::vector<Zaid>& getZaidVec() const { return zaidVec; }
   double getMacroDensity() const;
   double getMeanA() const;
   void setENDF7();
@@ -23,10 +23,14 @@
 #define MonteCarlo_Object_h
 
 class Token;
+class RuleProgram;
 
 namespace MonteCarlo
 {
   class neutron;
+  class SurfSideCache;
+  class TrackScratch;
+  class QueryContext;
 
 /*!
   \class Object
@@ -56,6 +60,7 @@ class Object
   int populated;     ///< Full population
 
   HeadRule HRule;    ///< Top rule
+  RuleProgram* HProg;   ///< Compiled form of HRule [if built]
   /// Set of surfaces that are logically opposite in the rule.
   std::set<const Geometry::Surface*> logicOppSurf;
  
@@ -63,6 +68,7 @@ class Object
   int checkExteriorValid(const Geometry::Vec3D&,const Geometry::Vec3D&) const;
   /// Calc in/out 
   int calcInOut(const int,const int) const;
+  void trackSurfaces(TrackScratch&) const;
 
  protected:
   
@@ -70,6 +76,7 @@ class Object
 
   /// Full surfaces (make a map including complementary object ?)
   std::vector<const Geometry::Surface*> SurList;  
+  std::vector<int> SurKind;          ///< Intercept kind of SurList items
   std::set<int> SurSet;              ///< set of surfaces in cell [signed]
 
   int trackDirection(const Geometry::Vec3D&,const Geometry::Vec3D&) const;
@@ -126,10 +133,12 @@ class Object
   
   int populate();
   int createSurfaceList();
+  void updateProgram();
   void createLogicOpp();
   int isObjSurfValid() const { return objSurfValid; }  ///< Check validity needed
   void setObjSurfValid()  { objSurfValid=1; }          ///< set as valid
   int addSurfString(const std::string&);   
+  int addIntersection(const HeadRule&);
   int removeSurface(const int);        
   int substituteSurf(const int,const int,Geometry::Surface*);  
   void makeComplement();
@@ -139,8 +148,13 @@ class Object
   int isValid(const Geometry::Vec3D&,const int) const;            
   int isDirectionValid(const Geometry::Vec3D&,const int) const;            
   int isValid(const Geometry::Vec3D&,const std::set<int>&) const;            
+  int isValid(const Geometry::Vec3D&,SurfSideCache&) const;
+  int isDirectionValid(const Geometry::Vec3D&,const int,
+		       SurfSideCache&) const;
   int pairValid(const int,const Geometry::Vec3D&) const;   
-  int isValid(const std::map<int,int>&) const; 
+  int isValid(const std::map<int,int>&) const;
+  void isValid(const std::vector<Geometry::Vec3D>&,
+	       std::vector<int>&) const; 
   std::map<int,int> mapValid(const Geometry::Vec3D&) const;
 
   int isOnSide(const Geometry::Vec3D&) const;
@@ -177,6 +191,17 @@ class Object
 		    const Geometry::Surface*&,const int =0) const;
   int trackOutCell(const MonteCarlo::neutron&,double&,
 		   const Geometry::Surface*&,const int =0) const;
+  int trackCell(TrackScratch&,const MonteCarlo::neutron&,double&,
+		const int,const Geometry::Surface*&,
+		const int) const;
+  int trackIntoCell(TrackScratch&,const MonteCarlo::neutron&,double&,
+		    const Geometry::Surface*&,const int =0) const;
+  int trackOutCell(TrackScratch&,const MonteCarlo::neutron&,double&,
+		   const Geometry::Surface*&,const int =0) const;
+  int trackIntoCell(QueryContext&,const MonteCarlo::neutron&,double&,
+		    const Geometry::Surface*&,const int =0) const;
+  int trackOutCell(QueryContext&,const MonteCarlo::neutron&,double&,
+		   const Geometry::Surface*&,const int =0) const;
 
   // OUTPUT
   std::string cellCompStr() const;
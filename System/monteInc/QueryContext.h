@@ -0,0 +1,115 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   monteInc/QueryContext.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef MonteCarlo_QueryContext_h
+#define MonteCarlo_QueryContext_h
+
+namespace MonteCarlo
+{
+  class Object;
+
+/*!
+  \class QueryContext
+  \brief State of a sequence of geometry queries
+  \author S.Ansell
+  \version 1.0
+  \date October 2017
+
+  Holds the state that a run of findCell / trackOutCell /
+  findNextObject calls carries from one query to the next:
+  the last cell found, the intercept buffers, the surface side
+  cache and counts of the queries. Each thread (or independent
+  tracking loop) owns its own context so the queries do not
+  share any mutable state. The old query signatures use the
+  SimTrack singleton and are kept as wrappers.
+*/
+
+class QueryContext
+{
+ private:
+
+  Object* lastCell;              ///< Last cell found
+  TrackScratch TrackBuffer;      ///< Intercept buffer
+  SurfSideCache SideCache;       ///< Surface side cache
+  
+  size_t nFind;                  ///< Number of findCell calls
+  size_t nTestHit;               ///< Found in the users guess
+  size_t nLastHit;               ///< Found in the last cell
+  size_t nIndexHit;              ///< Found by the cell index
+  size_t nSearch;                ///< Found by full search
+  size_t nTrack;                 ///< Number of cell tracks
+  size_t nNext;                  ///< Number of next object calls
+  size_t nBundleHit;             ///< Next cell from a guide track
+
+ public:
+
+  QueryContext();
+  QueryContext(const QueryContext&);
+  QueryContext& operator=(const QueryContext&);
+  ~QueryContext() {}    ///< Destructor
+
+  void clear();
+  
+  /// Last cell found
+  Object* getLastCell() const { return lastCell; }
+  /// Set the last cell found
+  void setLastCell(Object* OPtr) { lastCell=OPtr; }
+  /// Intercept buffer
+  TrackScratch& getTrackBuffer() { return TrackBuffer; }
+  /// Surface side cache
+  SurfSideCache& getSideCache() { return SideCache; }
+
+  /// Count a findCell call
+  void addFind() { nFind++; }
+  /// Count a hit on the users guess
+  void addTestHit() { nTestHit++; }
+  /// Count a hit on the last cell
+  void addLastHit() { nLastHit++; }
+  /// Count a hit from the cell index
+  void addIndexHit() { nIndexHit++; }
+  /// Count a full search
+  void addSearch() { nSearch++; }
+  /// Count a cell track
+  void addTrack() { nTrack++; }
+  /// Count a next object call
+  void addNext() { nNext++; }
+  /// Count a next cell taken from a guide track
+  void addBundleHit() { nBundleHit++; }
+
+  /// Number of findCell calls
+  size_t getFind() const { return nFind; }
+  /// Number of full searches
+  size_t getSearch() const { return nSearch; }
+  /// Number of tracks
+  size_t getTrack() const { return nTrack; }
+  /// Number of next object calls
+  size_t getNext() const { return nNext; }
+  /// Number of next cells from a guide track
+  size_t getBundleHit() const { return nBundleHit; }
+  
+  void write(std::ostream&) const;
+};
+
+std::ostream& operator<<(std::ostream&,const QueryContext&);
+
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   monteInc/RuleProgram.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef RuleProgram_h
+#define RuleProgram_h
+
+class Rule;
+class HeadRule;
+
+namespace MonteCarlo
+{
+  class SurfSideCache;
+}
+
+namespace Geometry
+{
+  class Surface;
+  class Plane;
+}
+
+/*!
+  \struct RuleInst
+  \brief Single leaf test in a RuleProgram
+  \author S.Ansell
+  \version 1.0
+  \date October 2017
+*/
+
+struct RuleInst
+{
+  int op;                          ///< 0 : plane / 1 : surface / 2 : rule
+  int keyN;                        ///< Surface number [unsigned]
+  int sign;                        ///< Sign of surface in rule
+  const Geometry::Plane* PPtr;     ///< Plane [op==0]
+  const Geometry::Surface* SPtr;   ///< Surface [op==0/1]
+  const Rule* RPtr;                ///< Rule fallback [op==2]
+  size_t slot;                     ///< Surface slot [op==0/1]
+  size_t onTrue;                   ///< Next instruction if true
+  size_t onFalse;                  ///< Next instruction if false
+};
+
+/*!
+  \class RuleProgram
+  \brief Flattened form of a rule tree
+  \author S.Ansell
+  \version 1.0
+  \date October 2017
+
+  The rule tree is compiled into a list of leaf tests,
+  each with a jump target for a true/false result. Intersections
+  and unions become short-circuit jumps and complement groups
+  swap the targets, so evaluation is a single loop without
+  walking the tree. Planes are evaluated inline; other surfaces
+  use side() and complement objects fall back to the rule.
+  Each surface is given a slot so that the program can also be
+  run from sides precalculated by a Geometry::SurfPack, which
+  is built once at compile. Non-plane
+  surfaces can be looked up in a SurfSideCache so a point tested
+  against several cells evaluates each surface once.
+  The program holds pointers to the surfaces of the rule so must
+  be recompiled if the rule is changed or repopulated.
+*/
+
+class RuleProgram
+{
+ private:
+
+  static const size_t trueExit;      ///< Exit flag for true
+  static const size_t falseExit;     ///< Exit flag for false
+
+  int compiled;                      ///< Program is valid
+  size_t entry;                      ///< First instruction
+  std::vector<RuleInst> Prog;        ///< Instructions
+  /// Unique surfaces [by slot]
+  std::vector<const Geometry::Surface*> slotSurf;
+  Geometry::SurfPack SPack;          ///< Packed surfaces [by slot]
+
+  size_t surfSlot(const Geometry::Surface*);
+  size_t compileRule(const Rule*,const size_t,const size_t);
+  size_t addInst(const RuleInst&);
+
+  int surfSide(const RuleInst&,const Geometry::Vec3D&,
+	       MonteCarlo::SurfSideCache*) const;
+  bool eval(const Geometry::Vec3D&,const int,const int,
+	    MonteCarlo::SurfSideCache*) const;
+
+ public:
+
+  RuleProgram();
+  RuleProgram(const RuleProgram&);
+  RuleProgram& operator=(const RuleProgram&);
+  ~RuleProgram() {}       ///< Destructor
+
+  void clear();
+  void compile(const HeadRule&);
+
+  /// Has the program been built
+  int isCompiled() const { return compiled; }
+  /// Number of instructions
+  size_t size() const { return Prog.size(); }
+  /// Surfaces used in the program [by slot]
+  const std::vector<const Geometry::Surface*>& getSurfaces() const
+    { return slotSurf; }
+
+  bool isValid(const Geometry::Vec3D&) const;
+  bool isValid(const Geometry::Vec3D&,const int) const;
+  bool isValid(const Geometry::Vec3D&,const std::set<int>&) const;
+  bool isDirectionValid(const Geometry::Vec3D&,const int) const;
+  int pairValid(const int,const Geometry::Vec3D&) const;
+
+  bool isValid(const Geometry::Vec3D&,MonteCarlo::SurfSideCache&) const;
+  bool isDirectionValid(const Geometry::Vec3D&,const int,
+			MonteCarlo::SurfSideCache&) const;
+  int pairValid(const int,const Geometry::Vec3D&,
+		MonteCarlo::SurfSideCache&) const;
+
+  bool isValid(const Geometry::Vec3D&,const std::vector<int>&,
+	       const size_t,const size_t) const;
+  void isValid(const std::vector<Geometry::Vec3D>&,
+	       std::vector<int>&) const;
+
+};
+
+#endif
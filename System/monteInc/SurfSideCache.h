@@ -0,0 +1,100 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   monteInc/SurfSideCache.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef MonteCarlo_SurfSideCache_h
+#define MonteCarlo_SurfSideCache_h
+
+namespace Geometry
+{
+  class Surface;
+}
+
+namespace MonteCarlo
+{
+
+/*!
+  \class SurfSideCache
+  \brief Memo of surface sides for a single point
+  \author S.Ansell
+  \version 1.0
+  \date October 2017
+
+  Holds the side of each surface evaluated at the current
+  point, so that cells sharing surfaces do not recalculate
+  them. The memo is a fixed open-addressed table keyed on the 
+  surface pointer : each entry is stamped with the generation
+  of the point, so moving to a new point only increments the
+  generation and no memory is allocated. Once the table is full
+  further surfaces are evaluated directly. The hit/miss counts
+  are also added to the totals of the thread.
+*/
+
+class SurfSideCache
+{
+ private:
+
+  static const size_t maxSurf=64;        ///< Table size [power of 2]
+
+  static thread_local size_t totalHit;   ///< Hit count [per thread]
+  static thread_local size_t totalMiss;  ///< Miss count [per thread]
+
+  int validPoint;                  ///< Point has been set
+  Geometry::Vec3D Pt;              ///< Current point
+  size_t genN;                     ///< Generation of the current point
+  size_t nSurf;                    ///< Number of surfaces at Pt
+
+  /// Surfaces in the table
+  const Geometry::Surface* SurfList[maxSurf];
+  int SideList[maxSurf];           ///< Side of each surface at Pt
+  size_t GenList[maxSurf];         ///< Generation of each entry
+
+  size_t nHit;                     ///< Number of hits
+  size_t nMiss;                    ///< Number of misses
+
+ public:
+
+  static void resetTotals();
+  static void writeTotals(std::ostream&);
+  /// Global number of hits
+  static size_t getTotalHit() { return totalHit; }
+  /// Global number of misses
+  static size_t getTotalMiss() { return totalMiss; }
+
+  SurfSideCache();
+  SurfSideCache(const SurfSideCache&);
+  SurfSideCache& operator=(const SurfSideCache&);
+  ~SurfSideCache() {}   ///< Destructor
+
+  void clear();
+  void setPoint(const Geometry::Vec3D&);
+  int side(const Geometry::Vec3D&,const Geometry::Surface*);
+
+  /// Number of hits
+  size_t getHit() const { return nHit; }
+  /// Number of misses
+  size_t getMiss() const { return nMiss; }
+  double hitRatio() const;
+
+};
+
+}
+
+#endif
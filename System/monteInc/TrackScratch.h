@@ -0,0 +1,132 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   monteInc/TrackScratch.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef MonteCarlo_TrackScratch_h
+#define MonteCarlo_TrackScratch_h
+
+namespace Geometry
+{
+  class Surface;
+  class Quadratic;
+  class Plane;
+  class Sphere;
+  class Cylinder;
+  class Cone;
+}
+
+namespace MonteCarlo
+{
+  class neutron;
+
+/*!
+  \class TrackScratch
+  \brief Line-surface intersection with reusable buffers
+  \author S.Ansell
+  \version 1.0
+  \date October 2017
+
+  Replacement for LineIntersectVisit in the tracking loops.
+  Each surface is given a kind [surfKind] once and the intersect
+  is dispatched on that kind to an inline kernel for planes,
+  spheres, cylinders, cones and general quadratics. Other
+  surfaces are visited as in LineIntersectVisit. The output
+  buffers are kept between tracks so a scratch owned by the
+  caller does no heap allocation once it has grown.
+  Points and distances are identical to LineIntersectVisit.
+*/
+
+class TrackScratch : public Global::BaseVisit
+{
+ public:
+
+  /// Kind of surface for the intersect dispatch
+  enum class SKind : int
+  { plane=0,sphere=1,cylinder=2,cone=3,quadratic=4,other=5 };
+
+ private:
+
+  Geometry::Line ATrack;                      ///< Track
+  std::vector<Geometry::Vec3D> PtOut;         ///< Output points
+  std::vector<double> DOut;                   ///< Output distances
+  /// Output surfaces
+  std::vector<const Geometry::Surface*> SurfOut;
+
+  void addRoots(const Geometry::Surface*,const size_t,
+		const std::pair<std::complex<double>,
+		std::complex<double> >&);
+  void procTrack(const Geometry::Surface*);
+
+  void intersectPlane(const Geometry::Plane&);
+  void intersectSphere(const Geometry::Sphere&);
+  void intersectCylinder(const Geometry::Cylinder&);
+  void intersectCone(const Geometry::Cone&);
+  void intersectQuadratic(const Geometry::Quadratic&);
+
+ public:
+
+  static SKind surfKind(const Geometry::Surface*);
+
+  TrackScratch();
+  TrackScratch(const TrackScratch&);
+  TrackScratch& operator=(const TrackScratch&);
+  virtual ~TrackScratch() {}   ///< Destructor
+
+  void setLine(const Geometry::Vec3D&,const Geometry::Vec3D&);
+  void setLine(const MonteCarlo::neutron&);
+  void clearTrack();
+
+  void addSurface(const Geometry::Surface*,const SKind);
+  void addSurface(const Geometry::Surface*);
+  void addSurfaces(const std::vector<const Geometry::Surface*>&,
+		   const std::vector<int>&);
+
+  /// \cond TABLE
+  virtual void Accept(const Geometry::Surface&);
+  virtual void Accept(const Geometry::Quadratic&);
+  virtual void Accept(const Geometry::ArbPoly&);
+  virtual void Accept(const Geometry::Cone&);
+  virtual void Accept(const Geometry::CylCan&);
+  virtual void Accept(const Geometry::Cylinder&);
+  virtual void Accept(const Geometry::EllipticCyl&);
+  virtual void Accept(const Geometry::General&);
+  virtual void Accept(const Geometry::MBrect&);
+  virtual void Accept(const Geometry::Plane&);
+  virtual void Accept(const Geometry::Sphere&);
+  virtual void Accept(const Geometry::Torus&);
+  /// \endcond TABLE
+
+  /// Track line
+  const Geometry::Line& getTrack() const { return ATrack; }
+  /// Number of intercepts
+  size_t size() const { return DOut.size(); }
+  /// Intercept points
+  const std::vector<Geometry::Vec3D>& getPoints() const { return PtOut; }
+  /// Intercept distances
+  const std::vector<double>& getDistance() const { return DOut; }
+  /// Intercept surfaces
+  const std::vector<const Geometry::Surface*>& getSurfIndex() const
+    { return SurfOut; }
+
+};
+
+}
+
+#endif
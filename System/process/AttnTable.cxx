@@ -0,0 +1,164 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   process/AttnTable.cxx
+ *
+ * Copyright (c) 2004-2016 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <cmath>
+#include <complex> 
+#include <vector>
+#include <set> 
+#include <map> 
+#include <string>
+#include <algorithm>
+#include <memory>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "Zaid.h"
+#include "MXcards.h"
+#include "Material.h"
+#include "DBMaterial.h"
+#include "AttnTable.h"
+
+namespace ModelSupport
+{
+
+AttnTable::AttnTable() :
+  NE(0)
+  /*! 
+    Constructor 
+  */
+{}
+
+AttnTable::AttnTable(const AttnTable& A) :
+  NE(A.NE),matSlot(A.matSlot),Sigma(A.Sigma)
+   /*! 
+    Copy Constructor 
+    \param A :: AttnTable to copy
+  */
+{}
+
+AttnTable&
+AttnTable::operator=(const AttnTable& A) 
+   /*! 
+     Assignment operator
+    \param A :: AttnTable to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      NE=A.NE;
+      matSlot=A.matSlot;
+      Sigma=A.Sigma;
+    }
+  return *this;
+}
+
+void
+AttnTable::build(const size_t nBin)
+  /*!
+    Build the table with no energy dependence
+    \param nBin :: Number of energy bins
+  */
+{
+  build(std::vector<double>(nBin,1.0));
+  return;
+}
+
+void
+AttnTable::build(const std::vector<double>& EScale)
+  /*!
+    Build the table from all the materials in DBMaterial
+    \param EScale :: Scale factor for each energy bin
+  */
+{
+  ELog::RegMethod RegA("AttnTable","build");
+
+  const ModelSupport::DBMaterial& DB=
+    ModelSupport::DBMaterial::Instance();
+  const std::map<int,MonteCarlo::Material>& MStore=DB.getStore();
+
+  NE=EScale.size();
+  matSlot.clear();
+  // slot 0 is for materials not in the table
+  Sigma.assign(NE,0.0);
+  if (!NE) return;
+  
+  if (!MStore.empty() && MStore.rbegin()->first>0)
+    matSlot.resize(static_cast<size_t>(MStore.rbegin()->first+1),0);
+  
+  for(const std::map<int,MonteCarlo::Material>::value_type& MV : MStore)
+    if (MV.first>0)
+      {
+	const MonteCarlo::Material& matInfo=MV.second;
+	const double density=matInfo.getAtomDensity();
+	const double AMean=matInfo.getMeanA();
+	const double SV=std::pow(AMean,0.66)*density;
+	matSlot[static_cast<size_t>(MV.first)]=Sigma.size()/NE;
+	for(const double ES : EScale)
+	  Sigma.push_back(SV*ES);
+      }
+  return;
+}
+
+const double*
+AttnTable::getSigma(const int matN) const
+  /*!
+    Get the factors of a material
+    \param matN :: Material number
+    \return pointer to NE factors
+  */
+{
+  const size_t index((matN>0) ? static_cast<size_t>(matN) : 0);
+  if (index>=matSlot.size() || !matSlot[index] || !NE)
+    {
+      ELog::RegMethod RegA("AttnTable","getSigma");
+      throw ColErr::InContainerError<int>(matN,"matN in AttnTable");
+    }
+  return &Sigma[matSlot[index]*NE];
+}
+
+double
+AttnTable::getSigma(const int matN,const size_t eIndex) const
+  /*!
+    Get the factor of a material
+    \param matN :: Material number
+    \param eIndex :: Energy bin
+    \return factor
+  */
+{
+  if (eIndex>=NE)
+    {
+      ELog::RegMethod RegA("AttnTable","getSigma(eIndex)");
+      throw ColErr::IndexError<size_t>(eIndex,NE,"eIndex");
+    }
+  return getSigma(matN)[eIndex];
+}
+
+} // Namespace ModelSupport
@@ -62,6 +62,10 @@
 #include "Algebra.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "Line.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "Qhull.h"
 #include "ObjSurfMap.h"
 #include "Zaid.h"
@@ -104,7 +108,7 @@ LineTrack::LineTrack(const Geometry::Vec3D& IP,
 
 LineTrack::LineTrack(const LineTrack& A) : 
   InitPt(A.InitPt),EndPt(A.EndPt),aimDist(A.aimDist),TDist(A.TDist),
-  Cells(A.Cells),ObjVec(A.ObjVec),Track(A.Track)
+  Cells(A.Cells),ObjVec(A.ObjVec),Track(A.Track),SurfN(A.SurfN)
   /*!
     Copy constructor
     \param A :: LineTrack to copy
@@ -123,7 +127,9 @@ LineTrack::operator=(const LineTrack& A)
     {
       TDist=A.TDist;
       Cells=A.Cells;
+      ObjVec=A.ObjVec;
       Track=A.Track;
+      SurfN=A.SurfN;
     }
   return *this;
 }
@@ -138,6 +144,7 @@ LineTrack::clearAll()
   Cells.clear();
   ObjVec.clear();
   Track.clear();
+  SurfN.clear();
   return;
 }
 
@@ -149,39 +156,91 @@ LineTrack::calculate(const Simulation& ASim)
     \param ASim :: Simulation to use						
   */
 {
-  ELog::RegMethod RegA("LineTrack","calculate");
+  MonteCarlo::QueryContext QC;
+  calculate(QC,ASim);
+  return;
+}
+
+void
+LineTrack::calculate(MonteCarlo::QueryContext& QC,
+		     const Simulation& ASim,
+		     const LineTrack* Guide)
+  /*!
+    Calculate the track with the caller's query state.
+    If a neighbouring track is given it is used as a guide:
+    close parallel tracks (e.g. from adjacent mesh points)
+    mostly cross the same cells through the same surfaces. 
+    While this track follows the guide the guide cell is the 
+    first tested for the start cell and for the cell over each
+    exit surface. Only if it is not valid is the full
+    search used and after that the guide is not used.
+    \param QC :: Query context
+    \param ASim :: Simulation to use
+    \param Guide :: Calculated track close to this track [0 for none]
+  */
+{
+  ELog::RegMethod RegA("LineTrack","calculate(QC)");
 
   double aDist(0);                         // Length of track
   const Geometry::Surface* SPtr;           // Surface
   const ModelSupport::ObjSurfMap* OSMPtr =ASim.getOSM();
+  MonteCarlo::SurfSideCache& Cache=QC.getSideCache();
+
+  // guide cells [GSize==0 : no guide]
+  const size_t GSize((Guide) ? Guide->ObjVec.size() : 0);
+  MonteCarlo::Object* GStart((GSize) ? Guide->ObjVec.front() : 0);
 
   MonteCarlo::neutron nOut(1.0,InitPt,EndPt-InitPt);
-  // Find Initial cell [no default]
-  MonteCarlo::Object* OPtr=ASim.findCell(InitPt+
-					 (EndPt-InitPt).unit()*1e-5,0);
+  // Find Initial cell : testing the guide first
+  MonteCarlo::Object* OPtr=ASim.findCell(QC,InitPt+
+					 (EndPt-InitPt).unit()*1e-5,
+					 GStart);
   if (!OPtr)
-    ELog::EM<<"Initial point not in model:"<<InitPt<<ELog::endErr;
+    {
+      ELog::EM<<"Initial point not in model:"<<InitPt<<ELog::endErr;
+      return;
+    }
   int SN=OPtr->isOnSide(InitPt);
-  
-  const MonteCarlo::Object* prevOPtr(0);
+
+  // index in guide of OPtr [GSize when not following]
+  size_t GIndex((GStart && OPtr==GStart) ? 0 : GSize);
   while(OPtr)
     {
       // Note: Need OPPOSITE Sign on exiting surface
-      SN= OPtr->trackOutCell(nOut,aDist,SPtr,abs(SN));
+      SN= OPtr->trackOutCell(QC,nOut,aDist,SPtr,abs(SN));
       // Update Track : returns 1 on excess of distance
-      if (SN && updateDistance(OPtr,aDist))
+      if (SN && updateDistance(OPtr,SN,aDist))
 	{
-	  prevOPtr=OPtr;
 	  nOut.moveForward(aDist);
+	  const int exclude(OPtr->getName());
 	  
-	  OPtr=OSMPtr->findNextObject(SN,nOut.Pos,OPtr->getName());
+	  OPtr=0;
+	  if (GIndex+1<GSize && Guide->SurfN[GIndex]==SN)
+	    {
+	      MonteCarlo::Object* GPtr=Guide->ObjVec[GIndex+1];
+	      if (GPtr->getName()!=exclude &&
+		  GPtr->isDirectionValid(nOut.Pos,SN,Cache))
+		{
+		  QC.addBundleHit();
+		  OPtr=GPtr;
+		  GIndex++;
+		}
+	    }
 	  if (!OPtr)
 	    {
-	      ELog::EM<<"INIT POINT == "<<InitPt<<ELog::endDiag;
-	      calculateError(ASim);
+	      GIndex=GSize;
+	      OPtr=OSMPtr->findNextObject(QC,SN,nOut.Pos,exclude);
+	      if (!OPtr)
+		{
+		  ELog::EM<<"INIT POINT == "<<InitPt<<ELog::endDiag;
+		  calculateError(ASim);
+		}
 	    }
 	  if (!OPtr || aDist<Geometry::zeroTol)
-	    OPtr=ASim.findCell(nOut.Pos,0);
+	    {
+	      GIndex=GSize;
+	      OPtr=ASim.findCell(QC,nOut.Pos,0);
+	    }
 	}
       else
 	OPtr=0;	
@@ -202,6 +261,7 @@ LineTrack::calculateError(const Simulation& ASim)
   
   double aDist(0);                         // Length of track
   const Geometry::Surface* SPtr;           // Surface
+  MonteCarlo::TrackScratch TrackBuffer;    // Intercept buffer
   const ModelSupport::ObjSurfMap* OSMPtr =ASim.getOSM();
 
   MonteCarlo::neutron nOut(1.0,InitPt,EndPt-InitPt);
@@ -221,11 +281,11 @@ LineTrack::calculateError(const Simulation& ASim)
       ELog::EM<<"SN == "<<SN<<ELog::endDiag;
 
       // Note: Need OPPOSITE Sign on exiting surface
-      SN= OPtr->trackOutCell(nOut,aDist,SPtr,abs(SN));
+      SN= OPtr->trackOutCell(TrackBuffer,nOut,aDist,SPtr,abs(SN));
       ELog::EM<<"Found Surf == "<<SN<<" "<<aDist<<ELog::endDiag;
 
       // Update Track : returns 1 on excess of distance
-      if (SN && updateDistance(OPtr,aDist))
+      if (SN && updateDistance(OPtr,SN,aDist))
 	{
 	  prevOPtr=OPtr;
 	  nOut.moveForward(aDist);
@@ -282,10 +342,12 @@ LineTrack::calculateError(const Simulation& ASim)
 }
 
 bool
-LineTrack::updateDistance(MonteCarlo::Object* OPtr,const double D) 
+LineTrack::updateDistance(MonteCarlo::Object* OPtr,
+			  const int SN,const double D) 
   /*!
     Add the distance, register cell etc
     \param OPtr :: Object points
+    \param SN :: Exit surface
     \param D :: Distance
     \return 1 if distance insufficient / 0 if at end of line
    */
@@ -294,6 +356,7 @@ LineTrack::updateDistance(MonteCarlo::Object* OPtr,const double D)
 
   Cells.push_back(OPtr->getName());
   ObjVec.push_back(OPtr);
+  SurfN.push_back(SN);
   TDist+=D;
   if (aimDist-TDist < -Geometry::zeroTol)
     {
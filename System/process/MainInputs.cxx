@@ -66,6 +66,7 @@ createInputs(inputParam& IParam)
   IParam.regFlag("a","axis");
   IParam.regMulti("angle","angle",10000,1,8);
   IParam.regDefItem<int>("c","cellRange",2,0,0);
+  IParam.regFlag("cellIndex","cellIndex");
   IParam.regItem("C","ECut");
   IParam.regDefItem<double>("cutWeight","cutWeight",2,0.5,0.25);
   IParam.regMulti("cutTime","cutTime",100,1);
@@ -135,10 +136,12 @@ createInputs(inputParam& IParam)
   IParam.regDefItem<int>("u","units",1,0);
   IParam.regItem("validCheck","validCheck",1);
   IParam.regItem("validPoint","validPoint",1);
+  IParam.regItem("varSnap","varSnapshot",1,1);
   IParam.regFlag("um","voidUnMask");
   IParam.regMulti("volume","volume",4,1);
   IParam.regItem("volCard","volCard");
   IParam.regDefItem<int>("VN","volNum",1,20000);
+  IParam.regDefItem<int>("volThreads","volThreads",1,1);
   IParam.regMulti("volCell","volCells",100,1,100);
     
   IParam.regFlag("void","void");
@@ -166,15 +169,22 @@ createInputs(inputParam& IParam)
 
   IParam.regMulti("wFCL","wFCL",25,0);
   IParam.regMulti("wWWG","wWWG",25,0);
+  IParam.regItem("wCache","weightCache",1,1);
+  IParam.regDefItem<int>("wThreads","weightThreads",1,1);
+  IParam.regDefItem<int>("wCellSample","weightCellSample",1,1);
   IParam.regMulti("wIMP","wIMP",25,0);
     
   IParam.regMulti("wwgE","wwgE",25,0);
   IParam.regItem("wwgVTK","wwgVTK",1,10);
+  IParam.regItem("wwgBinIn","wwgBinIn",1,1);
+  IParam.regItem("wwgBinOut","wwgBinOut",1,1);
   IParam.regItem("wwgNorm","wwgNorm",0,30);
   IParam.regMulti("wwgAdjoint","wwgAdjoint",100,1);
   IParam.regMulti("wwgCalc","wwgCalc",100,1);
   IParam.regMulti("wwgMarkov","wwgMarkov",100,1);
+  IParam.regItem("wwgRefine","wwgRefine",0,2);
   IParam.regItem("wwgRPtMesh","wwgRPtMesh",1,125);
+  IParam.regDefItem<int>("wwgThreads","wwgThreads",1,1);
   IParam.regItem("wwgXMesh","wwgXMesh",3,125);
   IParam.regItem("wwgYMesh","wwgYMesh",3,125);
   IParam.regItem("wwgZMesh","wwgZMesh",3,125);  
@@ -185,6 +195,7 @@ createInputs(inputParam& IParam)
   IParam.setDesc("angle","Orientate to component [name]");
   IParam.setDesc("axis","Rotate to main axis rotation [TS2]");
   IParam.setDesc("c","Cells to protect");
+  IParam.setDesc("cellIndex","Build cell bounding-box index for findCell");
   IParam.setDesc("cutWeight","Set the cut weights (wc1/wc2)" );
   IParam.setDesc("ECut","Cut energy");
   IParam.setDesc("cinder","Outer Cinder files");
@@ -247,10 +258,12 @@ createInputs(inputParam& IParam)
   IParam.setDesc("volume","Create volume about point/radius for f4 tally");
   IParam.setDesc("volCells","Cells [object/range]");
   IParam.setDesc("volCard","set/delete the vol card");
+  IParam.setDesc("volThreads","Number of threads in the volume integration");
   IParam.setDesc("vtk","Write out VTK plot mesh");
   IParam.setDesc("vcell","Use cell id rather than material");
   IParam.setDesc("vmat","Material sections to be written by vtk output");
   IParam.setDesc("VN","Number of points in the volume integration");
+  IParam.setDesc("varSnap","File to store/reuse the compiled variables");
   IParam.setDesc("validCheck","Run simulation to check for validity");
   IParam.setDesc("validPoint","Point to start valid check from");
 
@@ -259,8 +272,16 @@ createInputs(inputParam& IParam)
   IParam.setDesc("wDXT","Dxtran sphere addition [set -wDXT help] ");
   IParam.setDesc("wDD","Dxtran Diagnostic [set -wDXT help] ");
   IParam.setDesc("wWWG","Weight WindowGenerator Mesh  ");
+  IParam.setDesc("wCache","Directory to store/reuse weight track sums");
+  IParam.setDesc("wThreads","Number of threads in the cell weight tracking");
+  IParam.setDesc("wCellSample","Track points per cell for cell weights");
   IParam.setDesc("wwgCalc","Single step evolve for the calculate for WWG/WWCell  ");
-  IParam.setDesc("wwgMarkov","Evolve the calculate for WWG/WWCell  ");
+  IParam.setDesc("wwgMarkov","Evolve the calculate for WWG/WWCell "
+		 "[nIter ... range(cm)]");
+  IParam.setDesc("wwgThreads","Number of threads in the WWG mesh tracking");
+  IParam.setDesc("wwgRefine","Refine WWG mesh at steep weights [step split]");
+  IParam.setDesc("wwgBinIn","Read WWG mesh/weights from binary file");
+  IParam.setDesc("wwgBinOut","Write WWG mesh/weights to binary file");
   IParam.setDesc("wIMP","set imp partile imp object(s)  ");
   IParam.setDesc("wFCL","Forced Collision ");
   IParam.setDesc("wPWT","Photon Bias [set -wPWT help]");
@@ -34,6 +34,7 @@
 #include <memory>
 
 #include <boost/format.hpp>
+#include <boost/filesystem.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -462,6 +463,95 @@ setMaterialsDataBase(const inputParam& IParam)
 						"Materials Data Base type");
 }
   
+std::string
+varSnapshotKey(const inputParam& IParam,const std::string& progName)
+  /*!
+    Construct the key that identifies a variable snapshot.
+    This is the program, the executable stamp [size/time] and
+    the input items that change the variable set.
+    \param IParam :: Input param
+    \param progName :: Name of the program 
+    \return key [empty if the executable cannot be stamped]
+  */
+{
+  ELog::RegMethod RegA("MainProcess[F]","varSnapshotKey");
+
+  boost::system::error_code errCode;
+  const boost::filesystem::path exePath("/proc/self/exe");
+  const uintmax_t exeSize=boost::filesystem::file_size(exePath,errCode);
+  if (errCode) return "";
+  const std::time_t exeTime=
+    boost::filesystem::last_write_time(exePath,errCode);
+  if (errCode) return "";
+  
+  std::ostringstream cx;
+  cx<<progName<<" "<<exeSize<<" "<<exeTime;
+  const std::vector<std::string> snapItems({"defaultConfig","beamlines"});
+  for(const std::string& Item : snapItems)
+    {
+      const size_t NSet=(IParam.hasKey(Item)) ? IParam.setCnt(Item) : 0;
+      for(size_t index=0;index<NSet;index++)
+	{
+	  cx<<" :"<<Item;
+	  for(const std::string& Unit : IParam.getObjectItems(Item,index))
+	    cx<<" "<<Unit;
+	}
+    }
+  return cx.str();
+}
+
+int
+readVarSnapshot(FuncDataBase& Control,const inputParam& IParam,
+		const std::string& progName)
+  /*!
+    Replace the variables with a snapshot if the 
+    varSnapshot file exists and is valid
+    \param Control :: FuncDataBase to set
+    \param IParam :: Input param
+    \param progName :: Name of the program 
+    \return 1 if the variables were read
+  */
+{
+  ELog::RegMethod RegA("MainProcess[F]","readVarSnapshot");
+
+  if (!IParam.flag("varSnap")) return 0;
+  const std::string FName=IParam.getValue<std::string>("varSnap");
+  const std::string Key=varSnapshotKey(IParam,progName);
+  if (Key.empty())
+    {
+      ELog::EM<<"Unable to stamp executable : variable snapshot off"
+	      <<ELog::endWarn;
+      return 0;
+    }
+  if (!Control.readBinary(FName,Key))
+    {
+      ELog::EM<<"Variable snapshot "<<FName<<" invalid/stale"
+	      <<ELog::endDiag;
+      return 0;
+    }
+  ELog::EM<<"Variable snapshot used: "<<FName<<ELog::endDiag;
+  return 1;
+}
+
+void
+writeVarSnapshot(const FuncDataBase& Control,const inputParam& IParam,
+		 const std::string& progName)
+  /*!
+    Write the variables to the varSnapshot file 
+    \param Control :: FuncDataBase to write
+    \param IParam :: Input param
+    \param progName :: Name of the program 
+  */
+{
+  ELog::RegMethod RegA("MainProcess[F]","writeVarSnapshot");
+
+  if (!IParam.flag("varSnap")) return;
+  const std::string Key=varSnapshotKey(IParam,progName);
+  if (!Key.empty())
+    Control.writeBinary(IParam.getValue<std::string>("varSnap"),Key);
+  return;
+}
+
 void
 exitDelete(Simulation* SimPtr)
  /*!
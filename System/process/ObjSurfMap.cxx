@@ -46,6 +46,10 @@
 #include "Rules.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "Line.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "Surface.h"
 #include "Quadratic.h"
 #include "Plane.h"
@@ -257,23 +261,47 @@ ObjSurfMap::findNextObject(const int SN,
 			   const Geometry::Vec3D& Pos,
 			   const int objExclude) const
   /*!
-    Calculate the next object 
+    Calculate the next object using a context held by
+    the thread. The side cache is reset as the surfaces
+    may have changed since the last call.
     \param SN :: Surface number
     \param Pos :: position
     \param ObjExclude :: Excluded object
     \return Next Object Ptr / 0 on point not valid
   */
 {
-  ELog::RegMethod RegA("ObjSurfMap","findNextObject");
+  static thread_local MonteCarlo::QueryContext QC;
+  QC.getSideCache().clear();
+  return findNextObject(QC,SN,Pos,objExclude);
+}
 
+MonteCarlo::Object*
+ObjSurfMap::findNextObject(MonteCarlo::QueryContext& QC,
+			   const int SN,
+			   const Geometry::Vec3D& Pos,
+			   const int objExclude) const
+  /*!
+    Calculate the next object using the side cache of 
+    a query context
+    \param QC :: Query context
+    \param SN :: Surface number
+    \param Pos :: position
+    \param ObjExclude :: Excluded object
+    \return Next Object Ptr / 0 on point not valid
+  */
+{
+  ELog::HotMethod RegA("ObjSurfMap","findNextObject(QC)");
 
   const STYPE& MVec=getObjects(SN);
   STYPE::const_iterator mc;
 
+  QC.addNext();
+  // cells on SN share many surfaces : evaluate each once
+  MonteCarlo::SurfSideCache& Cache=QC.getSideCache();
   for(MonteCarlo::Object* MPtr : MVec)
     {
       if (MPtr->getName()!=objExclude && 
-	  MPtr->isDirectionValid(Pos,SN))
+	  MPtr->isDirectionValid(Pos,SN,Cache))
 	return MPtr;
     }
   
@@ -59,6 +59,7 @@
 #include "Material.h"
 #include "DBMaterial.h"
 #include "LineTrack.h"
+#include "AttnTable.h"
 #include "ObjectTrackAct.h"
 
 namespace ModelSupport
@@ -183,6 +184,44 @@ ObjectTrackAct::getAttnSum(const long int objN) const
   return sum;
 }
 
+void
+ObjectTrackAct::getAttnSum(const long int objN,
+			   const AttnTable& ATable,
+			   std::vector<double>& Sum) const
+  /*!
+    Calculate the attenuation sum for each energy bin
+    of the table in one pass of the track
+    \param objN :: Cell number to use
+    \param ATable :: Material attenuation table
+    \param Sum :: sum of distance*factor for each energy bin
+  */
+{
+  ELog::RegMethod RegA("ObjectTrackAct","getAttnSum(Table)");
+
+  std::map<long int,LineTrack>::const_iterator mc=Items.find(objN);
+  if (mc==Items.end())
+    throw ColErr::InContainerError<long int>(objN,"objN in Items");
+  
+  const std::vector<MonteCarlo::Object*>& OVec=
+    mc->second.getObjVec();
+  const std::vector<double>& TVec=
+    mc->second.getTrack();
+
+  const size_t NE(ATable.getNE());
+  Sum.assign(NE,0.0);
+  for(size_t i=0;i<TVec.size();i++)
+    {
+      const int matN=OVec[i]->getMat();
+      if (matN)
+	{
+	  const double* SV=ATable.getSigma(matN);
+	  for(size_t e=0;e<NE;e++)
+	    Sum[e]+=TVec[i]*SV[e];
+	}
+    }
+  return;
+}
+
 double
 ObjectTrackAct::getDistance(const long int objN) const
   /*!
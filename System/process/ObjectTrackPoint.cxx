@@ -121,6 +121,36 @@ ObjectTrackPoint::addUnit(const Simulation& System,
   return;
 }  
 
+void
+ObjectTrackPoint::addUnit(MonteCarlo::QueryContext& QC,
+			const Simulation& System,
+			const long int objN,
+			const Geometry::Vec3D& IPt,
+			const long int guideN)
+  /*!
+    Create a target track between the IPt and the target point
+    using a tracking context [one per thread]. If the track
+    guideN exists it is used as a guide [neighbouring points]
+    \param QC :: Query context
+    \param System :: Simulation to use
+    \param objN :: Index of object
+    \param IPt :: initial point
+    \param guideN :: Index of guide track [0 for none]
+  */
+{
+  ELog::RegMethod RegA("ObjectTrackPoint","addUnit(QC)");
+
+  std::map<long int,LineTrack>::iterator mc=Items.find(objN);
+  if (mc!=Items.end())
+    Items.erase(mc);
+  LineTrack A(IPt,TargetPt);
+  std::map<long int,LineTrack>::const_iterator gc=
+    (guideN) ? Items.find(guideN) : Items.end();
+  A.calculate(QC,System,(gc!=Items.end()) ? &gc->second : 0);
+  Items.insert(std::map<long int,LineTrack>::value_type(objN,A));
+  return;
+}  
+
 void 
 ObjectTrackPoint::write(std::ostream& OX) const
   /*!
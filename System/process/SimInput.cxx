@@ -73,6 +73,7 @@
 #include "ImportControl.h"
 #include "SimValid.h"
 #include "MainProcess.h"
+#include "TrackCache.h"
 #include "WeightControl.h"
 #include "SimInput.h"
 
@@ -102,6 +103,8 @@ importanceSim(Simulation& System,const mainSystem::inputParam& IParam)
   WeightSystem::PWT(System,IParam);
   WeightSystem::EnergyCellCut(System,IParam);
   mainSystem::renumberCells(System,IParam);
+  if (IParam.flag("cellIndex"))
+    System.buildCellIndex();
   WeightSystem::WeightControl WC;
   WC.processWeights(System,IParam);
   
@@ -31,6 +31,8 @@
 #include <set>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <exception>
 #include <boost/format.hpp>
 
 #include "Exception.h"
@@ -56,6 +58,11 @@
 #include "FuncDataBase.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "Line.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
+#include "SimTrack.h"
 #include "Qhull.h"
 #include "SimProcess.h"
 #include "SurInter.h"
@@ -76,7 +83,8 @@ VolSum::VolSum(const Geometry::Vec3D& OPt,
 	       const Geometry::Vec3D& AxisRange) : 
   Origin(OPt),X(fabs(AxisRange[0]),0,0),
   Y(0,fabs(AxisRange[1]),0),Z(0,0,fabs(AxisRange[2])),
-  fullVol(0.0),totalDist(0),nTracks(0)
+  fracX(0.0),fracY(0.0),fullVol(0.0),totalDist(0),nTracks(0),
+  nThread(1),seed(0)
   /*!
     Constructor
     \param OPt :: Centre
@@ -88,7 +96,8 @@ VolSum::VolSum(const VolSum& A) :
   Origin(A.Origin),X(A.X),Y(A.Y),Z(A.Z),
   fracX(A.fracX),fracY(A.fracY),
   fullVol(A.fullVol),totalDist(A.totalDist),
-  nTracks(A.nTracks),tallyVols(A.tallyVols)
+  nTracks(A.nTracks),nThread(A.nThread),seed(A.seed),
+  tallyVols(A.tallyVols)
   /*!
     Copy constructor
     \param A :: VolSum to copy
@@ -109,9 +118,13 @@ VolSum::operator=(const VolSum& A)
       X=A.X;
       Y=A.Y;
       Z=A.Z;
+      fracX=A.fracX;
+      fracY=A.fracY;
       fullVol=A.fullVol;
       totalDist=A.totalDist;
       nTracks=A.nTracks;
+      nThread=A.nThread;
+      seed=A.seed;
       tallyVols=A.tallyVols;
     }
   return *this;
@@ -293,6 +306,116 @@ VolSum::reset()
   return;
 }
 
+void
+VolSum::setThreads(const size_t NT,const unsigned int S)
+  /*!
+    Set the number of threads for the runs. Each thread 
+    has its own random stream seeded from S and the thread index,
+    so the result depends only on S and NT.
+    \param NT :: Number of threads [0/1 : serial with global RNG]
+    \param S :: Seed for the thread streams
+   */
+{
+  nThread=NT;
+  seed=S;
+  return;
+}
+
+void
+VolSum::addSum(const VolSum& A)
+  /*!
+    Add the tallies of a partial run
+    \param A :: VolSum of the same tallies
+   */
+{
+  totalDist+=A.totalDist;
+  for(tvTYPE::value_type& TV : tallyVols)
+    {
+      tvTYPE::const_iterator mc=A.tallyVols.find(TV.first);
+      if (mc!=A.tallyVols.end())
+	TV.second.addSum(mc->second);
+    }
+  return;
+}
+
+void
+VolSum::threadRun(const Simulation& System,const size_t N,
+		  const int trackFlag)
+  /*!
+    Split the run over the threads. Each thread tallies into
+    a copy of this and the copies are added in thread order.
+    \param System :: Simulation to use
+    \param N :: Number of points/tracks
+    \param trackFlag :: track run [1] / point run [0]
+   */
+{
+  ELog::RegMethod RegA("VolSum","threadRun");
+
+  const size_t NT((nThread<N) ? nThread : N);
+  if (!NT) return;
+  
+  std::vector<VolSum> Part(NT,*this);
+  std::vector<std::exception_ptr> Fail(NT);
+  std::vector<std::thread> Workers;
+  for(size_t i=0;i<NT;i++)
+    {
+      const size_t NPart(N/NT+((i<N % NT) ? 1 : 0));
+      Workers.push_back(std::thread([&System,&Part,&Fail,this,
+				     trackFlag,i,NPart]()
+	{
+	  try
+	    {
+	      ModelSupport::SimTrack::Instance().setLazy();
+	      MTRand::uint32 key[2]=
+		{ seed,static_cast<MTRand::uint32>(i) };
+	      MTRand TRNG(key,2);
+	      if (trackFlag)
+		Part[i].trackBlock(System,TRNG,NPart);
+	      else
+		Part[i].pointBlock(System,TRNG,NPart);
+	    }
+	  catch(...)
+	    {
+	      Fail[i]=std::current_exception();
+	    }
+	}));
+    }
+  for(std::thread& TH : Workers)
+    TH.join();
+
+  for(size_t i=0;i<NT;i++)
+    {
+      if (Fail[i])
+	std::rethrow_exception(Fail[i]);
+      addSum(Part[i]);
+    }
+  return;
+}
+
+void
+VolSum::pointBlock(const Simulation& System,MTRand& RX,const size_t N) 
+  /*!
+    Tally a block of random points
+    \param System :: Simulation to use
+    \param RX :: Random number stream
+    \param N :: Number of points to test
+  */
+{
+  MonteCarlo::QueryContext QC;        // Query state for this block
+  MonteCarlo::Object* OPtr(0);
+
+  for(size_t i=0;i<N;i++)
+    {
+      Geometry::Vec3D Pt(Origin+
+			 X*(RX.rand()-0.5)+
+			 Y*(RX.rand()-0.5)+
+			 Z*(RX.rand()-0.5));
+      OPtr=System.findCell(QC,Pt,OPtr);
+      addDistance(OPtr->getName(),1.0);
+    }
+  return;
+}
+
 void
 VolSum::pointRun(const Simulation& System,const size_t N) 
   /*!
@@ -303,34 +426,28 @@ VolSum::pointRun(const Simulation& System,const size_t N)
 {
   ELog::RegMethod RegA("VolSum","run");
   
-  MonteCarlo::Object* OPtr(0);
-
   reset();
   fullVol=X.abs()*Y.abs()*Z.abs();
   // Note for sphere that you can use X,Y,Z in any orthogonal 
   // directiron
 
-  for(size_t i=0;i<N;i++)
-    {
-      Geometry::Vec3D Pt(Origin+
-			 X*(RNG.rand()-0.5)+
-			 Y*(RNG.rand()-0.5)+
-			 Z*(RNG.rand()-0.5));
-      OPtr=System.findCell(Pt,OPtr);
-      addDistance(OPtr->getName(),1.0);
-    }
+  if (nThread>1)
+    threadRun(System,N,0);
+  else
+    pointBlock(System,RNG,N);
   nTracks+=N;
   return;
 }
 
 Geometry::Vec3D
-VolSum::getCubePoint() const
+VolSum::getCubePoint(MTRand& RX) const
   /*!
     Get a random point on the cuboic
+    \param RX :: Random number stream
     \return surface point
   */
 {
-  double R=RNG.rand();
+  double R=RX.rand();
   double pm(0.5);
   if (R>0.5)   
     {
@@ -340,39 +457,29 @@ VolSum::getCubePoint() const
   Geometry::Vec3D Pt(Origin);
   if (R<fracX) // XY surface
     {
-      Pt+=X*(RNG.rand()-0.5)+Y*(RNG.rand()-0.5);
+      Pt+=X*(RX.rand()-0.5)+Y*(RX.rand()-0.5);
       Pt+=Z*pm;
     }
   else if (R<fracY)
     {
-      Pt+=X*(RNG.rand()-0.5)+Z*(RNG.rand()-0.5);
+      Pt+=X*(RX.rand()-0.5)+Z*(RX.rand()-0.5);
       Pt+=Y*pm;
     }
   else 
     {
-      Pt+=Y*(RNG.rand()-0.5)+Z*(RNG.rand()-0.5);
+      Pt+=Y*(RX.rand()-0.5)+Z*(RX.rand()-0.5);
       Pt+=X*pm;
     }
   return Pt;
 }
-  
 
-  
 void
-VolSum::trackRun(const Simulation& System,const size_t N) 
+VolSum::setTrackArea()
   /*!
-    Calculate the tracking
-    \param System :: Simulation to use
-    \param N :: Number of points to test
+    Set the face fractions of the cube for the
+    start/end points of tracks
   */
 {
-  ELog::RegMethod RegA("VolSum","run");
-  
-  const ModelSupport::ObjSurfMap* OSMPtr =System.getOSM();
-
-  MonteCarlo::Object* InitObj(0);
-  reset();
-  
   const double AreaXY(X[0]*Y[1]);
   const double AreaXZ(X[0]*Z[2]);
   const double AreaYZ(Y[1]*Z[2]);
@@ -382,17 +489,32 @@ VolSum::trackRun(const Simulation& System,const size_t N)
 
   fracX=AreaXY/totalArea;
   fracY=(AreaXZ+AreaXY)/totalArea;
-  
+  return;
+}
+
+void
+VolSum::trackBlock(const Simulation& System,MTRand& RX,const size_t N) 
+  /*!
+    Tally a block of random tracks
+    \param System :: Simulation to use
+    \param RX :: Random number stream
+    \param N :: Number of tracks
+  */
+{
+  const ModelSupport::ObjSurfMap* OSMPtr =System.getOSM();
+
+  MonteCarlo::Object* InitObj(0);
   const Geometry::Surface* SPtr;          // Output surface
   double aDist;       
+  MonteCarlo::QueryContext QC;            // Query state for this block
 
   // Note for sphere that you can use X,Y,Z in any orthogonal 
   // directiron
 
   for(size_t i=0;i<N;i++)
     {
-      Geometry::Vec3D Pt=getCubePoint();
-      Geometry::Vec3D XPt=getCubePoint();
+      Geometry::Vec3D Pt=getCubePoint(RX);
+      Geometry::Vec3D XPt=getCubePoint(RX);
       double trackDistance=Pt.Distance(XPt);
       XPt-=Pt;
       totalDist+=trackDistance;
@@ -401,14 +523,14 @@ VolSum::trackRun(const Simulation& System,const size_t N)
       
       MonteCarlo::neutron TNeut(1,Pt,XPt);
       // Find Initial cell [Store for next time]
-      InitObj=System.findCell(TNeut.Pos,InitObj);      
+      InitObj=System.findCell(QC,TNeut.Pos,InitObj);      
       MonteCarlo::Object* OPtr=InitObj;
       int SN(0);
 
       while(OPtr)
 	{
 	  // Note: Need OPPOSITE Sign on exiting surface
-	  SN= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN);
+	  SN= -OPtr->trackOutCell(QC,TNeut,aDist,SPtr,-SN);
 	  trackDistance-=aDist;
 	  if (trackDistance > 0.0)
 	    {
@@ -418,7 +540,7 @@ VolSum::trackRun(const Simulation& System,const size_t N)
 
 	      OPtr=(SN) ?
 		OSMPtr->findNextObject
-		(SN,TNeut.Pos,OPtr->getName()) : 0;		
+		(QC,SN,TNeut.Pos,OPtr->getName()) : 0;		
 	    }
 	  else
 	    {
@@ -430,6 +552,27 @@ VolSum::trackRun(const Simulation& System,const size_t N)
 	    }
 	}
     }
+  return;
+}
+  
+void
+VolSum::trackRun(const Simulation& System,const size_t N) 
+  /*!
+    Calculate the tracking
+    \param System :: Simulation to use
+    \param N :: Number of points to test
+  */
+{
+  ELog::RegMethod RegA("VolSum","run");
+  
+  reset();
+  setTrackArea();
+
+  if (nThread>1)
+    threadRun(System,N,1);
+  else
+    trackBlock(System,RNG,N);
+
   ELog::EM<<"Total Dist == "<<totalDist<<ELog::endTrace;  
   nTracks+=N;
   return;
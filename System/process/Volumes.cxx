@@ -30,6 +30,7 @@
 #include <set>
 #include <string>
 #include <memory>
+#include <limits>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -79,7 +80,14 @@ calcVolumes(Simulation* SimPtr,const mainSystem::inputParam& IParam)
       const Geometry::Vec3D XYZ=IParam.getValue<Geometry::Vec3D>("volume",1);
 
       const size_t NP=IParam.getValue<size_t>("volNum");
+      const int NT=IParam.getValue<int>("volThreads");
+      if (NT<1)
+	throw ColErr::RangeError<int>(NT,1,std::numeric_limits<int>::max(),
+				      "volThreads");
       VolSum VTally(Org,XYZ);
+      VTally.setThreads(static_cast<size_t>(NT),
+			static_cast<unsigned int>
+			(IParam.getValue<long int>("random")));
       if (IParam.flag("volCells") )
 	populateCells(*SimPtr,IParam,VTally);
       else
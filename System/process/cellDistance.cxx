@@ -51,6 +51,8 @@
 #include "neutron.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "Line.h"
+#include "TrackScratch.h"
 #include "Qhull.h"
 #include "ObjSurfMap.h"
 #include "objectRegister.h"
@@ -134,6 +136,7 @@ cellDistance::calcPoint(const Geometry::Vec3D& Pt,
   
   const Geometry::Surface* SPtr;          // Output surface
   double aDist;                           // Output distribution
+  MonteCarlo::TrackScratch TrackBuffer;   // Intercept buffer
   
   setRange(Range);
 
@@ -147,7 +150,7 @@ cellDistance::calcPoint(const Geometry::Vec3D& Pt,
   int SN(0);      // if on a surface boundary : surf not to be used
   while(OPtr)
     {
-      SN= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN);
+      SN= -OPtr->trackOutCell(TrackBuffer,TNeut,aDist,SPtr,-SN);
       TNeut.moveForward(aDist);
       flag = (SN>=aRange && SN<bRange) ? 0 : 1;
 
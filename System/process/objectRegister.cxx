@@ -154,7 +154,7 @@ objectRegister::inRange(const int Index) const
     \return string
    */
 {
-  static std::string prev;
+  static thread_local std::string prev;   // last range [per thread]
   
   MTYPE::const_iterator mc;
   mc=regionMap.find(prev);
@@ -500,7 +500,7 @@ objectRegister::inRenumberRange(const int Index) const
     \return string of object
    */
 {
-  static std::string prev;
+  static thread_local std::string prev;   // last range [per thread]
   
   MTYPE::const_iterator mc;
   // normally same as previous search
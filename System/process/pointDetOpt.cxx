@@ -3,7 +3,7 @@
  
  * File:   process/pointDetOpt.cxx
  *
- * Copyright (c) 2004-2015 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -32,6 +32,9 @@
 #include <algorithm>
 #include <memory>
 #include <array>
+#include <atomic>
+#include <exception>
+#include <thread>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -44,6 +47,9 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "Line.h"
+#include "localRotate.h"
+#include "masterRotate.h"
 #include "varList.h"
 #include "Code.h"
 #include "FItem.h"
@@ -53,10 +59,16 @@
 #include "neutron.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "Qhull.h"
 #include "Triple.h"
 #include "NList.h"
 #include "NRange.h"
+#include "pairRange.h"
+#include "Tally.h"
+#include "pointTally.h"
 #include "SrcData.h"
 #include "SrcItem.h"
 #include "DSTerm.h"
@@ -68,6 +80,7 @@
 #include "LSwitchCard.h"
 #include "PhysicsCards.h"
 #include "Simulation.h"
+#include "fileSupport.h"
 #include "LineTrack.h"
 #include "ObjectTrackAct.h"
 #include "ObjectTrackPoint.h"
@@ -78,16 +91,27 @@
 namespace ModelSupport
 {
 
+pointDetOpt::pointDetOpt() : 
+  energy(1.0),nThread(1)
+  /*!
+    Constructor [no detectors]
+  */
+{}
+
 pointDetOpt::pointDetOpt(const Geometry::Vec3D& Pt) : 
-  energy(1.0),OA(Pt)
+  energy(1.0),nThread(1)
   /*!
     Constructor
     \param Pt :: target point
   */
-{}
+{
+  addDetector(Pt);
+}
 
 pointDetOpt::pointDetOpt(const pointDetOpt& A) : 
-  energy(A.energy),OA(A.OA)
+  energy(A.energy),nThread(A.nThread),
+  cellN(A.cellN),CofM(A.CofM),DetPt(A.DetPt),
+  tallyN(A.tallyN),detValid(A.detValid),MatSum(A.MatSum)
   /*!
     Copy Constructor
     \param A :: pointDetOpt to copy
@@ -105,84 +129,339 @@ pointDetOpt::operator=(const pointDetOpt& A)
   if (this!=&A)
     {
       energy=A.energy;
-      OA=A.OA;
+      nThread=A.nThread;
+      cellN=A.cellN;
+      CofM=A.CofM;
+      DetPt=A.DetPt;
+      tallyN=A.tallyN;
+      detValid=A.detValid;
+      MatSum=A.MatSum;
     }
   return *this;
 }
 
+size_t
+pointDetOpt::addDetector(const Geometry::Vec3D& Pt,const int tN)
+  /*!
+    Add a detector point
+    \param Pt :: Detector point
+    \param tN :: Tally number [0 if not attached to a tally]
+    \return index of detector
+  */
+{
+  DetPt.push_back(Pt);
+  tallyN.push_back(tN);
+  detValid.push_back(0);
+  MatSum.resize(DetPt.size()*cellN.size(),0.0);
+  return DetPt.size()-1;
+}
+
 void
-pointDetOpt::createObjAct(const Simulation& ASim) 
+pointDetOpt::setDetector(const size_t index,const Geometry::Vec3D& Pt)
   /*!
-    Create a set of vertex points
-    -- Note: routine tested in testObjectTrackAct
-    \param ASim : Simulation object
+    Move a detector. The sums are only invalidated if
+    the point has changed.
+    \param index :: Detector index
+    \param Pt :: New detector point
   */
 {
-  ELog::RegMethod RegA("pointDetOpt","createObjAct");
+  ELog::RegMethod RegA("pointDetOpt","setDetector");
+
+  if (index>=DetPt.size())
+    throw ColErr::IndexError<size_t>(index,DetPt.size(),"index");
+  if (DetPt[index]!=Pt)
+    {
+      DetPt[index]=Pt;
+      detValid[index]=0;
+    }
+  return;
+}
+
+size_t
+pointDetOpt::addPointTallies(const Simulation& ASim)
+  /*!
+    Add a detector for each point tally in the simulation
+    \param ASim :: Simulation 
+    \return number of detectors added
+  */
+{
+  ELog::RegMethod RegA("pointDetOpt","addPointTallies");
+
+  const masterRotate& MR=masterRotate::Instance();
+  const Simulation::TallyTYPE& tmap=ASim.getTallyMap();
+  size_t cnt(0);
+  for(const Simulation::TallyTYPE::value_type& mc : tmap)
+    {
+      const tallySystem::pointTally* PTptr=
+	dynamic_cast<const tallySystem::pointTally*>(mc.second);
+      if (PTptr)
+	{
+	  addDetector(MR.reverseRotate(PTptr->getCentre()),PTptr->getKey());
+	  cnt++;
+	}
+    }
+  return cnt;
+}
+
+int
+pointDetOpt::setCells(const Simulation& ASim)
+  /*!
+    Set the active cells and their centres. If these 
+    have changed all the detectors are invalidated.
+    \param ASim : Simulation object [calcAllVertex run]
+    \return 1 if the cells have changed
+  */
+{
+  ELog::RegMethod RegA("pointDetOpt","setCells");
 
+  std::vector<int> NVec;
+  std::vector<Geometry::Vec3D> CVec;
   const Simulation::OTYPE& Cells=ASim.getCells();
-  Simulation::OTYPE::const_iterator vc;
-  for(vc=Cells.begin();vc!=Cells.end();vc++)
+  for(const Simulation::OTYPE::value_type& vc : Cells)
+    if (!vc.second->isPlaceHold())
+      {
+	NVec.push_back(vc.first);
+	CVec.push_back(vc.second->getCofM());
+      }
+
+  if (NVec==cellN && CVec.size()==CofM.size() &&
+      std::equal(CVec.begin(),CVec.end(),CofM.begin(),
+		 [](const Geometry::Vec3D& A,const Geometry::Vec3D& B)
+		 { return A.X()==B.X() && A.Y()==B.Y() && A.Z()==B.Z(); }))
+    return 0;
+
+  cellN=std::move(NVec);
+  CofM=std::move(CVec);
+  std::fill(detValid.begin(),detValid.end(),0);
+  MatSum.assign(DetPt.size()*cellN.size(),0.0);
+  return 1;
+}
+
+void
+pointDetOpt::trackDetectors(const Simulation& ASim,
+			    const std::vector<size_t>& DList)
+  /*!
+    Track from each cell centre to the detectors in DList.
+    The work is split in blocks of cells [for a detector]
+    over nThread workers each with its own track and query
+    context. Each sum is independent so the result does
+    not depend on the number of threads.
+    \param ASim : Simulation object
+    \param DList :: Detectors to track
+  */
+{
+  ELog::RegMethod RegA("pointDetOpt","trackDetectors");
+
+  const size_t NC(cellN.size());
+  const size_t blockSize(64);
+  const size_t nBlock((NC+blockSize-1)/blockSize);
+  const size_t NItem(nBlock*DList.size());
+  if (!NItem) return;
+  
+  const size_t NT((nThread>1 && nThread<NItem) ? nThread :
+		  ((nThread>1) ? NItem : 1));
+  
+  std::atomic<size_t> nextItem(0);
+  std::vector<std::exception_ptr> Fail(NT);
+
+  auto worker=[&](const size_t TIndex)
     {
-      if (!vc->second->isPlaceHold())
+      try
 	{
-	  OA.addUnit(ASim,vc->first,vc->second->getCofM());
+	  ObjectTrackPoint OTrack(Geometry::Vec3D(0,0,0));
+	  MonteCarlo::QueryContext QC;
+	  for(size_t item=nextItem++;item<NItem;item=nextItem++)
+	    {
+	      const size_t DI(DList[item/nBlock]);
+	      const size_t IA((item % nBlock)*blockSize);
+	      const size_t IB((IA+blockSize<NC) ? IA+blockSize : NC);
+	      OTrack.clearAll();
+	      OTrack.setTarget(DetPt[DI]);
+	      double* DSum=MatSum.data()+DI*NC;
+	      for(size_t i=IA;i<IB;i++)
+		{
+		  OTrack.addUnit(QC,ASim,cellN[i],CofM[i]);
+		  DSum[i]=OTrack.getMatSum(cellN[i]);
+		}
+	    }
 	}
+      catch(...)
+	{
+	  Fail[TIndex]=std::current_exception();
+	  nextItem=NItem;
+	}
+    };
+  
+  std::vector<std::thread> Workers;
+  for(size_t i=1;i<NT;i++)
+    Workers.push_back(std::thread(worker,i));
+  worker(0);
+  for(std::thread& TH : Workers)
+    TH.join();
+
+  for(size_t i=0;i<NT;i++)
+    if (Fail[i])
+      std::rethrow_exception(Fail[i]);
 
+  for(const size_t DI : DList)
+    detValid[DI]=1;
+  return;
+}
+
+void
+pointDetOpt::createObjAct(const Simulation& ASim) 
+  /*!
+    Calculate the material track from each cell to each 
+    detector that is not valid.
+    -- Note: routine tested in testObjectTrackAct
+    \param ASim : Simulation object
+  */
+{
+  ELog::RegMethod RegA("pointDetOpt","createObjAct");
+
+  setCells(ASim);
+  std::vector<size_t> DList;
+  for(size_t i=0;i<DetPt.size();i++)
+    if (!detValid[i])
+      DList.push_back(i);
+
+  if (!DList.empty())
+    {
+      ELog::EM<<"Point detector tracks : "<<DList.size()<<" / "
+	      <<DetPt.size()<<" detectors to "<<cellN.size()
+	      <<" cells"<<ELog::endDiag;
+      trackDetectors(ASim,DList);
     }
   return;
 }
 
+double
+pointDetOpt::getMatSum(const size_t index,const size_t cellIndex) const
+  /*!
+    Get the material track length 
+    \param index :: Detector index
+    \param cellIndex :: Index of cell [not cell number]
+    \return material sum
+  */
+{
+  ELog::RegMethod RegA("pointDetOpt","getMatSum");
+
+  if (index>=DetPt.size() || !detValid[index])
+    throw ColErr::IndexError<size_t>(index,DetPt.size(),"valid detector");
+  if (cellIndex>=cellN.size())
+    throw ColErr::IndexError<size_t>(cellIndex,cellN.size(),"cellIndex");
+  return MatSum[index*cellN.size()+cellIndex];
+}
+
+void
+pointDetOpt::writeDetector(std::ostream& OX,const size_t index) const
+  /*!
+    Write the sums of a detector in binary form
+    \param OX :: Output stream [binary]
+    \param index :: Detector index
+  */
+{
+  ELog::RegMethod RegA("pointDetOpt","writeDetector");
+
+  if (index>=DetPt.size() || !detValid[index])
+    throw ColErr::IndexError<size_t>(index,DetPt.size(),"valid detector");
+  const size_t NC(cellN.size());
+  const std::vector<double> DSum
+    (MatSum.begin()+static_cast<long int>(index*NC),
+     MatSum.begin()+static_cast<long int>((index+1)*NC));
+  StrFunc::writeBinary(OX,NC);
+  StrFunc::writeBinary(OX,DSum);
+  return;
+}
+
+void
+pointDetOpt::readDetector(std::istream& IX,const size_t index) 
+  /*!
+    Read the sums of a detector written by writeDetector.
+    The cells must have been set [setCells].
+    \param IX :: Input stream [binary]
+    \param index :: Detector index
+  */
+{
+  ELog::RegMethod RegA("pointDetOpt","readDetector");
+
+  if (index>=DetPt.size())
+    throw ColErr::IndexError<size_t>(index,DetPt.size(),"index");
+  
+  const size_t NC(cellN.size());
+  size_t N;
+  std::vector<double> DSum;
+  StrFunc::readBinary(IX,N);
+  StrFunc::readBinary(IX,DSum);
+  if (N!=NC || DSum.size()!=NC)
+    throw ColErr::MisMatch<size_t>(DSum.size(),NC,"Cell sums/cells");
+  std::copy(DSum.begin(),DSum.end(),
+	    MatSum.begin()+static_cast<long int>(index*NC));
+  detValid[index]=1;
+  return;
+}
+
 void
-pointDetOpt::addTallyOpt(const int tallyN,Simulation& ASim)
+pointDetOpt::addTallyOpt(const int tallyNum,Simulation& ASim) const
+  /*!
+    Adds an importance card for the first detector
+    \param tallyNum :: tally nubmer
+    \param ASim :: Simulation to add component to
+  */
+{
+  addTallyOpt(0,tallyNum,ASim);
+  return;
+}
+
+void
+pointDetOpt::addTallyOpt(Simulation& ASim) const
+  /*!
+    Adds an importance card for each detector with a tally
+    \param ASim :: Simulation to add component to
+  */
+{
+  for(size_t i=0;i<DetPt.size();i++)
+    if (tallyN[i])
+      addTallyOpt(i,tallyN[i],ASim);
+  return;
+}
+
+void
+pointDetOpt::addTallyOpt(const size_t index,const int tallyNum,
+			 Simulation& ASim) const
   /*!
     Adds an importance card to the physics of type PD
     with the corresponding weights for the distance
-    \param tallyN :: tally nubmer
+    \param index :: Detector index
+    \param tallyNum :: tally nubmer
     \param ASim :: Simulation to add component to
   */
 {
   ELog::RegMethod RegA("pointDetOpt","addTallyOpt");
 
+  if (index>=DetPt.size() || !detValid[index])
+    throw ColErr::IndexError<size_t>(index,DetPt.size(),"valid detector");
+  
   // First get the physcis
   physicsSystem::PhysicsCards& PC=ASim.getPC();
   std::ostringstream cx;
-  cx<<"pd"<<tallyN;
+  cx<<"pd"<<tallyNum;
   physicsSystem::PhysImp& PD=PC.addPhysImp(cx.str(),"");
 
-  const Simulation::OTYPE& OCells=ASim.getCells(); 
-  Simulation::OTYPE::const_iterator mc;
-
+  const size_t NC(cellN.size());
+  const double* DSum=MatSum.data()+index*NC;
+  
   // First loop to find minimum distance:
   double minV(1e38);
-  double D;
-  for(mc=OCells.begin();mc!=OCells.end();mc++)
-    {
-      if (!mc->second->isPlaceHold())
-	{
-	  D=OA.getMatSum(mc->first);
-	  if (D<minV && D>0.0)
-	    {
-	      minV=D;
-	      if (minV<1.0)
-		break;
-	    }
-	}
-    }
+  for(size_t i=0;i<NC && minV>=1.0;i++)
+    if (DSum[i]<minV && DSum[i]>0.0)
+      minV=DSum[i];
 
   // Second loop to create Pd values [in an importance card]
   const double scale((minV<1.0) ? 1.0 : minV);
-  for(mc=OCells.begin();mc!=OCells.end();mc++)
-    {
-      if (!mc->second->isPlaceHold())
-	{
-	  const double D=OA.getMatSum(mc->first);
-	  if (D>1.0)
-	    PD.setValue(mc->first,scale/D);
-	  else
-	    PD.setValue(mc->first,1.0);
-	}
-    }
+  for(size_t i=0;i<NC;i++)
+    PD.setValue(cellN[i],(DSum[i]>1.0) ? scale/DSum[i] : 1.0);
+
   return;
 }
 
@@ -172,7 +172,10 @@ equalSurface(const Geometry::Surface* SPtr)
     EqualSurface<boost::mpl::_1 , boost::mpl::_2,const Geometry::Surface*> >::type FTYPE;
   
   ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
-  return FTYPE::dispatch(Index,SPtr,SurI.surMap());
+  SMAP CMap;
+  const SMAP& SearchMap=
+    (SurI.findCandidates(SPtr,CMap)) ? CMap : SurI.surMap();
+  return FTYPE::dispatch(Index,SPtr,SearchMap);
 }
 
 Geometry::Surface*
@@ -194,7 +197,10 @@ equalSurface(Geometry::Surface* SPtr)
     EqualSurface<boost::mpl::_1 , boost::mpl::_2,Geometry::Surface*> >::type FTYPE;
   
   ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
-  return FTYPE::dispatch(Index,SPtr,SurI.surMap());
+  SMAP CMap;
+  const SMAP& SearchMap=
+    (SurI.findCandidates(SPtr,CMap)) ? CMap : SurI.surMap();
+  return FTYPE::dispatch(Index,SPtr,SearchMap);
 }
 
 
@@ -244,7 +250,10 @@ equalSurfNum(const Geometry::Surface* SPtr)
     EqualSurface<boost::mpl::_1 , boost::mpl::_2,const Geometry::Surface*> >::type FTYPE;
   
   ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
-  const Geometry::Surface* OutPtr=FTYPE::dispatch(Index,SPtr,SurI.surMap());
+  SMAP CMap;
+  const SMAP& SearchMap=
+    (SurI.findCandidates(SPtr,CMap)) ? CMap : SurI.surMap();
+  const Geometry::Surface* OutPtr=FTYPE::dispatch(Index,SPtr,SearchMap);
   return OutPtr->getName();
 }
 
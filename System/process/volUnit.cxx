@@ -174,6 +174,19 @@ volUnit::addFlux(const int CN,const double R,const double D)
   return;
 }
 
+void 
+volUnit::addSum(const volUnit& A)
+  /*!
+    Add the contributions of another tally of the 
+    same cells [partial run]
+    \param A :: volUnit to add
+  */
+{
+  npts+=A.npts;
+  lineSum+=A.lineSum;
+  return;
+}
+
 void 
 volUnit::reset()
   /*!
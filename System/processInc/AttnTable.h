@@ -0,0 +1,69 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   processInc/AttnTable.h
+ *
+ * Copyright (c) 2004-2016 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef ModelSupport_AttnTable_h
+#define ModelSupport_AttnTable_h
+
+namespace ModelSupport
+{
+
+/*!
+  \class AttnTable
+  \version 1.0
+  \author S. Ansell
+  \date October 2017
+  \brief Attenuation factor of each material by energy bin
+
+  The factor A^0.66 * atom density of each material in DBMaterial
+  is calculated once and scaled for each energy bin. Materials
+  are indexed directly by number so a track sum does not need
+  to look up the DBMaterial map. Must be rebuilt if materials
+  are added or changed.
+*/
+
+class AttnTable
+{
+ private:
+
+  size_t NE;                      ///< Number of energy bins
+  std::vector<size_t> matSlot;    ///< Material number : slot [0 : none]
+  std::vector<double> Sigma;      ///< Factors [slot*NE+energy]
+  
+ public:
+
+  AttnTable();
+  AttnTable(const AttnTable&);
+  AttnTable& operator=(const AttnTable&);
+  ~AttnTable() {}    ///< Destructor
+
+  void build(const size_t);
+  void build(const std::vector<double>&);
+
+  /// Number of energy bins
+  size_t getNE() const { return NE; }
+  const double* getSigma(const int) const;
+  double getSigma(const int,const size_t) const;
+  
+};
+
+}
+
+#endif
@@ -30,6 +30,7 @@ namespace Geometry
 namespace MonteCarlo
 {
   class Object;
+  class QueryContext;
 }
 
 namespace ModelSupport
@@ -56,8 +57,9 @@ class LineTrack
   std::vector<long int> Cells;                   ///< Cells in order
   std::vector<MonteCarlo::Object*> ObjVec;  ///< Object pointer
   std::vector<double> Track;                ///< Track length
+  std::vector<int> SurfN;                   ///< Exit surface
 
-  bool updateDistance(MonteCarlo::Object*,const double);
+  bool updateDistance(MonteCarlo::Object*,const int,const double);
 
  public:
 
@@ -71,6 +73,8 @@ class LineTrack
   bool isCompelete() const { return (aimDist-TDist) < -Geometry::zeroTol; }
 
   void calculate(const Simulation&);
+  void calculate(MonteCarlo::QueryContext&,const Simulation&,
+		 const LineTrack* =0);
   void calculateError(const Simulation&);
   /// Access Cells
   const std::vector<long int>& getCells() const
@@ -78,6 +82,9 @@ class LineTrack
   /// Access Track lengths
   const std::vector<double>& getTrack() const
     { return Track; }
+  /// Access exit surfaces
+  const std::vector<int>& getSurfN() const
+    { return SurfN; }
   /// Access Object Pointers
   const std::vector<MonteCarlo::Object*>& getObjVec() const
     { return ObjVec; }
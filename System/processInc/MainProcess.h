@@ -56,6 +56,11 @@ namespace mainSystem
   void setVariables(Simulation&,const inputParam&,std::vector<std::string>&);
   void setMaterialsDataBase(const inputParam&);
 
+  std::string varSnapshotKey(const inputParam&,const std::string&);
+  int readVarSnapshot(FuncDataBase&,const inputParam&,const std::string&);
+  void writeVarSnapshot(const FuncDataBase&,const inputParam&,
+			const std::string&);
+
   int extractName(std::vector<std::string>&,std::string&);
 
   Simulation* createSimulation(inputParam&,std::vector<std::string>&,
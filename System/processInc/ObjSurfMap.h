@@ -30,6 +30,7 @@ namespace Geometry
 namespace MonteCarlo
 {
   class Object;
+  class QueryContext;
 }
 
 namespace ModelSupport
@@ -78,6 +79,8 @@ class ObjSurfMap
   const STYPE& getObjects(const int) const;
   MonteCarlo::Object* findNextObject(const int,
 				     const Geometry::Vec3D&,const int) const;
+  MonteCarlo::Object* findNextObject(MonteCarlo::QueryContext&,const int,
+				     const Geometry::Vec3D&,const int) const;
 
   const std::set<int>& connectedObjects(const int) const;
   
@@ -30,6 +30,7 @@ namespace Geometry
 namespace MonteCarlo
 {
   class Object;
+  class QueryContext;
 }
 
 namespace ModelSupport
@@ -70,6 +71,8 @@ class ObjectTrackPoint : public ObjectTrackAct
   void setTarget(const Geometry::Vec3D& Pt) { TargetPt=Pt; }
 
   void addUnit(const Simulation&,const long int,const Geometry::Vec3D&);
+  void addUnit(MonteCarlo::QueryContext&,const Simulation&,
+	       const long int,const Geometry::Vec3D&,const long int =0);
 
   /// Debug function effectivley
   //  const std::map<int,ObjTrackItem>& getMap() const { return Items; }
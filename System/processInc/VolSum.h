@@ -23,6 +23,8 @@
 #define ModelSupport_VolSum_h
 
 class Simulation;
+class MTRand;
+
 namespace MonteCarlo
 {
   class Object;
@@ -57,10 +59,19 @@ class VolSum
   double fullVol;                           ///< Full volume  
   double totalDist;                         ///< Total distance
   int nTracks;                              ///< Number of full tracks
+
+  size_t nThread;                           ///< Threads [0/1 : serial]
+  unsigned int seed;                        ///< Seed of thread streams
    
   tvTYPE tallyVols;                         ///< TallyNum:Volumes
 
-  Geometry::Vec3D getCubePoint() const;
+  Geometry::Vec3D getCubePoint(MTRand&) const;
+  void setTrackArea();
+
+  void pointBlock(const Simulation&,MTRand&,const size_t);
+  void trackBlock(const Simulation&,MTRand&,const size_t);
+  void threadRun(const Simulation&,const size_t,const int);
+  void addSum(const VolSum&);
   
  public:
   
@@ -70,6 +81,7 @@ class VolSum
   ~VolSum();
 
   void reset();
+  void setThreads(const size_t,const unsigned int);
   void addDistance(const int,const double);
   void addFlux(const int,const double&,const double&);
   
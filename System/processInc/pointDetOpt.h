@@ -3,7 +3,7 @@
  
  * File:   processInc/pointDetOpt.h
  *
- * Copyright (c) 2004-2016 by Stuart Ansell
+ * Copyright (c) 2004-2017 by Stuart Ansell
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -27,27 +27,70 @@ namespace ModelSupport
 
 /*!
   \class pointDetOpt
-  \version 1.0
+  \version 2.0
   \author S. Ansell
   \brief Optimization for point detectors
-  \date December 2010
+  \date October 2017
+
+  Holds the material track length from each active cell 
+  centre to a set of detector points. The cell list is shared
+  by all the detectors and the sums are stored in one flat 
+  array [detector][cell] in cell-map order. Only detectors 
+  that have been added or moved since the last call to 
+  createObjAct are tracked.
 */
+
 class pointDetOpt
 {
  private:
   
-  double energy;              ///< Energy of neutron to test:
-  ObjectTrackPoint OA;        ///< Object information 
+  double energy;                      ///< Energy of neutron to test:
+  size_t nThread;                     ///< Tracking threads
+
+  std::vector<int> cellN;             ///< Active cell numbers
+  std::vector<Geometry::Vec3D> CofM;  ///< Centre of each active cell
+
+  std::vector<Geometry::Vec3D> DetPt; ///< Detector points
+  std::vector<int> tallyN;            ///< Tally number [0 : none]
+  std::vector<int> detValid;          ///< MatSum valid for detector
+  std::vector<double> MatSum;         ///< Material sum [det*NCell+cell]
+
+  void trackDetectors(const Simulation&,const std::vector<size_t>&);
   
  public:
-  
+
+  pointDetOpt();
   pointDetOpt(const Geometry::Vec3D&);
   pointDetOpt(const pointDetOpt&);
   pointDetOpt& operator=(const pointDetOpt&);
   ~pointDetOpt() {}  ///< Destructor
 
+  /// Set the number of tracking threads
+  void setThreads(const size_t NT) { nThread=NT; }
+  /// Number of detectors
+  size_t nDetector() const { return DetPt.size(); }
+  /// Number of active cells
+  size_t nCell() const { return cellN.size(); }
+  /// Detector point
+  const Geometry::Vec3D& getPoint(const size_t I) const
+    { return DetPt[I]; }
+  /// Has the detector been tracked/read
+  int isValid(const size_t I) const { return detValid[I]; }
+  
+  size_t addDetector(const Geometry::Vec3D&,const int =0);
+  void setDetector(const size_t,const Geometry::Vec3D&);
+  size_t addPointTallies(const Simulation&);
+  int setCells(const Simulation&);
+  
   void createObjAct(const Simulation&);
-  void addTallyOpt(const int,Simulation&);
+  double getMatSum(const size_t,const size_t) const;
+
+  void writeDetector(std::ostream&,const size_t) const;
+  void readDetector(std::istream&,const size_t);
+  
+  void addTallyOpt(const int,Simulation&) const;
+  void addTallyOpt(const size_t,const int,Simulation&) const;
+  void addTallyOpt(Simulation&) const;
 
 };
   
@@ -60,6 +60,7 @@ class volUnit
   double calcLine(const double) const;
   void addUnit(const int,const double);
   void addFlux(const int,const double,const double);
+  void addSum(const volUnit&);
 
   /// access material number
   int getMat() const { return matNum; }
@@ -65,6 +65,8 @@
 #include "surfIndex.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "Line.h"
+#include "TrackScratch.h"
 #include "Qhull.h"
 #include "ObjSurfMap.h"
 #include "neutMaterial.h"
@@ -221,6 +223,7 @@ SimMonte::runMonte(const size_t Npts)
     
   //  const int aim((Npts>10) ? Npts/10 : 1);
   const Geometry::Surface* surfPtr;
+  MonteCarlo::TrackScratch TrackBuffer;     // Intercept buffer
   MonteCarlo::neutron Nout(0,Geometry::Vec3D(0,0,0),
 			   Geometry::Vec3D(1,0,0));
   const ModelSupport::ObjSurfMap* OSMPtr =getOSM();
@@ -252,7 +255,7 @@ SimMonte::runMonte(const size_t Npts)
 	      double R=RNG.randExc();
 	      // Calculate forward Track:
 	      int surfN;
-	      surfN=Cell.trackWeight(n,R,surfPtr);   
+	      surfN=Cell.trackWeight(TrackBuffer,n,R,surfPtr);   
 	      if (surfN)  
 		OPtr=OSMPtr->findNextObject(surfN,n.Pos,
 					    OPtr->getName());
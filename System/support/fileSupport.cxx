@@ -429,6 +429,128 @@ writeStream(const std::string& Fname,const std::string& Title,
   return 0;
 }
 
+template<typename T>
+void
+writeBinary(std::ostream& OX,const T& V)
+  /*!
+    Write a value in native binary form
+    \param OX :: Output stream [binary]
+    \param V :: Value
+  */
+{
+  OX.write(reinterpret_cast<const char*>(&V),sizeof(T));
+  return;
+}
+
+template<typename T>
+void
+writeBinary(std::ostream& OX,const std::vector<T>& V)
+  /*!
+    Write a vector in native binary form [size then values]
+    \param OX :: Output stream [binary]
+    \param V :: Values
+  */
+{
+  const size_t N(V.size());
+  writeBinary(OX,N);
+  if (N)
+    OX.write(reinterpret_cast<const char*>(V.data()),
+	     static_cast<std::streamsize>(N*sizeof(T)));
+  return;
+}
+
+size_t
+remainBinary(std::istream& IX)
+  /*!
+    Determine the number of bytes left in the stream,
+    so that a length read from it can be checked before use
+    \param IX :: Input stream [binary/seekable]
+    \return bytes from the current position to the end [0 on error]
+  */
+{
+  const std::streampos cur=IX.tellg();
+  if (cur<0)
+    return 0;
+  IX.seekg(0,std::ios::end);
+  const std::streampos endPos=IX.tellg();
+  IX.seekg(cur);
+  return (endPos>cur) ? static_cast<size_t>(endPos-cur) : 0;
+}
+
+template<typename T>
+void
+readBinary(std::istream& IX,T& V)
+  /*!
+    Read a value in native binary form
+    \param IX :: Input stream [binary]
+    \param V :: Value 
+  */
+{
+  IX.read(reinterpret_cast<char*>(&V),sizeof(T));
+  if (!IX.good())
+    throw ColErr::FileError(0,"stream","readBinary : short read");
+  return;
+}
+
+template<typename T>
+void
+readBinary(std::istream& IX,std::vector<T>& V)
+  /*!
+    Read a vector in native binary form [size then values]
+    \param IX :: Input stream [binary]
+    \param V :: Values
+  */
+{
+  size_t N;
+  readBinary(IX,N);
+  if (N>remainBinary(IX)/sizeof(T))
+    throw ColErr::FileError(0,"stream","readBinary : size exceeds stream");
+  V.resize(N);
+  if (N)
+    {
+      IX.read(reinterpret_cast<char*>(V.data()),
+	      static_cast<std::streamsize>(N*sizeof(T)));
+      if (!IX.good())
+	throw ColErr::FileError(0,"stream","readBinary : short read");
+    }
+  return;
+}
+
+void
+writeBinary(std::ostream& OX,const std::string& V)
+  /*!
+    Write a string in binary form [size then characters]
+    \param OX :: Output stream [binary]
+    \param V :: String
+  */
+{
+  const size_t N(V.size());
+  writeBinary(OX,N);
+  OX.write(V.data(),static_cast<std::streamsize>(N));
+  return;
+}
+
+void
+readBinary(std::istream& IX,std::string& V)
+  /*!
+    Read a string in binary form [size then characters]
+    \param IX :: Input stream [binary]
+    \param V :: String 
+  */
+{
+  size_t N;
+  readBinary(IX,N);
+  if (N>remainBinary(IX))
+    throw ColErr::FileError(0,"stream","readBinary : size exceeds stream");
+  V.resize(N);
+  if (N)
+    {
+      IX.read(&V[0],static_cast<std::streamsize>(N));
+      if (!IX.good())
+	throw ColErr::FileError(0,"stream","readBinary : short read");
+    }
+  return;
+}
 
 /// \cond TEMPLATE 
 
@@ -461,7 +583,23 @@ template int writeStream(const std::string&,const std::string&,
 			 const std::vector<double>&,
 			 const std::vector<DError::doubleErr>&,
 			 const int);
-
+ 
+template void writeBinary(std::ostream&,const char&);
+template void writeBinary(std::ostream&,const int&);
+template void writeBinary(std::ostream&,const long int&);
+template void writeBinary(std::ostream&,const size_t&);
+template void writeBinary(std::ostream&,const double&);
+template void writeBinary(std::ostream&,const std::vector<double>&);
+template void writeBinary(std::ostream&,const std::vector<size_t>&);
+template void writeBinary(std::ostream&,const std::vector<int>&);
+template void readBinary(std::istream&,char&);
+template void readBinary(std::istream&,int&);
+template void readBinary(std::istream&,long int&);
+template void readBinary(std::istream&,size_t&);
+template void readBinary(std::istream&,double&);
+template void readBinary(std::istream&,std::vector<double>&);
+template void readBinary(std::istream&,std::vector<size_t>&);
+template void readBinary(std::istream&,std::vector<int>&);
 
 /// \endcond TEMPLATE 
 
@@ -0,0 +1,111 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   support/lineWriter.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <string>
+
+#include "lineWriter.h"
+
+namespace StrFunc
+{
+
+lineWriter::lineWriter(std::ostream& O,const size_t LC) :
+  OX(O),lineCut(LC),itemCnt(0),Buffer(1<<16),pos(0)
+  /*!
+    Constructor
+    \param O :: Output stream
+    \param LC :: Number of items before a new line
+  */
+{}
+
+lineWriter::~lineWriter()
+  /*!
+    Destructor : writes the buffer
+  */
+{
+  flush();
+}
+
+void
+lineWriter::flush()
+  /*!
+    Pass the buffer to the stream
+  */
+{
+  if (pos)
+    OX.write(Buffer.data(),static_cast<std::streamsize>(pos));
+  pos=0;
+  return;
+}
+
+void
+lineWriter::add(const double V)
+  /*!
+    Add a value as writeLine would
+    \param V :: Value
+  */
+{
+  // 13 wide + line end + nul
+  if (pos+16>Buffer.size())
+    flush();
+
+  const double AVal(std::fabs(V));
+  char* BPtr=Buffer.data()+pos;
+  const size_t N=Buffer.size()-pos;
+  const int nChar=(AVal>9.9e4 || (AVal<1e-5 && AVal>1e-38)) ?
+    std::snprintf(BPtr,N,"%13.4e",V) :
+    std::snprintf(BPtr,N,"%13.4f",V);
+
+  pos+=static_cast<size_t>(nChar);
+  if (pos>=Buffer.size())       // only for non-finite values
+    {
+      pos=Buffer.size()-1;
+      flush();
+    }
+  itemCnt++;
+  if (itemCnt==lineCut)
+    {
+      Buffer[pos++]='\n';
+      itemCnt=0;
+    }
+  return;
+}
+
+void
+lineWriter::endLine()
+  /*!
+    Finish a part line
+  */
+{
+  if (itemCnt)
+    {
+      if (pos+1>Buffer.size())
+	flush();
+      Buffer[pos++]='\n';
+      itemCnt=0;
+    }
+  return;
+}
+
+}  // NAMESPACE StrFunc
@@ -50,6 +50,14 @@ int writeStream(const std::string&,const std::string&,
 		const std::vector<T>&,const std::vector<U>&,
 		const int);
 
+template<typename T> void writeBinary(std::ostream&,const T&);
+template<typename T> void writeBinary(std::ostream&,const std::vector<T>&);
+size_t remainBinary(std::istream&);
+template<typename T> void readBinary(std::istream&,T&);
+template<typename T> void readBinary(std::istream&,std::vector<T>&);
+void writeBinary(std::ostream&,const std::string&);
+void readBinary(std::istream&,std::string&);
+
 }  // NAMESPACE StrFunc
 
 #endif
@@ -0,0 +1,63 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   supportInc/lineWriter.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef StrFunc_lineWriter_h
+#define StrFunc_lineWriter_h
+
+namespace StrFunc
+{
+
+/*!
+  \class lineWriter
+  \brief Buffered writer of values in the WWG line format
+  \author S. Ansell
+  \version 1.0
+  \date October 2017
+
+  Gives the same output as writeLine [13.4f / 13.4e, lineCut
+  items per line] but formats into a local buffer that is
+  passed to the stream in large blocks. The buffer is 
+  written on flush() and in the destructor.
+*/
+
+class lineWriter
+{
+ private:
+
+  std::ostream& OX;              ///< Output stream
+  const size_t lineCut;          ///< Items per line
+  size_t itemCnt;                ///< Place in line
+  std::vector<char> Buffer;      ///< Output buffer
+  size_t pos;                    ///< Used length of buffer
+
+ public:
+
+  lineWriter(std::ostream&,const size_t);
+  ~lineWriter();
+
+  void add(const double);
+  void endLine();
+  void flush();
+};
+
+}
+
+#endif
@@ -1087,32 +1087,24 @@ changeParticleType(Simulation& Sim,const int tNumber,
 }
 
 void
-addPointPD(Simulation& ASim)
+addPointPD(Simulation& ASim,const size_t nThread)
   /*!
     Add point detector PD option to the tally
-    Assumed that calcAllVertex has been run on ASim
+    Assumed that calcAllVertex has been run on ASim.
+    All the point tallies are tracked in one pass.
     \param ASim :: Simulation value
+    \param nThread :: Number of tracking threads
   */
 {
   ELog::RegMethod RegA("TallyCreate","addPointPD");
 
-
-  const Simulation::TallyTYPE& tmap=ASim.getTallyMap();
-  Simulation::TallyTYPE::const_iterator mc;
-  for(mc=tmap.begin();mc!=tmap.end();mc++)
+  ModelSupport::pointDetOpt PD;
+  PD.setThreads(nThread);
+  if (PD.addPointTallies(ASim))
     {
-      const pointTally* PTptr=
-	dynamic_cast<const pointTally*>(mc->second);
-      if (PTptr)
-	{
-	  const masterRotate& MR=masterRotate::Instance();
-	  ModelSupport::pointDetOpt 
-	    PD(MR.reverseRotate(PTptr->getCentre()));
-	  PD.createObjAct(ASim);
-	  PD.addTallyOpt(PTptr->getKey(),ASim);
-	}
+      PD.createObjAct(ASim);
+      PD.addTallyOpt(ASim);
     }
-  
   return;
 }
 
@@ -86,7 +86,7 @@ namespace tallySystem
   void deleteTally(Simulation&,const int);
 
 
-  void addPointPD(Simulation&);
+  void addPointPD(Simulation&,const size_t);
   void removeF5Window(Simulation&,const int);
 
   void addXMLtally(Simulation&,const std::string&);
@@ -30,6 +30,7 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/multi_array.hpp>
 
@@ -174,12 +175,16 @@ void
 Visit::populate(const Simulation* SimPtr,
 		const std::set<std::string>& Active)
   /*!
-    The big population call
+    The big population call. Each cell found in a z-row is 
+    tested once against the rest of the row [one pass over
+    its surfaces] and the results are walked ; only points
+    that leave the cell require a findCell search.
     \param SimPtr :: Simulation system
     \param Active :: Active set
    */
 {
   ELog::RegMethod RegA("Visit","populate");
+
   MonteCarlo::Object* ObjPtr(0);
   Geometry::Vec3D aVec;
 
@@ -187,12 +192,23 @@ Visit::populate(const Simulation* SimPtr,
     ModelSupport::objectRegister::Instance();
   
   const bool aEmptyFlag=Active.empty();
+  // Active Set Code:
+  auto meshValue=[&](const MonteCarlo::Object* OPtr) -> double
+    {
+      if (aEmptyFlag)
+	return getResult(OPtr);
+      const std::string rangeStr=OR.inRange(OPtr->getName());
+      return (Active.find(rangeStr)!=Active.end()) ? getResult(OPtr) : 0.0;
+    };
 
-  size_t beCnt(0);
   double stepXYZ[3];
   for(size_t i=0;i<3;i++)
     stepXYZ[i]=XYZ[i]/nPts[i];
 
+  std::vector<Geometry::Vec3D> rowPts(static_cast<size_t>(nPts[2]));
+  // Cell : first index tested in the row : validity from the index
+  typedef std::pair<size_t,std::vector<int>> RTYPE;
+  std::map<const MonteCarlo::Object*,RTYPE> rowValid;
   for(long int i=0;i<nPts[0];i++)
     {
       aVec[0]=stepXYZ[0]*(i+0.5);
@@ -202,28 +218,39 @@ Visit::populate(const Simulation* SimPtr,
 	  for(long int k=0;k<nPts[2];k++)
 	    {
 	      aVec[2]=stepXYZ[2]*(0.5+k);
-	      const Geometry::Vec3D Pt=Origin+aVec;
-	      ObjPtr=SimPtr->findCell(Pt,ObjPtr);
-	      // Active Set Code:
-	      if (!aEmptyFlag)
+	      rowPts[static_cast<size_t>(k)]=Origin+aVec;
+	    }
+
+	  rowValid.clear();
+	  long int k(0);
+	  while(k<nPts[2])
+	    {
+	      if (ObjPtr)
 		{
-		  const std::string rangeStr=OR.inRange(ObjPtr->getName());
-		  if (Active.find(rangeStr)!=Active.end())
+		  const size_t kIndex(static_cast<size_t>(k));
+		  std::map<const MonteCarlo::Object*,RTYPE>::iterator mc=
+		    rowValid.find(ObjPtr);
+		  if (mc==rowValid.end())
 		    {
-		      mesh[i][j][k]=getResult(ObjPtr);
+		      mc=rowValid.emplace(ObjPtr,RTYPE(kIndex,{})).first;
+		      const std::vector<Geometry::Vec3D>
+			restPts(rowPts.begin()+k,rowPts.end());
+		      ObjPtr->isValid(restPts,mc->second.second);
 		    }
-		  else
-		    mesh[i][j][k]=0.0;
-		}
-	      // OLD Code:
-	      else
-		{
-		  mesh[i][j][k]=getResult(ObjPtr);
-		  if (outType==VISITenum::material && 
-		      fabs(mesh[i][j][k]-37)<1e-4)
-		    beCnt++;
+		  const size_t offset(mc->second.first);
+		  const std::vector<int>& VValid(mc->second.second);
+		  const double value=meshValue(ObjPtr);
+		  while(k<nPts[2] && 
+			VValid[static_cast<size_t>(k)-offset])
+		    {
+		      mesh[i][j][k]=value;
+		      k++;
+		    }
+		  if (k==nPts[2]) break;
 		}
-
+	      ObjPtr=SimPtr->findCell(rowPts[static_cast<size_t>(k)],ObjPtr);
+	      mesh[i][j][k]=meshValue(ObjPtr);
+	      k++;
 	    }
 	}
     }
@@ -42,6 +42,7 @@
 #include "BaseModVisit.h"
 #include "mathSupport.h"
 #include "support.h"
+#include "fileSupport.h"
 #include "MapSupport.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
@@ -120,6 +121,29 @@ CellWeight::addTracks(const long int cN,const double value)
   return;
 }
 
+void
+CellWeight::addTracks(const CellWeight& A)
+  /*!
+    Adds the track contributions of another CellWeight
+    \param A :: CellWeight to add
+  */
+{
+  ELog::RegMethod RegA("CellWeight","addTracks(CellWeight)");
+  
+  for(const CMapTYPE::value_type& cv : A.Cells)
+    {
+      CMapTYPE::iterator mc=Cells.find(cv.first);
+      if (mc==Cells.end())
+	Cells.emplace(cv.first,cv.second);
+      else
+	{
+	  mc->second.weight+=cv.second.weight;
+	  mc->second.number+=cv.second.number;
+	}
+    }
+  return;
+}
+
 double
 CellWeight::calcMinWeight(const double scaleFactor,
                           const double weightPower) const
@@ -134,7 +158,7 @@ CellWeight::calcMinWeight(const double scaleFactor,
   double minW(1e38);
   for(const CMapTYPE::value_type& cv : Cells)
     {
-      double W=exp(-cv.second.weight*sigmaScale*scaleFactor);
+      double W=exp(-cv.second.average()*sigmaScale*scaleFactor);
       if (W>1e-20)
         {
           W=std::pow(W,weightPower);
@@ -190,7 +214,7 @@ CellWeight::updateWM(const double eCut,
 
   for(const CMapTYPE::value_type& cv : Cells)
     {
-      double W=exp(-cv.second.weight*sigmaScale*scaleFactor*factor);
+      double W=exp(-cv.second.average()*sigmaScale*scaleFactor*factor);
       if (W<minWeight) W=1.0;    // avoid sqrt(-ve number etc)
       W=std::pow(W,weightPower);
 
@@ -249,8 +273,8 @@ CellWeight::invertWM(const double eCut,
 
   for(const CMapTYPE::value_type& cv : Cells)
     {
-      double W=(exp(-cv.second.weight*sigmaScale*scaleFactor*factor));
-      double WA=(exp(-cv.second.weight*sigmaScale*scaleFactor));
+      double W=(exp(-cv.second.average()*sigmaScale*scaleFactor*factor));
+      double WA=(exp(-cv.second.average()*sigmaScale*scaleFactor));
       if (WA>1e-20)
         {
           W=std::pow(W,weightPower);
@@ -281,6 +305,50 @@ CellWeight::write(std::ostream& OX) const
   return;
 } 
 
+void
+CellWeight::writeBinary(std::ostream& OX) const
+  /*!
+    Write out the tracks in binary form
+    \param OX :: Output stream [binary]
+  */
+{
+  StrFunc::writeBinary(OX,Cells.size());
+  for(const std::map<long int,CellItem>::value_type& cv : Cells)
+    {
+      StrFunc::writeBinary(OX,cv.first);
+      StrFunc::writeBinary(OX,cv.second.vCell);
+      StrFunc::writeBinary(OX,cv.second.weight);
+      StrFunc::writeBinary(OX,cv.second.number);
+    }
+  return;
+} 
+
+void
+CellWeight::readBinary(std::istream& IX) 
+  /*!
+    Read the tracks written by writeBinary [replaces current]
+    \param IX :: Input stream [binary]
+  */
+{
+  ELog::RegMethod RegA("CellWeight","readBinary");
+  
+  size_t N;
+  StrFunc::readBinary(IX,N);
+  CMapTYPE Out;
+  for(size_t i=0;i<N;i++)
+    {
+      long int cN;
+      CellItem CI(0.0);
+      StrFunc::readBinary(IX,cN);
+      StrFunc::readBinary(IX,CI.vCell);
+      StrFunc::readBinary(IX,CI.weight);
+      StrFunc::readBinary(IX,CI.number);
+      Out.emplace(cN,CI);
+    }
+  Cells.swap(Out);
+  return;
+} 
+
     
   
 } // namespace WeightSystem
@@ -31,6 +31,9 @@
 #include <string>
 #include <algorithm>
 #include <memory>
+#include <atomic>
+#include <exception>
+#include <thread>
 #include <boost/multi_array.hpp>
 
 #include "Exception.h"
@@ -47,6 +50,7 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "Line.h"
 #include "Mesh3D.h"
 #include "Rules.h"
 #include "varList.h"
@@ -56,14 +60,19 @@
 #include "BaseMap.h"
 #include "CellMap.h"
 #include "Object.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "Qhull.h"
 
 #include "Simulation.h"
 
 #include "LineTrack.h"
+#include "AttnTable.h"
 #include "ObjectTrackAct.h"
 #include "ObjectTrackPoint.h"
 #include "WWG.h"
+#include "WWGWeight.h"
 
 #include "MarkovProcess.h"
 
@@ -72,7 +81,9 @@ namespace WeightSystem
 {
 
 
-MarkovProcess::MarkovProcess()
+MarkovProcess::MarkovProcess() :
+  nIteration(0),WX(0),WY(0),WZ(0),FSize(0),
+  nThread(1),maxRange(-1.0)
  /*! 
     Constructor 
   */
@@ -80,7 +91,8 @@ MarkovProcess::MarkovProcess()
 
 MarkovProcess::MarkovProcess(const MarkovProcess& A) : 
   nIteration(A.nIteration),WX(A.WX),WY(A.WY),WZ(A.WZ),
-  FSize(A.FSize),fluxField(A.fluxField)
+  FSize(A.FSize),nThread(A.nThread),maxRange(A.maxRange),
+  rowStart(A.rowStart),colIndex(A.colIndex),fluxField(A.fluxField)
   /*!
     Copy constructor
     \param A :: MarkovProcess to copy
@@ -102,6 +114,10 @@ MarkovProcess::operator=(const MarkovProcess& A)
       WY=A.WY;
       WZ=A.WZ;
       FSize=A.FSize;
+      nThread=A.nThread;
+      maxRange=A.maxRange;
+      rowStart=A.rowStart;
+      colIndex=A.colIndex;
       fluxField=A.fluxField;
     }
   return *this;
@@ -129,12 +145,41 @@ MarkovProcess::initializeData(const WWG& wSet)
   WZ=static_cast<long int>(grid.getZSize());
 
   FSize=WX*WY*WZ;
-  
-  fluxField.resize(boost::extents[FSize][FSize]);
-  
+
+  // identity matrix
+  rowStart.resize(static_cast<size_t>(FSize+1));
+  colIndex.resize(static_cast<size_t>(FSize));
+  fluxField.assign(static_cast<size_t>(FSize),1.0);
+  for(long int i=0;i<FSize;i++)
+    {
+      rowStart[static_cast<size_t>(i)]=static_cast<size_t>(i);
+      colIndex[static_cast<size_t>(i)]=i;
+    }
+  rowStart.back()=static_cast<size_t>(FSize);
   return;
 }
 
+double
+MarkovProcess::cutRange(const double r2Length,
+			const double r2Power) const
+  /*!
+    Distance beyond which no coupling can pass the cut.
+    The attenuation is always positive so the weight is
+    less than -r2Power*log(r/r2Length) which must be 
+    greater than -20.
+    \param r2Length :: scale factor for length
+    \param r2Power :: power of 1/r^2 factor
+    \return max distance [-ve for no limit]
+   */
+{
+  double R(-1.0);
+  if (r2Power>Geometry::zeroTol && 20.0/r2Power<700.0)
+    R=r2Length*exp(20.0/r2Power);
+  if (maxRange>0.0 && (R<0.0 || maxRange<R))
+    R=maxRange;
+  return R;
+}
+
 void
 MarkovProcess::computeMatrix(const Simulation& System,
 			     const WWG& wSet,
@@ -143,6 +188,10 @@ MarkovProcess::computeMatrix(const Simulation& System,
 			     const double r2Power)
   /*!
     Calculate the makov chain process
+    Each row is the coupling to the other mesh points in 
+    range [upper triangle only as symmetric]. Rows are built by 
+    nThread workers and the tracks of adjacent points in 
+    a row guide each other.
     \param System :: Simualation
     \param wSet :: WWG set for grid
     \param densityFactor :: Scaling factor for density
@@ -153,36 +202,273 @@ MarkovProcess::computeMatrix(const Simulation& System,
   ELog::RegMethod RegA("MarkovProcess","computeMatrix");
 
   const Geometry::Mesh3D& grid=wSet.getGrid();
-  const std::vector<Geometry::Vec3D> midPts=wSet.getMidPoints();
+  const std::vector<Geometry::Vec3D>& midPts=wSet.getMidPoints();
 
   if (static_cast<long int>(midPts.size())!=FSize)
     throw ColErr::MisMatch<long int>
       (static_cast<long int>(midPts.size()),FSize,"MidPts.size != FSize");
 
-  for(long int i=0;i<FSize;i++)
-    fluxField[i][i]=1.0;
+  // Mid point coordinates on each axis
+  std::vector<double> XMid,YMid,ZMid;
+  for(long int i=0;i<WX;i++)
+    XMid.push_back((grid.getXCoordinate(static_cast<size_t>(i))+
+		    grid.getXCoordinate(static_cast<size_t>(i+1)))/2.0);
+  for(long int i=0;i<WY;i++)
+    YMid.push_back((grid.getYCoordinate(static_cast<size_t>(i))+
+		    grid.getYCoordinate(static_cast<size_t>(i+1)))/2.0);
+  for(long int i=0;i<WZ;i++)
+    ZMid.push_back((grid.getZCoordinate(static_cast<size_t>(i))+
+		    grid.getZCoordinate(static_cast<size_t>(i+1)))/2.0);
 
-  for(long int i=0;i<FSize;i++)
+  const double R=cutRange(r2Length,r2Power);
+  ModelSupport::AttnTable ATable;
+  ATable.build(1);
+  // index range [IA,IB) of points within R of V
+  auto axisRange=[R](const std::vector<double>& Mid,const double V,
+		     long int& IA,long int& IB)
+    {
+      if (R<0.0)
+	{
+	  IA=0;
+	  IB=static_cast<long int>(Mid.size());
+	  return;
+	}
+      IA=std::lower_bound(Mid.begin(),Mid.end(),V-R)-Mid.begin();
+      IB=std::upper_bound(Mid.begin(),Mid.end(),V+R)-Mid.begin();
+      return;
+    };
+  
+  // Upper triangle of each row
+  std::vector<std::vector<long int>> UCol(static_cast<size_t>(FSize));
+  std::vector<std::vector<double>> UValue(static_cast<size_t>(FSize));
+
+  const size_t NRow(static_cast<size_t>(FSize));
+  const size_t NT((nThread>1 && nThread<NRow) ? nThread :
+		  ((nThread>1 && NRow) ? NRow : 1));
+  std::atomic<size_t> nextRow(0);
+  std::vector<std::exception_ptr> Fail(NT);
+  
+  auto worker=[&](const size_t TIndex)
+    {
+      try
+	{
+	  MonteCarlo::QueryContext QC;
+	  std::vector<double> AT;
+	  for(size_t uI=nextRow++;uI<NRow;uI=nextRow++)
+	    {
+	      const long int i(static_cast<long int>(uI));
+	      const long int IX=i/(WY*WZ);
+	      const long int IY=(i/WZ) % WY;
+	      const long int IZ=i % WZ;
+	      long int XA,XB,YA,YB,ZA,ZB;
+	      axisRange(XMid,XMid[static_cast<size_t>(IX)],XA,XB);
+	      axisRange(YMid,YMid[static_cast<size_t>(IY)],YA,YB);
+	      axisRange(ZMid,ZMid[static_cast<size_t>(IZ)],ZA,ZB);
+	      if (XA<IX) XA=IX;
+	      
+	      ModelSupport::ObjectTrackPoint OTrack(midPts[uI]);
+	      std::vector<long int>& Col=UCol[uI];
+	      std::vector<double>& Value=UValue[uI];
+	      for(long int a=XA;a<XB;a++)
+		for(long int b=YA;b<YB;b++)
+		  {
+		    OTrack.clearAll();
+		    long int guideN(0);
+		    for(long int c=ZA;c<ZB;c++)
+		      {
+			const long int j((a*WY+b)*WZ+c);
+			if (j<=i) continue;
+			const size_t uJ(static_cast<size_t>(j));
+			if (R>0.0 && midPts[uJ].Distance(midPts[uI])>R)
+			  continue;
+			OTrack.addUnit(QC,System,j+1,midPts[uJ],guideN);
+			guideN=j+1;
+			double DistT=OTrack.getDistance(j+1)/r2Length;
+			if (DistT<1.0) DistT=1.0;
+			OTrack.getAttnSum(j+1,ATable,AT);
+			const double WFactor= 
+			  -densityFactor*AT[0]-r2Power*log(DistT);
+			if (WFactor>-20)
+			  {
+			    Col.push_back(j);
+			    Value.push_back(exp(WFactor));
+			  }
+		      }
+		  }
+	    }
+	}
+      catch(...)
+	{
+	  Fail[TIndex]=std::current_exception();
+	  nextRow=NRow;
+	}
+    };
+  
+  std::vector<std::thread> Workers;
+  for(size_t i=1;i<NT;i++)
+    Workers.push_back(std::thread(worker,i));
+  worker(0);
+  for(std::thread& TH : Workers)
+    TH.join();
+  for(size_t i=0;i<NT;i++)
+    if (Fail[i])
+      std::rethrow_exception(Fail[i]);
+
+  // Assemble the symmetric matrix : [lower : diagonal : upper]
+  std::vector<size_t> nLower(NRow,0);
+  for(size_t i=0;i<NRow;i++)
+    for(const long int j : UCol[i])
+      nLower[static_cast<size_t>(j)]++;
+
+  rowStart.resize(NRow+1);
+  rowStart[0]=0;
+  for(size_t i=0;i<NRow;i++)
+    rowStart[i+1]=rowStart[i]+nLower[i]+1+UCol[i].size();
+  colIndex.resize(rowStart.back());
+  fluxField.resize(rowStart.back());
+
+  std::vector<size_t> lowerPos(rowStart.begin(),rowStart.end()-1);
+  for(size_t i=0;i<NRow;i++)
     {
-      const size_t uI(static_cast<size_t>(i));
-      ModelSupport::ObjectTrackPoint OTrack(midPts[uI]); 
-      for(long int j=i+1;j<FSize;j++)
+      size_t index=rowStart[i]+nLower[i];
+      colIndex[index]=static_cast<long int>(i);
+      fluxField[index]=1.0;
+      for(size_t k=0;k<UCol[i].size();k++)
 	{
-	  const size_t uJ(static_cast<size_t>(i));
-	  OTrack.addUnit(System,j,midPts[uJ]);
-	  double DistT=OTrack.getDistance(j)/r2Length;
-	  if (DistT<1.0) DistT=1.0;
-	  const double AT=OTrack.getAttnSum(j);  // this can take an
-	  const double WFactor= -densityFactor*AT-r2Power*log(DistT);
-	  if (WFactor>-20)
-	    fluxField[i][j]=fluxField[j][i]=exp(-WFactor);
-	  else
-	    fluxField[i][j]=fluxField[j][i]=0.0;
+	  index++;
+	  const size_t uJ(static_cast<size_t>(UCol[i][k]));
+	  colIndex[index]=UCol[i][k];
+	  fluxField[index]=UValue[i][k];
+	  colIndex[lowerPos[uJ]]=static_cast<long int>(i);
+	  fluxField[lowerPos[uJ]]=UValue[i][k];
+	  lowerPos[uJ]++;
 	}
     }
+  ELog::EM<<"Markov matrix "<<FSize<<" points : "<<fluxField.size()
+	  <<" values [range "<<R<<"]"<<ELog::endDiag;
   return;
 }
 
+double
+MarkovProcess::getValue(const long int i,const long int j) const
+  /*!
+    Get a value of the matrix
+    \param i :: Row index
+    \param j :: Column index
+    \return value [0 if not stored]
+  */
+{
+  ELog::RegMethod RegA("MarkovProcess","getValue");
   
+  if (i<0 || i>=FSize)
+    throw ColErr::IndexError<long int>(i,FSize,"i");
+  if (j<0 || j>=FSize)
+    throw ColErr::IndexError<long int>(j,FSize,"j");
+
+  const size_t uI(static_cast<size_t>(i));
+  std::vector<long int>::const_iterator AC=colIndex.begin()+
+    static_cast<long int>(rowStart[uI]);
+  std::vector<long int>::const_iterator BC=colIndex.begin()+
+    static_cast<long int>(rowStart[uI+1]);
+  std::vector<long int>::const_iterator mc=std::lower_bound(AC,BC,j);
+  if (mc==BC || *mc!=j)
+    return 0.0;
+  return fluxField[static_cast<size_t>(mc-colIndex.begin())];
+}
+
+void
+MarkovProcess::multiply(const std::vector<double>& In,
+			std::vector<double>& Out) const
+  /*!
+    Apply the matrix to a flux vector
+    \param In :: Flux vector [FSize]
+    \param Out :: Matrix x In
+  */
+{
+  ELog::RegMethod RegA("MarkovProcess","multiply");
+
+  if (static_cast<long int>(In.size())!=FSize)
+    throw ColErr::MisMatch<long int>
+      (static_cast<long int>(In.size()),FSize,"In.size != FSize");
+  
+  const size_t NRow(static_cast<size_t>(FSize));
+  Out.resize(NRow);
+  for(size_t i=0;i<NRow;i++)
+    {
+      double sum(0.0);
+      for(size_t k=rowStart[i];k<rowStart[i+1];k++)
+	sum+=fluxField[k]*In[static_cast<size_t>(colIndex[k])];
+      Out[i]=sum;
+    }
+  return;
+}
+
+size_t
+MarkovProcess::solveFlux(std::vector<double>& Flux,
+			 const double tol) const
+  /*!
+    Iterate the flux through the matrix. Each step is 
+    normalized to a maximum of 1.0. Stops after nIteration
+    steps or if the largest change is less than tol.
+    \param Flux :: Initial flux / Final flux
+    \param tol :: Tolerance for convergence
+    \return number of steps
+  */
+{
+  ELog::RegMethod RegA("MarkovProcess","solveFlux");
+
+  std::vector<double> Next;
+  for(size_t step=0;step<nIteration;step++)
+    {
+      multiply(Flux,Next);
+      const double maxV=*std::max_element(Next.begin(),Next.end());
+      if (maxV<=0.0) return step;
+
+      double diff(0.0);
+      for(size_t i=0;i<Next.size();i++)
+	{
+	  Next[i]/=maxV;
+	  const double D=std::abs(Next[i]-Flux[i]);
+	  if (D>diff) diff=D;
+	}
+      Flux.swap(Next);
+      if (diff<tol) return step+1;
+    }
+  return nIteration;
+}
+
+void
+MarkovProcess::computeFlux(const WWG& wwg,WWGWeight& wSet) const
+  /*!
+    Propagate the WWG mesh weights through the matrix for 
+    each energy bin and set the log of the result in wSet
+    \param wwg :: WWG with initial mesh
+    \param wSet :: Output weights [log form]
+  */
+{
+  ELog::RegMethod RegA("MarkovProcess","computeFlux");
+
+  const boost::multi_array<double,4>& WMesh=wwg.getMesh();
+  const long int NE(wSet.getESize());
+  std::vector<double> Flux(static_cast<size_t>(FSize));
+  for(long int e=0;e<NE;e++)
+    {
+      long int index(0);
+      for(long int i=0;i<WX;i++)
+	for(long int j=0;j<WY;j++)
+	  for(long int k=0;k<WZ;k++)
+	    Flux[static_cast<size_t>(index++)]=WMesh[i][j][k][e];
+
+      const size_t nStep=solveFlux(Flux,1e-6);
+      ELog::EM<<"Markov energy bin "<<e<<" : "<<nStep<<" steps"
+	      <<ELog::endDiag;
+      for(long int i=0;i<FSize;i++)
+	{
+	  const double F=Flux[static_cast<size_t>(i)];
+	  wSet.setPoint(i,e,(F>1e-30) ? log(F) : log(1e-30));
+	}
+    }
+  return;
+}
   
 } // namespace WeightSystem
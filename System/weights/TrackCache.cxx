@@ -0,0 +1,276 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   weight/TrackCache.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex> 
+#include <vector>
+#include <list>
+#include <set>
+#include <map> 
+#include <string>
+#include <algorithm>
+#include <memory>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "support.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Surface.h"
+#include "Rules.h"
+#include "varList.h"
+#include "Code.h"
+#include "FuncDataBase.h"
+#include "HeadRule.h"
+#include "Object.h"
+#include "Qhull.h"
+#include "Zaid.h"
+#include "MXcards.h"
+#include "Material.h"
+#include "DBMaterial.h"
+#include "MD5hash.h"
+#include "Simulation.h"
+#include "TrackCache.h"
+
+namespace WeightSystem
+{
+
+const char TrackCache::cacheTag[8]={'C','L','T','R','K','C','1','\0'};
+  
+TrackCache::TrackCache() 
+  /*! 
+    Constructor [inactive]
+  */
+{}
+
+TrackCache::TrackCache(const TrackCache& A)  :
+  cacheDir(A.cacheDir),geomKey(A.geomKey)
+  /*! 
+    Copy Constructor 
+    \param A :: TrackCache to copy
+  */
+{}
+
+TrackCache&
+TrackCache::operator=(const TrackCache& A)
+  /*! 
+    Assignment operator
+    \param A :: TrackCache to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      cacheDir=A.cacheDir;
+      geomKey=A.geomKey;
+    }
+  return *this;
+}
+
+void
+TrackCache::setDirectory(const std::string& D)
+  /*!
+    Set the directory for the cache files
+    \param D :: Directory [empty to turn off]
+  */
+{
+  cacheDir=D;
+  while (cacheDir.size()>1 && cacheDir.back()=='/')
+    cacheDir.pop_back();
+  return;
+}
+  
+void
+TrackCache::setGeometry(const Simulation& System)
+  /*!
+    Set the geometry key from the variables,
+    the cell name/material/rule of each cell, the card of
+    each surface used [after rotation] and the
+    density and zaid/fraction list of each material used
+    \param System :: Simulation to use [cells populated]
+  */
+{
+  ELog::RegMethod RegA("TrackCache","setGeometry");
+
+  const ModelSupport::DBMaterial& DB=
+    ModelSupport::DBMaterial::Instance();
+
+  std::ostringstream cx;
+  cx.precision(12);
+  cx<<System.getDataBase().variableHash()<<"\n";
+  std::set<int> matSet;
+  std::map<int,const Geometry::Surface*> surfMap;
+  for(const Simulation::OTYPE::value_type& mc : System.getCells())
+    {
+      cx<<mc.first<<" "<<mc.second->getMat()<<" "
+	<<mc.second->cellCompStr()<<"\n";
+      if (mc.second->getMat())
+	matSet.insert(mc.second->getMat());
+      for(const Geometry::Surface* SPtr : mc.second->getSurList())
+	surfMap.emplace(SPtr->getName(),SPtr);
+    }
+  for(const std::map<int,const Geometry::Surface*>::value_type& sc : surfMap)
+    sc.second->write(cx);
+  for(const int matN : matSet)
+    {
+      if (!DB.hasKey(matN)) continue;
+      const MonteCarlo::Material& matInfo=DB.getMaterial(matN);
+      cx<<"m"<<matN<<" "<<matInfo.getAtomDensity();
+      for(const Zaid& ZItem : matInfo.getZaidVec())
+	cx<<" "<<ZItem.getZaidNum()<<"."<<ZItem.getTag()
+	  <<ZItem.getKey()<<" "<<ZItem.getDensity();
+      cx<<"\n";
+    }
+  
+  MD5hash Sum;
+  geomKey=Sum.processMessage(cx.str());
+  return;
+}
+
+std::string
+TrackCache::makeKey(const std::string& unitType,
+		    const std::vector<double>& Desc) const
+  /*!
+    Make the key for a track set
+    \param unitType :: Type of track set [source/units]
+    \param Desc :: Numbers defining the source and points
+    \return Key string [empty if not active]
+  */
+{
+  ELog::RegMethod RegA("TrackCache","makeKey");
+
+  if (!isActive()) return "";
+
+  std::string Msg(geomKey+" "+unitType+" ");
+  Msg.append(reinterpret_cast<const char*>(Desc.data()),
+	     Desc.size()*sizeof(double));
+  MD5hash Sum;
+  return Sum.processMessage(Msg);
+}
+
+std::string
+TrackCache::fileName(const std::string& Key) const
+  /*!
+    Name of the file for a key
+    \param Key :: Key string
+    \return file name
+  */
+{
+  return cacheDir+"/track_"+Key+".bin";
+}
+
+bool
+TrackCache::openRead(const std::string& Key,std::ifstream& IX) const
+  /*!
+    Open the file for a key and check its header
+    \param Key :: Key string
+    \param IX :: Input stream [placed after the header]
+    \return true if the file is valid for the key
+  */
+{
+  ELog::RegMethod RegA("TrackCache","openRead");
+  
+  if (!isActive()) return 0;
+  
+  IX.open(fileName(Key).c_str(),std::ios::binary);
+  if (!IX.good()) return 0;
+
+  char tag[sizeof(cacheTag)];
+  std::string fileKey(Key.size(),' ');
+  IX.read(tag,sizeof(tag));
+  IX.read(&fileKey[0],static_cast<std::streamsize>(fileKey.size()));
+  if (!IX.good() || !std::equal(tag,tag+sizeof(tag),cacheTag) ||
+      fileKey!=Key)
+    {
+      ELog::EM<<"Track cache "<<fileName(Key)<<" invalid"<<ELog::endWarn;
+      IX.close();
+      return 0;
+    }
+  ELog::EM<<"Track cache used: "<<fileName(Key)<<ELog::endDiag;
+  return 1;
+}
+
+bool
+TrackCache::openWrite(const std::string& Key,std::ofstream& OX) const
+  /*!
+    Open the file for a key and write its header
+    \param Key :: Key string
+    \param OX :: Output stream [placed after the header]
+    \return true if the file can be written
+  */
+{
+  ELog::RegMethod RegA("TrackCache","openWrite");
+  
+  if (!isActive()) return 0;
+  
+  OX.open(fileName(Key).c_str(),std::ios::binary);
+  if (!OX.good())
+    {
+      ELog::EM<<"Unable to write track cache "<<fileName(Key)<<ELog::endWarn;
+      return 0;
+    }
+  OX.write(cacheTag,sizeof(cacheTag));
+  OX.write(Key.c_str(),static_cast<std::streamsize>(Key.size()));
+  return 1;
+}
+
+void
+TrackCache::addDesc(std::vector<double>& Desc,
+		    const Geometry::Vec3D& Pt)
+  /*!
+    Add a point to a key description
+    \param Desc :: Description to extend
+    \param Pt :: Point to add
+  */
+{
+  Desc.push_back(Pt[0]);
+  Desc.push_back(Pt[1]);
+  Desc.push_back(Pt[2]);
+  return;
+}
+
+void
+TrackCache::addDesc(std::vector<double>& Desc,
+		    const std::vector<Geometry::Vec3D>& Pts)
+  /*!
+    Add a set of points to a key description
+    \param Desc :: Description to extend
+    \param Pts :: Points to add
+  */
+{
+  Desc.reserve(Desc.size()+3*Pts.size());
+  for(const Geometry::Vec3D& Pt : Pts)
+    addDesc(Desc,Pt);
+  return;
+}
+  
+} // namespace WeightSystem
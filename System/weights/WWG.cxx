@@ -32,6 +32,8 @@
 #include <string>
 #include <algorithm>
 #include <memory>
+#include <exception>
+#include <thread>
 #include <boost/multi_array.hpp>
 #include <boost/format.hpp>
 
@@ -47,6 +49,8 @@
 #include "Matrix.h"
 #include "Vec3D.h"
 #include "support.h"
+#include "fileSupport.h"
+#include "lineWriter.h"
 #include "Rules.h"
 #include "varList.h"
 #include "Code.h"
@@ -65,9 +69,11 @@
 namespace WeightSystem
 {
 
+const char WWG::binaryTag[8]={'C','L','W','W','G','B','1','\0'};
+
 WWG::WWG() :
   ptype('n'),wupn(8.0),wsurv(1.4),maxsp(5),
-  mwhere(-1),mtime(0),switchn(-2),
+  mwhere(-1),mtime(0),switchn(-2),nThread(1),
   EBin({1e8})
   /*!
     Constructor : 
@@ -78,7 +84,7 @@ WWG::WWG() :
 WWG::WWG(const WWG& A) : 
   ptype(A.ptype),wupn(A.wupn),wsurv(A.wsurv),maxsp(A.maxsp),
   mwhere(A.mwhere),mtime(A.mtime),switchn(A.switchn),
-  EBin(A.EBin),Grid(A.Grid),WMesh(A.WMesh)
+  nThread(A.nThread),EBin(A.EBin),Grid(A.Grid),WMesh(A.WMesh)
   /*!
     Copy constructor
     \param A :: WWG to copy
@@ -102,6 +108,7 @@ WWG::operator=(const WWG& A)
       mwhere=A.mwhere;
       mtime=A.mtime;
       switchn=A.switchn;
+      nThread=A.nThread;
       EBin=A.EBin;
       Grid=A.Grid;
       WMesh=A.WMesh;
@@ -150,15 +157,7 @@ WWG::resetMesh(const std::vector<double>& W)
   
   
   WMesh.resize(boost::extents[LX][LY][LZ][EBSize]);
-  for(long int i=0;i<LX;i++)
-    for(long int j=0;j<LY;j++)
-      for(long int k=0;k<LZ;k++)
-	for(long int e=0;e<EBSize;e++)
-	  {
-	    WMesh[i][j][k][e]=0.0;   // W[static_cast<size_t>(e)];
-	  }
-
-  
+  std::fill(WMesh.data(),WMesh.data()+WMesh.num_elements(),0.0);
   return;
 }
 
@@ -191,6 +190,76 @@ WWG::setEnergyBin(const std::vector<double>& EB,
 }
 
     
+template<typename F>
+void
+WWG::blockRun(const size_t NData,const F& Func) const
+  /*!
+    Run a function over contiguous ranges of the flat mesh
+    buffer. Large meshes are split into nThread ranges each
+    run on its own thread. 
+    \param NData :: Number of items
+    \param Func :: Function(thread index,first,last+1) 
+  */
+{
+  // below this the thread start up costs more than the pass
+  const size_t parallelSize(1UL<<16);
+  const size_t NT((nThread>1 && NData>=parallelSize) ? nThread : 1);
+  
+  std::vector<std::exception_ptr> Fail(NT);
+  auto worker=[&](const size_t TIndex)
+    {
+      try
+	{
+	  Func(TIndex,(NData*TIndex)/NT,(NData*(TIndex+1))/NT);
+	}
+      catch(...)
+	{
+	  Fail[TIndex]=std::current_exception();
+	}
+    };
+  
+  std::vector<std::thread> Workers;
+  for(size_t i=1;i<NT;i++)
+    Workers.push_back(std::thread(worker,i));
+  worker(0);
+  for(std::thread& TH : Workers)
+    TH.join();
+  
+  for(size_t i=0;i<NT;i++)
+    if (Fail[i])
+      std::rethrow_exception(Fail[i]);
+  return;
+}
+
+void
+WWG::meshRange(double& minValue,double& maxValue) const
+  /*!
+    Get the min/max value of the mesh in one pass
+    \param minValue :: Min value 
+    \param maxValue :: Max value
+  */
+{
+  const double* TData=WMesh.data();
+  const size_t NData=WMesh.num_elements();
+  
+  std::vector<double> minV(nThread+1,1e38);
+  std::vector<double> maxV(nThread+1,-1e38);
+  blockRun(NData,[&](const size_t TI,const size_t IA,const size_t IB)
+	   {
+	     double minT(1e38),maxT(-1e38);
+	     for(size_t i=IA;i<IB;i++)
+	       {
+		 minT=std::min(minT,TData[i]);
+		 maxT=std::max(maxT,TData[i]);
+	       }
+	     minV[TI]=minT;
+	     maxV[TI]=maxT;
+	   });
+  minValue=*std::min_element(minV.begin(),minV.end());
+  maxValue=*std::max_element(maxV.begin(),maxV.end());
+  return;
+}
+
 void
 WWG::updateWM(const WWGWeight& UMesh,
               const double scaleFactor)
@@ -206,34 +275,36 @@ WWG::updateWM(const WWGWeight& UMesh,
   const boost::multi_array<double,4>& UGrid=
     UMesh.getGrid();
 
-  // centre sizes - not 0:
-  const long int NX=UMesh.getXSize(); 
-  const long int NY=UMesh.getYSize();
-  const long int NZ=UMesh.getZSize();
-  const long int NE=UMesh.getESize();
-
-  double MinMesh(1e8);
-  double MinW(1e8);
-  double W;
+  const size_t NData=WMesh.num_elements();
+  if (UGrid.num_elements()!=NData)
+    throw ColErr::MisMatch<size_t>(UGrid.num_elements(),NData,
+				   "WWGWeight/WMesh size");
   
-  for(long int i=0;i<NX;i++)
-    for(long int j=0;j<NY;j++)
-      for(long int k=0;k<NZ;k++)
-	for(long int e=0;e<NE;e++)
-	  {
-	    W=UGrid[i][j][k][e]*scaleFactor;
-	    if (W>-40)
-	      {
-		W=exp(W);
-		WMesh[i][j][k][e]+=W;
-		if (WMesh[i][j][k][e]<MinMesh)
-		  MinMesh=WMesh[i][j][k][e];
-		if (W<MinW)
-		  MinW=W;
-			 
-	      }
-	  }
-  ELog::EM<<"Min == "<<MinW<<" "<<MinMesh<<" "<<scaleFactor<<ELog::endDiag;
+  const double* UData=UGrid.data();
+  double* TData=WMesh.data();
+
+  std::vector<double> MinMesh(nThread+1,1e8);
+  std::vector<double> MinW(nThread+1,1e8);
+  blockRun(NData,[&](const size_t TI,const size_t IA,const size_t IB)
+	   {
+	     double minM(1e8),minW(1e8);
+	     for(size_t i=IA;i<IB;i++)
+	       {
+		 const double W=UData[i]*scaleFactor;
+		 if (W>-40)
+		   {
+		     const double EW=exp(W);
+		     TData[i]+=EW;
+		     minM=std::min(minM,TData[i]);
+		     minW=std::min(minW,EW);
+		   }
+	       }
+	     MinMesh[TI]=minM;
+	     MinW[TI]=minW;
+	   });
+  ELog::EM<<"Min == "<<*std::min_element(MinW.begin(),MinW.end())<<" "
+	  <<*std::min_element(MinMesh.begin(),MinMesh.end())<<" "
+	  <<scaleFactor<<ELog::endDiag;
   
   return;
 }
@@ -276,16 +347,7 @@ WWG::powerRange(const double pR)
    */
 {
   ELog::RegMethod RegA("WWG","powerRange");
-
-  double* TData=WMesh.data();
-
-  const size_t NData=WMesh.num_elements();
-  if (NData && std::abs(pR-1.0)>Geometry::zeroTol)
-    {
-      ELog::EM<<"power range == "<<pR<<ELog::endDiag;
-      for(size_t i=0;i<NData;i++)
-        TData[i]=std::pow(TData[i],pR);
-    }
+  process({WWGStep(WWGStep::SType::power,pR)});
   return;
 }
 
@@ -297,18 +359,7 @@ WWG::normalize()
   */
 {
   ELog::RegMethod RegA("WWG","normalize");
-
-  double* TData=WMesh.data();
-
-  const size_t NData=WMesh.num_elements();
-  if (NData)
-    {
-      const double maxValue = *std::max_element(TData,TData+NData-1);
-      ELog::EM<<"Rescaling to max value == "<<maxValue<<ELog::endDiag;
-      if (maxValue>1e-38)
-	for(size_t i=0;i<NData;i++)
-	  TData[i]/=maxValue;
-    }
+  process({WWGStep(WWGStep::SType::normalize)});
   return;
 }
 
@@ -321,26 +372,116 @@ WWG::scaleRange(const double minR,const double maxR)
   */
 {
   ELog::RegMethod RegA("WWG","scaleRange");
+  process({WWGStep(WWGStep::SType::scaleRange,minR,maxR)});
+  return;
+}
 
+void
+WWG::process(const std::vector<WWGStep>& Steps)
+  /*!
+    Apply a list of post-processing steps to the mesh.
+    The min/max needed by normalize/scaleRange are found 
+    in one pass and then carried through the later steps 
+    [all are monotonic] so that the steps are applied together
+    block by block in a single further pass. A power step on a 
+    mesh with negative values ends the group as the range is 
+    then not known. The result is the same as applying 
+    each step in turn.
+    \param Steps :: Steps to apply in order
+  */
+{
+  ELog::RegMethod RegA("WWG","process");
+
+  /// Single operation on a value
+  struct OpUnit
+  {
+    int type;      ///< 0 : x/A : 1 (x-A)*B+C : 2 : x^A
+    double A;      ///< First factor
+    double B;      ///< Second factor
+    double C;      ///< Third factor
+  };
+  
   double* TData=WMesh.data();
-
   const size_t NData=WMesh.num_elements();
-  const double RScale=maxR-minR;
-  if (NData)
+  if (!NData) return;
+
+  size_t index(0);
+  while(index<Steps.size())
     {
-      const double maxValue = *std::max_element(TData,TData+NData-1);
-      const double minValue = *std::min_element(TData,TData+NData-1);
-      const double TScale=maxValue-minValue;
-      if (TScale>1e-38)
+      double minValue,maxValue;
+      meshRange(minValue,maxValue);
+
+      std::vector<OpUnit> Ops;
+      bool rangeKnown(1);
+      for(;rangeKnown && index<Steps.size();index++)
 	{
-	  for(size_t i=0;i<NData;i++)
-	    TData[i]=(TData[i]-minValue)*(RScale/TScale)+minR;
+	  const WWGStep& SUnit(Steps[index]);
+	  if (SUnit.type==WWGStep::SType::normalize)
+	    {
+	      ELog::EM<<"Rescaling to max value == "<<maxValue<<ELog::endDiag;
+	      if (maxValue>1e-38)
+		{
+		  Ops.push_back({0,maxValue,0.0,0.0});
+		  minValue/=maxValue;
+		  maxValue/=maxValue;
+		}
+	    }
+	  else if (SUnit.type==WWGStep::SType::scaleRange)
+	    {
+	      const double TScale=maxValue-minValue;
+	      if (TScale>1e-38)
+		{
+		  const double F=(SUnit.B-SUnit.A)/TScale;
+		  Ops.push_back({1,minValue,F,SUnit.A});
+		  const double VA=(minValue-minValue)*F+SUnit.A;
+		  const double VB=(maxValue-minValue)*F+SUnit.A;
+		  minValue=std::min(VA,VB);
+		  maxValue=std::max(VA,VB);
+		}
+	    }
+	  else if (std::abs(SUnit.A-1.0)>Geometry::zeroTol)
+	    {
+	      ELog::EM<<"power range == "<<SUnit.A<<ELog::endDiag;
+	      Ops.push_back({2,SUnit.A,0.0,0.0});
+	      if (minValue>=0.0)
+		{
+		  const double VA=std::pow(minValue,SUnit.A);
+		  const double VB=std::pow(maxValue,SUnit.A);
+		  minValue=std::min(VA,VB);
+		  maxValue=std::max(VA,VB);
+		}
+	      else
+		rangeKnown=0;
+	    }
 	}
+      if (Ops.empty()) continue;
+
+      // blocks small enough to stay in cache between ops
+      const size_t blockSize(2048);
+      blockRun(NData,[&](const size_t,const size_t IA,const size_t IB)
+	       {
+		 for(size_t BA=IA;BA<IB;BA+=blockSize)
+		   {
+		     double* DPtr=TData+BA;
+		     const size_t NB((BA+blockSize<IB) ? blockSize : IB-BA);
+		     for(const OpUnit& OU : Ops)
+		       {
+			 if (OU.type==0)
+			   for(size_t i=0;i<NB;i++)
+			     DPtr[i]/=OU.A;
+			 else if (OU.type==1)
+			   for(size_t i=0;i<NB;i++)
+			     DPtr[i]=(DPtr[i]-OU.A)*OU.B+OU.C;
+			 else
+			   for(size_t i=0;i<NB;i++)
+			     DPtr[i]=std::pow(DPtr[i],OU.A);
+		       }
+		   }
+	       });
     }
   return;
 }
   
-  
 void
 WWG::scaleMeshItem(const size_t I,const size_t J,const size_t K,
                    const size_t EI,const double W)
@@ -398,31 +539,112 @@ WWG::writeWWINP(const std::string& FName) const
   OX.open(FName.c_str());
 
   Grid.writeWWINP(OX,1,EBin.size());
-  size_t itemCnt=0;
-  for(const double& E : EBin)
-    StrFunc::writeLine(OX,E,itemCnt,6);
-  if (itemCnt!=0)
-    OX<<std::endl;
-  itemCnt=0;
 
-  const long int XSize(static_cast<long int>(WMesh.shape()[0]));
-  const long int YSize(static_cast<long int>(WMesh.shape()[1]));
-  const long int ZSize(static_cast<long int>(WMesh.shape()[2]));
-  const long int ESize(static_cast<long int>(WMesh.shape()[3]));
-  for(long int EI=0;EI<ESize;EI++)
-    {
-      itemCnt=0;
-      for(long int K=0;K<ZSize;K++)
-	for(long int J=0;J<YSize;J++)
-	  for(long int I=0;I<XSize;I++)
-	    StrFunc::writeLine(OX,WMesh[I][J][K][EI],itemCnt,6);
-      if (itemCnt)   OX<<std::endl;
-    }
+  // Mesh values are the bulk of the file : format them into
+  // blocks rather than one stream operation per value
+  {
+    StrFunc::lineWriter LW(OX,6);
+    for(const double& E : EBin)
+      LW.add(E);
+    LW.endLine();
+    
+    const long int XSize(static_cast<long int>(WMesh.shape()[0]));
+    const long int YSize(static_cast<long int>(WMesh.shape()[1]));
+    const long int ZSize(static_cast<long int>(WMesh.shape()[2]));
+    const long int ESize(static_cast<long int>(WMesh.shape()[3]));
+    for(long int EI=0;EI<ESize;EI++)
+      {
+	for(long int K=0;K<ZSize;K++)
+	  for(long int J=0;J<YSize;J++)
+	    for(long int I=0;I<XSize;I++)
+	      LW.add(WMesh[I][J][K][EI]);
+	LW.endLine();
+      }
+  }
   OX.close();
 		       
   return;
 }  
 
+void
+WWG::writeBinary(const std::string& FName) const
+  /*!
+    Write out the mesh/weights in native binary form
+    so that they can be read back by readBinary for 
+    reprocessing without re-running the weight calculation.
+    \param FName :: Output filename
+  */
+{
+  ELog::RegMethod RegA("WWG","writeBinary");
+
+  if (FName.empty()) return;
+  std::ofstream OX(FName.c_str(),std::ios::binary);
+  if (!OX.good())
+    throw ColErr::FileError(0,FName,"Unable to open for writing");
+
+  OX.write(binaryTag,sizeof(binaryTag));
+  StrFunc::writeBinary(OX,ptype);
+  StrFunc::writeBinary(OX,wupn);
+  StrFunc::writeBinary(OX,wsurv);
+  StrFunc::writeBinary(OX,maxsp);
+  StrFunc::writeBinary(OX,mwhere);
+  StrFunc::writeBinary(OX,mtime);
+  StrFunc::writeBinary(OX,switchn);
+  StrFunc::writeBinary(OX,EBin);
+  Grid.writeBinary(OX);
+
+  for(size_t i=0;i<4;i++)
+    StrFunc::writeBinary(OX,WMesh.shape()[i]);
+  OX.write(reinterpret_cast<const char*>(WMesh.data()),
+	   static_cast<std::streamsize>(WMesh.num_elements()*sizeof(double)));
+  OX.close();
+  return;
+}
+
+void
+WWG::readBinary(const std::string& FName) 
+  /*!
+    Read a mesh/weights from a file written by writeBinary
+    \param FName :: Input filename
+  */
+{
+  ELog::RegMethod RegA("WWG","readBinary");
+
+  std::ifstream IX(FName.c_str(),std::ios::binary);
+  if (!IX.good())
+    throw ColErr::FileError(0,FName,"Unable to open");
+
+  char tag[sizeof(binaryTag)];
+  IX.read(tag,sizeof(tag));
+  if (!IX.good() || !std::equal(tag,tag+sizeof(tag),binaryTag))
+    throw ColErr::FileError(0,FName,"Not a WWG binary file");
+
+  StrFunc::readBinary(IX,ptype);
+  StrFunc::readBinary(IX,wupn);
+  StrFunc::readBinary(IX,wsurv);
+  StrFunc::readBinary(IX,maxsp);
+  StrFunc::readBinary(IX,mwhere);
+  StrFunc::readBinary(IX,mtime);
+  StrFunc::readBinary(IX,switchn);
+  StrFunc::readBinary(IX,EBin);
+  Grid.readBinary(IX);
+  
+  size_t shape[4];
+  for(size_t i=0;i<4;i++)
+    StrFunc::readBinary(IX,shape[i]);
+  if (shape[0]!=Grid.getXSize() || shape[1]!=Grid.getYSize() ||
+      shape[2]!=Grid.getZSize() || shape[3]!=EBin.size())
+    throw ColErr::FileError(0,FName,"Mesh/grid size mismatch");
+  
+  WMesh.resize(boost::extents[shape[0]][shape[1]][shape[2]][shape[3]]);
+  IX.read(reinterpret_cast<char*>(WMesh.data()),
+	  static_cast<std::streamsize>
+	  (WMesh.num_elements()*sizeof(double)));
+  if (!IX.good())
+    throw ColErr::FileError(0,FName,"Short mesh data");
+  calcGridMidPoints();
+  return;
+}
 
 void
 WWG::writeVTK(const std::string& FName) const
@@ -81,6 +81,7 @@
 #include "WWGItem.h"
 #include "WWGWeight.h"
 #include "MarkovProcess.h"
+#include "TrackCache.h"
 #include "WeightControl.h"
 
 namespace WeightSystem
@@ -101,11 +102,15 @@ WeightControl::procWWGWeights(Simulation& System,
     WeightSystem::weightManager::Instance();  
 
   procParam(IParam,"wWWG",0,0);
-  wwgMesh(IParam);               // create mesh [wwgXMesh etc]
-  wwgEnergy(IParam);             // set default energy grid
-
-  wwgCreate(System,IParam);
-  wwgMarkov(System,IParam);
+  if (!wwgBinaryRead(IParam))      // re-use a stored mesh
+    {
+      wwgMesh(IParam);               // create mesh [wwgXMesh etc]
+      wwgEnergy(IParam);             // set default energy grid
+      
+      wwgCreate(System,IParam);
+      wwgMarkov(System,IParam);
+    }
+  wwgBinaryWrite(IParam);          // store un-normalized mesh
   wwgNormalize(IParam); 
   wwgVTK(IParam);
   WM.getParticle('n')->setActiveWWP(0);
@@ -140,7 +145,15 @@ WeightControl::wwgMarkov(const Simulation& System,
       if (nMarkov)
 	{
 	  MarkovProcess MCalc;
+	  MCalc.setIteration(nMarkov);
+	  MCalc.setThreads(procThreads(IParam,"wwgThreads"));
+	  MCalc.setRange(markovRange);
 	  MCalc.initializeData(wwg);
+	  MCalc.computeMatrix(System,wwg,density,r2Length,r2Power);
+
+	  WWGWeight wSet(EBin.size(),wwg.getGrid());
+	  MCalc.computeFlux(wwg,wSet);
+	  wwg.updateWM(wSet,scaleFactor);
 	}
     }
 
@@ -161,7 +174,14 @@ WeightControl::wwgCreate(const Simulation& System,
   WeightSystem::weightManager& WM=
     WeightSystem::weightManager::Instance();
   WWG& wwg=WM.getWWG();
+  wwg.setThreads(procThreads(IParam,"wwgThreads"));
   const std::vector<double> EBin=wwg.getEBin();
+  if (IParam.flag("wwgRefine"))
+    {
+      wwgRefine(System,IParam);
+      return;
+    }
+  
   const std::vector<Geometry::Vec3D> GridMidPt=wwg.getMidPoints();
   const size_t NSetCnt=IParam.setCnt("wwgCalc");
 
@@ -169,52 +189,197 @@ WeightControl::wwgCreate(const Simulation& System,
     {
       // local mesh - zeroed
       WWGWeight wSet(EBin.size(),wwg.getGrid());   
+      wSet.setThreads(procThreads(IParam,"wwgThreads"));
       procParam(IParam,"wwgCalc",index,0);
+      wwgCheckActive();
 
-      if (activePtType=="Plane")   //
-	{
-	  ELog::EM<<"Active type == Plane"<<ELog::endDiag;
-          if (activePtIndex>=planePt.size())
-            throw ColErr::IndexError<size_t>(activePtIndex,planePt.size(),
-                                             "planePt.size() < activePtIndex");
-	  wSet.wTrack(System,planePt[activePtIndex],EBin,GridMidPt,
-		      density,r2Length,r2Power);
-	}
-      else if (activePtType=="Source")
-        {
-	  if (activePtIndex>=sourcePt.size())
-            throw ColErr::IndexError<size_t>(activePtIndex,sourcePt.size(),
-                                             "sourcePt.size() < activePtIndex");
-          ELog::EM<<"Calling Source Point"<<ELog::endDiag;
-          wSet.wTrack(System,sourcePt[activePtIndex],EBin,GridMidPt,
-		      density,r2Length,r2Power);
-        }
-      else 
-	throw ColErr::InContainerError<std::string>
-	  (activePtType,"SourceType no known");
-
-      // min weight == exp(w) (negative) 
-      if (minWeight>1.0)
-	minWeight*= -log(10.0);
-      else if (minWeight<0.0)
-	minWeight*= log(10);
-      else if (minWeight>1e-30)
-	minWeight= exp(minWeight);
-      else
-	minWeight= exp(1e-30);
+      wwgTrack(System,EBin,GridMidPt,wSet);
+      wSet.applyTracks(density,r2Length,r2Power);
+      wwgCombine(wwg,wSet);
+    }
+  return;
+}
 
-      if (!activeAdjointFlag)
-	{
-	  wSet.makeSource(minWeight);
-	}
-      else
+void
+WeightControl::wwgRefine(const Simulation& System,
+			 const mainSystem::inputParam& IParam)
+  /*!
+    Calculate the WWG weights with local refinement of the mesh.
+    A pass on the input mesh flags the points that differ from 
+    a neighbour by more than the allowed step [in log weight]. 
+    Each mesh bin holding a flagged point is split and only 
+    the new points within flagged bins are tracked, the others
+    take the track sums of their coarse bin.
+    As the mesh is a product of x/y/z bins the split is
+    applied to whole bin rows/columns.
+    \param System :: Simulation
+    \param IParam :: Input deck [wwgRefine step split]
+   */
+{
+  ELog::RegMethod RegA("WeightControl","wwgRefine");
+
+  WeightSystem::weightManager& WM=
+    WeightSystem::weightManager::Instance();
+  WWG& wwg=WM.getWWG();
+  const size_t nThread=procThreads(IParam,"wwgThreads");
+  const std::vector<double> EBin=wwg.getEBin();
+  const size_t NSetCnt=IParam.setCnt("wwgCalc");
+
+  const double maxStep=IParam.getDefValue<double>(1.0,"wwgRefine",0);
+  const size_t nSplit=IParam.getDefValue<size_t>(2,"wwgRefine",1);
+  if (maxStep<=0.0)
+    throw ColErr::RangeError<double>(maxStep,0.0,1e38,"wwgRefine step");
+  if (nSplit<2)
+    throw ColErr::IndexError<size_t>(nSplit,2,"wwgRefine split < 2");
+  
+  const Geometry::Mesh3D CGrid(wwg.getGrid());
+  const std::vector<Geometry::Vec3D> CMidPt=wwg.getMidPoints();
+
+  // coarse pass
+  std::vector<WWGWeight> CSet;
+  std::vector<int> Flag;
+  for(size_t index=0;index<NSetCnt;index++)
+    {
+      WWGWeight wSet(EBin.size(),CGrid);
+      wSet.setThreads(nThread);
+      procParam(IParam,"wwgCalc",index,0);
+      wwgCheckActive();
+
+      wwgTrack(System,EBin,CMidPt,wSet);
+      wSet.applyTracks(density,r2Length,r2Power);
+      wSet.markGradient(maxStep,Flag);
+      CSet.push_back(wSet);
+    }
+  if (CSet.empty()) return;
+
+  // split the bins holding a flagged point
+  const size_t NX(CGrid.getXSize());
+  const size_t NY(CGrid.getYSize());
+  const size_t NZ(CGrid.getZSize());
+  std::vector<size_t> XR(NX,1),YR(NY,1),ZR(NZ,1);
+  size_t nFlag(0);
+  for(size_t i=0;i<NX;i++)
+    for(size_t j=0;j<NY;j++)
+      for(size_t k=0;k<NZ;k++)
+	if (Flag[(i*NY+j)*NZ+k])
+	  {
+	    XR[i]=nSplit;
+	    YR[j]=nSplit;
+	    ZR[k]=nSplit;
+	    nFlag++;
+	  }
+
+  const Geometry::Mesh3D FGrid=CGrid.refine(XR,YR,ZR);
+  
+  // coarse bin of each fine bin on an axis
+  auto parentIndex=[](const std::vector<size_t>& R)
+    {
+      std::vector<size_t> Out;
+      for(size_t i=0;i<R.size();i++)
+	Out.insert(Out.end(),R[i],i);
+      return Out;
+    };
+  const std::vector<size_t> PX=parentIndex(XR);
+  const std::vector<size_t> PY=parentIndex(YR);
+  const std::vector<size_t> PZ=parentIndex(ZR);
+
+  std::vector<size_t> Parent;
+  std::vector<size_t> Active;
+  for(size_t i=0;i<PX.size();i++)
+    for(size_t j=0;j<PY.size();j++)
+      for(size_t k=0;k<PZ.size();k++)
 	{
-	  ELog::EM<<"Call adjoint:"<<minWeight<<ELog::endDiag;
-	  wSet.makeAdjoint(minWeight);
+	  const size_t PI((PX[i]*NY+PY[j])*NZ+PZ[k]);
+	  if (Flag[PI])
+	    Active.push_back(Parent.size());
+	  Parent.push_back(PI);
 	}
 
-      wwg.updateWM(wSet,scaleFactor);
+  wwg.getGrid()=FGrid;
+  wwg.resetMesh(std::vector<double>(EBin.size(),1.0));
+  wwg.calcGridMidPoints();
+  const std::vector<Geometry::Vec3D> FMidPt=wwg.getMidPoints();
+  
+  ELog::EM<<"WWG refine : "<<nFlag<<" / "<<CMidPt.size()
+	  <<" coarse points flagged : tracking "<<Active.size()
+	  <<" / "<<FMidPt.size()<<" points"<<ELog::endDiag;
+
+  // fine pass
+  for(size_t index=0;index<NSetCnt;index++)
+    {
+      WWGWeight wSet(EBin.size(),FGrid);
+      wSet.setThreads(nThread);
+      procParam(IParam,"wwgCalc",index,0);
+
+      wSet.copyTracks(CSet[index],Parent);
+      if (!Active.empty())
+	wwgRefineTrack(System,EBin,FMidPt,Parent,Active,wSet);
+      wSet.applyTracks(density,r2Length,r2Power);
+      wwgCombine(wwg,wSet);
+    }
+  return;
+}
+
+void
+WeightControl::wwgCheckActive() const
+  /*!
+    Check that the active plane/source point exists
+  */
+{
+  ELog::RegMethod RegA("WeightControl","wwgCheckActive");
+
+  if (activePtType=="Plane")   //
+    {
+      ELog::EM<<"Active type == Plane"<<ELog::endDiag;
+      if (activePtIndex>=planePt.size())
+	throw ColErr::IndexError<size_t>(activePtIndex,planePt.size(),
+					 "planePt.size() < activePtIndex");
+    }
+  else if (activePtType=="Source")
+    {
+      if (activePtIndex>=sourcePt.size())
+	throw ColErr::IndexError<size_t>(activePtIndex,sourcePt.size(),
+					 "sourcePt.size() < activePtIndex");
+      ELog::EM<<"Calling Source Point"<<ELog::endDiag;
+    }
+  else 
+    throw ColErr::InContainerError<std::string>
+      (activePtType,"SourceType no known");
+  return;
+}
+
+void
+WeightControl::wwgCombine(WWG& wwg,WWGWeight& wSet)
+  /*!
+    Convert a tracked weight set to source/adjoint form
+    and add it to the WWG mesh
+    \param wwg :: WWG mesh to update
+    \param wSet :: Weight set [log form from applyTracks]
+   */
+{
+  ELog::RegMethod RegA("WeightControl","wwgCombine");
+
+  // min weight == exp(w) (negative) 
+  if (minWeight>1.0)
+    minWeight*= -log(10.0);
+  else if (minWeight<0.0)
+    minWeight*= log(10);
+  else if (minWeight>1e-30)
+    minWeight= exp(minWeight);
+  else
+    minWeight= exp(1e-30);
+
+  if (!activeAdjointFlag)
+    {
+      wSet.makeSource(minWeight);
     }
+  else
+    {
+      ELog::EM<<"Call adjoint:"<<minWeight<<ELog::endDiag;
+      wSet.makeAdjoint(minWeight);
+    }
+
+  wwg.updateWM(wSet,scaleFactor);
   return;
 }
   
@@ -230,6 +395,7 @@ WeightControl::wwgNormalize(const mainSystem::inputParam& IParam)
   WeightSystem::weightManager& WM=
     WeightSystem::weightManager::Instance();
   WWG& wwg=WM.getWWG();
+  wwg.setThreads(procThreads(IParam,"wwgThreads"));
 
   if (IParam.flag("wwgNorm"))
     {
@@ -242,8 +408,9 @@ WeightControl::wwgNormalize(const mainSystem::inputParam& IParam)
 	  const double powerWeight=
 	    IParam.getDefValue<double>(1.0,"wwgNorm",0,1);
 	  ELog::EM<<"Scale Range == "<<std::pow(10.0,-minWeight)<<ELog::endDiag;
-	  wwg.scaleRange(std::pow(10.0,-minWeight),1.0);
-	  wwg.powerRange(powerWeight);
+	  wwg.process({WWGStep(WWGStep::SType::scaleRange,
+			       std::pow(10.0,-minWeight),1.0),
+		       WWGStep(WWGStep::SType::power,powerWeight)});
 	}
     }
   return;
@@ -336,6 +503,121 @@ WeightControl::wwgMesh(const mainSystem::inputParam& IParam)
   return;
 }
 
+void
+WeightControl::wwgTrack(const Simulation& System,
+			const std::vector<double>& EBin,
+			const std::vector<Geometry::Vec3D>& GridMidPt,
+			WWGWeight& wSet)
+  /*!
+    Calculate the track sums for the WWG mesh points from
+    the active plane/source point. The sums are taken from
+    the cache if present and stored otherwise.
+    \param System :: Simulation
+    \param EBin :: Energy bins
+    \param GridMidPt :: Mesh points
+    \param wSet :: Weight set to fill
+   */
+{
+  ELog::RegMethod RegA("WeightControl","wwgTrack");
+
+  std::vector<double> Desc(EBin);
+  if (activePtType=="Plane")
+    {
+      TrackCache::addDesc(Desc,planePt[activePtIndex].getNormal());
+      Desc.push_back(planePt[activePtIndex].getDistance());
+    }
+  else
+    TrackCache::addDesc(Desc,sourcePt[activePtIndex]);
+  TrackCache::addDesc(Desc,GridMidPt);
+
+  const std::string Key=TCache.makeKey("WWG"+activePtType,Desc);
+  std::ifstream IX;
+  if (TCache.openRead(Key,IX))
+    {
+      try
+	{
+	  wSet.readTracks(IX);
+	  return;
+	}
+      catch (ColErr::ExBase&)
+	{
+	  ELog::EM<<"Track cache invalid : retracking"<<ELog::endWarn;
+	}
+    }
+  
+  if (activePtType=="Plane")
+    wSet.calcTracks(System,planePt[activePtIndex],GridMidPt);
+  else
+    wSet.calcTracks(System,sourcePt[activePtIndex],GridMidPt);
+
+  std::ofstream OX;
+  if (TCache.openWrite(Key,OX))
+    wSet.writeTracks(OX);
+  return;
+}
+  
+void
+WeightControl::wwgRefineTrack(const Simulation& System,
+			      const std::vector<double>& EBin,
+			      const std::vector<Geometry::Vec3D>& FMidPt,
+			      const std::vector<size_t>& Parent,
+			      const std::vector<size_t>& Active,
+			      WWGWeight& wSet)
+  /*!
+    Calculate the track sums of the active points of a refined
+    WWG mesh : the other points hold the sums copied from their
+    coarse points. The sums are taken from the cache if present
+    and stored otherwise [the parent/active lists are in the key].
+    \param System :: Simulation
+    \param EBin :: Energy bins
+    \param FMidPt :: Refined mesh points
+    \param Parent :: Coarse point of each refined point
+    \param Active :: Index of the points to track
+    \param wSet :: Weight set [holding the copied sums]
+   */
+{
+  ELog::RegMethod RegA("WeightControl","wwgRefineTrack");
+
+  std::vector<double> Desc(EBin);
+  if (activePtType=="Plane")
+    {
+      TrackCache::addDesc(Desc,planePt[activePtIndex].getNormal());
+      Desc.push_back(planePt[activePtIndex].getDistance());
+    }
+  else
+    TrackCache::addDesc(Desc,sourcePt[activePtIndex]);
+  TrackCache::addDesc(Desc,FMidPt);
+  for(const size_t PI : Parent)
+    Desc.push_back(static_cast<double>(PI));
+  for(const size_t AI : Active)
+    Desc.push_back(static_cast<double>(AI));
+
+  const std::string Key=TCache.makeKey("WWGrefine"+activePtType,Desc);
+  std::ifstream IX;
+  if (TCache.openRead(Key,IX))
+    {
+      try
+	{
+	  wSet.readTracks(IX);
+	  return;
+	}
+      catch (ColErr::ExBase&)
+	{
+	  ELog::EM<<"Track cache invalid : retracking"<<ELog::endWarn;
+	}
+    }
+
+  if (activePtType=="Plane")
+    wSet.calcTracks(System,planePt[activePtIndex],FMidPt,Active);
+  else
+    wSet.calcTracks(System,sourcePt[activePtIndex],FMidPt,Active);
+
+  std::ofstream OX;
+  if (TCache.openWrite(Key,OX))
+    wSet.writeTracks(OX);
+  return;
+}
+  
 void
 WeightControl::wwgVTK(const mainSystem::inputParam& IParam)
   /*!
@@ -358,6 +640,48 @@ WeightControl::wwgVTK(const mainSystem::inputParam& IParam)
     }
   return;
 }
+
+int
+WeightControl::wwgBinaryRead(const mainSystem::inputParam& IParam)
+  /*!
+    Read the WWG mesh/weights from a binary file 
+    in place of the track calculation
+    \param IParam :: Input parameters
+    \return 1 if the mesh was read
+  */
+{
+  ELog::RegMethod RegA("WeightControl","wwgBinaryRead");
+  
+  if (!IParam.flag("wwgBinIn")) return 0;
+
+  WeightSystem::weightManager& WM=
+    WeightSystem::weightManager::Instance();
+  WWG& wwg=WM.getWWG();
+  const std::string FName=
+    IParam.getValue<std::string>("wwgBinIn",0);
+  wwg.readBinary(FName);
+  ELog::EM<<"WWG mesh read from "<<FName<<ELog::endDiag;
+  return 1;
+}
+
+void
+WeightControl::wwgBinaryWrite(const mainSystem::inputParam& IParam)
+  /*!
+    Write the WWG mesh/weights to a binary file
+    \param IParam :: Input parameters
+  */
+{
+  ELog::RegMethod RegA("WeightControl","wwgBinaryWrite");
+  
+  if (IParam.flag("wwgBinOut"))
+    {
+      WeightSystem::weightManager& WM=
+	WeightSystem::weightManager::Instance();
+      const WWG& wwg=WM.getWWG();
+      wwg.writeBinary(IParam.getValue<std::string>("wwgBinOut",0));
+    }
+  return;
+}
 		       
 }  // NAMESPACE weightSystem
 
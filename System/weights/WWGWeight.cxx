@@ -30,7 +30,12 @@
 #include <map> 
 #include <string>
 #include <algorithm>
+#include <numeric>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
 #include <boost/multi_array.hpp>
 
 #include "Exception.h"
@@ -43,10 +48,12 @@
 #include "BaseModVisit.h"
 #include "mathSupport.h"
 #include "support.h"
+#include "fileSupport.h"
 #include "MapSupport.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "Line.h"
 #include "Mesh3D.h"
 #include "Surface.h"
 #include "Quadratic.h"
@@ -61,6 +68,9 @@
 #include "BaseMap.h"
 #include "CellMap.h"
 #include "Object.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "Qhull.h"
 #include "weightManager.h"
 #include "WForm.h"
@@ -69,6 +79,7 @@
 #include "CellWeight.h"
 #include "Simulation.h"
 #include "LineTrack.h"
+#include "AttnTable.h"
 #include "ObjectTrackAct.h"
 #include "ObjectTrackPoint.h"
 #include "ObjectTrackPlane.h"
@@ -85,7 +96,7 @@ WWGWeight::WWGWeight(const size_t EB,
   WX(static_cast<long int>(Grid.getXSize())),
   WY(static_cast<long int>(Grid.getYSize())),
   WZ(static_cast<long int>(Grid.getZSize())),
-  WE(static_cast<long int>(EB)),
+  WE(static_cast<long int>(EB)),nThread(1),
   WGrid(boost::extents[WX][WY][WZ][WE])
   /*! 
     Constructor 
@@ -98,7 +109,8 @@ WWGWeight::WWGWeight(const size_t EB,
 
 WWGWeight::WWGWeight(const WWGWeight& A)  :
   WX(A.WX),WY(A.WY),WZ(A.WZ),WE(A.WE),
-  WGrid(A.WGrid)
+  nThread(A.nThread),WGrid(A.WGrid),
+  TDist(A.TDist),TAttn(A.TAttn)
   /*! 
     Copy Constructor 
     \param A :: WWGWeight to copy
@@ -115,7 +127,10 @@ WWGWeight::operator=(const WWGWeight& A)
 {
   if (this!=&A)
     {
+      nThread=A.nThread;
       WGrid=A.WGrid;
+      TDist=A.TDist;
+      TAttn=A.TAttn;
     }
   return *this;
 }
@@ -127,14 +142,7 @@ WWGWeight::zeroWGrid()
     Zero WGrid
   */
 {
-  for(long int i=0;i<WX;i++)
-    for(long int  j=0;j<WY;j++)
-      for(long int k=0;k<WZ;k++)
-        for(long int e=0;e<WE;e++)
-          {
-            WGrid[i][j][k][e]=0.0;
-          }
-  
+  std::fill(WGrid.data(),WGrid.data()+WGrid.num_elements(),0.0);
   return;
 }
 
@@ -253,16 +261,390 @@ WWGWeight::makeAdjoint(const double MValue)
   return;
 }
   
+template<typename T>
+void
+WWGWeight::trackRun(const Simulation& System,
+		    const T& TrackUnit,
+		    const ModelSupport::AttnTable& ATable,
+		    const std::vector<Geometry::Vec3D>& MidPt,
+		    const std::vector<size_t>& Active)
+  /*!
+    Track from each grid point to the source and store the 
+    track length and attenuation sum of the grid point for each 
+    energy bin [TDist/TAttn]. If Active is not empty only those
+    points are tracked and the other values are left unchanged
+    [these must already be set]. The points are taken in blocks
+    of whole z-rows by nThread workers each with their own track 
+    object and query context. In a block each track is guided by
+    the track of the previous z-point [or the previous y-row for
+    the first point of a row] as these cross the same cells.
+    Each point is independent so the result does not depend 
+    on the number of threads.
+    \param System :: Simulation to use    
+    \param TrackUnit :: ObjectTrackPoint/ObjectTrackPlane to copy
+    \param ATable :: Material attenuation for each energy bin
+    \param MidPt :: Grid points
+    \param Active :: Index of points to track [empty for all]
+  */
+{
+  ELog::RegMethod RegA("WWGWeight","trackRun");
+
+  const size_t NE(static_cast<size_t>(WE));
+  if (MidPt.size()*NE!=WGrid.num_elements())
+    throw ColErr::MisMatch<size_t>(MidPt.size()*NE,WGrid.num_elements(),
+				   "MidPt/WGrid size");
+  const bool fullFlag(Active.empty());
+  if (fullFlag)
+    {
+      TDist.resize(MidPt.size());
+      TAttn.resize(MidPt.size()*NE);
+    }
+  else if (TDist.size()!=MidPt.size())
+    throw ColErr::MisMatch<size_t>(TDist.size(),MidPt.size(),
+				   "Track sums not set for partial track");
+  const size_t NPts(fullFlag ? MidPt.size() : Active.size());
+
+  const size_t rowSize((WZ>0) ? static_cast<size_t>(WZ) : 1);
+  const size_t blockSize(rowSize*((rowSize<64) ? 64/rowSize : 1));
+  const size_t NT((nThread>1 && nThread<NPts) ? nThread :
+		  ((nThread>1 && NPts) ? NPts : 1));
+  const size_t reportStep((NPts/10>blockSize) ? NPts/10 : blockSize);
+  
+  std::atomic<size_t> nextPt(0);
+  std::atomic<size_t> donePt(0);
+  std::vector<std::exception_ptr> Fail(NT);
+  std::vector<size_t> nBundle(NT,0);
+  std::vector<size_t> nNext(NT,0);
+
+  const std::chrono::steady_clock::time_point TStart=
+    std::chrono::steady_clock::now();
+  
+  auto worker=[&](const size_t TIndex)
+    {
+      try
+	{
+	  T OTrack(TrackUnit);
+	  MonteCarlo::QueryContext QC;
+	  std::vector<double> AT;
+	  size_t nextReport(reportStep);
+	  for(size_t IA=nextPt.fetch_add(blockSize);IA<NPts;
+	      IA=nextPt.fetch_add(blockSize))
+	    {
+	      const size_t IB((IA+blockSize<NPts) ? IA+blockSize : NPts);
+	      OTrack.clearAll();
+	      for(size_t k=IA;k<IB;k++)
+		{
+		  const size_t i(fullFlag ? k : Active[k]);
+		  const long int cN(static_cast<long int>(i+1));
+		  // partial : guide by the previous active point
+		  const size_t guideI=(!fullFlag) ?
+		    ((k>IA) ? Active[k-1]+1 : 0) :
+		    ((i % rowSize) ? i : ((i-IA>=rowSize) ? i+1-rowSize : 0));
+		  OTrack.addUnit(QC,System,cN,MidPt[i],
+				 static_cast<long int>(guideI));
+		  TDist[i]=OTrack.getDistance(cN);
+		  OTrack.getAttnSum(cN,ATable,AT);
+		  std::copy(AT.begin(),AT.begin()+static_cast<long int>(NE),
+			    TAttn.begin()+static_cast<long int>(i*NE));
+		}
+	      const size_t nDone=(donePt+=IB-IA);
+	      // only the calling thread writes to the log
+	      if (!TIndex && nDone>=nextReport && nDone<NPts)
+		{
+		  const std::chrono::duration<double> DT=
+		    std::chrono::steady_clock::now()-TStart;
+		  ELog::EM<<"WWG tracks "<<nDone<<" / "<<NPts<<" [";
+		  if (DT.count()>0.0)
+		    ELog::EM<<static_cast<double>(nDone)/DT.count();
+		  ELog::EM<<" pts/s]"<<ELog::endDiag;
+		  nextReport=nDone+reportStep;
+		}
+	    }
+	  nBundle[TIndex]=QC.getBundleHit();
+	  nNext[TIndex]=QC.getNext()+QC.getBundleHit();
+	}
+      catch(...)
+	{
+	  Fail[TIndex]=std::current_exception();
+	  nextPt=NPts;
+	}
+    };
+
+  std::vector<std::thread> Workers;
+  for(size_t i=1;i<NT;i++)
+    Workers.push_back(std::thread(worker,i));
+  worker(0);
+  for(std::thread& TH : Workers)
+    TH.join();
+
+  for(size_t i=0;i<NT;i++)
+    if (Fail[i])
+      std::rethrow_exception(Fail[i]);
+
+  const std::chrono::duration<double> DT=
+    std::chrono::steady_clock::now()-TStart;
+  ELog::EM<<"WWG tracks "<<NPts<<" in "<<DT.count()<<" s [";
+  if (DT.count()>0.0)
+    ELog::EM<<static_cast<double>(NPts)/DT.count()<<" pts/s ";
+  ELog::EM<<NT<<" thread(s)]"<<ELog::endDiag;
+  ELog::EM<<"WWG cell crossings from guide tracks "
+	  <<std::accumulate(nBundle.begin(),nBundle.end(),0UL)<<" / "
+	  <<std::accumulate(nNext.begin(),nNext.end(),0UL)<<ELog::endDiag;
+  return;
+}
+
+void
+WWGWeight::calcTracks(const Simulation& System,
+		      const Geometry::Vec3D& initPt,
+		      const std::vector<Geometry::Vec3D>& MidPt)
+  /*!
+    Calculate the tracks from sourcePoint to each grid point
+    \param System :: Simulation to use    
+    \param initPt :: Point for outgoing track
+    \param MidPt :: Grid points
+  */
+{
+  calcTracks(System,initPt,MidPt,std::vector<size_t>());
+  return;
+}
+
+void
+WWGWeight::calcTracks(const Simulation& System,
+		      const Geometry::Vec3D& initPt,
+		      const std::vector<Geometry::Vec3D>& MidPt,
+		      const std::vector<size_t>& Active)
+  /*!
+    Calculate the tracks from sourcePoint to the active grid points
+    \param System :: Simulation to use    
+    \param initPt :: Point for outgoing track
+    \param MidPt :: Grid points
+    \param Active :: Index of points to track [empty for all]
+  */
+{
+  ELog::RegMethod RegA("WWGWeight","calcTracks(Vec3D)");
+
+  ELog::EM<<"Processing  "<<(Active.empty() ? MidPt.size() : Active.size())
+	  <<" for WWG"<<ELog::endDiag;
+  const ModelSupport::ObjectTrackPoint OTrack(initPt);
+  ModelSupport::AttnTable ATable;
+  ATable.build(static_cast<size_t>(WE));
+  trackRun(System,OTrack,ATable,MidPt,Active);
+  return;
+}
+
+void
+WWGWeight::calcTracks(const Simulation& System,
+		      const Geometry::Plane& initPlane,
+		      const std::vector<Geometry::Vec3D>& MidPt)
+  /*!
+    Calculate the tracks from a plane to each grid point
+    \param System :: Simulation to use    
+    \param initPlane :: Plane for outgoing track
+    \param MidPt :: Grid points
+  */
+{
+  calcTracks(System,initPlane,MidPt,std::vector<size_t>());
+  return;
+}
+
+void
+WWGWeight::calcTracks(const Simulation& System,
+		      const Geometry::Plane& initPlane,
+		      const std::vector<Geometry::Vec3D>& MidPt,
+		      const std::vector<size_t>& Active)
+  /*!
+    Calculate the tracks from a plane to the active grid points
+    \param System :: Simulation to use    
+    \param initPlane :: Plane for outgoing track
+    \param MidPt :: Grid points
+    \param Active :: Index of points to track [empty for all]
+  */
+{
+  ELog::RegMethod RegA("WWGWeight","calcTracks(Plane)");
+
+  const ModelSupport::ObjectTrackPlane OTrack(initPlane);
+  ModelSupport::AttnTable ATable;
+  ATable.build(static_cast<size_t>(WE));
+  trackRun(System,OTrack,ATable,MidPt,Active);
+  return;
+}
+
+void
+WWGWeight::copyTracks(const WWGWeight& Coarse,
+		      const std::vector<size_t>& Parent)
+  /*!
+    Set the track sums of each point from a point of a 
+    coarser grid. 
+    \param Coarse :: Weight set with track sums
+    \param Parent :: Index of coarse point for each point
+  */
+{
+  ELog::RegMethod RegA("WWGWeight","copyTracks");
+
+  const size_t NE(static_cast<size_t>(WE));
+  if (Coarse.WE!=WE || Parent.size()*NE!=WGrid.num_elements())
+    throw ColErr::MisMatch<size_t>(Parent.size()*NE,WGrid.num_elements(),
+				   "Parent/WGrid size");
+  if (!Coarse.hasTracks())
+    throw ColErr::EmptyValue<void>("Coarse track sums");
+
+  TDist.resize(Parent.size());
+  TAttn.resize(Parent.size()*NE);
+  for(size_t i=0;i<Parent.size();i++)
+    {
+      const size_t PI(Parent[i]);
+      if (PI>=Coarse.TDist.size())
+	throw ColErr::IndexError<size_t>(PI,Coarse.TDist.size(),"Parent");
+      TDist[i]=Coarse.TDist[PI];
+      std::copy(Coarse.TAttn.begin()+static_cast<long int>(PI*NE),
+		Coarse.TAttn.begin()+static_cast<long int>((PI+1)*NE),
+		TAttn.begin()+static_cast<long int>(i*NE));
+    }
+  return;
+}
+
+void
+WWGWeight::markGradient(const double maxStep,
+			std::vector<int>& Flag) const
+  /*!
+    Flag each point that differs from one of its
+    x/y/z neighbours by more than maxStep in any energy bin.
+    The grid is in log form [applyTracks] so the test is 
+    on the ratio of the weights. Flags are or-ed into Flag
+    so several sets can be tested against one grid.
+    \param maxStep :: Largest log step allowed
+    \param Flag :: Flag for each point [x][y][z]
+  */
+{
+  ELog::RegMethod RegA("WWGWeight","markGradient");
+
+  const size_t NX(static_cast<size_t>(WX));
+  const size_t NY(static_cast<size_t>(WY));
+  const size_t NZ(static_cast<size_t>(WZ));
+  const size_t NE(static_cast<size_t>(WE));
+  const size_t NPts(NX*NY*NZ);
+  if (Flag.empty())
+    Flag.resize(NPts,0);
+  if (Flag.size()!=NPts)
+    throw ColErr::MisMatch<size_t>(Flag.size(),NPts,"Flag/WGrid size");
+
+  const double* TData=WGrid.data();
+  // neighbour step in point index for x/y/z
+  const size_t step[3]={NY*NZ,NZ,1};
+  for(size_t i=0;i<NX;i++)
+    for(size_t j=0;j<NY;j++)
+      for(size_t k=0;k<NZ;k++)
+	{
+	  const size_t PA((i*NY+j)*NZ+k);
+	  const bool endFlag[3]={i+1==NX,j+1==NY,k+1==NZ};
+	  for(size_t dir=0;dir<3;dir++)
+	    {
+	      if (endFlag[dir]) continue;
+	      const size_t PB(PA+step[dir]);
+	      for(size_t eI=0;eI<NE;eI++)
+		if (std::abs(TData[PA*NE+eI]-TData[PB*NE+eI])>maxStep)
+		  {
+		    Flag[PA]=1;
+		    Flag[PB]=1;
+		    break;
+		  }
+	    }
+	}
+  return;
+}
+
+void
+WWGWeight::applyTracks(const double densityFactor,
+		       const double r2Length,
+		       const double r2Power)
+  /*!
+    Set the grid from the stored track sums as
+    exp(-density*Sigma)/r^power in log form. This only 
+    depends on the track sums so can be redone for a new
+    set of factors without retracking.
+    \param densityFactor :: Scaling factor for density
+    \param r2Length :: scale factor for length
+    \param r2Power :: power of 1/r^2 factor
+  */
+{
+  ELog::RegMethod RegA("WWGWeight","applyTracks");
+
+  const size_t NE(static_cast<size_t>(WE));
+  if (TDist.size()*NE!=WGrid.num_elements() ||
+      TAttn.size()!=WGrid.num_elements())
+    throw ColErr::MisMatch<size_t>(TAttn.size(),WGrid.num_elements(),
+				   "Track sums/WGrid size");
+
+  // WGrid is [x][y][z][E] with z fastest : same order as MidPt
+  double* TData=WGrid.data();
+  double minV(0.0);
+  for(size_t i=0;i<TDist.size();i++)
+    {
+      double DistT=TDist[i]/r2Length;
+      if (DistT<1.0) DistT=1.0;
+      const double RV=r2Power*log(DistT);
+      for(size_t index=0;index<NE;index++)
+	{
+	  const double V= -densityFactor*TAttn[i*NE+index]-RV;
+	  if (V<minV) minV=V;
+	  TData[i*NE+index]=V;
+	}
+    }
+  ELog::EM<<"WWG track weights Min == "<<minV<<ELog::endDiag;
+  return;
+}
+
+void
+WWGWeight::writeTracks(std::ostream& OX) const
+  /*!
+    Write the track sums in binary form
+    \param OX :: Output stream [binary]
+  */
+{
+  ELog::RegMethod RegA("WWGWeight","writeTracks");
+
+  StrFunc::writeBinary(OX,static_cast<size_t>(WE));
+  StrFunc::writeBinary(OX,TDist);
+  StrFunc::writeBinary(OX,TAttn);
+  return;
+}
+
+void
+WWGWeight::readTracks(std::istream& IX)
+  /*!
+    Read the track sums written by writeTracks
+    \param IX :: Input stream [binary]
+  */
+{
+  ELog::RegMethod RegA("WWGWeight","readTracks");
+
+  size_t NE;
+  StrFunc::readBinary(IX,NE);
+  std::vector<double> DVec;
+  std::vector<double> AVec;
+  StrFunc::readBinary(IX,DVec);
+  StrFunc::readBinary(IX,AVec);
+  if (NE!=static_cast<size_t>(WE) ||
+      DVec.size()*NE!=WGrid.num_elements() ||
+      AVec.size()!=WGrid.num_elements())
+    throw ColErr::MisMatch<size_t>(AVec.size(),WGrid.num_elements(),
+				   "Track sums/WGrid size");
+  TDist=std::move(DVec);
+  TAttn=std::move(AVec);
+  return;
+}
+
 void
 WWGWeight::wTrack(const Simulation& System,
 		  const Geometry::Vec3D& initPt,
-		  const std::vector<double>& EBin,
+		  const std::vector<double>&,
 		  const std::vector<Geometry::Vec3D>& MidPt,
 		  const double densityFactor,
 		  const double r2Length,
 		  const double r2Power)
   /*!
     Calculate a specific track from sourcePoint to position
+    and set the grid
     \param System :: Simulation to use    
     \param initPt :: Point for outgoing track
     \param EBin :: Energy points
@@ -274,46 +656,22 @@ WWGWeight::wTrack(const Simulation& System,
 {
   ELog::RegMethod RegA("WWGWeight","wTrack(Vec3D)");
 
-  ModelSupport::ObjectTrackPoint OTrack(initPt);
-
-  long int cN(1);
-  ELog::EM<<"Processing  "<<MidPt.size()<<" for WWG"<<ELog::endDiag;
-  double minV(1.0);
-  for(const Geometry::Vec3D& Pt : MidPt)
-    {
-      ModelSupport::ObjectTrackPoint OTrack(initPt);
-      OTrack.addUnit(System,cN,Pt);
-      double DistT=OTrack.getDistance(cN)/r2Length;
-      if (DistT<1.0) DistT=1.0;
-      const double AT=OTrack.getAttnSum(cN);    // this can take an
-                                                // energy
-      for(long int index=0;index<WE;index++)
-        {
-	  //	  ELog::EM<<"Pt["<<Pt<<"] == "<<densityFactor*AT
-	  //		  <<" "<<r2Power*log(DistT)<<ELog::endDiag;
-	  // exp(-Sigma)/r^2  in log form
-          setPoint(cN-1,index,-densityFactor*AT-r2Power*log(DistT));
-        }
-
-      if (!(cN % 10000))
-	ELog::EM<<"Item "<<cN<<" "<<MidPt.size()<<" "<<densityFactor<<" "
-		<<r2Length<<ELog::endDiag;
-      cN++;
-    }
+  calcTracks(System,initPt,MidPt);
+  applyTracks(densityFactor,r2Length,r2Power);
   return;
 }
 
-
 void
 WWGWeight::wTrack(const Simulation& System,
 		  const Geometry::Plane& initPlane,
-		  const std::vector<double>& EBin,
+		  const std::vector<double>&,
 		  const std::vector<Geometry::Vec3D>& MidPt,
 		  const double densityFactor,
 		  const double r2Length,
 		  const double r2Power)
   /*!
     Calculate a specific trac from sourcePoint to  postion
+    and set the grid
     \param System :: Simulation to use    
     \param initPlane :: Plane for outgoing track
     \param EBin :: Energy points
@@ -325,28 +683,8 @@ WWGWeight::wTrack(const Simulation& System,
 {
   ELog::RegMethod RegA("WWGWeight","wTrack(Plane)");
 
-  ModelSupport::ObjectTrackPlane OTrack(initPlane);
-  long int cN(1);
-  double minV(1.0);
-  for(const Geometry::Vec3D& Pt : MidPt)
-    {
-      OTrack.addUnit(System,cN,Pt);
-      double DistT=OTrack.getDistance(cN)/r2Length;
-      if (DistT<1.0) DistT=1.0;
-      const double AT=OTrack.getAttnSum(cN);    // this can take an energy
-      double V= -densityFactor*AT-r2Power*log(DistT);
-      if (V<minV)
-	{
-	  minV=V;
-	  ELog::EM<<"Min == "<<V<<ELog::endDiag;
-	}
-      for(long int index=0;index<WE;index++)
-        {
-          // exp(-Sigma)/r^2  in log form
-          setPoint(cN-1,index,-densityFactor*AT-r2Power*log(DistT));
-        }
-      cN++;
-    }
+  calcTracks(System,initPlane,MidPt);
+  applyTracks(densityFactor,r2Length,r2Power);
   return;
 }
 
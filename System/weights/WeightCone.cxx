@@ -76,6 +76,7 @@
 #include "ObjectTrackPoint.h"
 #include "ObjectTrackPlane.h"
 #include "Mesh3D.h"
+#include "TrackCache.h"
 #include "WeightControl.h"
 
 namespace WeightSystem
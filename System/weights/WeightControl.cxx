@@ -32,6 +32,9 @@
 #include <string>
 #include <algorithm>
 #include <memory>
+#include <exception>
+#include <thread>
+#include <limits>
 #include <boost/multi_array.hpp>
 
 #include "Exception.h"
@@ -45,6 +48,7 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "Line.h"
 #include "Surface.h"
 #include "Quadratic.h"
 #include "Plane.h"
@@ -58,6 +62,9 @@
 #include "BaseMap.h"
 #include "CellMap.h"
 #include "Object.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "Qhull.h"
 #include "weightManager.h"
 #include "WForm.h"
@@ -76,7 +83,9 @@
 #include "ObjectTrackAct.h"
 #include "ObjectTrackPoint.h"
 #include "ObjectTrackPlane.h"
+#include "pointDetOpt.h"
 #include "Mesh3D.h"
+#include "TrackCache.h"
 #include "WeightControl.h"
 
 namespace WeightSystem
@@ -84,8 +93,8 @@ namespace WeightSystem
   
 WeightControl::WeightControl() :
   scaleFactor(1.0),minWeight(1e-20),weightPower(0.5),
-  density(1.0),r2Length(1.0),r2Power(2.0),nMarkov(0),
-  activeAdjointFlag(0),activePtType("Void"),activePtIndex(0)
+  density(1.0),r2Length(1.0),r2Power(2.0),nMarkov(0),markovRange(100.0),
+  nThread(1),nSample(1),activeAdjointFlag(0),activePtType("Void"),activePtIndex(0)
   /*
     Constructor
   */
@@ -96,10 +105,12 @@ WeightControl::WeightControl() :
 WeightControl::WeightControl(const WeightControl& A) :
   scaleFactor(A.scaleFactor),minWeight(A.minWeight),
   weightPower(A.weightPower),EBand(A.EBand),WT(A.WT),
-  nMarkov(A.nMarkov),objectList(A.objectList),
+  nMarkov(A.nMarkov),markovRange(A.markovRange),
+  nThread(A.nThread),nSample(A.nSample),
+  objectList(A.objectList),
   activeAdjointFlag(A.activeAdjointFlag),
   activePtType(A.activePtType),activePtIndex(A.activePtIndex),
-  sourcePt(A.sourcePt)
+  sourcePt(A.sourcePt),TCache(A.TCache)
   /*!
     Copy constructor
     \param A :: WeightControl to copy
@@ -126,11 +137,16 @@ WeightControl::operator=(const WeightControl& A)
       
       EBand=A.EBand;
       WT=A.WT;
+      nMarkov=A.nMarkov;
+      markovRange=A.markovRange;
+      nThread=A.nThread;
+      nSample=A.nSample;
       objectList=A.objectList;
       activeAdjointFlag=A.activeAdjointFlag;
       activePtType=A.activePtType;
       activePtIndex=A.activePtIndex;
       sourcePt=A.sourcePt;
+      TCache=A.TCache;
     }
   return *this;      
 }
@@ -304,6 +320,8 @@ WeightControl::procMarkov(const mainSystem::inputParam& IParam,
   density=IParam.getDefValue<double>(1.0,unitName,iSet,index++);
   r2Length=IParam.getDefValue<double>(1.0,unitName,iSet,index++);
   r2Power=IParam.getDefValue<double>(2.0,unitName,iSet,index++);
+  // 100cm : beyond a few mesh cells the chain couples the points
+  markovRange=IParam.getDefValue<double>(100.0,unitName,iSet,index++);
 
   if (scaleFactor>1.0)
     ELog::EM<<"density scale factor > 1.0 "<<ELog::endWarn;
@@ -313,7 +331,8 @@ WeightControl::procMarkov(const mainSystem::inputParam& IParam,
     	  <<" minW:"<<minWeight
     	  <<" rho:"<<density
     	  <<" r2Len:"<<r2Length
-	  <<" r2Pow:"<<r2Power<<ELog::endDiag;
+	  <<" r2Pow:"<<r2Power
+	  <<" range:"<<markovRange<<ELog::endDiag;
   return;
   
   return;
@@ -363,6 +382,25 @@ WeightControl::procParam(const mainSystem::inputParam& IParam,
   return;
 }
 
+size_t
+WeightControl::procThreads(const mainSystem::inputParam& IParam,
+			   const std::string& unitName)
+  /*!
+    Get a thread count option [registered as int]
+    \param IParam :: Input parameters
+    \param unitName :: option name
+    \return number of threads [>=1]
+   */
+{
+  ELog::RegMethod RegA("WeightControl","procThreads");
+
+  const int NT=IParam.getValue<int>(unitName);
+  if (NT<1)
+    throw ColErr::RangeError<int>(NT,1,std::numeric_limits<int>::max(),
+				  unitName);
+  return static_cast<size_t>(NT);
+}
+
 void
 WeightControl::procRebaseHelp() const
   /*!
@@ -476,6 +514,78 @@ WeightControl::procSourcePoint(const mainSystem::inputParam& IParam)
 }
 
   
+template<typename T>
+void
+WeightControl::cTrackRun(const Simulation& System,
+			 const T& TrackUnit,
+			 const std::vector<Geometry::Vec3D>& Pts,
+			 const std::vector<long int>& index,
+			 CellWeight& CTrack) const
+  /*!
+    Track from each point to the source and add the attenuation
+    to the cell weight. The points are split into nThread 
+    contiguous blocks, each with its own track object, query 
+    context and CellWeight, and the CellWeights are added in block
+    order at the end. Each track is guided by the previous point 
+    of the block [normally a point of the same cell].
+    \param System :: Simulation to use    
+    \param TrackUnit :: ObjectTrackPoint/ObjectTrackPlane to copy
+    \param Pts :: Point on track
+    \param index :: cellnumber / index number
+    \param CTrack :: Item Weight to add tracks to
+  */
+{
+  ELog::RegMethod RegA("WeightControl","cTrackRun");
+
+  const size_t NPts(Pts.size());
+  const size_t NT((nThread>1 && nThread<NPts) ? nThread :
+		  ((nThread>1 && NPts) ? NPts : 1));
+
+  std::vector<long int> unitIndex(NPts);
+  long int cN(index.empty() ? 1 : index.back());
+  for(size_t i=0;i<NPts;i++)
+    unitIndex[i]=(i>=index.size()) ? cN++ : index[i];
+
+  std::vector<CellWeight> TWeight(NT);
+  std::vector<std::exception_ptr> Fail(NT);
+  auto worker=[&](const size_t TIndex)
+    {
+      try
+	{
+	  T OTrack(TrackUnit);
+	  MonteCarlo::QueryContext QC;
+	  const size_t IA((NPts*TIndex)/NT);
+	  const size_t IB((NPts*(TIndex+1))/NT);
+	  for(size_t i=IA;i<IB;i++)
+	    {
+	      const long int tN(static_cast<long int>(i+1));
+	      OTrack.addUnit(QC,System,tN,Pts[i],
+			     (i>IA) ? static_cast<long int>(i) : 0);
+	      TWeight[TIndex].addTracks(unitIndex[i],OTrack.getAttnSum(tN));
+	    }
+	}
+      catch(...)
+	{
+	  Fail[TIndex]=std::current_exception();
+	}
+    };
+
+  std::vector<std::thread> Workers;
+  for(size_t i=1;i<NT;i++)
+    Workers.push_back(std::thread(worker,i));
+  worker(0);
+  for(std::thread& TH : Workers)
+    TH.join();
+
+  for(size_t i=0;i<NT;i++)
+    if (Fail[i])
+      std::rethrow_exception(Fail[i]);
+
+  for(const CellWeight& CW : TWeight)
+    CTrack.addTracks(CW);
+  return;
+}
+  
 void
 WeightControl::cTrack(const Simulation& System,
                       const Geometry::Vec3D& initPt,
@@ -494,16 +604,8 @@ WeightControl::cTrack(const Simulation& System,
   ELog::RegMethod RegA("WeightControl","cTrack");
   // SOURCE Point
 
-  ModelSupport::ObjectTrackPoint OTrack(initPt);
-  std::vector<double> WVec;
-
-  long int cN(index.empty() ? 1 : index.back());
-  for(size_t i=0;i<Pts.size();i++)
-    {
-      const long int unit(i>=index.size() ? cN++ : index[i]);
-      OTrack.addUnit(System,unit,Pts[i]);
-      CTrack.addTracks(unit,OTrack.getAttnSum(unit));
-    } 
+  const ModelSupport::ObjectTrackPoint OTrack(initPt);
+  cTrackRun(System,OTrack,Pts,index,CTrack);
   return;
 }
 
@@ -525,20 +627,56 @@ WeightControl::cTrack(const Simulation& System,
   ELog::RegMethod RegA("WeightControl","cTrack");
   // SOURCE Point
 
-  ModelSupport::ObjectTrackPlane OTrack(initPlane);
-  std::vector<double> WVec;
-
-  long int cN(index.empty() ? 1 : index.back());
-  for(size_t i=0;i<Pts.size();i++)
-    {
-      const long int unit(i>=index.size() ? cN++ : index[i]);
-      OTrack.addUnit(System,unit,Pts[i]);
-      CTrack.addTracks(unit,OTrack.getAttnSum(unit));
-    } 
+  const ModelSupport::ObjectTrackPlane OTrack(initPlane);
+  cTrackRun(System,OTrack,Pts,index,CTrack);
   return;
 }
 
+void
+WeightControl::cellPoints(const Simulation& System,
+			  const std::vector<int>& cellVec,
+			  std::vector<Geometry::Vec3D>& Pts,
+			  std::vector<long int>& index) const
+  /*!
+    Get the track points of the material cells. The first 
+    point is the centre of mass and further points [nSample] 
+    are taken half way to vertices of the cell spaced through 
+    the vertex list, if they are inside the cell.
+    \param System :: Simulation to use
+    \param cellVec :: Cells to track
+    \param Pts :: Track points
+    \param index :: Cell number of each point
+  */
+{
+  ELog::RegMethod RegA("WeightControl","cellPoints");
   
+  for(const int cellN : cellVec)
+    {
+      const MonteCarlo::Qhull* CellPtr=System.findQhull(cellN);
+      if (CellPtr && CellPtr->getMat())
+        {
+	  const Geometry::Vec3D& CofM=CellPtr->getCofM();
+          index.push_back(CellPtr->getName());  // this should be cellN ??
+          Pts.push_back(CofM);
+	  if (nSample>1)
+	    {
+	      const std::vector<Geometry::Vec3D> VPts=CellPtr->getVertex();
+	      const size_t NV(VPts.size());
+	      for(size_t i=1;i<nSample && NV;i++)
+		{
+		  const Geometry::Vec3D MPt=
+		    (CofM+VPts[((i-1)*NV)/(nSample-1)])/2.0;
+		  if (CellPtr->isValid(MPt))
+		    {
+		      index.push_back(CellPtr->getName());
+		      Pts.push_back(MPt);
+		    }
+		}
+	    }
+        }
+    }
+  return;
+}
   
 void
 WeightControl::calcCellTrack(const Simulation& System,
@@ -591,16 +729,7 @@ WeightControl::calcCellTrack(const Simulation& System,
   CTrack.clear();
   std::vector<Geometry::Vec3D> Pts;
   std::vector<long int> index;
-
-  for(const int cellN : cellVec)
-    {
-      const MonteCarlo::Qhull* CellPtr=System.findQhull(cellN);
-      if (CellPtr && CellPtr->getMat())
-        {
-          index.push_back(CellPtr->getName());  // this should be cellN ??
-          Pts.push_back(CellPtr->getCofM());
-        }
-    }
+  cellPoints(System,cellVec,Pts,index);
 
   cTrack(System,curPlane,Pts,index,CTrack);
   return;
@@ -623,23 +752,126 @@ WeightControl::calcCellTrack(const Simulation& System,
   CTrack.clear();
   std::vector<Geometry::Vec3D> Pts;
   std::vector<long int> index;
+  cellPoints(System,cellVec,Pts,index);
+  ELog::EM<<"Cell Track = "<<initPt<<" : "<<Pts.size()
+	  <<" points"<<ELog::endDiag;
+
+  cTrack(System,initPt,Pts,index,CTrack);
+  return;
+}
+
+void
+WeightControl::cellTrack(const Simulation& System,
+			 const std::vector<int>& cellVec,
+			 CellWeight& CTrack)
+  /*!
+    Calculate the cell tracks for the active plane/source
+    point. The track sums are taken from the cache if 
+    present and stored otherwise.
+    \param System :: Simulation to use
+    \param cellVec :: Cells to track
+    \param CTrack :: Cell Weights for output 
+  */
+{
+  ELog::RegMethod RegA("WeightControl","cellTrack");
 
+  std::vector<double> Desc;
+  if (activePtType=="Plane")
+    {
+      TrackCache::addDesc(Desc,planePt[activePtIndex].getNormal());
+      Desc.push_back(planePt[activePtIndex].getDistance());
+    }
+  else
+    TrackCache::addDesc(Desc,sourcePt[activePtIndex]);
+  Desc.push_back(static_cast<double>(nSample));
   for(const int cellN : cellVec)
+    Desc.push_back(static_cast<double>(cellN));
+  
+  const std::string Key=TCache.makeKey("Cell"+activePtType,Desc);
+  std::ifstream IX;
+  if (TCache.openRead(Key,IX))
     {
-      const MonteCarlo::Qhull* CellPtr=System.findQhull(cellN);
-      if (CellPtr && CellPtr->getMat())
-        {
-          index.push_back(CellPtr->getName());  // this should be cellN ??
-          Pts.push_back(CellPtr->getCofM());
-          ELog::EM<<"Cell Track = "<<initPt<<" : "<<index.back()
-                  <<" : [COM] "<<Pts.back()<<ELog::endDiag;
-        }
+      try
+	{
+	  CTrack.readBinary(IX);
+	  return;
+	}
+      catch (ColErr::ExBase&)
+	{
+	  ELog::EM<<"Track cache invalid : retracking"<<ELog::endWarn;
+	}
     }
-
-  cTrack(System,initPt,Pts,index,CTrack);
+  
+  if (activePtType=="Plane")
+    calcCellTrack(System,planePt[activePtIndex],cellVec,CTrack);
+  else
+    calcCellTrack(System,sourcePt[activePtIndex],cellVec,CTrack);
+
+  std::ofstream OX;
+  if (TCache.openWrite(Key,OX))
+    CTrack.writeBinary(OX);
   return;
 }
 
+void
+WeightControl::procPointPD(Simulation& System)
+  /*!
+    Add the PD importance for each point tally. The 
+    sums for a detector are taken from the cache if present 
+    so only new or moved detectors are tracked.
+    Assumed that calcAllVertex has been run on System
+    \param System :: Simulation to use
+  */
+{
+  ELog::RegMethod RegA("WeightControl","procPointPD");
+
+  if (!TCache.isActive())
+    {
+      tallySystem::addPointPD(System,nThread);
+      return;
+    }
+
+  ModelSupport::pointDetOpt PD;
+  PD.setThreads(nThread);
+  if (!PD.addPointTallies(System)) return;
+  PD.setCells(System);
+
+  std::vector<std::string> KeyVec;
+  for(size_t i=0;i<PD.nDetector();i++)
+    {
+      std::vector<double> Desc;
+      TrackCache::addDesc(Desc,PD.getPoint(i));
+      Desc.push_back(static_cast<double>(PD.nCell()));
+      KeyVec.push_back(TCache.makeKey("PointDet",Desc));
+      
+      std::ifstream IX;
+      if (TCache.openRead(KeyVec.back(),IX))
+	{
+	  try
+	    {
+	      PD.readDetector(IX,i);
+	    }
+	  catch (ColErr::ExBase&)
+	    {
+	      ELog::EM<<"Track cache invalid : retracking"<<ELog::endWarn;
+	    }
+	}
+    }
+  
+  std::vector<int> readFlag;
+  for(size_t i=0;i<PD.nDetector();i++)
+    readFlag.push_back(PD.isValid(i));
+
+  PD.createObjAct(System);
+  for(size_t i=0;i<PD.nDetector();i++)
+    {
+      std::ofstream OX;
+      if (!readFlag[i] && TCache.openWrite(KeyVec[i],OX))
+	PD.writeDetector(OX,i);
+    }
+  PD.addTallyOpt(System);
+  return;
+}
 
 void
 WeightControl::procObject(const Simulation& System,
@@ -688,7 +920,7 @@ WeightControl::procObject(const Simulation& System,
             throw ColErr::IndexError<size_t>(activePtIndex,planePt.size(),
                                              "planePt.size() < activePtIndex");
           CellWeight CW;
-          calcCellTrack(System,planePt[activePtIndex],objCells,CW);
+          cellTrack(System,objCells,CW);
           if (!activeAdjointFlag)
             CW.updateWM(energyCut,scaleFactor,minWeight,weightPower);
           else
@@ -701,7 +933,7 @@ WeightControl::procObject(const Simulation& System,
               (activePtIndex,sourcePt.size(),"sourcePt.size() < activePtIndex");
         
           CellWeight CW;
-          calcCellTrack(System,sourcePt[activePtIndex],objCells,CW);
+          cellTrack(System,objCells,CW);
           if (!activeAdjointFlag)
             CW.updateWM(energyCut,scaleFactor,minWeight,weightPower);
           else
@@ -918,6 +1150,14 @@ WeightControl::processWeights(Simulation& System,
   System.populateCells();
   System.createObjSurfMap();
 
+  setCellTrack(procThreads(IParam,"wThreads"),
+	       IParam.getValue<size_t>("wCellSample"));
+  if (IParam.flag("wCache"))
+    {
+      TCache.setDirectory(IParam.getValue<std::string>("wCache"));
+      TCache.setGeometry(System);
+    }
+
   if (IParam.flag("weightType"))
     procType(IParam);
   if (IParam.flag("weight"))
@@ -943,7 +1183,7 @@ WeightControl::processWeights(Simulation& System,
   if (IParam.flag("weightTemp"))
     scaleTempWeights(System,10.0);
   if (IParam.flag("tallyWeight"))
-    tallySystem::addPointPD(System);
+    procPointPD(System);
   if (IParam.flag("weightRebase"))
     procRebase(System,IParam);
 
@@ -1010,7 +1250,8 @@ WeightControl::help() const
   ELog::EM<<"-- wWWG --::"<<ELog::endDiag;
   ELog::EM<<"-- wwgNorm -- minWeight power :: 10^-minWeight and w=w^power "<<ELog::endDiag;
   ELog::EM<<"-- wwgCalc --::"<<ELog::endDiag;
-  ELog::EM<<"-- wwgMarkov --::"<<ELog::endDiag;
+  ELog::EM<<"-- wwgMarkov -- nIter energyCut scale minWeight density "
+    "r2Length r2Power range[cm : -ve for no limit] ::"<<ELog::endDiag;
   ELog::EM<<"-- wwgRPtMesh -- set hte reference point for the mesh ::"<<ELog::endDiag;
   ELog::EM<<"-- wwgVTK --::"<<ELog::endDiag;
   procCalcHelp();
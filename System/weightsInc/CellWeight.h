@@ -43,6 +43,8 @@ struct CellItem
   /// Copy construct
   CellItem(const CellItem& A) :
     vCell(A.vCell),weight(A.weight),number(A.number) {}
+  /// Mean track value
+  double average() const { return weight/number; }
 };
   
 /*!
@@ -74,6 +76,7 @@ class CellWeight
 
   void clear();
   void addTracks(const long int,const double);
+  void addTracks(const CellWeight&);
 
   
   void updateWM(const double,const double,
@@ -81,6 +84,8 @@ class CellWeight
   void invertWM(const double,const double,
 		const double,const double) const;
   void write(std::ostream&) const;
+  void writeBinary(std::ostream&) const;
+  void readBinary(std::istream&);
   
 };
 
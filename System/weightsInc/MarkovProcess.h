@@ -50,6 +50,11 @@ namespace WeightSystem
     \author S. Ansell
     \date October 2015
     \brief Input to Weights controller
+
+    The transport matrix between the WWG mesh points is sparse:
+    only couplings above the cut [exp(-20)] are kept and they 
+    are stored in compressed row form. Only pairs of points 
+    closer than the range that can pass the cut are tracked.
   */
   
 class MarkovProcess
@@ -64,8 +69,16 @@ class MarkovProcess
   long int WZ;             ///< WZ size of WWG
 
   long int FSize;          ///< size of fluxField [square]
-  /// Array of interaction [initialCell][finalCell]
-  boost::multi_array<double,2> fluxField;
+
+  size_t nThread;          ///< Threads for the matrix [0/1 : serial]
+  double maxRange;         ///< Max coupling distance [-ve : cut only]
+
+  std::vector<size_t> rowStart;     ///< Start of each row [FSize+1]
+  std::vector<long int> colIndex;   ///< Column of each value
+  /// Interaction values [initialCell][finalCell] in rowStart order
+  std::vector<double> fluxField;
+
+  double cutRange(const double,const double) const;
   
  public:
 
@@ -75,9 +88,22 @@ class MarkovProcess
   ~MarkovProcess();
 
 
+  /// Set the number of iterations
+  void setIteration(const size_t N) { nIteration=N; }
+  /// Set the number of threads
+  void setThreads(const size_t NT) { nThread=NT; }
+  /// Set the max distance between coupled points
+  void setRange(const double R) { maxRange=R; }
+  /// Number of stored values
+  size_t nonZero() const { return fluxField.size(); }
+
   void initializeData(const WWG&);
   void computeMatrix(const Simulation&,const WWG&,const double,
 		     const double,const double);
+  double getValue(const long int,const long int) const;
+  void multiply(const std::vector<double>&,std::vector<double>&) const;
+  size_t solveFlux(std::vector<double>&,const double) const;
+  void computeFlux(const WWG&,WWGWeight&) const;
     
 };
 
@@ -0,0 +1,81 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   weightInc/TrackCache.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef WeightSystem_TrackCache_h
+#define WeightSystem_TrackCache_h
+
+class Simulation;
+
+namespace WeightSystem
+{
+
+/*!
+  \class TrackCache
+  \version 1.0
+  \author S. Ansell
+  \date October 2017
+  \brief On-disk store of the track attenuation sums
+
+  The track sums of a cell/mesh set depend only on the geometry
+  and the source. They are written to a file named by an MD5 key 
+  of the geometry [variable hash and cells] and the source/points 
+  so that a rerun with a new density/r2Length/r2Power only 
+  re-applies the weight formula. Each file starts with a tag
+  and the full key so a stale or mis-named file is not used.
+*/
+  
+class TrackCache 
+{
+ private:
+
+  static const char cacheTag[8];      ///< File identifier
+  
+  std::string cacheDir;               ///< Directory [empty : off]
+  std::string geomKey;                ///< Hash of geometry
+
+  std::string fileName(const std::string&) const;
+  
+ public:
+
+  TrackCache();
+  TrackCache(const TrackCache&);
+  TrackCache& operator=(const TrackCache&);    
+  ~TrackCache() {}          ///< Destructor
+
+  /// Is the cache in use
+  bool isActive() const { return !cacheDir.empty(); }
+  void setDirectory(const std::string&);
+  void setGeometry(const Simulation&);
+
+  std::string makeKey(const std::string&,
+		      const std::vector<double>&) const;
+  
+  bool openRead(const std::string&,std::ifstream&) const;
+  bool openWrite(const std::string&,std::ofstream&) const;
+
+  static void addDesc(std::vector<double>&,const Geometry::Vec3D&);
+  static void addDesc(std::vector<double>&,
+		      const std::vector<Geometry::Vec3D>&);
+};
+
+}
+
+#endif
@@ -32,6 +32,29 @@ class Simulation;
 namespace WeightSystem
 {
   class WWGWeight;
+
+  /*!
+    \struct WWGStep 
+    \author S. Ansell
+    \version 1.0
+    \date October 2017
+    \brief Single post-processing step on the WWG mesh
+  */
+  
+struct WWGStep
+{
+  /// Step type
+  enum class SType { normalize=0, scaleRange=1, power=2 };
+
+  SType type;          ///< Type of step
+  double A;            ///< minR / power
+  double B;            ///< maxR
+
+  /// Constructor
+  WWGStep(const SType T,const double AV=0.0,const double BV=0.0) :
+    type(T),A(AV),B(BV) {}
+};
+  
   /*!
     \class WWG 
     \author S. Ansell
@@ -51,6 +74,8 @@ class WWG
   int mwhere;          ///< Check weight -1:col 0:all 1:surf
   int mtime;           ///< Flag to inditace energy(0)/time(1)
   int switchn;         ///< read from wwinp file
+
+  size_t nThread;      ///< Threads for mesh passes [0/1 serial]
   
   std::vector<double> EBin;      ///< Energy bins
   Geometry::Mesh3D Grid;         ///< Mesh Grid
@@ -60,6 +85,12 @@ class WWG
   /// weight mesh
   boost::multi_array<double,4> WMesh;
     
+  static const char binaryTag[8];   ///< Binary file identifier
+  
+  template<typename F>
+  void blockRun(const size_t,const F&) const;
+  void meshRange(double&,double&) const;
+  
   void writeHead(std::ostream&) const;
   
  public:
@@ -77,6 +108,8 @@ class WWG
   /// get grid mid point
   const std::vector<Geometry::Vec3D>& getMidPoints() const
     {return GridMidPt; }
+  /// access to weight mesh
+  const boost::multi_array<double,4>& getMesh() const { return WMesh; }
   /// Access to EBin
   const std::vector<double>& getEBin() const { return EBin; }
   void setEnergyBin(const std::vector<double>&,
@@ -89,14 +122,20 @@ class WWG
 		     const size_t,const double);
   void calcGridMidPoints();
   void updateWM(const WWGWeight&,const double);
+  /// Set the number of threads for mesh passes
+  void setThreads(const size_t NT) { nThread=NT; }
   void normalize();
   void scaleRange(const double,const double);
   void powerRange(const double);
+  void process(const std::vector<WWGStep>&);
 
   void write(std::ostream&) const;
   void writeWWINP(const std::string&) const;
   void writeVTK(const std::string&) const;
 
+  void writeBinary(const std::string&) const;
+  void readBinary(const std::string&);
+
 
   
 };
@@ -22,6 +22,11 @@
 #ifndef WeightSystem_WWGWeight_h
 #define WeightSystem_WWGWeight_h
 
+namespace ModelSupport
+{
+  class AttnTable;
+}
+
 namespace WeightSystem
 {
 
@@ -41,9 +46,20 @@ class WWGWeight
   const long int WY;             ///< Weight YIndex size
   const long int WZ;             ///< Weight ZIndex size
   const long int WE;             ///< Energy size
+
+  size_t nThread;                ///< Tracking threads [0/1 : serial]
   
   /// local storage for data [i,j,j,Energy]
   boost::multi_array<double,4> WGrid; 
+
+  std::vector<double> TDist;     ///< Track length [by point]
+  std::vector<double> TAttn;     ///< Attenuation sum [point,energy]
+  
+  template<typename T>
+  void trackRun(const Simulation&,const T&,
+		const ModelSupport::AttnTable&,
+		const std::vector<Geometry::Vec3D>&,
+		const std::vector<size_t>&);
   
  public:
 
@@ -57,6 +73,9 @@ class WWGWeight
   long int getZSize() const { return WZ; }
   long int getESize() const { return WE; }
 
+  /// Set the number of tracking threads
+  void setThreads(const size_t NT) { nThread=NT; }
+
   void zeroWGrid();
   double calcMaxAttn(const long int) const;
   double calcMaxAttn() const;
@@ -72,6 +91,24 @@ class WWGWeight
     { return WGrid; }
   void setPoint(const long int,const long int,const double);
 
+  void calcTracks(const Simulation&,const Geometry::Vec3D&,
+		  const std::vector<Geometry::Vec3D>&);
+  void calcTracks(const Simulation&,const Geometry::Plane&,
+		  const std::vector<Geometry::Vec3D>&);
+  void calcTracks(const Simulation&,const Geometry::Vec3D&,
+		  const std::vector<Geometry::Vec3D>&,
+		  const std::vector<size_t>&);
+  void calcTracks(const Simulation&,const Geometry::Plane&,
+		  const std::vector<Geometry::Vec3D>&,
+		  const std::vector<size_t>&);
+  void copyTracks(const WWGWeight&,const std::vector<size_t>&);
+  void markGradient(const double,std::vector<int>&) const;
+  /// Have the raw track sums been calculated/read
+  bool hasTracks() const { return !TDist.empty(); }
+  void applyTracks(const double,const double,const double);
+  void writeTracks(std::ostream&) const;
+  void readTracks(std::istream&);
+  
   void wTrack(const Simulation&,const Geometry::Vec3D&,
 	      const std::vector<double>&,
 	      const std::vector<Geometry::Vec3D>&,
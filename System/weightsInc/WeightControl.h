@@ -43,6 +43,7 @@ namespace WeightSystem
   class ItemWeight;
   class CellWeight;
   class WWGWeight;
+  class WWG;
   
   /*!
     \class WeightControl
@@ -69,6 +70,10 @@ class WeightControl
 
   // exta factors for MARKOV:
   size_t nMarkov;                ///< Markov count  
+  double markovRange;            ///< Max Markov coupling range [-ve : none]
+
+  size_t nThread;                ///< Cell tracking threads 
+  size_t nSample;                ///< Track points per cell
   
   std::set<std::string> objectList;  ///< Object list to this cut [local]
 
@@ -79,6 +84,8 @@ class WeightControl
   std::vector<Geometry::Cone> conePt;         ///< Cone points
   std::vector<Geometry::Plane> planePt;       ///< Plane points
   std::vector<Geometry::Vec3D> sourcePt;      ///< Source Points
+
+  TrackCache TCache;                 ///< Stored track sums
   
   void setHighEBand();
   void setMidEBand();
@@ -95,6 +102,8 @@ class WeightControl
   void procType(const mainSystem::inputParam&);
   void procParam(const mainSystem::inputParam&,const std::string&,
 		const size_t,const size_t);
+  static size_t procThreads(const mainSystem::inputParam&,
+			    const std::string&);
   void procMarkov(const mainSystem::inputParam&,const std::string&,
 		  const size_t);
   void procTypeHelp() const;
@@ -104,6 +113,9 @@ class WeightControl
   void procTrackLine(const mainSystem::inputParam&);
   void procObject(const Simulation&,
 		  const mainSystem::inputParam&);
+  void cellTrack(const Simulation&,const std::vector<int>&,
+		 CellWeight&);
+  void procPointPD(Simulation&);
   void procRebase(const Simulation&,
 		  const mainSystem::inputParam&);
   void procTrack(const Simulation&,
@@ -122,6 +134,14 @@ class WeightControl
   
   
   void setWeights(Simulation&);
+  template<typename T>
+  void cTrackRun(const Simulation&,const T&,
+		 const std::vector<Geometry::Vec3D>&,
+		 const std::vector<long int>&,
+		 CellWeight&) const;
+  void cellPoints(const Simulation&,const std::vector<int>&,
+		  std::vector<Geometry::Vec3D>&,
+		  std::vector<long int>&) const;
   void cTrack(const Simulation&,const Geometry::Vec3D&,
 	      const std::vector<Geometry::Vec3D>&,
 	      const std::vector<long int>&,
@@ -143,7 +163,18 @@ class WeightControl
   void wwgMesh(const mainSystem::inputParam&);
   void wwgEnergy(const mainSystem::inputParam&);
   void wwgVTK(const mainSystem::inputParam&);
+  int wwgBinaryRead(const mainSystem::inputParam&);
+  void wwgBinaryWrite(const mainSystem::inputParam&);
   void wwgCreate(const Simulation&,const mainSystem::inputParam&);
+  void wwgRefine(const Simulation&,const mainSystem::inputParam&);
+  void wwgCheckActive() const;
+  void wwgCombine(WWG&,WWGWeight&);
+  void wwgTrack(const Simulation&,const std::vector<double>&,
+		const std::vector<Geometry::Vec3D>&,WWGWeight&);
+  void wwgRefineTrack(const Simulation&,const std::vector<double>&,
+		      const std::vector<Geometry::Vec3D>&,
+		      const std::vector<size_t>&,const std::vector<size_t>&,
+		      WWGWeight&);
   void wwgMarkov(const Simulation&,const mainSystem::inputParam&);
   void wwgNormalize(const mainSystem::inputParam&);
   
@@ -151,10 +182,6 @@ class WeightControl
 		    WWGWeight&);
   void calcWWGTrack(const Simulation&,const Geometry::Vec3D&,
 		    WWGWeight&);
-  void calcCellTrack(const Simulation&,const Geometry::Vec3D&,
-		     const std::vector<int>&,CellWeight&);
-  void calcCellTrack(const Simulation&,const Geometry::Plane&,
-		     const std::vector<int>&,CellWeight&);
   void calcCellTrack(const Simulation&,const Geometry::Cone&,
 		     CellWeight&);
 
@@ -166,6 +193,13 @@ class WeightControl
   WeightControl& operator=(const WeightControl&);
   ~WeightControl();
 
+  /// Set the cell tracking threads and points per cell
+  void setCellTrack(const size_t NT,const size_t NS)
+    { nThread=NT; nSample=(NS) ? NS : 1; }
+  void calcCellTrack(const Simulation&,const Geometry::Vec3D&,
+		     const std::vector<int>&,CellWeight&);
+  void calcCellTrack(const Simulation&,const Geometry::Plane&,
+		     const std::vector<int>&,CellWeight&);
   
   void processWeights(Simulation&,const mainSystem::inputParam&);
     
@@ -66,6 +66,7 @@
 #include "varList.h"
 #include "Code.h"
 #include "FuncDataBase.h"
+#include "varScope.h"
 #include "HeadRule.h"
 #include "RuleSupport.h"
 #include "Object.h"
@@ -336,21 +337,22 @@ GuideLine::processShape(const FuncDataBase& Control)
   Geometry::Vec3D StartPt=guideFC.getCentre();
   double beamX,beamZ,bXYang,bZang;
 
+  // keyName+index+tail variables
+  varScope SV(Control,keyName);
   for(size_t index=0;index<nShapes;index++)
     {
       const std::string NStr=StrFunc::makeString(index);
-      const std::string BKey=keyName+NStr;
 
       const std::string typeID= 
-	Control.EvalVar<std::string>(keyName+NStr+"TypeID");
+	SV.EvalVar<std::string>(index,"TypeID");
       // PROCESS NEXT SECTION:
       // Beam position [def original]
 
       // Initial directions:
-      beamX=Control.EvalDefVar<double>(BKey+"XStep",0.0);
-      beamZ=Control.EvalDefVar<double>(BKey+"ZStep",0.0);
-      bXYang=Control.EvalDefVar<double>(BKey+"XYAngle",0.0);
-      bZang=Control.EvalDefVar<double>(BKey+"ZAngle",0.0);
+      beamX=SV.EvalDefVar<double>(index,"XStep",0.0);
+      beamZ=SV.EvalDefVar<double>(index,"ZStep",0.0);
+      bXYang=SV.EvalDefVar<double>(index,"XYAngle",0.0);
+      bZang=SV.EvalDefVar<double>(index,"ZAngle",0.0);
 
       if (index)
 	{
@@ -361,7 +363,7 @@ GuideLine::processShape(const FuncDataBase& Control)
 	addGuideUnit(index,StartPt,beamX,beamZ,bXYang,bZang);
 
       setDefault("Guide"+NStr);
-      const double L=Control.EvalVar<double>(keyName+NStr+"Length");      
+      const double L=SV.EvalVar<double>(index,"Length");      
 
       // Simple rectangle projection:
       // ALL PROJECTIONS IN ROTATED DISTANCE
@@ -369,8 +371,8 @@ GuideLine::processShape(const FuncDataBase& Control)
       if (typeID=="Rectangle")   
 	{
 	  PlateUnit* SU=new PlateUnit(GINumber,SULayer);
-	  const double H=Control.EvalVar<double>(keyName+NStr+"Height");
-	  const double W=Control.EvalVar<double>(keyName+NStr+"Width");
+	  const double H=SV.EvalVar<double>(index,"Height");
+	  const double W=SV.EvalVar<double>(index,"Width");
 
 	  SU->addPrimaryPoint(Geometry::Vec3D(-W/2.0,0,-H/2.0));
 	  SU->addPrimaryPoint(Geometry::Vec3D(W/2.0,0,-H/2.0));
@@ -386,10 +388,10 @@ GuideLine::processShape(const FuncDataBase& Control)
       else if (typeID=="Tapper" || typeID=="Taper")   
 	{
 	  PlateUnit* SU=new PlateUnit(GINumber,SULayer);
-	  const double HA=Control.EvalVar<double>(keyName+NStr+"HeightStart");
-	  const double WA=Control.EvalVar<double>(keyName+NStr+"WidthStart");
-	  const double HB=Control.EvalVar<double>(keyName+NStr+"HeightEnd");
-	  const double WB=Control.EvalVar<double>(keyName+NStr+"WidthEnd");
+	  const double HA=SV.EvalVar<double>(index,"HeightStart");
+	  const double WA=SV.EvalVar<double>(index,"WidthStart");
+	  const double HB=SV.EvalVar<double>(index,"HeightEnd");
+	  const double WB=SV.EvalVar<double>(index,"WidthEnd");
 
 	  SU->addPairPoint(Geometry::Vec3D(-WA/2.0,0.0,-HA/2.0),
 			   Geometry::Vec3D(-WB/2.0,0.0,-HB/2.0));
@@ -409,15 +411,15 @@ GuideLine::processShape(const FuncDataBase& Control)
 	{
 	  BenderUnit* BU=new BenderUnit(GINumber,SULayer);
 
-	  const double HA=Control.EvalVar<double>(keyName+NStr+"AHeight");
-	  const double HB=Control.EvalDefVar<double>(keyName+NStr+"BHeight",HA);
-	  const double WA=Control.EvalVar<double>(keyName+NStr+"AWidth");
-	  const double WB=Control.EvalDefVar<double>(keyName+NStr+"BWidth",WA);
+	  const double HA=SV.EvalVar<double>(index,"AHeight");
+	  const double HB=SV.EvalDefVar<double>(index,"BHeight",HA);
+	  const double WA=SV.EvalVar<double>(index,"AWidth");
+	  const double WB=SV.EvalDefVar<double>(index,"BWidth",WA);
 	  // angular rotation of bend direciton from +Z
 	  const double bendAngDir=
-	    Control.EvalVar<double>(keyName+NStr+"AngDir");
+	    SV.EvalVar<double>(index,"AngDir");
 	  const double radius=
-	    Control.EvalVar<double>(keyName+NStr+"Radius");
+	    SV.EvalVar<double>(index,"Radius");
 
 	  BU->setValues(HA,HB,WA,WB,L,radius,bendAngDir);
 	  BU->setOriginAxis(Origin,X,Y,Z);
@@ -428,19 +430,19 @@ GuideLine::processShape(const FuncDataBase& Control)
 	{
 	  DBenderUnit* BU=new DBenderUnit(GINumber,SULayer);
 
-	  const double HA=Control.EvalVar<double>(keyName+NStr+"AHeight");
-	  const double HB=Control.EvalDefVar<double>(keyName+NStr+"BHeight",HA);
-	  const double WA=Control.EvalVar<double>(keyName+NStr+"AWidth");
-	  const double WB=Control.EvalDefVar<double>(keyName+NStr+"BWidth",WA);
+	  const double HA=SV.EvalVar<double>(index,"AHeight");
+	  const double HB=SV.EvalDefVar<double>(index,"BHeight",HA);
+	  const double WA=SV.EvalVar<double>(index,"AWidth");
+	  const double WB=SV.EvalDefVar<double>(index,"BWidth",WA);
 	  // angular rotation of bend direciton from +Z
 	  const double RadA=
-	    Control.EvalVar<double>(keyName+NStr+"RadiusA");
+	    SV.EvalVar<double>(index,"RadiusA");
 	  const double RadB=
-	    Control.EvalVar<double>(keyName+NStr+"RadiusB");
+	    SV.EvalVar<double>(index,"RadiusB");
 	  const double bendAngDir=
-	    Control.EvalVar<double>(keyName+NStr+"AngDir");
+	    SV.EvalVar<double>(index,"AngDir");
 	  const double sndAngDir=
-	    Control.EvalDefVar<double>(keyName+NStr+"SndDir",bendAngDir+90.0);
+	    SV.EvalDefVar<double>(index,"SndDir",bendAngDir+90.0);
 
 	  BU->setApperture(HA,HB,WA,WB);
 	  BU->setRadii(RadA,RadB);
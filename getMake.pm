@@ -15,7 +15,7 @@ sub new
     cxx11 => " -std=c++11",
     fcomp => "gfortran",
     cflag => "-fPIC -Wconversion -W -Wall -Wextra ".
-	"-Wno-comment -fexceptions",
+	"-Wno-comment -fexceptions -pthread",
 
     boostInc => "-I/opt/local/include",
     boostLib => "-L/opt/local/lib -lboost_regex",
@@ -0,0 +1,108 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   include/CellIndex.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef ModelSupport_CellIndex_h
+#define ModelSupport_CellIndex_h
+
+class Rule;
+
+namespace MonteCarlo
+{
+  class Object;
+  class Qhull;
+}
+
+namespace ModelSupport
+{
+
+/*!
+  \class CellIndex
+  \version 1.0
+  \author S. Ansell
+  \date October 2017
+  \brief Bounding volume hierarchy of cell boxes for point location
+
+  Each non-placeholder cell is given a conservative axis-aligned
+  box derived from its rule tree (axis aligned planes, spheres and
+  cylinders bound it, everything else is open). Bounded cells are
+  placed in a BVH, open cells are kept in a list that is always tested.
+  The index holds object pointers so must be cleared if cells
+  are added/removed/renumbered.
+*/
+
+class CellIndex
+{
+ public:
+
+  /// Box : lowX,lowY,lowZ,highX,highY,highZ
+  typedef std::array<double,6> BoxTYPE;
+
+ private:
+
+  static const size_t leafSize;       ///< Max cells in a leaf node
+
+  std::vector<MonteCarlo::Object*> cellPtr;   ///< Bounded cells
+  std::vector<BoxTYPE> cellBox;               ///< Box of each bounded cell
+  std::vector<MonteCarlo::Object*> openCells; ///< Unbounded cells
+
+  std::vector<size_t> itemOrder;     ///< Cell index in node order
+  std::vector<BoxTYPE> nodeBox;      ///< Node bounding box
+  std::vector<size_t> nodeFirst;     ///< First item [leaf]
+  std::vector<size_t> nodeCount;     ///< Number of items [0 : branch]
+  std::vector<size_t> nodeRight;     ///< Right child [left is index+1]
+
+  static BoxTYPE openBox();
+  static bool isBounded(const BoxTYPE&);
+  static bool inBox(const BoxTYPE&,const Geometry::Vec3D&);
+  static void intersectBox(BoxTYPE&,const BoxTYPE&);
+  static void unionBox(BoxTYPE&,const BoxTYPE&);
+  static BoxTYPE surfBox(const Geometry::Surface*,const int);
+
+  size_t buildNode(const size_t,const size_t);
+
+ public:
+
+  CellIndex();
+  CellIndex(const CellIndex&);
+  CellIndex& operator=(const CellIndex&);
+  ~CellIndex() {}    ///< Destructor
+
+  static BoxTYPE ruleBox(const Rule*);
+  static bool overlapBox(const BoxTYPE&,const BoxTYPE&);
+
+  void clearAll();
+  void build(const std::map<int,MonteCarlo::Qhull*>&);
+
+  /// Number of cells in the BVH
+  size_t nBounded() const { return cellPtr.size(); }
+  /// Number of cells always checked
+  size_t nOpen() const { return openCells.size(); }
+  /// Has the index been built
+  bool isBuilt() const { return !cellPtr.empty() || !openCells.empty(); }
+
+  MonteCarlo::Object* findCell(const Geometry::Vec3D&) const;
+  void boxCells(const BoxTYPE&,std::vector<MonteCarlo::Object*>&) const;
+
+};
+
+}
+
+#endif
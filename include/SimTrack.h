@@ -42,7 +42,10 @@ namespace ModelSupport
 
   In a given simulation tracks or isValid operations based on points
   typically start from the last used cell : This keeps a track of the 
-  last used cell as an optimization point.
+  last used cell as an optimization point. There is one instance per
+  thread so a worker thread has its own last cell. Simulations 
+  must be registered with addSim unless the thread has been set 
+  to register them on first use [VolSum workers].
 */
 
 
@@ -53,6 +56,7 @@ class SimTrack
   /// Storage of the findCell Ptr
   typedef std::map<unsigned long int,MonteCarlo::Object*> fcTYPE;
   fcTYPE findCell;   ///< Find cell Map
+  int lazyFlag;      ///< Register simulations on first use
 
   SimTrack();
 
@@ -65,6 +69,9 @@ class SimTrack
 
   static SimTrack& Instance();
 
+  /// Register simulations on first use [worker thread]
+  void setLazy() { lazyFlag=1; }
+
   // Cell Ptr:
   MonteCarlo::Object* curCell(const Simulation*) const;
   void setCell(const Simulation*,MonteCarlo::Object*);
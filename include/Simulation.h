@@ -48,6 +48,7 @@ class RemoveCell;
 namespace ModelSupport
 {
   class ObjSurfMap;
+  class CellIndex;
 }
 
 namespace WeightSystem
@@ -61,6 +62,7 @@ namespace MonteCarlo
   class Object;
   class Material;
   class Qhull;
+  class QueryContext;
 }
 
 /*!
@@ -95,6 +97,7 @@ class Simulation
   int CNum;                             ///< Number of complementary components
   FuncDataBase DB;                      ///< DataBase of variables
   ModelSupport::ObjSurfMap* OSMPtr;     ///< Object surface map [if required]
+  ModelSupport::CellIndex* CIPtr;       ///< Cell box index [if built]
 
   TransTYPE TList;                      ///< Transforms List (key=Transform)
 
@@ -156,6 +159,9 @@ class Simulation
   const MonteCarlo::Qhull* findQhull(const int) const; 
   MonteCarlo::Object* findCell(const Geometry::Vec3D&,
 			       MonteCarlo::Object*) const;
+  MonteCarlo::Object* findCell(MonteCarlo::QueryContext&,
+			       const Geometry::Vec3D&,
+			       MonteCarlo::Object*) const;
   int findCellNumber(const Geometry::Vec3D&,const int) const;  
 
   int existCell(const int) const;              ///< check if cell exist
@@ -224,6 +230,11 @@ class Simulation
   /// Access surface map
   const ModelSupport::ObjSurfMap* getOSM() const;
 
+  void buildCellIndex();
+  void clearCellIndex();
+  /// Access cell index [0 if not built]
+  const ModelSupport::CellIndex* getCellIndex() const { return CIPtr; }
+
   // Tally processing
 
   void removeAllTally();
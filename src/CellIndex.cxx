@@ -0,0 +1,481 @@
+/*********************************************************************
+  CombLayer : MCNP(X) Input builder
+
+ * File:   src/CellIndex.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <list>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <array>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Surface.h"
+#include "Quadratic.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include "Cylinder.h"
+#include "Rules.h"
+#include "HeadRule.h"
+#include "Object.h"
+#include "Qhull.h"
+#include "CellIndex.h"
+
+namespace ModelSupport
+{
+
+const size_t CellIndex::leafSize(4);
+
+CellIndex::CellIndex()
+  /*!
+    Constructor
+  */
+{}
+
+CellIndex::CellIndex(const CellIndex& A) :
+  cellPtr(A.cellPtr),cellBox(A.cellBox),openCells(A.openCells),
+  itemOrder(A.itemOrder),nodeBox(A.nodeBox),nodeFirst(A.nodeFirst),
+  nodeCount(A.nodeCount),nodeRight(A.nodeRight)
+  /*!
+    Copy constructor
+    \param A :: CellIndex to copy
+  */
+{}
+
+CellIndex&
+CellIndex::operator=(const CellIndex& A)
+  /*!
+    Assignment operator
+    \param A :: CellIndex to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      cellPtr=A.cellPtr;
+      cellBox=A.cellBox;
+      openCells=A.openCells;
+      itemOrder=A.itemOrder;
+      nodeBox=A.nodeBox;
+      nodeFirst=A.nodeFirst;
+      nodeCount=A.nodeCount;
+      nodeRight=A.nodeRight;
+    }
+  return *this;
+}
+
+void
+CellIndex::clearAll()
+  /*!
+    Remove all the cells / nodes
+  */
+{
+  cellPtr.clear();
+  cellBox.clear();
+  openCells.clear();
+  itemOrder.clear();
+  nodeBox.clear();
+  nodeFirst.clear();
+  nodeCount.clear();
+  nodeRight.clear();
+  return;
+}
+
+CellIndex::BoxTYPE
+CellIndex::openBox()
+  /*!
+    Construct an unbounded box
+    \return infinite box
+  */
+{
+  const double inf(std::numeric_limits<double>::infinity());
+  BoxTYPE Out;
+  for(size_t i=0;i<3;i++)
+    {
+      Out[i]= -inf;
+      Out[i+3]= inf;
+    }
+  return Out;
+}
+
+bool
+CellIndex::isBounded(const BoxTYPE& Box)
+  /*!
+    Determine if the box is finite in all directions
+    \param Box :: Box to test
+    \return true if finite
+  */
+{
+  for(const double& V : Box)
+    if (!std::isfinite(V)) return 0;
+  return 1;
+}
+
+bool
+CellIndex::inBox(const BoxTYPE& Box,const Geometry::Vec3D& Pt)
+  /*!
+    Determine if the point is within the box
+    \param Box :: Box to test
+    \param Pt :: Point to test
+    \return true if Pt within/on the box
+  */
+{
+  return (Pt.X()>=Box[0] && Pt.X()<=Box[3] &&
+	  Pt.Y()>=Box[1] && Pt.Y()<=Box[4] &&
+	  Pt.Z()>=Box[2] && Pt.Z()<=Box[5]);
+}
+
+bool
+CellIndex::overlapBox(const BoxTYPE& A,const BoxTYPE& B)
+  /*!
+    Determine if two boxes have a common region
+    [touching boxes overlap]
+    \param A :: First box
+    \param B :: Second box
+    \return true if the boxes overlap
+  */
+{
+  for(size_t i=0;i<3;i++)
+    if (A[i]>B[i+3] || B[i]>A[i+3])
+      return 0;
+  return 1;
+}
+
+void
+CellIndex::intersectBox(BoxTYPE& Box,const BoxTYPE& A)
+  /*!
+    Reduce the box to the common region with A
+    \param Box :: Box to modify
+    \param A :: Box to intersect with
+  */
+{
+  for(size_t i=0;i<3;i++)
+    {
+      Box[i]=std::max(Box[i],A[i]);
+      Box[i+3]=std::min(Box[i+3],A[i+3]);
+    }
+  return;
+}
+
+void
+CellIndex::unionBox(BoxTYPE& Box,const BoxTYPE& A)
+  /*!
+    Expand the box to include A
+    \param Box :: Box to modify
+    \param A :: Box to add
+  */
+{
+  for(size_t i=0;i<3;i++)
+    {
+      Box[i]=std::min(Box[i],A[i]);
+      Box[i+3]=std::max(Box[i+3],A[i+3]);
+    }
+  return;
+}
+
+CellIndex::BoxTYPE
+CellIndex::surfBox(const Geometry::Surface* SPtr,const int sign)
+  /*!
+    Calculate the conservative box of one side of a surface.
+    Only axis aligned planes, the inside of spheres and the inside
+    of cylinders give a bounded component.
+    \param SPtr :: Surface
+    \param sign :: Side of the surface
+    \return box of the half space
+  */
+{
+  // Slack so that points on the surface remain in the box
+  const double tol(1e-6);
+  BoxTYPE Out=openBox();
+  if (!SPtr) return Out;
+
+  const Geometry::Plane* PPtr=
+    dynamic_cast<const Geometry::Plane*>(SPtr);
+  if (PPtr)
+    {
+      const Geometry::Vec3D& N=PPtr->getNormal();
+      const double D=PPtr->getDistance();
+      for(size_t i=0;i<3;i++)
+	{
+	  const double NV=(i==0) ? N.X() : ((i==1) ? N.Y() : N.Z());
+	  if (std::abs(std::abs(NV)-1.0)<Geometry::zeroTol)
+	    {
+	      // n.x >= D (sign>0)  or n.x <= D (sign<0)
+	      if (NV*sign>0.0)
+		Out[i]=D*NV-tol;
+	      else
+		Out[i+3]=D*NV+tol;
+	    }
+	}
+      return Out;
+    }
+
+  if (sign>0) return Out;
+
+  const Geometry::Sphere* SphPtr=
+    dynamic_cast<const Geometry::Sphere*>(SPtr);
+  if (SphPtr)
+    {
+      const Geometry::Vec3D& C=SphPtr->getCentre();
+      const double R=SphPtr->getRadius()+tol;
+      Out={ {C.X()-R,C.Y()-R,C.Z()-R,C.X()+R,C.Y()+R,C.Z()+R} };
+      return Out;
+    }
+
+  const Geometry::Cylinder* CPtr=
+    dynamic_cast<const Geometry::Cylinder*>(SPtr);
+  if (CPtr)
+    {
+      const Geometry::Vec3D& C=CPtr->getCentre();
+      const Geometry::Vec3D& N=CPtr->getNormal();
+      const double R=CPtr->getRadius()+tol;
+      const double CV[3]={C.X(),C.Y(),C.Z()};
+      const double NV[3]={N.X(),N.Y(),N.Z()};
+      for(size_t i=0;i<3;i++)
+	if (std::abs(NV[i])<Geometry::zeroTol)
+	  {
+	    Out[i]=CV[i]-R;
+	    Out[i+3]=CV[i]+R;
+	  }
+    }
+  return Out;
+}
+
+CellIndex::BoxTYPE
+CellIndex::ruleBox(const Rule* RPtr)
+  /*!
+    Calculate a conservative box from the rule tree
+    Intersections reduce the box, unions expand it and anything
+    that cannot be bounded (complements/general surfaces) is open.
+    \param RPtr :: Rule to process
+    \return Box containing the rule
+  */
+{
+  if (!RPtr) return openBox();
+
+  const SurfPoint* SP=dynamic_cast<const SurfPoint*>(RPtr);
+  if (SP)
+    return surfBox(SP->getKey(),SP->getSign());
+
+  const int RType=RPtr->type();
+  if (RType==1 || RType==-1)
+    {
+      const Rule* APtr=RPtr->leaf(0);
+      const Rule* BPtr=RPtr->leaf(1);
+      BoxTYPE Out=ruleBox(APtr);
+      if (BPtr)
+	{
+	  if (RType==1)
+	    intersectBox(Out,ruleBox(BPtr));
+	  else
+	    unionBox(Out,ruleBox(BPtr));
+	}
+      return Out;
+    }
+  return openBox();
+}
+
+size_t
+CellIndex::buildNode(const size_t first,const size_t N)
+  /*!
+    Recursive construction of the node holding
+    the items itemOrder[first -> first+N]
+    \param first :: First item
+    \param N :: number of items
+    \return node index
+  */
+{
+  const size_t nodeIndex=nodeBox.size();
+
+  BoxTYPE NBox=cellBox[itemOrder[first]];
+  for(size_t i=first+1;i<first+N;i++)
+    unionBox(NBox,cellBox[itemOrder[i]]);
+
+  nodeBox.push_back(NBox);
+  nodeFirst.push_back(first);
+  nodeCount.push_back(N);
+  nodeRight.push_back(0);
+  if (N<=leafSize)
+    return nodeIndex;
+
+  // split on the longest axis about the median centre
+  size_t axis(0);
+  double maxLen(-1.0);
+  for(size_t i=0;i<3;i++)
+    if (NBox[i+3]-NBox[i]>maxLen)
+      {
+	maxLen=NBox[i+3]-NBox[i];
+	axis=i;
+      }
+
+  const size_t NHalf(N/2);
+  std::nth_element
+    (itemOrder.begin()+static_cast<long int>(first),
+     itemOrder.begin()+static_cast<long int>(first+NHalf),
+     itemOrder.begin()+static_cast<long int>(first+N),
+     [this,axis](const size_t A,const size_t B)
+     {
+       return (cellBox[A][axis]+cellBox[A][axis+3]) <
+	 (cellBox[B][axis]+cellBox[B][axis+3]);
+     });
+
+  nodeCount[nodeIndex]=0;
+  buildNode(first,NHalf);
+  nodeRight[nodeIndex]=buildNode(first+NHalf,N-NHalf);
+  return nodeIndex;
+}
+
+void
+CellIndex::build(const std::map<int,MonteCarlo::Qhull*>& OList)
+  /*!
+    Construct the index from the cell map
+    The cells must have been populated
+    \param OList :: Cell map
+  */
+{
+  ELog::RegMethod RegA("CellIndex","build");
+
+  clearAll();
+  for(const std::map<int,MonteCarlo::Qhull*>::value_type& OV : OList)
+    {
+      MonteCarlo::Object* OPtr=OV.second;
+      if (OPtr->isPlaceHold()) continue;
+      const BoxTYPE Box=ruleBox(OPtr->topRule());
+      if (isBounded(Box))
+	{
+	  cellPtr.push_back(OPtr);
+	  cellBox.push_back(Box);
+	}
+      else
+	openCells.push_back(OPtr);
+    }
+
+  itemOrder.resize(cellPtr.size());
+  for(size_t i=0;i<itemOrder.size();i++)
+    itemOrder[i]=i;
+
+  if (!cellPtr.empty())
+    buildNode(0,cellPtr.size());
+
+  ELog::EM<<"Cell index: "<<cellPtr.size()<<" bounded / "
+	  <<openCells.size()<<" open cells "
+	  <<"("<<nodeBox.size()<<" nodes)"<<ELog::endDiag;
+  return;
+}
+
+MonteCarlo::Object*
+CellIndex::findCell(const Geometry::Vec3D& Pt) const
+  /*!
+    Find the cell containing the point
+    \param Pt :: Point to test
+    \return Object Ptr / 0 if not found
+  */
+{
+  if (!nodeBox.empty())
+    {
+      std::vector<size_t> nodeStack;
+      nodeStack.push_back(0);
+      while(!nodeStack.empty())
+	{
+	  const size_t NI=nodeStack.back();
+	  nodeStack.pop_back();
+	  if (!inBox(nodeBox[NI],Pt)) continue;
+	  if (nodeCount[NI])
+	    {
+	      for(size_t i=nodeFirst[NI];i<nodeFirst[NI]+nodeCount[NI];i++)
+		{
+		  const size_t index=itemOrder[i];
+		  if (inBox(cellBox[index],Pt) &&
+		      cellPtr[index]->isValid(Pt))
+		    return cellPtr[index];
+		}
+	    }
+	  else
+	    {
+	      nodeStack.push_back(nodeRight[NI]);
+	      nodeStack.push_back(NI+1);
+	    }
+	}
+    }
+  for(MonteCarlo::Object* OPtr : openCells)
+    if (OPtr->isValid(Pt))
+      return OPtr;
+
+  return 0;
+}
+
+void
+CellIndex::boxCells(const BoxTYPE& Box,
+		    std::vector<MonteCarlo::Object*>& Out) const
+  /*!
+    Find the cells that may have a common region with the box.
+    All the open cells are included.
+    \param Box :: Box to test
+    \param Out :: Cells whose box overlaps [appended]
+  */
+{
+  if (!nodeBox.empty())
+    {
+      std::vector<size_t> nodeStack;
+      nodeStack.push_back(0);
+      while(!nodeStack.empty())
+	{
+	  const size_t NI=nodeStack.back();
+	  nodeStack.pop_back();
+	  if (!overlapBox(nodeBox[NI],Box)) continue;
+	  if (nodeCount[NI])
+	    {
+	      for(size_t i=nodeFirst[NI];i<nodeFirst[NI]+nodeCount[NI];i++)
+		{
+		  const size_t index=itemOrder[i];
+		  if (overlapBox(cellBox[index],Box))
+		    Out.push_back(cellPtr[index]);
+		}
+	    }
+	  else
+	    {
+	      nodeStack.push_back(nodeRight[NI]);
+	      nodeStack.push_back(NI+1);
+	    }
+	}
+    }
+  Out.insert(Out.end(),openCells.begin(),openCells.end());
+  return;
+}
+
+}  // NAMESPACE ModelSupport
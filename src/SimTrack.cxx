@@ -43,7 +43,8 @@
 namespace ModelSupport
 {
 
-SimTrack::SimTrack() 
+SimTrack::SimTrack() :
+  lazyFlag(0)
   /*!
     Constructor
   */
@@ -52,11 +53,11 @@ SimTrack::SimTrack()
 SimTrack&
 SimTrack::Instance()
   /*!
-    Singleton this
+    Singleton this [one per thread]
     \return SimTrack object
    */
 {
-  static SimTrack ST;
+  static thread_local SimTrack ST;
   return ST;
 }
 
@@ -92,7 +93,8 @@ SimTrack::addSim(const Simulation* SimPtr)
 void
 SimTrack::setCell(const Simulation* SimPtr,MonteCarlo::Object* OPtr)
   /*!
-    Set the current cell pointer
+    Set the current cell pointer. A lazy thread registers
+    the simulation on first use.
     \param SimPtr :: Significant figures
     \param OPtr :: Object Pointer
   */
@@ -103,10 +105,13 @@ SimTrack::setCell(const Simulation* SimPtr,MonteCarlo::Object* OPtr)
   fcTYPE::iterator mc=findCell.find(sInt);
   if (mc==findCell.end())
     {
-      throw ColErr::InContainerError<fcTYPE::key_type>
-	(sInt,"sInt not fould in findCell");
+      if (!lazyFlag)
+	throw ColErr::InContainerError<fcTYPE::key_type>
+	  (sInt,"sInt not fould in findCell");
+      findCell.insert(fcTYPE::value_type(sInt,OPtr));
     }
-  mc->second=OPtr;
+  else
+    mc->second=OPtr;
   return;
 }
 
@@ -115,17 +120,17 @@ SimTrack::curCell(const Simulation* SimPtr) const
   /*!
     Get the current cell
     \param SimPtr :: Significant figures
-    \return :: Object Pointer
+    \return :: Object Pointer [0 if not yet set in a lazy thread]
   */
 {
-  ELog::RegMethod RegA("SimTrack","curCell");
-
   fcTYPE::key_type sInt=reinterpret_cast<fcTYPE::key_type>(SimPtr);
   fcTYPE::const_iterator mc=findCell.find(sInt);
-  if (mc==findCell.end())
+  if (mc!=findCell.end())
+    return mc->second;
+  if (!lazyFlag)
     throw ColErr::InContainerError<fcTYPE::key_type>
       (sInt,"simluation<long Int>");
-  return mc->second;
+  return 0;
 }
 
 void
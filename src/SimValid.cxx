@@ -52,6 +52,9 @@
 #include "FuncDataBase.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "SurfSideCache.h"
+#include "Line.h"
+#include "TrackScratch.h"
 #include "Qhull.h"
 #include "SimProcess.h"
 #include "SurInter.h"
@@ -113,6 +116,7 @@ SimValid::run(const Simulation& System,const size_t N) const
   MonteCarlo::Object* InitObj(0);
   const Geometry::Surface* SPtr;          // Output surface
   double aDist;       
+  MonteCarlo::TrackScratch TrackBuffer;   // Intercept buffer
 
   // Note for sphere that you can use X,Y,Z in any orthogonal 
   // directiron
@@ -123,6 +127,7 @@ SimValid::run(const Simulation& System,const size_t N) const
   InitObj=System.findCell(Centre,InitObj);  
   const int initSurfNum=InitObj->isOnSide(Centre);
 
+  MonteCarlo::SurfSideCache::resetTotals();
   ELog::EM<<"Init Object nubmer == "<<InitObj->getName()<<ELog::endDiag;      
   ELog::EM<<"Initial surface [if on surf] == "<<initSurfNum<<ELog::endDiag; 
      
@@ -145,7 +150,7 @@ SimValid::run(const Simulation& System,const size_t N) const
       while(OPtr && OPtr->getImp())
 	{
 	  // Note: Need OPPOSITE Sign on exiting surface
-	  SN= OPtr->trackOutCell(TNeut,aDist,SPtr,abs(SN));
+	  SN= OPtr->trackOutCell(TrackBuffer,TNeut,aDist,SPtr,abs(SN));
 
 	  if (aDist>1e30 && Pts.size()<=1)
 	    {
@@ -208,12 +213,14 @@ SimValid::run(const Simulation& System,const size_t N) const
           ELog::EM<<"TRACK to NEXT"<<ELog::endDiag;
           ELog::EM<<"--------------"<<ELog::endDiag;
           
-          OPtr->trackOutCell(TNeut,aDist,SPtr,abs(SN));
+          OPtr->trackOutCell(TrackBuffer,TNeut,aDist,SPtr,abs(SN));
 	  ELog::EM<<"Failed to calculate cell correctly: "<<i<<ELog::endCrit;
 	  return 0;
 	}
     }
   ELog::EM<<"Finished Validation check"<<ELog::endDiag;
+  MonteCarlo::SurfSideCache::writeTotals(ELog::EM.Estream());
+  ELog::EM<<ELog::endDiag;
   return 1;
 }
 
@@ -86,6 +86,10 @@
 #include "HeadRule.h"
 #include "Object.h"
 #include "Qhull.h"
+#include "Line.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "WForm.h"
 #include "weightManager.h"
 #include "ModeCard.h"
@@ -100,11 +104,12 @@
 #include "BaseMap.h"
 #include "CellMap.h"
 #include "SimTrack.h"
+#include "CellIndex.h"
 #include "Simulation.h"
 
 Simulation::Simulation()  :
   mcnpVersion(6),CNum(100000),OSMPtr(new ModelSupport::ObjSurfMap),
-  PhysPtr(new physicsSystem::PhysicsCards)
+  CIPtr(0),PhysPtr(new physicsSystem::PhysicsCards)
   /*!
     Start of simulation Object
   */
@@ -115,7 +120,7 @@ Simulation::Simulation()  :
 Simulation::Simulation(const Simulation& A)  :
   mcnpVersion(A.mcnpVersion),inputFile(A.inputFile),
   CNum(A.CNum),DB(A.DB),
-  OSMPtr(new ModelSupport::ObjSurfMap),
+  OSMPtr(new ModelSupport::ObjSurfMap),CIPtr(0),
   TList(A.TList),  cellOutOrder(A.cellOutOrder),
   PhysPtr(new physicsSystem::PhysicsCards(*A.PhysPtr))
   /*!
@@ -229,6 +234,7 @@ Simulation::deleteObjects()
   ELog::RegMethod RegA("Simulation","deleteObjects");
   
   ModelSupport::SimTrack::Instance().setCell(this,0);
+  clearCellIndex();
   for(OTYPE::value_type& mc : OList)
     delete mc.second;
   
@@ -481,6 +487,7 @@ Simulation::addCell(const int cellNumber,const MonteCarlo::Qhull& A)
       ELog::EM<<"Call from: "<<RegA.getBasePtr()->getItem(-1)<<ELog::endCrit;
       throw ColErr::ExitAbort("Cell number in use");
     }
+  clearCellIndex();
   OList.insert(OTYPE::value_type(cellNumber,A.clone()));
   MonteCarlo::Qhull* QHptr=OList[cellNumber];
 
@@ -710,6 +717,7 @@ Simulation::removeCells(const int startN,const int endN)
   ModelSupport::objectRegister& OR=
     ModelSupport::objectRegister::Instance();
 
+  clearCellIndex();
   // It seems quicker to create a new map and copy
   OTYPE newOList;
   OTYPE::iterator vc;
@@ -752,6 +760,7 @@ Simulation::removeCell(const int cellNumber)
   
   ModelSupport::SimTrack& ST(ModelSupport::SimTrack::Instance());
   ST.checkDelete(this,vc->second);
+  clearCellIndex();
   delete vc->second;
   OList.erase(vc);
 
@@ -772,6 +781,7 @@ Simulation::removeAllSurface(const int KeyN)
     \returns Number of surface removed (will do)
   */
 {
+  clearCellIndex();
   OTYPE::iterator oc;
   for(oc=OList.begin();oc!=OList.end();oc++)
     {
@@ -802,6 +812,7 @@ Simulation::substituteAllSurface(const int KeyN,const int NsurfN)
     throw ColErr::InContainerError<int>
       (NsurfN,"Surface number not found");
 
+  clearCellIndex();
   OTYPE::iterator oc;
   for(oc=OList.begin();oc!=OList.end();oc++)
     oc->second->substituteSurf(KeyN,NsurfN,XPtr);
@@ -1299,6 +1310,33 @@ Simulation::createObjSurfMap()
   return;
 }
 
+void
+Simulation::buildCellIndex()
+  /*!
+    Construct the bounding box index of the cells
+    used to accelerate findCell. Cells must be populated.
+  */
+{
+  ELog::RegMethod RegA("Simulation","buildCellIndex");
+
+  if (!CIPtr)
+    CIPtr=new ModelSupport::CellIndex;
+  CIPtr->build(OList);
+  return;
+}
+
+void
+Simulation::clearCellIndex()
+  /*!
+    Remove the cell index : required if any cell is
+    added/removed/renumbered or the surfaces are moved.
+  */
+{
+  delete CIPtr;
+  CIPtr=0;
+  return;
+}
+
 const ModelSupport::ObjSurfMap* 
 Simulation::getOSM() const
   /*!
@@ -1495,6 +1533,7 @@ Simulation::findCell(const Geometry::Vec3D& Pt,
 		     MonteCarlo::Object* testCell) const
   /*! 
     Object that a given the point is in.
+    The last cell is kept in the SimTrack singleton.
     \param Pt :: Point to find
     \param testCell :: Last Cell (since points often are close together 
     \retval Object ptr
@@ -1502,31 +1541,70 @@ Simulation::findCell(const Geometry::Vec3D& Pt,
   */
 {
   ModelSupport::SimTrack& ST(ModelSupport::SimTrack::Instance());
+
+  MonteCarlo::QueryContext QC;
+  QC.setLastCell(ST.curCell(this));
+  MonteCarlo::Object* OPtr=findCell(QC,Pt,testCell);
+  ST.setCell(this,QC.getLastCell());
+  return OPtr;
+}
+
+MonteCarlo::Object*
+Simulation::findCell(MonteCarlo::QueryContext& QC,
+		     const Geometry::Vec3D& Pt,
+		     MonteCarlo::Object* testCell) const
+  /*! 
+    Object that a given the point is in.
+    \param QC :: Query context [holds last cell found]
+    \param Pt :: Point to find
+    \param testCell :: Last Cell (since points often are close together 
+    \retval Object ptr
+    \retval 0 :: No cell exists
+  */
+{
+  QC.addFind();
   // First test users guess:
   if (testCell && testCell->isValid(Pt))
     {
-      ST.setCell(this,testCell);
+      QC.addTestHit();
+      QC.setLastCell(testCell);
       return testCell;
     }
   // Ok how about our last find
-  MonteCarlo::Object* curObjPtr=ST.curCell(this);
+  MonteCarlo::Object* curObjPtr=QC.getLastCell();
   if (curObjPtr && curObjPtr!=testCell 
       && curObjPtr->isValid(Pt))
-    return curObjPtr;
+    {
+      QC.addLastHit();
+      return curObjPtr;
+    }
+
+  // Use the box index if available
+  if (CIPtr)
+    {
+      MonteCarlo::Object* OPtr=CIPtr->findCell(Pt);
+      if (OPtr)
+	{
+	  QC.addIndexHit();
+	  QC.setLastCell(OPtr);
+	  return OPtr;
+	}
+    }
       
   // now we need to search everthing
+  QC.addSearch();
   OTYPE::const_iterator mpc;
   for(mpc=OList.begin();mpc!=OList.end();mpc++)
     {
       if (!mpc->second->isPlaceHold() &&
 	  mpc->second->isValid(Pt))
         {
-	  ST.setCell(this,mpc->second);
+	  QC.setLastCell(mpc->second);
 	  return mpc->second;
 	}
     }
   // Found NOTHING :-(
-  ST.setCell(this,0);
+  QC.setLastCell(0);
   return 0;
 }
 
@@ -2089,6 +2167,7 @@ Simulation::renumberCells(const std::vector<int>& cOffset,
   //Offset index  
   const int cIndex(10000);
 
+  clearCellIndex();
   OTYPE newMap;           // New map with correct numbering
   int nNum(0);
   int index(1);
@@ -2269,6 +2348,7 @@ Simulation::masterRotation()
     ModelSupport::objectRegister::Instance();
 
   masterRotate& MR = masterRotate::Instance();
+  clearCellIndex();
   
   const ModelSupport::surfIndex::STYPE& SurMap=
     ModelSupport::surfIndex::Instance().surMap();
@@ -2276,11 +2356,15 @@ Simulation::masterRotation()
   std::map<int,Geometry::Surface*>::const_iterator sc;
   for(sc=SurMap.begin();sc!=SurMap.end();sc++)
     MR.applyFull(sc->second);
+  ModelSupport::surfIndex::Instance().rehash();
 
-  // Apply to QHull if calculated:
+  // Apply to QHull if calculated [and rebuild compiled rules]:
   OTYPE::iterator oc;
   for(oc=OList.begin();oc!=OList.end();oc++)
-    MR.applyFull(oc->second);
+    {
+      MR.applyFull(oc->second);
+      oc->second->updateProgram();
+    }
 
   // Physics units [dxtrans and others]
   PhysPtr->rotateMaster();
@@ -65,6 +65,7 @@
 #include "simpleObj.h"
 #include "Simulation.h"
 #include "World.h"
+#include "AttachSupport.h"
 
 #include "Debug.h"
 
@@ -120,11 +121,13 @@ testAttachSupport::applyTest(const int extra)
   typedef int (testAttachSupport::*testPtr)();
   testPtr TPtr[]=
     {
+      &testAttachSupport::testAutoInsert,
       &testAttachSupport::testBoundaryValid,
       &testAttachSupport::testInsertComponent
     };
   const std::string TestName[]=
     {
+      "AutoInsert",
       "BoundaryValid",
       "InsertComponent"
     };
@@ -153,6 +156,71 @@ testAttachSupport::applyTest(const int extra)
   return 0;
 }
 
+int
+testAttachSupport::testAutoInsert() 
+  /*!
+    Test the box rejection and the insertion of an object
+    into the cells found from the cell index
+    \return 0 on success
+  */
+{
+  ELog::RegMethod RegA("testAttachSupport","testAutoInsert");
+
+  initSim();
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  // Remote box [disjoint from object]
+  SurI.createSurface(201,"px 100");
+  SurI.createSurface(202,"px 200");
+  SurI.createSurface(203,"py -50");
+  SurI.createSurface(204,"py 50");
+  SurI.createSurface(205,"pz -50");
+  SurI.createSurface(206,"pz 50");
+  ASim.addCell(MonteCarlo::Qhull(5002,0,0.0,"201 -202 203 -204 205 -206"));
+
+  std::shared_ptr<testSystem::simpleObj> 
+    CC(new testSystem::simpleObj("AutoA"));
+  CC->createAll(ASim,World::masterOrigin());
+  
+  MonteCarlo::Qhull* OuterPtr=ASim.findQhull(5001);
+  MonteCarlo::Qhull* BoxPtr=ASim.findQhull(5002);
+  const std::string boxStr=BoxPtr->cellCompStr();
+  
+  if (checkBoxIntersect(*CC,*BoxPtr) ||
+      checkIntersect(*CC,*BoxPtr,BoxPtr->getSurList()))
+    {
+      ELog::EM<<"Failed on disjoint box"<<ELog::endDiag;
+      return -1;
+    }
+  if (!checkBoxIntersect(*CC,*OuterPtr))
+    {
+      ELog::EM<<"Failed on outer cell"<<ELog::endDiag;
+      return -1;
+    }
+
+  addToInsertAutoCtrl(ASim,*CC,*CC);
+
+  const Geometry::Vec3D Origin(0,0,0);
+  const Geometry::Vec3D Remote(0,0,100);
+  if (OuterPtr->isValid(Origin) || !OuterPtr->isValid(Remote))
+    {
+      ELog::EM<<"Object not excluded from outer cell :"
+	      <<OuterPtr->cellCompStr()<<ELog::endDiag;
+      return -1;
+    }
+  if (BoxPtr->cellCompStr()!=boxStr)
+    {
+      ELog::EM<<"Remote box changed :"<<BoxPtr->cellCompStr()<<ELog::endDiag;
+      return -1;
+    }
+  const MonteCarlo::Object* APtr=ASim.findCell(Origin,0);
+  if (!APtr || APtr->getName()==5001)
+    {
+      ELog::EM<<"Object cell not found "<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
 int
 testAttachSupport::testBoundaryValid() 
   /*!
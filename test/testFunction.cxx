@@ -28,10 +28,12 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
 #include <algorithm>
 #include <iterator>
 #include <tuple>
+#include <cstdio>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -43,10 +45,14 @@
 #include "Matrix.h"
 #include "Vec3D.h"
 #include "support.h"
+#include "fileSupport.h"
 #include "funcList.h"
 #include "varList.h"
 #include "Code.h"
+#include "FItem.h"
 #include "FuncDataBase.h"
+#include "varScope.h"
+#include "MD5hash.h"
 
 #include "testFunc.h"
 #include "testFunction.h"
@@ -80,8 +86,12 @@ testFunction::applyTest(const int extra)
     {
       &testFunction::testAnalyse,
       &testFunction::testBuiltIn,
+      &testFunction::testCache,
       &testFunction::testCopyVarSet,
       &testFunction::testEval,
+      &testFunction::testOptimise,
+      &testFunction::testScope,
+      &testFunction::testSnapshot,
       &testFunction::testString, 
       &testFunction::testVariable,
       &testFunction::testVec3D,
@@ -92,8 +102,12 @@ testFunction::applyTest(const int extra)
     {
       "Analyse",
       "BuiltIn",
+      "Cache",
       "CopyVarSet",
       "Eval",
+      "Optimise",
+      "Scope",
+      "Snapshot",
       "String",
       "Variable",
       "Vec3D",
@@ -200,6 +214,81 @@ testFunction::testBuiltIn()
   return 0;
 }
 
+int
+testFunction::testCache()
+  /*!
+    Test that function variables are cached and that
+    changing a variable updates only its dependents
+    \return 0 on succes and -ve on failure
+  */
+{
+  ELog::RegMethod RegA("testFunction","testCache");
+
+  FuncDataBase Control;
+
+  Control.addVariable("lenA",2.0);
+  Control.addVariable("lenD",5.0);
+  Control.Parse("lenA*3.0");
+  Control.addVariable("lenB");
+  Control.Parse("lenB+1.0");
+  Control.addVariable("lenC");
+  Control.Parse("lenD*2.0");
+  Control.addVariable("lenE");
+
+  const varList& VL=Control.getVarList();
+  const int indexC=Control.findItem("lenC")->getIndex();
+  const int indexE=Control.findItem("lenE")->getIndex();
+
+  // Name : expected C : expected E
+  typedef std::tuple<std::string,double,double,double> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE("",0.0,7.0,10.0),
+      TTYPE("lenA",4.0,13.0,10.0),
+      TTYPE("lenD",1.0,13.0,2.0)
+    };
+
+  double V;
+  for(const TTYPE& tc : Tests)
+    {
+      const std::string& VName=std::get<0>(tc);
+      if (!VName.empty())
+	{
+	  Control.setVariable(VName,std::get<1>(tc));
+	  // only dependents are cleared
+	  if ((VName=="lenA")==VL.getCache(indexC,V) ||
+	      (VName=="lenD")==VL.getCache(indexE,V))
+	    {
+	      ELog::EM<<"Invalidate failed on "<<VName<<ELog::endDiag;
+	      return -1;
+	    }
+	}
+      const double C=Control.EvalVar<double>("lenC");
+      const double E=Control.EvalVar<double>("lenE");
+      if (std::abs(C-std::get<2>(tc))>1e-6 ||
+	  std::abs(E-std::get<3>(tc))>1e-6 ||
+	  !VL.getCache(indexC,V) || std::abs(V-C)>1e-6)
+	{
+	  ELog::EM<<"Set "<<VName<<ELog::endDiag;
+	  ELog::EM<<"C == "<<C<<" ("<<std::get<2>(tc)<<")"<<ELog::endDiag;
+	  ELog::EM<<"E == "<<E<<" ("<<std::get<3>(tc)<<")"<<ELog::endDiag;
+	  return -1;
+	}
+    }
+
+  // Redefine an intermediate function
+  Control.Parse("lenA-1.0");
+  Control.setVariable("lenB");
+  if (std::abs(Control.EvalVar<double>("lenC")-4.0)>1e-6)
+    {
+      ELog::EM<<"Redefine failed : C == "
+	      <<Control.EvalVar<double>("lenC")<<ELog::endDiag;
+      return -1;
+    }
+  
+  return 0;
+}
+
 int
 testFunction::testCopyVarSet()
   /*!
@@ -280,6 +369,232 @@ testFunction::testEval()
   return 0;
 }
 
+int
+testFunction::testOptimise()
+  /*!
+    Test the constant folding and the scalar evaluation
+    of compiled code
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testFunction","testOptimise");
+
+  FuncDataBase Control;
+  Control.addVariable("lenA",2.0);
+  Control.addVariable("vecA",Geometry::Vec3D(1,2,3));
+  
+  // Function : byte code size : scalar : value 
+  typedef std::tuple<std::string,size_t,int,double> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE("2.0*3.0+1.0",1,1,7.0),
+      TTYPE("lenA*(2.0+3.0)",3,1,10.0),
+      TTYPE("sqrt(16.0)+lenA",3,1,6.0),
+      TTYPE("log(exp(2.0))",1,1,2.0),
+      TTYPE("max(lenA,3.0)-min(1.0,4.0)",5,1,2.0),
+      TTYPE("dot(vecA,vec3d(1.0,0.0,0.0))",6,0,1.0)
+    };
+
+  for(const TTYPE& tc : Tests)
+    {
+      Control.Parse(std::get<0>(tc));
+      const Code& CV=Control.getBuild();
+      const double V=Control.Eval<double>();
+      if (CV.getBC().size()!=std::get<1>(tc) ||
+	  CV.isScalar()!=std::get<2>(tc) ||
+	  std::abs(V-std::get<3>(tc))>1e-6)
+	{
+	  ELog::EM<<"Function "<<std::get<0>(tc)<<ELog::endDiag;
+	  ELog::EM<<"BC size == "<<CV.getBC().size()<<" ("
+		  <<std::get<1>(tc)<<")"<<ELog::endDiag;
+	  ELog::EM<<"Scalar  == "<<CV.isScalar()<<ELog::endDiag;
+	  ELog::EM<<"V       == "<<V<<" ("<<std::get<3>(tc)<<")"
+		  <<ELog::endDiag;
+	  return -1;
+	}
+    }
+
+  // scalar code with a Vec3D variable : general evaluation
+  Control.Parse("vecA*(1.0+1.0)");
+  Control.addVariable("vecB");
+  Control.Parse("lenA*3.0");
+  Control.addVariable("lenB");
+  Control.Parse("lenB+lenA");
+  Control.addVariable("lenC");
+  const Geometry::Vec3D VB=Control.EvalVar<Geometry::Vec3D>("vecB");
+  const double C=Control.EvalVar<double>("lenC");
+  if (VB!=Geometry::Vec3D(2,4,6) || std::abs(C-8.0)>1e-6)
+    {
+      ELog::EM<<"VB == "<<VB<<ELog::endDiag;
+      ELog::EM<<"C  == "<<C<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
+int
+testFunction::testScope()
+  /*!
+    Test the varScope access and the name hash after
+    variables are removed / copied / replaced
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testFunction","testScope");
+
+  FuncDataBase Control;
+  Control.addVariable("guideLength",10.0);
+  Control.addVariable("guide0Length",3.0);
+  Control.addVariable("guide1Length",4.0);
+  Control.addVariable("guide1Width",5);
+  Control.addVariable("guideMat","Void");
+  Control.addVariable("guideXStep",1.0);
+
+  Control.removeVariable("guideXStep");
+  Control.copyVar("guide2Length","guide1Length");
+  Control.addVariable("guide1Width",7.0);    // replace
+  
+  varScope SV(Control,"guide");
+  // head+tail : index [-1 none] : value [-1 not found] 
+  typedef std::tuple<std::string,long int,double> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE("Length",-1,10.0),
+      TTYPE("Length",0,3.0),
+      TTYPE("Length",1,4.0),
+      TTYPE("Length",2,4.0),
+      TTYPE("Width",1,7.0),
+      TTYPE("Width",2,-1.0),
+      TTYPE("XStep",-1,-1.0)
+    };
+  
+  for(const TTYPE& tc : Tests)
+    {
+      const std::string& tail=std::get<0>(tc);
+      const long int index=std::get<1>(tc);
+      const size_t sIndex=static_cast<size_t>(index);
+      const int hasVar=(index<0) ?
+	SV.hasVariable(tail) : SV.hasVariable(sIndex,tail);
+      const double V=(index<0) ?
+	SV.EvalDefVar<double>(tail,-1.0) :
+	SV.EvalDefVar<double>(sIndex,tail,-1.0);
+      const std::string fullKey=(index<0) ? "guide"+tail :
+	"guide"+std::to_string(index)+tail;
+      
+      if (hasVar!=Control.hasVariable(fullKey) ||
+	  std::abs(V-std::get<2>(tc))>1e-6)
+	{
+	  ELog::EM<<"Key "<<fullKey<<" : "<<hasVar<<ELog::endDiag;
+	  ELog::EM<<"V == "<<V<<" ("<<std::get<2>(tc)<<")"<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  if (SV.EvalVar<std::string>("Mat")!="Void" ||
+      SV.EvalVar<int>(1,"Width")!=7)
+    {
+      ELog::EM<<"Failed on Mat/Width"<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
+int
+testFunction::testSnapshot()
+  /*!
+    Test the binary snapshot of the variables: 
+    round trip / key mismatch / function dependencies /
+    corrupt length prefixes
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testFunction","testSnapshot");
+
+  const std::string FName("testFunctionSnap.bin");
+  
+  FuncDataBase Control;
+  Control.addVariable("lenA",2.0);
+  Control.addVariable("lenNumber",7);
+  Control.addVariable("lenMat","Stainless304");
+  Control.addVariable("lenVec",Geometry::Vec3D(1,2,3));
+  Control.Parse("lenA*3.0");
+  Control.addVariable("lenB");
+  Control.Parse("lenB+lenNumber");
+  Control.addVariable("lenC");
+  Control.writeBinary(FName,"KeyA");
+
+  FuncDataBase Snap;
+  Snap.addVariable("lenOld",1.0);
+  const int failRead=Snap.readBinary(FName,"KeyB");
+  const int goodRead=Snap.readBinary(FName,"KeyA");
+  std::remove(FName.c_str());
+  
+  if (failRead || !goodRead || Snap.hasVariable("lenOld"))
+    {
+      ELog::EM<<"Read == "<<failRead<<" "<<goodRead<<ELog::endDiag;
+      return -1;
+    }
+
+  const std::vector<std::string> Keys=Control.getKeys();
+  if (Keys!=Snap.getKeys())
+    {
+      ELog::EM<<"Keys differ"<<ELog::endDiag;
+      return -1;
+    }
+  for(const std::string& K : Keys)
+    {
+      const std::string A=Control.EvalVar<std::string>(K);
+      const std::string B=Snap.EvalVar<std::string>(K);
+      if (A!=B)
+	{
+	  ELog::EM<<"Variable "<<K<<" : "<<A<<" != "<<B<<ELog::endDiag;
+	  return -1;
+	}
+    }
+
+  // dependencies rebuilt from the read code
+  Snap.setVariable("lenA",4.0);
+  const double C=Snap.EvalVar<double>("lenC");
+  const Geometry::Vec3D V=Snap.EvalVar<Geometry::Vec3D>("lenVec");
+  if (std::abs(C-19.0)>1e-6 || V!=Geometry::Vec3D(1,2,3) ||
+      Snap.EvalVar<int>("lenNumber")!=7)
+    {
+      ELog::EM<<"C == "<<C<<" (19.0)"<<ELog::endDiag;
+      ELog::EM<<"V == "<<V<<ELog::endDiag;
+      return -1;
+    }
+
+  // corrupt sizes : rejected and the variables left untouched
+  const char tag[8]={'C','L','V','A','R','S','1','\0'};
+  const size_t badSize(static_cast<size_t>(1) << 40);
+  std::ostringstream cx(std::ios::binary);
+  StrFunc::writeBinary(cx,static_cast<int>(2));
+  StrFunc::writeBinary(cx,badSize);
+  MD5hash sum;
+  const std::string Block(cx.str());
+  const std::string BlockHash(sum.processMessage(Block));
+  for(size_t i=0;i<2;i++)
+    {
+      std::ofstream OX(FName.c_str(),std::ios::binary);
+      OX.write(tag,sizeof(tag));
+      StrFunc::writeBinary(OX,std::string("KeyA"));
+      if (!i)   // outer length
+	StrFunc::writeBinary(OX,badSize);
+      else     // variable count in a valid block
+	{
+	  StrFunc::writeBinary(OX,BlockHash);
+	  StrFunc::writeBinary(OX,Block);
+	}
+      OX.close();
+      const int badRead=Snap.readBinary(FName,"KeyA");
+      std::remove(FName.c_str());
+      if (badRead || !Snap.hasVariable("lenNumber"))
+	{
+	  ELog::EM<<"Corrupt read ["<<i<<"] == "<<badRead<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  return 0;
+}
 
 int
 testFunction::testString()
@@ -436,7 +751,7 @@ testFunction::testVec3DFunctions()
   Tests.push_back(TTYPE("abs(V1+vec3d(1,2,3))",0,Geometry::Vec3D(0,0,0),
 			sqrt(16+36+64)));
   Tests.push_back(TTYPE("dot(V1,vec3d(1,2,3))",0,Geometry::Vec3D(0,0,0),
-			sqrt(16+36+64)));
+			26.0));
 
   for(const VTYPE& vc : TestVar)
     XX.addVariable(std::get<0>(vc),std::get<1>(vc));
@@ -66,6 +66,10 @@
 #include "Algebra.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "Line.h"
+#include "TrackScratch.h"
+#include "SurfSideCache.h"
+#include "QueryContext.h"
 #include "Qhull.h"
 #include "surfRegister.h"
 #include "ModelSupport.h"
@@ -196,11 +200,15 @@ testLineTrack::applyTest(const int extra)
   typedef int (testLineTrack::*testPtr)();
   testPtr TPtr[]=
     {
-      &testLineTrack::testLine
+      &testLineTrack::testLine,
+      &testLineTrack::testQueryContext,
+      &testLineTrack::testGuide
     };
   const std::string TestName[]=
     {
-      "Line"
+      "Line",
+      "QueryContext",
+      "Guide"
     };
   
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -275,6 +283,71 @@ testLineTrack::testLine()
   return 0;
 }
 
+int
+testLineTrack::testQueryContext()
+  /*!
+    Tracks through the system with a single query context
+    and checks against the singleton based tracking
+    \return 0 on success and -1 on error
+  */
+{
+  ELog::RegMethod RegA("testLineTrack","testQueryContext");
+
+  initSim();
+
+  typedef std::tuple<Geometry::Vec3D,Geometry::Vec3D> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE(Geometry::Vec3D(0,0,30),Geometry::Vec3D(0,0,0)),
+      TTYPE(Geometry::Vec3D(0,0,-10),Geometry::Vec3D(0,0,10)),
+      TTYPE(Geometry::Vec3D(-10,0,6),Geometry::Vec3D(10,0,6)),
+      TTYPE(Geometry::Vec3D(-10,-10,-10),Geometry::Vec3D(10,10,10))
+    };
+
+  MonteCarlo::QueryContext QC;
+  int cnt(1);
+  for(const TTYPE& tc : Tests)
+    {
+      LineTrack LTA(std::get<0>(tc),std::get<1>(tc));
+      LineTrack LTB(std::get<0>(tc),std::get<1>(tc));
+      LTA.calculate(ASim);
+      LTB.calculate(QC,ASim);
+      if (LTA.getCells()!=LTB.getCells() ||
+	  LTA.getTrack()!=LTB.getTrack())
+	{
+	  ELog::EM<<"Failed on test :"<<cnt<<ELog::endDiag;
+	  ELog::EM<<"Singleton == "<<LTA<<ELog::endDiag;
+	  ELog::EM<<"Context   == "<<LTB<<ELog::endDiag;
+	  return -1;
+	}
+      cnt++;
+    }
+  if (QC.getFind()<Tests.size() || QC.getTrack()<Tests.size())
+    {
+      ELog::EM<<"Context not used: "<<QC<<ELog::endDiag;
+      return -1;
+    }
+  
+  // findCell must agree with and without the context
+  const std::vector<Geometry::Vec3D> Pts=
+    {
+      Geometry::Vec3D(0,0,0),Geometry::Vec3D(2,0,0),
+      Geometry::Vec3D(0,0,5),Geometry::Vec3D(10,10,10),
+      Geometry::Vec3D(0.5,0.5,0.5),Geometry::Vec3D(0,0,30)
+    };
+  for(const Geometry::Vec3D& Pt : Pts)
+    {
+      const MonteCarlo::Object* APtr=ASim.findCell(Pt,0);
+      const MonteCarlo::Object* BPtr=ASim.findCell(QC,Pt,0);
+      if (APtr!=BPtr || QC.getLastCell()!=BPtr)
+	{
+	  ELog::EM<<"Failed on point :"<<Pt<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  return 0;
+}
+
 int
 testLineTrack::checkResult(const LineTrack& LT,
 			   const long int CSum,const double TSum) const
@@ -302,3 +375,45 @@ testLineTrack::checkResult(const LineTrack& LT,
     }  
   return (cValue!=CSum || fabs(TSum-tValue)>1e-3) ? 0 : 1;
 }
+
+int
+testLineTrack::testGuide()
+  /*!
+    Tracks a fan of lines to a point with each line guided
+    by the previous line and checks against the unguided tracks
+    \return 0 on success and -1 on error
+  */
+{
+  ELog::RegMethod RegA("testLineTrack","testGuide");
+
+  initSim();
+
+  const Geometry::Vec3D EndPt(0,0,-10);
+  MonteCarlo::QueryContext QC;
+  std::vector<LineTrack> Guided;
+  for(size_t i=0;i<40;i++)
+    {
+      const double x(-10.0+0.5*static_cast<double>(i));
+      const Geometry::Vec3D StartPt(x,0.1,30.0);
+      LineTrack LTA(StartPt,EndPt);
+      LineTrack LTB(StartPt,EndPt);
+      LTA.calculate(ASim);
+      LTB.calculate(QC,ASim,(Guided.empty()) ? 0 : &Guided.back());
+
+      if (LTA.getCells()!=LTB.getCells() ||
+	  LTA.getTrack()!=LTB.getTrack())
+	{
+	  ELog::EM<<"Failed on line :"<<i<<ELog::endDiag;
+	  ELog::EM<<"Full   == "<<LTA<<ELog::endDiag;
+	  ELog::EM<<"Guided == "<<LTB<<ELog::endDiag;
+	  return -1;
+	}
+      Guided.push_back(LTB);
+    }
+  if (!QC.getBundleHit())
+    {
+      ELog::EM<<"No cells from guide track : "<<QC<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
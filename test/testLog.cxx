@@ -30,6 +30,7 @@
 #include <complex>
 #include <string>
 #include <algorithm>
+#include <thread>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -41,6 +42,21 @@
 #include "testFunc.h"
 #include "testLog.h" 
 
+namespace
+{
+  std::string
+  deepStack(const size_t N)
+    /*!
+      Recurse N levels and return the stack at the bottom
+      \param N :: Levels to go
+      \return Full stack
+    */
+  {
+    ELog::RegMethod RegA("testLog[F]","deepStack");
+    return (N) ? deepStack(N-1) : ELog::RegMethod::getFull();
+  }
+}
+
 testLog::testLog() 
   /// Constructor
 {}
@@ -65,11 +81,13 @@ testLog::applyTest(const int extra)
   typedef int (testLog::*testPtr)();
   testPtr TPtr[]=
     {
-      &testLog::testENDL
+      &testLog::testENDL,
+      &testLog::testRegMethod
     };
   const std::string TestName[]=
     {
-      "ENDL"
+      "ENDL",
+      "RegMethod"
     };
   
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -122,3 +140,109 @@ testLog::testENDL()
   ELog::EM<<"END of  ::3 EMPTY LINE:"<<ELog::endDebug;
   return 0;
 }
+
+int
+testLog::testRegMethod()
+  /*!
+    Test the registration stack text
+    \return 0 on success / -ve on error
+   */
+{
+  ELog::RegMethod RegA("testLog","testRegMethod");
+
+  const std::string Base("testLog::testRegMethod");
+  if (ELog::RegMethod::getBase()!=Base)
+    {
+      ELog::EM<<"Base == "<<ELog::RegMethod::getBase()<<ELog::endDiag;
+      return -1;
+    }
+  
+  {
+    ELog::RegMethod RegB("Outer","method",3);
+    const std::string CN("Inner");
+    ELog::RegMethod RegC(CN,"method");
+    if (ELog::RegMethod::getBase()!="Inner::method" ||
+	ELog::RegMethod::getItem(-1)!="Outer<3>::method")
+      {
+	ELog::EM<<"Base == "<<ELog::RegMethod::getBase()<<ELog::endDiag;
+	ELog::EM<<"Item == "<<ELog::RegMethod::getItem(-1)<<ELog::endDiag;
+	return -2;
+      }
+    const std::string Full=ELog::RegMethod::getFull();
+    const std::string Tail(Base+"\n"+std::string(2*RegA.getBasePtr()->
+					  getDepth()-4,' ')+
+			   "Outer<3>::method\n"+
+			   std::string(2*RegA.getBasePtr()->getDepth()-2,' ')+
+			   "Inner::method");
+    if (Full.size()<Tail.size() ||
+	Full.substr(Full.size()-Tail.size())!=Tail)
+      {
+	ELog::EM<<"Full == "<<Full<<ELog::endDiag;
+	ELog::EM<<"Tail == "<<Tail<<ELog::endDiag;
+	return -3;
+      }
+
+    // exception location is the stack when thrown 
+    try
+      {
+	RegC.setTrack("extra");
+	throw ColErr::IndexError<size_t>(4,2,"index");
+      }
+    catch (ColErr::ExBase& A)
+      {
+	const std::string Msg(A.what());
+	if (Msg.find(Full+"\n")==std::string::npos ||
+	    Msg.find("Info:extra")==std::string::npos)
+	  {
+	    ELog::EM<<"Msg == "<<Msg<<ELog::endDiag;
+	    return -4;
+	  }
+      }
+  }
+  if (ELog::RegMethod::getBase()!=Base)
+    return -5;
+
+  {
+    ELog::HotMethod RegB("Hot","method");
+    const std::string HotBase((REGTRACE_LEVEL>1) ? "Hot::method" : Base);
+    if (ELog::RegMethod::getBase()!=HotBase)
+      {
+	ELog::EM<<"Hot == "<<ELog::RegMethod::getBase()<<ELog::endDiag;
+	return -6;
+      }
+  }
+
+  // deeper than the ring : only the last items kept
+  // [own thread so this stack is not overwritten]
+  std::string Deep,DeepBase,After;
+  std::thread DeepThread([&Deep,&DeepBase,&After]()
+    {
+      ELog::RegMethod RegB("testLog[F]","deepThread");
+      Deep=deepStack(1000);
+      DeepBase=ELog::RegMethod::getBase();
+      ELog::RegMethod RegC("After","method");
+      After=ELog::RegMethod::getFull();
+    });
+  DeepThread.join();
+  
+  const std::string DeepItem("testLog[F]::deepStack");
+  if (Deep.substr(0,4)!="...\n" ||
+      Deep.find("deepThread")!=std::string::npos ||
+      Deep.size()<DeepItem.size() ||
+      Deep.substr(Deep.size()-DeepItem.size())!=DeepItem)
+    {
+      ELog::EM<<"Deep == "<<Deep.substr(0,100)<<ELog::endDiag;
+      return -7;
+    }
+  // outer items overwritten
+  if (!DeepBase.empty() || After!="...\nAfter::method")
+    {
+      ELog::EM<<"Deep base == "<<DeepBase<<ELog::endDiag;
+      ELog::EM<<"After == "<<After<<ELog::endDiag;
+      return -8;
+    }
+  if (ELog::RegMethod::getBase()!=Base)
+    return -9;
+  
+  return 0;
+}
@@ -76,11 +76,15 @@ testMesh3D::applyTest(const int extra)
   typedef int (testMesh3D::*testPtr)();
   testPtr TPtr[]=
     {
-      &testMesh3D::testPoint
+      &testMesh3D::testBinary,
+      &testMesh3D::testPoint,
+      &testMesh3D::testRefine
     };
   const std::string TestName[]=
     {
-      "Point"
+      "Binary",
+      "Point",
+      "Refine"
     };
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
   if (!extra)
@@ -148,6 +152,62 @@ testMesh3D::createXYZ(Geometry::Mesh3D& WMesh,
   return;
 }
 
+int
+testMesh3D::testBinary()
+  /*!
+    Test the binary write/read of a mesh
+    \return -ve on error / 0 on success
+   */
+{
+  ELog::RegMethod RegA("testMesh3D","testBinary");
+
+  Geometry::Mesh3D A;
+  createXYZ(A,"-120 3 0.0 2 120.0","0 3 240.0","-120 4 120");
+  A.setRefPt(Geometry::Vec3D(1,2,3));
+
+  std::stringstream SX;
+  A.writeBinary(SX);
+  Geometry::Mesh3D B;
+  B.readBinary(SX);
+
+  if (B.getXSize()!=A.getXSize() ||
+      B.getYSize()!=A.getYSize() ||
+      B.getZSize()!=A.getZSize())
+    {
+      ELog::EM<<"Size A "<<A.getXSize()<<" "<<A.getYSize()
+	      <<" "<<A.getZSize()<<ELog::endDiag;
+      ELog::EM<<"Size B "<<B.getXSize()<<" "<<B.getYSize()
+	      <<" "<<B.getZSize()<<ELog::endDiag;
+      return -1;
+    }
+  for(size_t i=0;i<A.getXSize();i++)
+    for(size_t j=0;j<A.getYSize();j++)
+      for(size_t k=0;k<A.getZSize();k++)
+	if (A.point(i,j,k)!=B.point(i,j,k))
+	  {
+	    ELog::EM<<"Point "<<i<<":"<<j<<":"<<k<<ELog::endDiag;
+	    ELog::EM<<"A == "<<A.point(i,j,k)<<ELog::endDiag;
+	    ELog::EM<<"B == "<<B.point(i,j,k)<<ELog::endDiag;
+	    return -2;
+	  }
+
+  // Truncated stream must throw
+  std::stringstream SY;
+  A.writeBinary(SY);
+  std::stringstream SZ(SY.str().substr(0,SY.str().size()/2));
+  try
+    {
+      Geometry::Mesh3D C;
+      C.readBinary(SZ);
+      ELog::EM<<"Truncated stream read"<<ELog::endDiag;
+      return -3;
+    }
+  catch (ColErr::ExBase&)
+    { }
+  
+  return 0;
+}
+
 int
 testMesh3D::testPoint()
   /*!
@@ -162,7 +222,11 @@ testMesh3D::testPoint()
   std::vector<TTYPE> Tests=
     {
       TTYPE{"-120 3 120.0","0 3 240.0","-120 3 120",
-            1,1,2,Geometry::Vec3D(-40,80,40)}
+            1,1,2,Geometry::Vec3D(-40,80,40)},
+      TTYPE{"-120 3 0.0 2 120.0","0 3 240.0","-120 4 120",
+            4,1,3,Geometry::Vec3D(60,80,60)},
+      TTYPE{"-120 3 0.0 2 120.0","0 1 60.0 3 240.0","-120 4 120",
+            3,2,0,Geometry::Vec3D(0,120,-120)}
     };
 
   Geometry::Mesh3D A;
@@ -184,8 +248,71 @@ testMesh3D::testPoint()
           ELog::EM<<"Expect "<<Res<<ELog::endDiag;
           return -1;
         }
+      cnt++;
     }
   
   return 0;
 
 }
+
+int
+testMesh3D::testRefine()
+  /*!
+    Test the splitting of mesh bins
+    \return -ve on error / 0 on success
+   */
+{
+  ELog::RegMethod RegA("testMesh3D","testRefine");
+
+  Geometry::Mesh3D A;
+  createXYZ(A,"-120 3 0.0 2 120.0","0 3 240.0","-120 4 120");
+
+  const std::vector<size_t> XR({1,2,1,3,1});
+  const std::vector<size_t> YR({1,1,1});
+  const std::vector<size_t> ZR({2,0,1,2});
+  const Geometry::Mesh3D B=A.refine(XR,YR,ZR);
+
+  if (B.getXSize()!=8 || B.getYSize()!=3 || B.getZSize()!=6)
+    {
+      ELog::EM<<"Size B "<<B.getXSize()<<" "<<B.getYSize()
+	      <<" "<<B.getZSize()<<ELog::endDiag;
+      return -1;
+    }
+
+  // each coarse x bin is split evenly
+  size_t fineI(0);
+  for(size_t i=0;i<XR.size();i++)
+    {
+      const double XA=A.getXCoordinate(i);
+      const double XB=A.getXCoordinate(i+1);
+      for(size_t s=0;s<XR[i];s++)
+	{
+	  const double XExpect=XA+static_cast<double>(s)*
+	    (XB-XA)/static_cast<double>(XR[i]);
+	  if (std::abs(B.getXCoordinate(fineI)-XExpect)>1e-10)
+	    {
+	      ELog::EM<<"X["<<fineI<<"] == "<<B.getXCoordinate(fineI)
+		      <<" != "<<XExpect<<ELog::endDiag;
+	      return -2;
+	    }
+	  fineI++;
+	}
+    }
+  if (std::abs(B.getXCoordinate(fineI)-120.0)>1e-10 ||
+      B.point(2,1,4)!=Geometry::Vec3D(-60,80,60))
+    {
+      ELog::EM<<"End X == "<<B.getXCoordinate(fineI)<<ELog::endDiag;
+      ELog::EM<<"Point == "<<B.point(2,1,4)<<ELog::endDiag;
+      return -3;
+    }
+
+  try
+    {
+      A.refine(YR,YR,ZR);
+      ELog::EM<<"Mis-sized refine accepted"<<ELog::endDiag;
+      return -4;
+    }
+  catch (ColErr::ExBase&)
+    { }
+  return 0;
+}
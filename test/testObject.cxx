@@ -55,6 +55,9 @@
 #include "Algebra.h"
 #include "surfIndex.h"
 #include "HeadRule.h"
+#include "SurfPack.h"
+#include "RuleProgram.h"
+#include "SurfSideCache.h"
 #include "Object.h"
 #include "Qhull.h"
 #include "neutron.h"
@@ -179,7 +182,9 @@ testObject::applyTest(const int extra)
   typedef int (testObject::*testPtr)();
   testPtr TPtr[]=
     {
+      &testObject::testAddIntersection,
       &testObject::testCellStr,
+      &testObject::testCompiledValid,
       &testObject::testComplement,
       &testObject::testIsValid,
       &testObject::testIsOnSide,
@@ -187,11 +192,14 @@ testObject::applyTest(const int extra)
       &testObject::testRemoveComplement,
       &testObject::testSetObject,
       &testObject::testSetObjectExtra,
+      &testObject::testSideCache,
       &testObject::testTrackCell
     };
   const std::string TestName[]=
     {
+      "AddIntersection",
       "CellStr",
+      "CompiledValid",
       "Complement",
       "IsValid",
       "IsOnSide",
@@ -199,6 +207,7 @@ testObject::applyTest(const int extra)
       "RemoveComplement",
       "SetObject",
       "SetObjectExtra",
+      "SideCache",
       "TrackCell"
     };
   
@@ -227,6 +236,83 @@ testObject::applyTest(const int extra)
 }
 
 
+int
+testObject::testAddIntersection()
+  /*!
+    Test the splicing of a rule into a cell against
+    the string addition
+    \retval -1 :: Failed to agree
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testObject","testAddIntersection");
+
+  createSurfaces();
+
+  // Cell : Exclude 
+  typedef std::tuple<std::string,std::string> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE("4 10 0.05524655  -100","#(1 -2 3 -4 5 -6)"),
+      TTYPE("5 10 0.05524655  -11 : 12 : -13 : 14","-100 #(1 -2 3 -4)"),
+      TTYPE("6 10 0.05524655  11 -12 13 -14 15 -16","(-1 : 2 : 6)"),
+      TTYPE("7 10 0.05524655  -100 (-1 : 2 : -3 : 4)","(-21 : 22)")
+    };
+  const double step[]={-26.0,-12.0,-3.0,-1.0,-0.5,0.5,1.0,2.0,3.0,12.0,20.0};
+
+  for(const TTYPE& tc : Tests)
+    {
+      HeadRule XRule;
+      if (!XRule.procString(std::get<1>(tc)))
+	{
+	  ELog::EM<<"Failed to process "<<std::get<1>(tc)<<ELog::endDiag;
+	  return -1;
+	}
+      for(int popFlag=0;popFlag<2;popFlag++)
+	{
+	  Qhull A;
+	  Qhull B;
+	  A.setObject(std::get<0>(tc));
+	  B.setObject(std::get<0>(tc));
+	  if (popFlag)
+	    {
+	      A.createSurfaceList();
+	      B.createSurfaceList();
+	    }
+	  A.addSurfString(std::get<1>(tc));
+	  if (!B.addIntersection(XRule))
+	    {
+	      ELog::EM<<"Failed to add "<<std::get<1>(tc)<<ELog::endDiag;
+	      return -1;
+	    }
+	  A.createSurfaceList();
+	  B.createSurfaceList();
+	  if (A.getSurfSet()!=B.getSurfSet())
+	    {
+	      ELog::EM<<"Surface sets differ :"<<popFlag<<ELog::endDiag;
+	      ELog::EM<<"A == "<<A.cellCompStr()<<ELog::endDiag;
+	      ELog::EM<<"B == "<<B.cellCompStr()<<ELog::endDiag;
+	      return -1;
+	    }
+	  for(const double x : step)
+	    for(const double y : step)
+	      for(const double z : step)
+		{
+		  const Geometry::Vec3D Pt(x,y,z);
+		  if (A.isValid(Pt)!=B.isValid(Pt))
+		    {
+		      ELog::EM<<"Cell == "<<std::get<0>(tc)<<ELog::endDiag;
+		      ELog::EM<<"Point == "<<Pt<<" :"<<popFlag<<ELog::endDiag;
+		      ELog::EM<<"A == "<<A.cellCompStr()<<ELog::endDiag;
+		      ELog::EM<<"B == "<<B.cellCompStr()<<ELog::endDiag;
+		      return -1;
+		    }
+		}
+	}
+    }
+  return 0;
+}
+
 int
 testObject::testCellStr()
   /*!
@@ -471,6 +557,143 @@ testObject::testIsValid()
   return 0;
 }
 
+int
+testObject::testCompiledValid()
+  /*!
+    Test the compiled rule program against the rule tree
+    \retval -1 :: Failed to agree
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testObject","testCompiledValid");
+
+  createSurfaces();
+
+  const std::vector<std::string> Cells=
+    {
+      "4 10 0.05524655  1 -2 3 -4 5 -6",
+      "5 10 0.05524655  -11 : 12 : -13 : 14 : -15 : 16",
+      "6 10 0.05524655  11 -12 13 -14 15 -16 #(1 -2 3 -4 5 -6)",
+      "7 10 0.05524655  -100 (-1 : 2 : -3 : 4) (-5:6) -21",
+      "8 10 0.05524655  (11 -2 : 21 -22) 3 -14 -100"
+    };
+  const std::vector<int> SNList={1,-2,6,12,-16,21,100};
+  const double step[]={-26.0,-15.0,-3.0,-1.0,0.0,0.5,1.0,3.0,10.0,12.0,25.0};
+
+  for(const std::string& CStr : Cells)
+    {
+      Qhull A;
+      A.setObject(CStr);
+      A.createSurfaceList();
+      const HeadRule& HR=A.getHeadRule();
+      RuleProgram RP;
+      RP.compile(HR);
+      if (!RP.isCompiled() || !RP.size())
+	{
+	  ELog::EM<<"Failed to compile "<<CStr<<ELog::endDiag;
+	  return -1;
+	}
+      std::vector<Geometry::Vec3D> Pts;
+      for(const double x : step)
+	for(const double y : step)
+	  for(const double z : step)
+	    Pts.push_back(Geometry::Vec3D(x,y,z));
+
+      std::vector<int> PtValid;
+      A.isValid(Pts,PtValid);
+      for(size_t i=0;i<Pts.size();i++)
+	if (PtValid[i]!=HR.isValid(Pts[i]))
+	  {
+	    ELog::EM<<"Cell == "<<CStr<<ELog::endDiag;
+	    ELog::EM<<"Point[multi] == "<<Pts[i]<<ELog::endDiag;
+	    return -1;
+	  }
+
+      for(const double x : step)
+	for(const double y : step)
+	  for(const double z : step)
+	    {
+	      const Geometry::Vec3D Pt(x,y,z);
+	      if (A.isValid(Pt)!=HR.isValid(Pt))
+		{
+		  ELog::EM<<"Cell == "<<CStr<<ELog::endDiag;
+		  ELog::EM<<"Point == "<<Pt<<ELog::endDiag;
+		  ELog::EM<<"Valid == "<<A.isValid(Pt)<<" ["
+			  <<HR.isValid(Pt)<<"]"<<ELog::endDiag;
+		  return -1;
+		}
+	      for(const int SN : SNList)
+		{
+		  if (A.isValid(Pt,SN)!=HR.isValid(Pt,SN) ||
+		      A.isDirectionValid(Pt,SN)!=
+		      HR.isDirectionValid(Pt,SN) ||
+		      A.pairValid(SN,Pt)!=HR.pairValid(SN,Pt) ||
+		      RP.isValid(Pt,std::set<int>({SN,1}))!=
+		      HR.isValid(Pt,std::set<int>({SN,1})))
+		    {
+		      ELog::EM<<"Cell == "<<CStr<<ELog::endDiag;
+		      ELog::EM<<"Point == "<<Pt<<" SN == "<<SN<<ELog::endDiag;
+		      ELog::EM<<"Pair == "<<A.pairValid(SN,Pt)<<" ["
+			      <<HR.pairValid(SN,Pt)<<"]"<<ELog::endDiag;
+		      return -1;
+		    }
+		}
+	    }
+    }
+  return 0;
+}
+
+int
+testObject::testSideCache()
+  /*!
+    Test the validity with a shared surface side cache
+    \retval -1 :: Failed to agree
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testObject","testSideCache");
+
+  createSurfaces();
+
+  // Cells sharing the sphere
+  Qhull A;
+  Qhull B;
+  A.setObject("4 10 0.05524655  -100 1 -2");
+  B.setObject("5 10 0.05524655  -100 (-1:2)");
+  A.createSurfaceList();
+  B.createSurfaceList();
+
+  const std::vector<Geometry::Vec3D> Pts=
+    {
+      Geometry::Vec3D(0,0,0),Geometry::Vec3D(0,0,25),
+      Geometry::Vec3D(-1,3,0),Geometry::Vec3D(3,0,4),
+      Geometry::Vec3D(30,0,0)
+    };
+  const std::vector<int> SNList={1,-2,100,-100};
+
+  MonteCarlo::SurfSideCache Cache;
+  for(const Geometry::Vec3D& Pt : Pts)
+    for(const int SN : SNList)
+      {
+	if (A.isDirectionValid(Pt,SN,Cache)!=A.isDirectionValid(Pt,SN) ||
+	    B.isDirectionValid(Pt,SN,Cache)!=B.isDirectionValid(Pt,SN) ||
+	    A.isValid(Pt,Cache)!=A.isValid(Pt) ||
+	    B.isValid(Pt,Cache)!=B.isValid(Pt))
+	  {
+	    ELog::EM<<"Point == "<<Pt<<" SN == "<<SN<<ELog::endDiag;
+	    return -1;
+	  }
+      }
+  // Sphere is evaluated once per point
+  if (Cache.getMiss()!=Pts.size() || !Cache.getHit())
+    {
+      ELog::EM<<"Hit/Miss == "<<Cache.getHit()<<" "
+	      <<Cache.getMiss()<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
 int
 testObject::testIsOnSide() 
   /*!
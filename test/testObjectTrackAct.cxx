@@ -22,6 +22,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <cmath>
 #include <complex> 
 #include <vector>
@@ -35,6 +36,7 @@
 #include <iterator>
 #include <memory>
 #include <tuple>
+#include <boost/multi_array.hpp>
 
 
 #include "Exception.h"
@@ -48,6 +50,11 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "Surface.h"
+#include "Quadratic.h"
+#include "Plane.h"
+#include "Cone.h"
+#include "Mesh3D.h"
 #include "varList.h"
 #include "Code.h"
 #include "FItem.h"
@@ -64,8 +71,17 @@
 #include "surfRegister.h"
 #include "ModelSupport.h"
 #include "LineTrack.h"
+#include "AttnTable.h"
 #include "ObjectTrackAct.h"
 #include "ObjectTrackPoint.h"
+#include "pointDetOpt.h"
+#include "WWG.h"
+#include "WWGWeight.h"
+#include "MarkovProcess.h"
+#include "inputParam.h"
+#include "CellWeight.h"
+#include "TrackCache.h"
+#include "WeightControl.h"
 
 #include "testFunc.h"
 #include "testObjectTrackAct.h"
@@ -165,6 +181,27 @@ testObjectTrackAct::createObjects()
 
   return;
 }
+
+void
+testObjectTrackAct::createMesh(const size_t NX,const size_t NY,
+			       Geometry::Mesh3D& Grid,
+			       std::vector<double>& EBin,
+			       Geometry::Vec3D& SourcePt) const
+  /*!
+    Create the WWG mesh [3 z bins], energy bins and 
+    source point shared by the WWG tests
+    \param NX :: Number of x bins
+    \param NY :: Number of y bins
+    \param Grid :: Mesh to set
+    \param EBin :: Energy bins to set
+    \param SourcePt :: Source point to set
+  */
+{
+  Grid.setMesh({-15.0,15.0},{NX},{-15.0,15.0},{NY},{-3.0,3.0},{3});
+  EBin={1.0,10.0};
+  SourcePt=Geometry::Vec3D(20.0,0.0,0.0);
+  return;
+}
   
 
 int 
@@ -183,11 +220,27 @@ testObjectTrackAct::applyTest(const int extra)
   typedef int (testObjectTrackAct::*testPtr)();
   testPtr TPtr[]=
     {
-      &testObjectTrackAct::testPointDet
+      &testObjectTrackAct::testAttnTable,
+      &testObjectTrackAct::testCellThreads,
+      &testObjectTrackAct::testMarkov,
+      &testObjectTrackAct::testPointDet,
+      &testObjectTrackAct::testPointDetOpt,
+      &testObjectTrackAct::testRefineTrack,
+      &testObjectTrackAct::testTrackKey,
+      &testObjectTrackAct::testTrackSums,
+      &testObjectTrackAct::testWWGThreads
     };
   const std::string TestName[]=
     {
-      "PointDet"
+      "AttnTable",
+      "CellThreads",
+      "Markov",
+      "PointDet",
+      "PointDetOpt",
+      "RefineTrack",
+      "TrackKey",
+      "TrackSums",
+      "WWGThreads"
     };
   
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -215,6 +268,176 @@ testObjectTrackAct::applyTest(const int extra)
   return 0;
 }
 
+int
+testObjectTrackAct::testAttnTable()
+  /*!
+    Check the attenuation from the material table for each
+    energy bin against the single attenuation sum
+    \return 0 on success and -1 on error
+  */
+{
+  ELog::RegMethod RegA("testObjectTrackAct","testAttnTable");
+
+  ObjectTrackPoint OA(Geometry::Vec3D(20,0,0));
+  
+  ASim.calcAllVertex();
+  const Simulation::OTYPE& Cells=ASim.getCells();
+  for(const Simulation::OTYPE::value_type& vc : Cells)
+    if (!vc.second->isPlaceHold())
+      OA.addUnit(ASim,vc.first,vc.second->getCofM());
+
+  const std::vector<double> EScale({1.0,0.5,2.0});
+  AttnTable ATable;
+  ATable.build(EScale);
+  
+  std::vector<double> AT;
+  for(const Simulation::OTYPE::value_type& vc : Cells)
+    {
+      if (vc.second->isPlaceHold()) continue;
+      const double A=OA.getAttnSum(vc.first);
+      OA.getAttnSum(vc.first,ATable,AT);
+      if (AT.size()!=EScale.size())
+	return -1;
+      for(size_t i=0;i<AT.size();i++)
+	if (std::abs(AT[i]-A*EScale[i])>1e-12*A)
+	  {
+	    ELog::EM<<"Cell["<<vc.first<<"] "<<i<<" : "
+		    <<AT[i]<<" != "<<A*EScale[i]<<ELog::endDiag;
+	    return -1;
+	  }
+    }
+  return 0;
+}
+
+int
+testObjectTrackAct::testCellThreads()
+  /*!
+    Check that the cell weight tracking gives the same
+    cell weights for one and several threads
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testObjectTrackAct","testCellThreads");
+
+  ASim.calcAllVertex();
+  const std::vector<int> cellVec({1,2,3,4,5});
+  const Geometry::Vec3D SourcePt(0.0,-20.0,0.0);
+
+  // threads : samples per cell
+  typedef std::tuple<size_t,size_t> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE(1,1),TTYPE(2,1),TTYPE(4,1),
+      TTYPE(1,5),TTYPE(3,5),TTYPE(8,5)
+    };
+
+  std::string Serial[2];
+  for(const TTYPE& tc : Tests)
+    {
+      WeightSystem::WeightControl WC;
+      WC.setCellTrack(std::get<0>(tc),std::get<1>(tc));
+      WeightSystem::CellWeight CW;
+      WC.calcCellTrack(ASim,SourcePt,cellVec,CW);
+      
+      std::ostringstream cx;
+      CW.write(cx);
+      std::string& Res=Serial[(std::get<1>(tc)>1) ? 1 : 0];
+      if (std::get<0>(tc)==1)
+	Res=cx.str();
+      else if (Res!=cx.str())
+	{
+	  ELog::EM<<"Threads == "<<std::get<0>(tc)<<" samples "
+		  <<std::get<1>(tc)<<ELog::endDiag;
+	  ELog::EM<<"Serial   ::\n"<<Res<<ELog::endDiag;
+	  ELog::EM<<"Threaded ::\n"<<cx.str()<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  // extra samples add extra tracks
+  if (Serial[0]==Serial[1])
+    {
+      ELog::EM<<"Sample points not used"<<ELog::endDiag;
+      return -2;
+    }
+  return 0;
+}
+
+int
+testObjectTrackAct::testMarkov()
+  /*!
+    Check the sparse Markov matrix against directly 
+    tracked values and the range cut
+    \return 0 on success and -1 on error
+  */
+{
+  ELog::RegMethod RegA("testObjectTrackAct","testMarkov");
+
+  WeightSystem::WWG wwg;
+  wwg.getGrid().setMesh({-15.0,15.0},{6},{-15.0,15.0},{5},{-3.0,3.0},{2});
+  wwg.calcGridMidPoints();
+  wwg.setEnergyBin({10.0},{1.0});
+  const std::vector<Geometry::Vec3D>& MidPt=wwg.getMidPoints();
+  const long int NPts(static_cast<long int>(MidPt.size()));
+  
+  WeightSystem::MarkovProcess MA;
+  MA.initializeData(wwg);
+  MA.computeMatrix(ASim,wwg,1.0,1.0,2.0);
+
+  WeightSystem::MarkovProcess MB;
+  MB.setThreads(3);
+  MB.setRange(8.0);
+  MB.initializeData(wwg);
+  MB.computeMatrix(ASim,wwg,1.0,1.0,2.0);
+
+  if (MB.nonZero()>=MA.nonZero())
+    {
+      ELog::EM<<"Range cut not applied : "<<MA.nonZero()<<" "
+	      <<MB.nonZero()<<ELog::endDiag;
+      return -1;
+    }
+  
+  for(long int i=0;i<NPts;i++)
+    for(long int j=0;j<NPts;j++)
+      {
+	const size_t uI(static_cast<size_t>(i));
+	const size_t uJ(static_cast<size_t>(j));
+	double expect(1.0);
+	if (i!=j)
+	  {
+	    ObjectTrackPoint OA(MidPt[uI]);
+	    OA.addUnit(ASim,1,MidPt[uJ]);
+	    double DistT=OA.getDistance(1);
+	    if (DistT<1.0) DistT=1.0;
+	    const double WF= -OA.getAttnSum(1)-2.0*log(DistT);
+	    expect=(WF>-20) ? exp(WF) : 0.0;
+	  }
+	const double VA=MA.getValue(i,j);
+	const double VB=MB.getValue(i,j);
+	const double expectB=
+	  (MidPt[uI].Distance(MidPt[uJ])>8.0) ? 0.0 : expect;
+	if (std::abs(VA-expect)>1e-12*expect ||
+	    std::abs(VB-expectB)>1e-12*expectB ||
+	    VA!=MA.getValue(j,i))
+	  {
+	    ELog::EM<<"Failed on "<<i<<" "<<j<<ELog::endDiag;
+	    ELog::EM<<"Values == "<<VA<<" "<<VB<<" : "<<expect
+		    <<ELog::endDiag;
+	    return -1;
+	  }
+      }
+
+  // Flux iteration is normalised to a maximum of 1.0
+  std::vector<double> Flux(static_cast<size_t>(NPts),1.0);
+  MA.setIteration(5);
+  if (!MA.solveFlux(Flux,1e-8) ||
+      std::abs(*std::max_element(Flux.begin(),Flux.end())-1.0)>1e-12)
+    {
+      ELog::EM<<"Flux iteration failed"<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
 int
 testObjectTrackAct::testPointDet()
   /*!
@@ -258,3 +481,355 @@ testObjectTrackAct::testPointDet()
   return 0;
 }
 
+int
+testObjectTrackAct::testPointDetOpt()
+  /*!
+    Check the multi-detector material sums against a 
+    single track for each detector, for several threads,
+    a moved detector and a stored detector
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testObjectTrackAct","testPointDetOpt");
+
+  ASim.calcAllVertex();
+  const std::vector<Geometry::Vec3D> DVec=
+    {
+      Geometry::Vec3D(20,0,0),
+      Geometry::Vec3D(-20,3,1),
+      Geometry::Vec3D(0,25,-2)
+    };
+
+  // check sums of PD against single tracks
+  auto checkPD=[this](const pointDetOpt& PD,
+		      const std::vector<Geometry::Vec3D>& Pts) -> int
+    {
+      const Simulation::OTYPE& Cells=ASim.getCells();
+      for(size_t i=0;i<Pts.size();i++)
+	{
+	  ObjectTrackPoint OA(Pts[i]);
+	  size_t cellIndex(0);
+	  for(const Simulation::OTYPE::value_type& vc : Cells)
+	    {
+	      if (vc.second->isPlaceHold()) continue;
+	      OA.addUnit(ASim,vc.first,vc.second->getCofM());
+	      const double A=OA.getMatSum(vc.first);
+	      const double B=PD.getMatSum(i,cellIndex);
+	      if (std::abs(A-B)>1e-10)
+		{
+		  ELog::EM<<"Detector "<<i<<" cell "<<vc.first<<" : "
+			  <<A<<" != "<<B<<ELog::endDiag;
+		  return -1;
+		}
+	      cellIndex++;
+	    }
+	  if (cellIndex!=PD.nCell())
+	    return -1;
+	}
+      return 0;
+    };
+
+  pointDetOpt PA;
+  for(const Geometry::Vec3D& Pt : DVec)
+    PA.addDetector(Pt);
+  PA.createObjAct(ASim);
+  if (checkPD(PA,DVec)) return -1;
+
+  pointDetOpt PB;
+  PB.setThreads(4);
+  for(const Geometry::Vec3D& Pt : DVec)
+    PB.addDetector(Pt);
+  PB.createObjAct(ASim);
+  for(size_t i=0;i<DVec.size();i++)
+    for(size_t j=0;j<PB.nCell();j++)
+      if (PA.getMatSum(i,j)!=PB.getMatSum(i,j))
+	{
+	  ELog::EM<<"Thread sum "<<i<<":"<<j<<ELog::endDiag;
+	  return -2;
+	}
+
+  // move one detector : only that one is invalid
+  std::vector<Geometry::Vec3D> MVec(DVec);
+  MVec[1]=Geometry::Vec3D(-15,-4,0);
+  PB.setDetector(0,DVec[0]);
+  PB.setDetector(1,MVec[1]);
+  if (!PB.isValid(0) || PB.isValid(1) || !PB.isValid(2))
+    {
+      ELog::EM<<"Valid flags "<<PB.isValid(0)<<PB.isValid(1)
+	      <<PB.isValid(2)<<ELog::endDiag;
+      return -3;
+    }
+  PB.createObjAct(ASim);
+  if (checkPD(PB,MVec)) return -4;
+
+  // stored detector
+  std::stringstream SX;
+  PB.writeDetector(SX,1);
+  pointDetOpt PC;
+  PC.addDetector(MVec[1]);
+  PC.setCells(ASim);
+  PC.readDetector(SX,0);
+  if (!PC.isValid(0)) return -5;
+  for(size_t j=0;j<PC.nCell();j++)
+    if (PC.getMatSum(0,j)!=PB.getMatSum(1,j))
+      return -5;
+  
+  return 0;
+}
+
+int
+testObjectTrackAct::testRefineTrack()
+  /*!
+    Check the partial tracking of a refined WWG mesh: the 
+    tracked points must match a full track and the others
+    the coarse points. Check that the gradient flags mark
+    only points with a large step to a neighbour.
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testObjectTrackAct","testRefineTrack");
+
+  Geometry::Mesh3D Grid;
+  std::vector<double> EBin;
+  Geometry::Vec3D SourcePt;
+  createMesh(6,5,Grid,EBin,SourcePt);
+
+  WeightSystem::WWGWeight WA(EBin.size(),Grid);
+  WA.calcTracks(ASim,SourcePt,Grid.midPoints());
+  WA.applyTracks(1.0,1.0,2.0);
+
+  // gradient flags
+  const long int NX(WA.getXSize());
+  const long int NY(WA.getYSize());
+  const long int NZ(WA.getZSize());
+  const double maxStep(0.5);
+  std::vector<int> Flag;
+  WA.markGradient(maxStep,Flag);
+  const boost::multi_array<double,4>& AGrid=WA.getGrid();
+  for(long int i=0;i<NX;i++)
+    for(long int j=0;j<NY;j++)
+      for(long int k=0;k<NZ;k++)
+	{
+	  int steep(0);
+	  const long int DI[6][3]={{-1,0,0},{1,0,0},{0,-1,0},
+				   {0,1,0},{0,0,-1},{0,0,1}};
+	  for(size_t dir=0;dir<6 && !steep;dir++)
+	    {
+	      const long int a(i+DI[dir][0]);
+	      const long int b(j+DI[dir][1]);
+	      const long int c(k+DI[dir][2]);
+	      if (a<0 || b<0 || c<0 || a>=NX || b>=NY || c>=NZ)
+		continue;
+	      for(long int e=0;e<2;e++)
+		if (std::abs(AGrid[i][j][k][e]-AGrid[a][b][c][e])>maxStep)
+		  steep=1;
+	    }
+	  const size_t index(static_cast<size_t>((i*NY+j)*NZ+k));
+	  if (steep!=Flag[index])
+	    {
+	      ELog::EM<<"Flag["<<i<<" "<<j<<" "<<k<<"] == "
+		      <<Flag[index]<<ELog::endDiag;
+	      return -1;
+	    }
+	}
+
+  // refined mesh : x bins 1,2 split 3 and z bin 1 split 2
+  const Geometry::Mesh3D FGrid=Grid.refine({1,3,3,1,1,1},
+					   {1,1,1,1,1},{1,2,1});
+  const std::vector<Geometry::Vec3D> FMidPt=FGrid.midPoints();
+  std::vector<size_t> Parent;
+  std::vector<size_t> Active;
+  const size_t PX[]={0,1,1,1,2,2,2,3,4,5};
+  const size_t PZ[]={0,1,1,2};
+  for(size_t i=0;i<10;i++)
+    for(size_t j=0;j<5;j++)
+      for(size_t k=0;k<4;k++)
+	{
+	  if (j==2 && (PX[i]==1 || PX[i]==2))
+	    Active.push_back(Parent.size());
+	  Parent.push_back((PX[i]*5+j)*3+PZ[k]);
+	}
+
+  WeightSystem::WWGWeight WB(EBin.size(),FGrid);
+  WB.calcTracks(ASim,SourcePt,FMidPt);
+  WB.applyTracks(1.0,1.0,2.0);
+
+  WeightSystem::WWGWeight WC(EBin.size(),FGrid);
+  WC.copyTracks(WA,Parent);
+  WC.calcTracks(ASim,SourcePt,FMidPt,Active);
+  WC.applyTracks(1.0,1.0,2.0);
+
+  const double* AData=WA.getGrid().data();
+  const double* BData=WB.getGrid().data();
+  const double* CData=WC.getGrid().data();
+  size_t activeIndex(0);
+  for(size_t i=0;i<Parent.size();i++)
+    {
+      const bool activeFlag(activeIndex<Active.size() &&
+			    Active[activeIndex]==i);
+      if (activeFlag) activeIndex++;
+      for(size_t e=0;e<2;e++)
+	{
+	  const double Expect=(activeFlag) ?
+	    BData[i*2+e] : AData[Parent[i]*2+e];
+	  if (CData[i*2+e]!=Expect)
+	    {
+	      ELog::EM<<"Point "<<i<<" ["<<activeFlag<<"] "
+		      <<CData[i*2+e]<<" != "<<Expect<<ELog::endDiag;
+	      return -2;
+	    }
+	}
+    }
+  return 0;
+}
+
+int
+testObjectTrackAct::testTrackKey()
+  /*!
+    Check that moving only a surface changes the
+    geometry key of the track cache
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testObjectTrackAct","testTrackKey");
+
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  ASim.populateCells();
+
+  // directory only named : nothing is written
+  WeightSystem::TrackCache TC;
+  TC.setDirectory("testTrackKey");
+  const std::vector<double> Desc({1.0,2.0,3.0});
+
+  TC.setGeometry(ASim);
+  const std::string KeyA=TC.makeKey("test",Desc);
+
+  Geometry::Surface* SPtr=SurI.getSurf(6);
+  SPtr->displace(Geometry::Vec3D(0,0,0.5));
+  TC.setGeometry(ASim);
+  const std::string KeyB=TC.makeKey("test",Desc);
+
+  SPtr->displace(Geometry::Vec3D(0,0,-0.5));
+  TC.setGeometry(ASim);
+  const std::string KeyC=TC.makeKey("test",Desc);
+
+  if (KeyA.empty() || KeyA==KeyB || KeyA!=KeyC)
+    {
+      ELog::EM<<"Key A == "<<KeyA<<ELog::endDiag;
+      ELog::EM<<"Key B == "<<KeyB<<ELog::endDiag;
+      ELog::EM<<"Key C == "<<KeyC<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
+int
+testObjectTrackAct::testTrackSums()
+  /*!
+    Check that stored WWG track sums re-read and re-applied
+    with new factors give the same weights as a full track
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testObjectTrackAct","testTrackSums");
+
+  Geometry::Mesh3D Grid;
+  std::vector<double> EBin;
+  Geometry::Vec3D SourcePt;
+  createMesh(6,5,Grid,EBin,SourcePt);
+  const std::vector<Geometry::Vec3D> MidPt=Grid.midPoints();
+
+  WeightSystem::WWGWeight WA(EBin.size(),Grid);
+  WA.calcTracks(ASim,SourcePt,MidPt);
+  std::stringstream SX;
+  WA.writeTracks(SX);
+
+  // density : r2Length : r2Power
+  typedef std::tuple<double,double,double> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE(1.0,1.0,2.0),
+      TTYPE(0.5,3.0,2.0),
+      TTYPE(1.2,1.0,1.5)
+    };
+
+  WeightSystem::WWGWeight WB(EBin.size(),Grid);
+  WB.readTracks(SX);
+  for(const TTYPE& tc : Tests)
+    {
+      WeightSystem::WWGWeight WC(EBin.size(),Grid);
+      WC.wTrack(ASim,SourcePt,EBin,MidPt,
+		std::get<0>(tc),std::get<1>(tc),std::get<2>(tc));
+      WB.applyTracks(std::get<0>(tc),std::get<1>(tc),std::get<2>(tc));
+
+      const double* BData=WB.getGrid().data();
+      const double* CData=WC.getGrid().data();
+      const size_t NData=WC.getGrid().num_elements();
+      for(size_t i=0;i<NData;i++)
+	if (BData[i]!=CData[i])
+	  {
+	    ELog::EM<<"Factors == "<<std::get<0>(tc)<<" "<<std::get<1>(tc)
+		    <<" "<<std::get<2>(tc)<<" index "<<i<<ELog::endDiag;
+	    ELog::EM<<"Stored == "<<BData[i]<<" tracked == "
+		    <<CData[i]<<ELog::endDiag;
+	    return -1;
+	  }
+    }
+  
+  // A grid of the wrong size must not accept the sums
+  Geometry::Mesh3D GridB;
+  GridB.setMesh({-15.0,15.0},{4},{-15.0,15.0},{5},{-3.0,3.0},{3});
+  WeightSystem::WWGWeight WD(EBin.size(),GridB);
+  std::stringstream SY;
+  WA.writeTracks(SY);
+  try
+    {
+      WD.readTracks(SY);
+      ELog::EM<<"Mis-sized track sums accepted"<<ELog::endDiag;
+      return -2;
+    }
+  catch (ColErr::ExBase&)
+    { }
+  return 0;
+}
+
+int
+testObjectTrackAct::testWWGThreads()
+  /*!
+    Check that the WWG mesh tracking gives the same
+    weights for one and several threads
+    \return 0 on success and -1 on error
+  */
+{
+  ELog::RegMethod RegA("testObjectTrackAct","testWWGThreads");
+
+  Geometry::Mesh3D Grid;
+  std::vector<double> EBin;
+  Geometry::Vec3D SourcePt;
+  createMesh(12,10,Grid,EBin,SourcePt);
+  const std::vector<Geometry::Vec3D> MidPt=Grid.midPoints();
+
+  WeightSystem::WWGWeight WA(EBin.size(),Grid);
+  WA.wTrack(ASim,SourcePt,EBin,MidPt,1.0,1.0,2.0);
+
+  const size_t NThread[]={2,3,8};
+  for(const size_t NT : NThread)
+    {
+      WeightSystem::WWGWeight WB(EBin.size(),Grid);
+      WB.setThreads(NT);
+      WB.wTrack(ASim,SourcePt,EBin,MidPt,1.0,1.0,2.0);
+
+      const double* AData=WA.getGrid().data();
+      const double* BData=WB.getGrid().data();
+      const size_t NData=WA.getGrid().num_elements();
+      for(size_t i=0;i<NData;i++)
+	if (AData[i]!=BData[i])
+	  {
+	    ELog::EM<<"Threads == "<<NT<<" index "<<i<<ELog::endDiag;
+	    ELog::EM<<"Serial == "<<AData[i]<<" threaded == "
+		    <<BData[i]<<ELog::endDiag;
+	    return -1;
+	  }
+    }
+  return 0;
+}
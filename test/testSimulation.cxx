@@ -35,6 +35,7 @@
 #include <iterator>
 #include <memory>
 #include <tuple>
+#include <array>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -55,6 +56,7 @@
 #include "Surface.h"
 #include "surfIndex.h"
 #include "Quadratic.h"
+#include "Plane.h"
 #include "surfaceFactory.h"
 #include "Rules.h"
 #include "varList.h"
@@ -73,7 +75,11 @@
 #include "surfRegister.h"
 #include "ModelSupport.h"
 #include "neutron.h"
+#include "CellIndex.h"
 #include "Simulation.h"
+#include "transComp.h"
+#include "localRotate.h"
+#include "masterRotate.h"
 
 #include "testFunc.h"
 #include "testSimulation.h"
@@ -187,14 +193,18 @@ testSimulation::applyTest(const int extra)
   typedef int (testSimulation::*testPtr)();
   testPtr TPtr[]=
     {
+      &testSimulation::testCellIndex,
       &testSimulation::testCreateObjSurfMap,
       &testSimulation::testInCell,
+      &testSimulation::testMasterRotation,
       &testSimulation::testTrackNeutron
     };
   const std::string TestName[]=
     {
+      "CellIndex",
       "CreateObjSurfMap",
       "InCell",
+      "MasterRotation",
       "TrackNeutron"
     };
   
@@ -222,6 +232,56 @@ testSimulation::applyTest(const int extra)
   return 0;
 }
 
+int
+testSimulation::testMasterRotation()
+  /*!
+    Check that the compiled cell rules follow the surfaces
+    after a master rotation : batched isValid must match
+    the rule tree of each cell
+    \return 0 on success and -1 on error
+  */
+{
+  ELog::RegMethod RegA("testSimulation","testMasterRotation");
+
+  masterRotate& MR = masterRotate::Instance();
+  MR.reset();
+  MR.addRotation(Geometry::Vec3D(0,0,1),Geometry::Vec3D(0,0,0),30.0);
+  MR.addDisplace(Geometry::Vec3D(0.5,-0.3,0.2));
+
+  ASim.populateCells();
+  ASim.masterRotation();
+
+  const double step[]={-26.0,-12.0,-3.1,-1.4,-0.8,0.0,0.9,
+		       1.3,2.7,3.3,11.0,14.0,24.0};
+  std::vector<Geometry::Vec3D> Pts;
+  for(const double x : step)
+    for(const double y : step)
+      for(const double z : step)
+	Pts.push_back(Geometry::Vec3D(x,y,z));
+
+  int flag(0);
+  std::vector<int> PtValid;
+  for(const Simulation::OTYPE::value_type& mc : ASim.getCells())
+    {
+      const MonteCarlo::Object* OPtr=mc.second;
+      const HeadRule& HR=OPtr->getHeadRule();
+      OPtr->isValid(Pts,PtValid);
+      for(size_t i=0;!flag && i<Pts.size();i++)
+	if (PtValid[i]!=HR.isValid(Pts[i]))
+	  {
+	    ELog::EM<<"Cell == "<<mc.first<<ELog::endDiag;
+	    ELog::EM<<"Point == "<<Pts[i]<<" : "<<PtValid[i]
+		    <<" ["<<HR.isValid(Pts[i])<<"]"<<ELog::endDiag;
+	    flag=1;
+	  }
+    }
+
+  // unrotated geometry for the other tests
+  MR.reset();
+  initSim();
+  return (flag) ? -1 : 0;
+}
+
 int
 testSimulation::testTrackNeutron()
   /*!
@@ -280,6 +340,56 @@ testSimulation::testTrackNeutron()
             
 }
 
+int
+testSimulation::testCellIndex()
+  /*!
+    Test the bounding box index gives the same cells
+    as the full search
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testSimulation","testCellIndex");
+
+  ASim.populateCells();
+  ASim.buildCellIndex();
+  const ModelSupport::CellIndex* CIPtr=ASim.getCellIndex();
+  if (!CIPtr || CIPtr->nBounded()!=4 || CIPtr->nOpen()!=1)
+    {
+      if (CIPtr)
+	ELog::EM<<"Bounded/Open == "<<CIPtr->nBounded()<<" "
+		<<CIPtr->nOpen()<<ELog::endDiag;
+      return -1;
+    }
+
+  // Point : cell
+  typedef std::tuple<Geometry::Vec3D,int> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE(Geometry::Vec3D(0,0,0),2),
+      TTYPE(Geometry::Vec3D(0,26,0),1),
+      TTYPE(Geometry::Vec3D(0,2,0),3),
+      TTYPE(Geometry::Vec3D(12.5,0.3,0),4),
+      TTYPE(Geometry::Vec3D(0,5,0),5),
+      TTYPE(Geometry::Vec3D(-20,0,0),5)
+    };
+
+  for(const TTYPE& tc : Tests)
+    {
+      const MonteCarlo::Object* OPtr=CIPtr->findCell(std::get<0>(tc));
+      if (!OPtr || OPtr->getName()!=std::get<1>(tc))
+	{
+	  ELog::EM<<"Failed on point:"<<std::get<0>(tc)<<ELog::endDiag;
+	  ELog::EM<<"Cell == "<<(OPtr ? OPtr->getName() : 0)
+		  <<" expected "<<std::get<1>(tc)<<ELog::endDiag;
+	  return -2;
+	}
+    }
+
+  ASim.clearCellIndex();
+  if (ASim.getCellIndex()) return -3;
+  return 0;
+}
+
 int
 testSimulation::testCreateObjSurfMap()
   /*!
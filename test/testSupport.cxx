@@ -31,6 +31,7 @@
 #include <string>
 #include <algorithm>
 #include <tuple>
+#include <sstream>
 
 #ifndef NO_REGEX
 #include <boost/regex.hpp>
@@ -46,6 +47,7 @@
 #include "support.h"
 #include "stringCombine.h"
 #include "regexSupport.h"
+#include "lineWriter.h"
 
 #include "testFunc.h"
 #include "testSupport.h"
@@ -83,6 +85,7 @@ testSupport::applyTest(const int extra)
       &testSupport::testExtractWord,
       &testSupport::testFullBlock,
       &testSupport::testItemize,
+      &testSupport::testLineWriter,
       &testSupport::testSection,
       &testSupport::testSectionCinder,
       &testSupport::testSectionRange,
@@ -102,6 +105,7 @@ testSupport::applyTest(const int extra)
       "ExtractWord",
       "FullBlock",
       "Itemize",
+      "LineWriter",
       "Section",
       "SectionCinder",
       "SectionRange",
@@ -374,6 +378,69 @@ testSupport::testItemize()
   return 0;  
 }
 
+int
+testSupport::testLineWriter()
+  /*!
+    Test the buffered lineWriter against writeLine
+    \retval -1 :: output different
+    \retval 0 on success
+  */
+{
+  ELog::RegMethod RegA("testSupport","testLineWriter");
+
+  const std::vector<double> Values=
+    { 0.0,1.0,-1.0,1e-6,-3.4e-7,1e-40,99000.0,99000.1,
+      -1.2e8,0.5,12345.678,1e-5,3.0,7.25,-0.001 };
+
+  // test several lengths [part lines / exact lines]
+  for(const size_t NV : {size_t(0),size_t(4),size_t(6),
+	size_t(12),Values.size()})
+    {
+      std::ostringstream OA;
+      std::ostringstream OB;
+      size_t itemCnt(0);
+      {
+	StrFunc::lineWriter LW(OB,6);
+	for(size_t i=0;i<NV;i++)
+	  {
+	    StrFunc::writeLine(OA,Values[i],itemCnt,6);
+	    LW.add(Values[i]);
+	  }
+	if (itemCnt) OA<<std::endl;
+	LW.endLine();
+      }
+      if (OA.str()!=OB.str())
+	{
+	  ELog::EM<<"Failed on size "<<NV<<ELog::endDiag;
+	  ELog::EM<<"writeLine  ::\n"<<OA.str()<<ELog::endDiag;
+	  ELog::EM<<"lineWriter ::\n"<<OB.str()<<ELog::endDiag;
+	  return -1;
+	}
+    }
+
+  // Large block to force a buffer flush
+  std::ostringstream OA;
+  std::ostringstream OB;
+  size_t itemCnt(0);
+  {
+    StrFunc::lineWriter LW(OB,6);
+    for(size_t i=0;i<20000;i++)
+      {
+	const double V=Values[i % Values.size()]*static_cast<double>(i);
+	StrFunc::writeLine(OA,V,itemCnt,6);
+	LW.add(V);
+      }
+    if (itemCnt) OA<<std::endl;
+    LW.endLine();
+  }
+  if (OA.str()!=OB.str())
+    {
+      ELog::EM<<"Failed on large block"<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
 int
 testSupport::testSection()
   /*!
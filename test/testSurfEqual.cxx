@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <memory>
 #include <tuple>
+#include <chrono>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -53,8 +54,11 @@
 #include "NullSurface.h"
 #include "Sphere.h"
 #include "Plane.h"
+#include "Cylinder.h"
+#include "Cone.h"
 #include "surfaceFactory.h"
 #include "surfEqual.h"
+#include "surfCompare.h"
 
 #include "testFunc.h"
 #include "testSurfEqual.h"
@@ -112,14 +116,22 @@ testSurfEqual::applyTest(const int extra)
   testPtr TPtr[]=
     {
       &testSurfEqual::testBasicPair,
-      &testSurfEqual::testEqualSurfNum
+      &testSurfEqual::testEqualSurfNum,
+      &testSurfEqual::testHashBenchmark,
+      &testSurfEqual::testHashEqual,
+      &testSurfEqual::testHashPlanes
     };
 
   const std::string TestName[]=
     {
       "BasicPair",
-      "EqualSurfNum"
+      "EqualSurfNum",
+      "HashBenchmark",
+      "HashEqual",
+      "HashPlanes"
     };
+  // benchmark : only run when selected
+  const int benchIndex(3);
 
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
   if (!extra)
@@ -134,7 +146,7 @@ testSurfEqual::applyTest(const int extra)
     }
   for(int i=0;i<TSize;i++)
     {
-      if (extra<0 || extra==i+1)
+      if ((extra<0 && i+1!=benchIndex) || extra==i+1)
         {
 	  TestFunc::regTest(TestName[i]);
 	  const int retValue= (this->*TPtr[i])();
@@ -208,3 +220,200 @@ testSurfEqual::testEqualSurfNum()
   return 0;
 }
 
+int
+testSurfEqual::testHashEqual()
+  /*!
+    Test the hash search against the full search of the 
+    surface map for surfaces that are equal within tolerance, 
+    opposite or just different.
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfEqual","testHashEqual");
+
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+
+  SurI.createSurface(21,"so 5.0");
+  SurI.createSurface(22,"s 1 2 3 5.0");
+  SurI.createSurface(23,"cx 4.0");
+  SurI.createSurface(24,"c/y 1 2 4.0");
+  SurI.createSurface(25,"kz 3.0 0.5");
+  SurI.createSurface(26,"p 1 1 0 2.0");
+
+  // Surface : Expected number [0 no match]
+  typedef std::tuple<std::string,int> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE("px -1.000000001",1),
+      TTYPE("px 1",2),
+      TTYPE("p -1 0 0 1",11),
+      TTYPE("px 1.001",0),
+      TTYPE("so 5.000000001",21),
+      TTYPE("s 1 2 3.0000000001 5.0",22),
+      TTYPE("s 1 2 3 5.1",0),
+      TTYPE("cx 4.0",23),
+      TTYPE("c/y 1 2 4.0000000001",24),
+      TTYPE("c/y 1 2.1 4.0",0),
+      TTYPE("kz 3.0 0.5",25),
+      TTYPE("p 1 1 0 2.0",26),
+      TTYPE("p 1 1 0.0001 2.0",0)
+    };
+
+  int cnt(1);
+  for(const TTYPE& tc : Tests)
+    {
+      Geometry::Surface* SPtr=
+	Geometry::surfaceFactory::Instance().processLine(std::get<0>(tc));
+      SPtr->setName(9999);
+
+      const int res=ModelSupport::equalSurfNum(SPtr);
+      const int expect=(std::get<1>(tc)) ? std::get<1>(tc) : 9999;
+
+      // full map search:
+      const Geometry::Surface* fullPtr(SPtr);
+      for(const ModelSupport::surfIndex::STYPE::value_type& SV :
+	    SurI.surMap())
+	if (SV.first!=9999 &&
+	    ModelSupport::equalSurface(SPtr,SV.second)==1)
+	  {
+	    fullPtr=SV.second;
+	    break;
+	  }
+      
+      if (res!=expect || fullPtr->getName()!=res)
+	{
+	  ELog::EM<<"Failed on test "<<cnt<<" : "<<std::get<0>(tc)<<ELog::endDiag;
+	  ELog::EM<<"Result == "<<res<<" ["<<expect<<"] full == "
+		  <<fullPtr->getName()<<ELog::endDiag;
+	  delete SPtr;
+	  return -1;
+	}
+      delete SPtr;
+      cnt++;
+    }
+
+  // opposite plane 
+  Geometry::Plane PX(9999,0);
+  PX.setSurface("p -1 -1 0 -2.0");
+  if (SurI.findOpposite(&PX)!=26)
+    {
+      ELog::EM<<"Failed on opposite plane"<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
+int
+testSurfEqual::testHashPlanes()
+  /*!
+    Check the hash search against the full search for 
+    a small set of planes with repeats
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfEqual","testHashPlanes");
+  return checkHashPlanes(1000,0);
+}
+
+int
+testSurfEqual::checkHashPlanes(const int NSurf,const int timeFlag)
+  /*!
+    Register NSurf planes (10% repeated) with the hash search,
+    and compare a sample of the repeats against the full
+    search of the surface map
+    \param NSurf :: Number of planes [multiple of 10]
+    \param timeFlag :: Write the search times
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfEqual","checkHashPlanes");
+
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+
+  const int offset(100000);
+  // sample every repeat of a small set / 200 of a large one
+  const int sampleStep((NSurf>2000) ? NSurf/200 : 10);
+  
+  std::vector<Geometry::Plane*> Sample;
+  int nInsert(0);
+  
+  std::chrono::high_resolution_clock::time_point TStart=
+    std::chrono::high_resolution_clock::now();
+  for(int i=0;i<NSurf;i++)
+    {
+      // Every 10th plane repeats an earlier [unique] one 
+      const int index=(i%10==9) ? i-5 : i;
+      const double theta=0.001*index;
+      const double phi=0.0007*index;
+      const Geometry::Vec3D Norm(cos(theta)*sin(phi),
+				 sin(theta)*sin(phi),cos(phi));
+      Geometry::Plane* PX=
+	SurI.createUniqSurf<Geometry::Plane>(offset+i);
+      PX->setPlane(Norm,0.01*(index % 1000));
+
+      const int N=ModelSupport::equalSurfNum(PX);
+      if (N==PX->getName() && !SurI.findOpposite(PX))
+	{
+	  SurI.insertSurface(PX);
+	  nInsert++;
+	}
+      else if ((i % sampleStep)==9)
+	Sample.push_back(PX);
+      else
+	delete PX;
+    }
+  std::chrono::duration<double> hashTime=
+    std::chrono::high_resolution_clock::now()-TStart;
+
+  // Full search of the sample:
+  int flag(0);
+  TStart=std::chrono::high_resolution_clock::now();
+  for(const Geometry::Plane* PX : Sample)
+    {
+      const Geometry::Surface* FPtr=
+	ModelSupport::EqualSurf<const Geometry::Plane*,const Geometry::Surface*>
+	(PX,SurI.surMap());
+      if (FPtr->getName()!=ModelSupport::equalSurfNum(PX))
+	flag=1;
+    }
+  std::chrono::duration<double> fullTime=
+    std::chrono::high_resolution_clock::now()-TStart;
+  
+  for(Geometry::Plane* PX : Sample)
+    delete PX;
+  for(int i=0;i<NSurf;i++)
+    if (SurI.getSurf(offset+i))
+      SurI.deleteSurface(offset+i);
+
+  if (timeFlag)
+    {
+      const double fullEst=(Sample.empty()) ? 0.0 :
+	fullTime.count()*static_cast<double>(NSurf)/
+	static_cast<double>(2*Sample.size());
+      ELog::EM<<"Registered "<<NSurf<<" planes ["<<nInsert<<" unique]"
+	      <<ELog::endDiag;
+      ELog::EM<<"Hash search time == "<<hashTime.count()
+	      <<" s"<<ELog::endDiag;
+      ELog::EM<<"Full search time [estimate] == "<<fullEst
+	      <<" s"<<ELog::endDiag;
+    }
+  
+  if (flag || Sample.empty() || nInsert!=NSurf-NSurf/10)
+    {
+      ELog::EM<<"Hash search differs from full search"<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
+
+int
+testSurfEqual::testHashBenchmark()
+  /*!
+    Time the registration of 10^5 planes with the hash
+    search [benchmark : only run when selected]
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfEqual","testHashBenchmark");
+  return checkHashPlanes(100000,1);
+}
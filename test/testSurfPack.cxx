@@ -0,0 +1,242 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   test/testSurfPack.cxx
+ *
+ * Copyright (c) 2004-2015 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <list>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "support.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Surface.h"
+#include "surfIndex.h"
+#include "SurfPack.h"
+
+#include "testFunc.h"
+#include "testSurfPack.h"
+
+using namespace Geometry;
+
+testSurfPack::testSurfPack() 
+  /*!
+    Constructor
+  */
+{}
+
+testSurfPack::~testSurfPack() 
+  /*!
+    Destructor
+  */
+{
+  ModelSupport::surfIndex::Instance().reset();
+}
+
+void
+testSurfPack::createSurfaces()
+  /*!
+    Create a surface of each packed form
+  */
+{
+  ELog::RegMethod RegA("testSurfPack","createSurfaces");
+
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  SurI.reset();
+
+  SurI.createSurface(1,"px 1");
+  SurI.createSurface(2,"p 1 1 0 0.5");
+  SurI.createSurface(3,"so 2");
+  SurI.createSurface(4,"s 1 0.5 0 1.5");
+  SurI.createSurface(5,"cx 1");
+  SurI.createSurface(6,"c/y 0.5 0.5 1");
+  SurI.createSurface(7,"c/z 0.5 0 2");
+  SurI.createSurface(8,"gq 1 1 0.5 0 0 0 0 0 0 -4");
+  SurI.createSurface(9,"kx 1 1");
+  return;
+}
+
+int
+testSurfPack::checkSides(const SurfPack& SP,
+			 const std::vector<Geometry::Vec3D>& Pts) const
+  /*!
+    Check the packed sides against Surface::side for both
+    the single point and the multi point forms
+    \param SP :: Pack to test
+    \param Pts :: Points to test
+    \return -1 on failure / 0 on success
+  */
+{
+  ELog::RegMethod RegA("testSurfPack","checkSides");
+
+  std::vector<int> Out;
+  for(const Geometry::Vec3D& Pt : Pts)
+    {
+      SP.side(Pt,Out);
+      for(size_t i=0;i<SP.size();i++)
+	if (Out[i]!=SP.getSurf(i)->side(Pt))
+	  {
+	    ELog::EM<<"Surface "<<SP.getSurf(i)->getName()
+		    <<" Pt == "<<Pt<<ELog::endDiag;
+	    ELog::EM<<"Side == "<<Out[i]<<" ["
+		    <<SP.getSurf(i)->side(Pt)<<"]"<<ELog::endDiag;
+	    return -1;
+	  }
+    }
+
+  std::vector<int> SMat;
+  SP.sideMatrix(Pts,SMat);
+  for(size_t i=0;i<SP.size();i++)
+    {
+      SP.side(i,Pts,Out);
+      for(size_t j=0;j<Pts.size();j++)
+	if (Out[j]!=SP.getSurf(i)->side(Pts[j]) ||
+	    SMat[i*Pts.size()+j]!=Out[j])
+	  {
+	    ELog::EM<<"Surface "<<SP.getSurf(i)->getName()
+		    <<" Pt == "<<Pts[j]<<ELog::endDiag;
+	    ELog::EM<<"Side == "<<Out[j]<<" "<<SMat[i*Pts.size()+j]
+		    <<" ["<<SP.getSurf(i)->side(Pts[j])<<"]"<<ELog::endDiag;
+	    return -1;
+	  }
+    }
+  return 0;
+}
+
+int 
+testSurfPack::applyTest(const int extra)
+  /*!
+    Applies all the tests and returns 
+    the error number
+    \param extra :: index of test
+    \retval -1 Side failed
+    \retval 0 All succeeded
+  */
+{
+  ELog::RegMethod RegA("testSurfPack","applyTest");
+  TestFunc::regSector("testSurfPack");
+
+  typedef int (testSurfPack::*testPtr)();
+  testPtr TPtr[]=
+    {
+      &testSurfPack::testSide,
+      &testSurfPack::testUpdate
+    };
+  const std::string TestName[]=
+    {
+      "Side",
+      "Update"
+    };
+  const int TSize(sizeof(TPtr)/sizeof(testPtr));
+  if (!extra)
+    {
+      TestFunc::Instance().writeList(std::cout,TSize,TestName);
+      return 0;
+    }
+  for(int i=0;i<TSize;i++)
+    {
+      if (extra<0 || extra==i+1)
+        {
+	  TestFunc::regTest(TestName[i]);
+	  const int retValue= (this->*TPtr[i])();
+	  if (retValue || extra>0)
+	    return retValue;
+	}
+    }
+  return 0;
+}
+
+int
+testSurfPack::testSide()
+  /*!
+    Test the packed side calculation against each surface
+    \retval -1 :: failed to agree
+    \retval 0 :: All passed
+  */
+{
+  ELog::RegMethod RegA("testSurfPack","testSide");
+
+  createSurfaces();
+  const ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+
+  SurfPack SP;
+  SP.addSurfaces(SurI.surMap());
+  if (SP.size()!=SurI.surMap().size() ||
+      SP.addSurface(SurI.getSurf(3))!=SP.getSlot(SurI.getSurf(3)))
+    {
+      ELog::EM<<"Failed to add surfaces :"<<SP.size()<<ELog::endDiag;
+      return -1;
+    }
+
+  // include points on the surfaces
+  const double step[]={-2.5,-2.0,-1.0,-0.5,0.0,0.5,1.0,1.5,2.0,3.0};
+  std::vector<Geometry::Vec3D> Pts;
+  for(const double x : step)
+    for(const double y : step)
+      for(const double z : step)
+	Pts.push_back(Geometry::Vec3D(x,y,z));
+
+  return checkSides(SP,Pts);
+}
+
+int
+testSurfPack::testUpdate()
+  /*!
+    Test the packed side calculation after the
+    surfaces have moved
+    \retval -1 :: failed to agree
+    \retval 0 :: All passed
+  */
+{
+  ELog::RegMethod RegA("testSurfPack","testUpdate");
+
+  createSurfaces();
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+
+  SurfPack SP;
+  SP.addSurfaces(SurI.surMap());
+  for(const ModelSupport::surfIndex::STYPE::value_type& SItem :
+	SurI.surMap())
+    SItem.second->displace(Geometry::Vec3D(0.5,-0.5,0.25));
+  SP.update();
+
+  const std::vector<Geometry::Vec3D> Pts=
+    {
+      Geometry::Vec3D(1.5,0,0),Geometry::Vec3D(0,0,0),
+      Geometry::Vec3D(0.5,-0.5,2.25),Geometry::Vec3D(1.5,0,1.5),
+      Geometry::Vec3D(1.5,0.5,0.25),Geometry::Vec3D(-3,1,2)
+    };
+  return checkSides(SP,Pts);
+}
@@ -0,0 +1,255 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   test/testTrackScratch.cxx
+ *
+ * Copyright (c) 2004-2015 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <list>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <tuple>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "support.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Surface.h"
+#include "surfIndex.h"
+#include "Line.h"
+#include "Rules.h"
+#include "HeadRule.h"
+#include "Object.h"
+#include "Qhull.h"
+#include "neutron.h"
+#include "LineIntersectVisit.h"
+#include "TrackScratch.h"
+
+#include "testFunc.h"
+#include "testTrackScratch.h"
+
+using namespace MonteCarlo;
+
+testTrackScratch::testTrackScratch() 
+  /*!
+    Constructor
+  */
+{}
+
+testTrackScratch::~testTrackScratch() 
+  /*!
+    Destructor
+  */
+{
+  ModelSupport::surfIndex::Instance().reset();
+}
+
+void
+testTrackScratch::createSurfaces()
+  /*!
+    Create a surface of each intercept kind
+  */
+{
+  ELog::RegMethod RegA("testTrackScratch","createSurfaces");
+
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  SurI.reset();
+
+  SurI.createSurface(1,"px 1");
+  SurI.createSurface(2,"p 1 1 0 0.5");
+  SurI.createSurface(3,"so 2");
+  SurI.createSurface(4,"s 1 0.5 0 1.5");
+  SurI.createSurface(5,"cx 1");
+  SurI.createSurface(6,"c/y 0.5 0.5 1");
+  SurI.createSurface(7,"c/z 0.5 0 2");
+  SurI.createSurface(8,"gq 1 1 0.5 0 0 0 0 0 0 -4");
+  SurI.createSurface(9,"kx 1 1");
+  SurI.createSurface(10,"k/z 0 0 1 0.5 1");
+  return;
+}
+
+int 
+testTrackScratch::applyTest(const int extra)
+  /*!
+    Applies all the tests and returns 
+    the error number
+    \param extra :: index of test
+    \retval -1 Intersect failed
+    \retval 0 All succeeded
+  */
+{
+  ELog::RegMethod RegA("testTrackScratch","applyTest");
+  TestFunc::regSector("testTrackScratch");
+
+  typedef int (testTrackScratch::*testPtr)();
+  testPtr TPtr[]=
+    {
+      &testTrackScratch::testIntersect,
+      &testTrackScratch::testObjectTrack
+    };
+  const std::string TestName[]=
+    {
+      "Intersect",
+      "ObjectTrack"
+    };
+  const int TSize(sizeof(TPtr)/sizeof(testPtr));
+  if (!extra)
+    {
+      TestFunc::Instance().writeList(std::cout,TSize,TestName);
+      return 0;
+    }
+  for(int i=0;i<TSize;i++)
+    {
+      if (extra<0 || extra==i+1)
+        {
+	  TestFunc::regTest(TestName[i]);
+	  const int retValue= (this->*TPtr[i])();
+	  if (retValue || extra>0)
+	    return retValue;
+	}
+    }
+  return 0;
+}
+
+int
+testTrackScratch::testIntersect()
+  /*!
+    Test the intercept kernels against LineIntersectVisit.
+    One scratch is reused for all the tracks.
+    \retval -1 :: failed to agree
+    \retval 0 :: All passed
+  */
+{
+  ELog::RegMethod RegA("testTrackScratch","testIntersect");
+
+  createSurfaces();
+  const ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+
+  // Origin : Direction
+  typedef std::tuple<Geometry::Vec3D,Geometry::Vec3D> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE(Geometry::Vec3D(0,0,0),Geometry::Vec3D(1,0,0)),
+      TTYPE(Geometry::Vec3D(-3,0.2,0.1),Geometry::Vec3D(1,0.1,0)),
+      TTYPE(Geometry::Vec3D(0.3,-4,0.5),Geometry::Vec3D(0,1,0)),
+      TTYPE(Geometry::Vec3D(0.1,0.2,-5),Geometry::Vec3D(0.1,0.3,1)),
+      TTYPE(Geometry::Vec3D(2,2,2),Geometry::Vec3D(-1,-1,-1)),
+      TTYPE(Geometry::Vec3D(0,5,0),Geometry::Vec3D(0,0,1))
+    };
+
+  TrackScratch TS;
+  for(const TTYPE& tc : Tests)
+    {
+      const Geometry::Vec3D& O(std::get<0>(tc));
+      const Geometry::Vec3D& D(std::get<1>(tc));
+      for(const std::map<int,Geometry::Surface*>::value_type& SMC :
+	    SurI.surMap())
+	{
+	  const Geometry::Surface* SPtr=SMC.second;
+	  LineIntersectVisit LI(O,D);
+	  SPtr->acceptVisitor(LI);
+	  TS.setLine(O,D);
+	  TS.addSurface(SPtr);
+
+	  const std::vector<Geometry::Vec3D>& LPts=LI.getPoints();
+	  const std::vector<double>& LD=LI.getDistance();
+	  const std::vector<Geometry::Vec3D>& TPts=TS.getPoints();
+	  const std::vector<double>& TD=TS.getDistance();
+
+	  int flag(LPts.size()==TPts.size() &&
+		   TS.getSurfIndex().size()==TPts.size());
+	  for(size_t i=0;flag && i<LPts.size();i++)
+	    if (LPts[i]!=TPts[i] || std::abs(LD[i]-TD[i])>1e-12 ||
+		TS.getSurfIndex()[i]!=SPtr)
+	      flag=0;
+	  if (!flag)
+	    {
+	      ELog::EM<<"Surface "<<SPtr->getName()<<" "
+		      <<SPtr->className()<<ELog::endDiag;
+	      ELog::EM<<"Line "<<O<<" :: "<<D<<ELog::endDiag;
+	      for(const Geometry::Vec3D& Pt : LPts)
+		ELog::EM<<"Visit Pt == "<<Pt<<ELog::endDiag;
+	      for(const Geometry::Vec3D& Pt : TPts)
+		ELog::EM<<"Track Pt == "<<Pt<<ELog::endDiag;
+	      return -1;
+	    }
+	}
+    }
+  return 0;
+}
+
+int
+testTrackScratch::testObjectTrack()
+  /*!
+    Test that a reused scratch gives the same
+    exit as a new one for each track
+    \retval -1 :: failed to agree
+    \retval 0 :: All passed
+  */
+{
+  ELog::RegMethod RegA("testTrackScratch","testObjectTrack");
+
+  createSurfaces();
+  
+  Qhull A;
+  A.setObject("4 10 0.05 -3 5 -1");
+  A.populate();
+  A.createSurfaceList();
+
+  const std::vector<Geometry::Vec3D> Dir=
+    {
+      Geometry::Vec3D(1,0,0),Geometry::Vec3D(-1,0,0),
+      Geometry::Vec3D(0,1,0),Geometry::Vec3D(0,0.3,1),
+      Geometry::Vec3D(-1,-1,0.2)
+    };
+
+  TrackScratch TS;
+  const Geometry::Surface* SPtr;
+  const Geometry::Surface* SPtrB;
+  double aDist,bDist;
+  for(const Geometry::Vec3D& D : Dir)
+    {
+      const neutron TNeut(1,Geometry::Vec3D(-0.5,1.3,0.1),D);
+      const int SA=A.trackOutCell(TS,TNeut,aDist,SPtr,0);
+      const int SB=A.trackOutCell(TNeut,bDist,SPtrB,0);
+      if (SA!=SB || SPtr!=SPtrB || std::abs(aDist-bDist)>1e-12 || !SA)
+	{
+	  ELog::EM<<"Track == "<<D<<ELog::endDiag;
+	  ELog::EM<<"SN == "<<SA<<" "<<SB<<ELog::endDiag;
+	  ELog::EM<<"Dist == "<<aDist<<" "<<bDist<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  return 0;
+}
@@ -28,6 +28,7 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
 
 #include "Exception.h"
@@ -34,6 +34,7 @@
 #include <numeric>
 #include <iterator>
 #include <memory>
+#include <tuple>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -207,11 +208,13 @@ testVolumes::applyTest(const int extra)
   testPtr TPtr[]=
     {
       &testVolumes::testPointVolume,
+      &testVolumes::testThreadVolume,
       &testVolumes::testVolume
     };
   const std::string TestName[]=
     {
       "PointVolume",
+      "ThreadVolume",
       "Volume"
     };
   
@@ -302,3 +305,50 @@ testVolumes::testPointVolume()
   return 0;
 }
 
+int
+testVolumes::testThreadVolume()
+  /*!
+    Test the threaded volume runs : reproducible for a 
+    given seed/thread count and agreeing with the sphere volume
+    \return 0 on success and -1 on error
+  */
+{
+  ELog::RegMethod RegA("testVolumes","testThreadVolume");
+
+  const double sphereVol(4.0*M_PI*216.0/3.0);   // Cell 2 [so 6.0]
+
+  // nThread : trackFlag : nPts : tolerance [0 : not checked]
+  typedef std::tuple<size_t,int,size_t,double> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE(4,0,200000,0.02),
+      TTYPE(3,1,40000,0.0)
+    };
+
+  for(const TTYPE& tc : Tests)
+    {
+      double V[2];
+      for(size_t i=0;i<2;i++)
+	{
+	  VolSum VTally(Geometry::Vec3D(0,0,0),
+			Geometry::Vec3D(16.0,16.0,16.0));
+	  VTally.addTallyCell(4,2);
+	  VTally.setThreads(std::get<0>(tc),12345);
+	  if (std::get<1>(tc))
+	    VTally.trackRun(ASim,std::get<2>(tc));
+	  else
+	    VTally.pointRun(ASim,std::get<2>(tc));
+	  V[i]=VTally.calcVolume(4);
+	}
+      if (V[0]!=V[1] || (std::get<3>(tc)>0.0 && 
+	  std::abs(V[0]-sphereVol)>std::get<3>(tc)*sphereVol))
+	{
+	  ELog::EM<<"Threads == "<<std::get<0>(tc)<<" track:"
+		  <<std::get<1>(tc)<<ELog::endDiag;
+	  ELog::EM<<"Volume == "<<V[0]<<" "<<V[1]
+		  <<" ["<<sphereVol<<"]"<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  return 0;
+}
@@ -0,0 +1,203 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   test/testWWG.cxx
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <list>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <boost/multi_array.hpp>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Mesh3D.h"
+#include "WWG.h"
+#include "WWGWeight.h"
+
+#include "testFunc.h"
+#include "testWWG.h"
+
+using namespace WeightSystem;
+
+testWWG::testWWG() 
+  /*!
+    Constructor
+  */
+{}
+
+testWWG::~testWWG() 
+  /*!
+    Destructor
+  */
+{}
+
+int 
+testWWG::applyTest(const int extra)
+  /*!
+    Applies all the tests and returns 
+    the error number
+    \param extra :: index of test
+    \retval -1 Distance failed
+    \retval 0 All succeeded
+  */
+{
+  ELog::RegMethod RegA("testWWG","applyTest");
+  TestFunc::regSector("testWWG");
+  
+  typedef int (testWWG::*testPtr)();
+  testPtr TPtr[]=
+    {
+      &testWWG::testProcess
+    };
+  const std::string TestName[]=
+    {
+      "Process"
+    };
+  const int TSize(sizeof(TPtr)/sizeof(testPtr));
+  if (!extra)
+    {
+      std::ios::fmtflags flagIO=std::cout.setf(std::ios::left);
+      for(int i=0;i<TSize;i++)
+        {
+	  std::cout<<std::setw(30)<<TestName[i]<<"("<<i+1<<")"<<std::endl;
+	}
+      std::cout.flags(flagIO);
+      return 0;
+    }
+  
+  for(int i=0;i<TSize;i++)
+    {
+      if (extra<0 || extra==i+1)
+        {
+	  TestFunc::regTest(TestName[i]);
+	  const int retValue= (this->*TPtr[i])();
+	  if (retValue || extra>0)
+	    return retValue;
+	}
+    }
+  return 0;
+}
+
+void
+testWWG::createMesh(WWG& wwg) const
+  /*!
+    Create a 50x40x20 mesh with two energy bins
+    filled with exp(-attenuation) values
+    \param wwg :: WWG to fill
+  */
+{
+  ELog::RegMethod RegA("testWWG","createMesh");
+
+  wwg.getGrid().setMesh({0.0,10.0},{50},{0.0,10.0},{40},{0.0,10.0},{20});
+  wwg.setEnergyBin({1.0,10.0},{1.0,1.0});
+  wwg.calcGridMidPoints();
+
+  WWGWeight WSet(2,wwg.getGrid());
+  const long int NPts(static_cast<long int>(wwg.getGrid().size()));
+  for(long int i=0;i<NPts;i++)
+    for(long int e=0;e<2;e++)
+      WSet.setPoint(i,e,-0.001*static_cast<double>((i*7+e*13) % 20011));
+  wwg.updateWM(WSet,1.0);
+  return;
+}
+
+int
+testWWG::testProcess()
+  /*!
+    Test the fused mesh processing against each step 
+    applied in turn to a copy of the mesh 
+    \return -ve on error / 0 on success
+   */
+{
+  ELog::RegMethod RegA("testWWG","testProcess");
+
+  typedef WWGStep::SType ST;
+  // Steps : threads
+  typedef std::tuple<std::vector<WWGStep>,size_t> TTYPE;
+  const std::vector<TTYPE> Tests=
+    {
+      TTYPE({WWGStep(ST::normalize)},1),
+      TTYPE({WWGStep(ST::scaleRange,1e-5,1.0),WWGStep(ST::power,0.5)},1),
+      TTYPE({WWGStep(ST::scaleRange,1e-5,1.0),WWGStep(ST::power,0.5)},4),
+      TTYPE({WWGStep(ST::normalize),WWGStep(ST::power,2.0),
+	    WWGStep(ST::scaleRange,0.2,0.8),WWGStep(ST::normalize)},3),
+      TTYPE({WWGStep(ST::scaleRange,-1.0,1.0),WWGStep(ST::power,3.0),
+	    WWGStep(ST::scaleRange,0.0,2.0)},2)
+    };
+  
+  int cnt(1);
+  for(const TTYPE& tc : Tests)
+    {
+      WWG wwg;
+      createMesh(wwg);
+      const boost::multi_array<double,4>& WMesh=wwg.getMesh();
+      std::vector<double> Ref(WMesh.data(),
+			      WMesh.data()+WMesh.num_elements());
+
+      // reference : each step in turn
+      for(const WWGStep& SUnit : std::get<0>(tc))
+	{
+	  const double maxV=*std::max_element(Ref.begin(),Ref.end());
+	  const double minV=*std::min_element(Ref.begin(),Ref.end());
+	  if (SUnit.type==ST::normalize && maxV>1e-38)
+	    for(double& V : Ref)
+	      V/=maxV;
+	  else if (SUnit.type==ST::scaleRange && maxV-minV>1e-38)
+	    for(double& V : Ref)
+	      V=(V-minV)*((SUnit.B-SUnit.A)/(maxV-minV))+SUnit.A;
+	  else if (SUnit.type==ST::power)
+	    for(double& V : Ref)
+	      V=std::pow(V,SUnit.A);
+	}
+      
+      wwg.setThreads(std::get<1>(tc));
+      wwg.process(std::get<0>(tc));
+      const double* TData=WMesh.data();
+      for(size_t i=0;i<Ref.size();i++)
+	if (!(std::abs(TData[i]-Ref[i])<=1e-12*std::abs(Ref[i])))
+	  {
+	    ELog::EM<<"Test "<<cnt<<" index "<<i<<ELog::endDiag;
+	    ELog::EM<<"Result == "<<TData[i]<<" expect "<<Ref[i]
+		    <<ELog::endDiag;
+	    return -1;
+	  }
+      cnt++;
+    }
+  return 0;
+}
@@ -45,6 +45,7 @@ private:
   void createSurfaces();
 
   //Tests 
+  int testAutoInsert();
   int testBoundaryValid();
   int testInsertComponent();
 
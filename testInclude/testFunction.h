@@ -38,8 +38,12 @@ private:
   //Tests 
   int testAnalyse();
   int testBuiltIn();
+  int testCache();
   int testCopyVarSet();
   int testEval();
+  int testOptimise();
+  int testScope();
+  int testSnapshot();
   int testString();
   int testVariable();
   int testVec3D();
@@ -50,7 +50,9 @@ private:
 		  const double) const;
 
   //Tests 
+  int testGuide();
   int testLine();
+  int testQueryContext();
   
 
 public:
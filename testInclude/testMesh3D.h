@@ -46,7 +46,9 @@ private:
 		 const std::string&,const std::string&,
 		 const std::string&) const;
   //Tests 
+  int testBinary();
   int testPoint();
+  int testRefine();
  
 public:
 
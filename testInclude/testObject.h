@@ -46,7 +46,9 @@ private:
   void createSurfaces();
 
   //Tests 
+  int testAddIntersection();
   int testCellStr();
+  int testCompiledValid();
   int testComplement();
   int testIsValid();
   int testIsOnSide();
@@ -54,6 +56,7 @@ private:
   int testRemoveComplement();
   int testSetObject();
   int testSetObjectExtra();
+  int testSideCache();
   int testTrackCell();
 
 public:
@@ -22,6 +22,12 @@
 #ifndef testObjectTrackAct_h
 #define testObjectTrackAct_h 
 
+namespace Geometry
+{
+  class Vec3D;
+  class Mesh3D;
+}
+
 /*!
   \class testObjectTrackAct
   \brief Tests the class Object
@@ -41,9 +47,19 @@ private:
   void initSim();
   void createSurfaces();
   void createObjects();
+  void createMesh(const size_t,const size_t,Geometry::Mesh3D&,
+		  std::vector<double>&,Geometry::Vec3D&) const;
 
   //Tests 
+  int testAttnTable();
+  int testCellThreads();
+  int testMarkov();
   int testPointDet();
+  int testPointDetOpt();
+  int testRefineTrack();
+  int testTrackKey();
+  int testTrackSums();
+  int testWWGThreads();
 
 public:
   
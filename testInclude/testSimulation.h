@@ -43,8 +43,10 @@ private:
   void createObjects();
 
   //Tests 
+  int testCellIndex();
   int testCreateObjSurfMap();
   int testInCell();
+  int testMasterRotation();
   int testTrackNeutron();
 
 public:
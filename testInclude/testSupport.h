@@ -44,6 +44,7 @@ private:
   int testExtractWord();
   int testFullBlock();  
   int testItemize();    
+  int testLineWriter();
   int testSection();
   int testSectionCinder();
   int testSectionRange();    
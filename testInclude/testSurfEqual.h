@@ -37,10 +37,14 @@ class testSurfEqual
  private:
   
   void createSurfaces();
+  int checkHashPlanes(const int,const int);
   		  
   //Tests 
   int testBasicPair();
   int testEqualSurfNum();
+  int testHashBenchmark();
+  int testHashEqual();
+  int testHashPlanes();
  
  public:
 
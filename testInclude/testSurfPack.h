@@ -0,0 +1,60 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   testInclude/testSurfPack.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef testSurfPack_h
+#define testSurfPack_h 
+
+namespace Geometry
+{
+  class SurfPack;
+}
+
+/*!
+  \class testSurfPack
+  \brief Tests the class SurfPack class
+  \author S. Ansell
+  \date October 2017
+  \version 1.0
+
+  Test the packed side calculation against each surface
+*/
+
+class testSurfPack 
+{
+private:
+
+  void createSurfaces();
+  int checkSides(const Geometry::SurfPack&,
+		 const std::vector<Geometry::Vec3D>&) const;
+
+  //Tests 
+  int testSide();
+  int testUpdate();
+ 
+public:
+
+  testSurfPack();
+  ~testSurfPack();
+
+  int applyTest(const int);     
+};
+
+#endif
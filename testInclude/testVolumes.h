@@ -44,6 +44,7 @@ private:
 
   //Tests 
   int testPointVolume();
+  int testThreadVolume();
   int testVolume();
 
 public:
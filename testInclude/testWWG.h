@@ -0,0 +1,55 @@
+/********************************************************************* 
+  CombLayer : MCNP(X) Input builder
+ 
+ * File:   testInclude/testWWG.h
+ *
+ * Copyright (c) 2004-2017 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef testWWG_h
+#define testWWG_h 
+
+namespace WeightSystem
+{
+  class WWG;
+}
+
+/*!
+  \class testWWG
+  \brief Tests the WWG mesh post-processing
+  \author S. Ansell
+  \date October 2017
+  \version 1.0
+*/
+
+class testWWG 
+{
+private:
+
+  void createMesh(WeightSystem::WWG&) const;
+  
+  //Tests 
+  int testProcess();
+  
+public:
+
+  testWWG();
+  ~testWWG();
+
+  int applyTest(const int);     
+};
+
+#endif
@@ -56,6 +56,7 @@
 #include "neutron.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "TrackScratch.h"
 #include "Zaid.h"
 #include "MXcards.h"
 #include "Material.h"
@@ -243,11 +244,29 @@ ObjComponent::trackWeight(MonteCarlo::neutron& N,
     \param surfPtr :: surface that track ended on
     \return surface number that it exited at /  0
   */
+{
+  MonteCarlo::TrackScratch TrackBuffer;
+  return trackWeight(TrackBuffer,N,R,surfPtr);
+}
+
+int
+ObjComponent::trackWeight(MonteCarlo::TrackScratch& TrackBuffer,
+			  MonteCarlo::neutron& N,double& R,
+			  const Geometry::Surface*& surfPtr) const
+  /*!
+    This tracks a neutron through object and determines the 
+    the track modification to a scattering point.
+    \param TrackBuffer :: Intercept buffer [reused by caller]
+    \param N :: neutron to move forward:change weight:new direction
+    \param R :: Random number exponent step
+    \param surfPtr :: surface that track ended on
+    \return surface number that it exited at /  0
+  */
 {
   ELog::RegMethod RegA("ObjComponent","trackWeight");
   double aDist(0);
       
-  const int SN=ObjPtr->trackOutCell(N,aDist,surfPtr);
+  const int SN=ObjPtr->trackOutCell(TrackBuffer,N,aDist,surfPtr);
   //  ELog::EM<<"Nutron Track"<<N.weight<<ELog::endDiag;
   if (MatPtr)    // not-void
     {